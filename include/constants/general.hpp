@@ -17,6 +17,22 @@ constexpr const size_t PING_EVENTS_QUEUE_LENGTH = 1;
 constexpr const size_t NETWORK_EVENTS_QUEUE_LENGTH = 1;
 
 constexpr const int POSITION_REPORT_INTERVAL = 20;
+// las posiciones se publican en lotes al juntar POSITION_BATCH_SIZE, cuando
+// la más antigua cumple POSITION_BATCH_MAX_AGE_MS o al terminar el viaje
+constexpr const size_t POSITION_BATCH_SIZE = 10;
+constexpr const int POSITION_BATCH_MAX_AGE_MS = 240 * 1000;
+// AT+SMPUB admite hasta 1024 bytes
+constexpr const size_t POSITION_BATCH_MAX_PAYLOAD = 1024;
+
+// la telemetría se publica en el formato binario de events/telemetry_codec.hpp;
+// con false se publica en JSON
+constexpr const bool TELEMETRY_BINARY_ENCODING = true;
+// versión de los tópicos versionados: v1 para JSON y v2 para el formato binario
+constexpr const int TELEMETRY_TOPIC_VERSION = TELEMETRY_BINARY_ENCODING ? 2 : 1;
+
+constexpr const int MOBILE_HOUSEKEEPING_INTERVAL_MS = 5000;
+constexpr const int MOBILE_EXECUTOR_POLL_MS = 20;
+constexpr const size_t MOBILE_EVENT_BATCH_SIZE = 8;
 
 constexpr const int PANIC_BTN_EVENTS_TO_CONFIRM = 3;
 
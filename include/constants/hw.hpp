@@ -16,6 +16,7 @@ namespace modem {
 constexpr const uart_port_t UART_PORT = UART_NUM_1;
 constexpr const int UART_BUFFER_SIZE = 1024;
 constexpr const int UART_BAUD_RATE = 115200;
+constexpr const int UART_MAX_BAUD_RATE = 921600;
 
 constexpr const int PIN_U1_TX = 1;
 constexpr const int PIN_U1_RX = 2;
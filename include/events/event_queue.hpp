@@ -1,11 +1,22 @@
 #pragma once
 
+#include <atomic>
 #include <memory>
 #include <ctime>
 
 #include <freertos/FreeRTOS.h>
 #include <freertos/queue.h>
 #include "definitions.hpp"
+#include "event_ring.hpp"
+
+// con 1, las colas de EventQueueSet usan EventRing (sin bloqueos, un solo
+// despertar por ráfaga) en lugar de colas de FreeRTOS. Los productores de
+// EventRing reintentan cada tick mientras la cola está llena y overwrite()
+// conserva el evento pendiente, por lo que las colas de FreeRTOS siguen
+// siendo la opción predeterminada
+#ifndef EVENT_QUEUE_USE_RING
+#define EVENT_QUEUE_USE_RING 0
+#endif
 
 namespace axomotor::events {
 
@@ -87,31 +98,93 @@ private:
     QueueHandle_t m_handle;
 };
 
-class DeviceEventQueue : public EventQueue<device_event_t>
+#if EVENT_QUEUE_USE_RING
+template <typename T>
+using EventQueueBackend = EventRing<T>;
+#else
+template <typename T>
+using EventQueueBackend = EventQueue<T>;
+#endif
+
+class DeviceEventQueue : public EventQueueBackend<device_event_t>
 {
 friend class EventQueueSet;
 
 public:
+#if EVENT_QUEUE_USE_RING
+    DeviceEventQueue(size_t length, const EventNotifier *notifier = nullptr);
+#else
     DeviceEventQueue(size_t length);
+#endif
     bool send_to_back(const event_code_t code, TickType_t ticks_to_wait = portMAX_DELAY) const;
     bool send_to_front(const event_code_t code, TickType_t ticks_to_wait = portMAX_DELAY) const;
 };
 
-using PositionEventQueue = EventQueue<position_event_t>;
-using PingEventQueue = EventQueue<ping_event_t>;
+using PositionEventQueue = EventQueueBackend<position_event_t>;
+using PingEventQueue = EventQueueBackend<ping_event_t>;
+
+/**
+ * @brief Evento de cualquiera de las colas de EventQueueSet.
+ */
+struct queued_event_t
+{
+    event_type_t type;
+    union
+    {
+        device_event_t device;
+        position_event_t position;
+        ping_event_t ping;
+    };
+};
 
 class EventQueueSet
 {
 public:
     EventQueueSet();
     
+    /**
+     * @brief Espera hasta que alguna cola tenga un evento y devuelve su tipo.
+     * Con EventRing, si hay varias, se elige en orden de prioridad
+     * (dispositivo, ping y posición).
+     */
     event_type_t wait_for_event(TickType_t ticks_to_wait = portMAX_DELAY) const;
-    
+
+    /**
+     * @brief Espera hasta que haya al menos un evento y después toma todos
+     * los que estén listos en las colas (hasta max_items), en orden de
+     * prioridad: dispositivo, ping y posición. Los de una misma cola
+     * conservan su orden.
+     * @return Cantidad de eventos obtenidos (0 si se agotó la espera).
+     */
+    size_t drain(
+        queued_event_t *events,
+        size_t max_items,
+        TickType_t ticks_to_wait = portMAX_DELAY) const;
+
+    /**
+     * @brief Cantidad de veces que el consumidor se despertó en
+     * wait_for_event(), para comparar ambas implementaciones.
+     */
+    uint32_t get_wakeup_count() const;
+
+private:
+#if EVENT_QUEUE_USE_RING
+    // se construye antes que las colas que lo comparten
+    const EventNotifier m_notifier;
+#else
+    QueueSetHandle_t m_handle;
+    mutable std::atomic<uint32_t> m_wakeup_count;
+#endif
+
+public:
     const DeviceEventQueue device;
     const PositionEventQueue position;
     const PingEventQueue ping;
+
+#if EVENT_QUEUE_USE_RING
 private:
-    QueueSetHandle_t m_handle;
+    event_type_t get_ready_event() const;
+#endif
 };
 
 
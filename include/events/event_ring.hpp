@@ -0,0 +1,348 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <type_traits>
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+namespace axomotor::events {
+
+// índice de la notificación de tarea con la que se despierta al consumidor
+// (el 0 lo usan algunos componentes de ESP-IDF)
+constexpr static const UBaseType_t EVENT_NOTIFY_INDEX = 1;
+
+static_assert(
+    configTASK_NOTIFICATION_ARRAY_ENTRIES > EVENT_NOTIFY_INDEX,
+    "CONFIG_FREERTOS_TASK_NOTIFICATION_ARRAY_ENTRIES must be at least 2"
+);
+
+/**
+ * @brief Despierta a la tarea que consume una o varias colas EventRing. Los
+ * productores solo envían la notificación si el consumidor está esperando,
+ * por lo que una ráfaga de eventos produce un solo despertar.
+ */
+class EventNotifier
+{
+public:
+    EventNotifier();
+    EventNotifier(const EventNotifier &) = delete;
+
+    /**
+     * @brief Despierta al consumidor si está esperando. Se llama después de
+     * publicar un elemento.
+     */
+    void notify() const;
+
+    /**
+     * @brief Bloquea al consumidor hasta recibir una notificación. Debe
+     * llamarse después de prepare_wait() y de verificar que no hay
+     * elementos pendientes.
+     * @return false si se agotó el tiempo de espera.
+     */
+    bool wait(TickType_t ticks_to_wait) const;
+
+    /**
+     * @brief Indica que el consumidor está por esperar; los elementos
+     * publicados a partir de aquí lo despertarán.
+     */
+    void prepare_wait() const;
+
+    /**
+     * @brief Cancela la espera cuando, después de prepare_wait(), se
+     * encontraron elementos pendientes.
+     */
+    void cancel_wait() const;
+
+    /**
+     * @brief Cantidad de veces que el consumidor se despertó por una
+     * notificación.
+     */
+    uint32_t get_wakeup_count() const { return m_wakeup_count; }
+
+    EventNotifier &operator=(const EventNotifier &) = delete;
+
+private:
+    mutable std::atomic<TaskHandle_t> m_task;
+    mutable std::atomic<bool> m_is_waiting;
+    mutable std::atomic<uint32_t> m_wakeup_count;
+};
+
+/**
+ * @brief Búfer circular acotado sin bloqueos para varios productores y un
+ * consumidor. Cada celda tiene un número de secuencia que indica si está
+ * libre o lista para leerse, de modo que los productores solo compiten por
+ * la posición de escritura (una operación CAS).
+ *
+ * El arreglo se redondea a una potencia de 2 (al menos 2 celdas, ya que con
+ * una sola no se distingue una celda llena de una libre), pero no se admiten
+ * más elementos que los solicitados.
+ */
+template <typename T>
+class RingBuffer
+{
+    static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable");
+
+public:
+    explicit RingBuffer(size_t size) :
+        m_size{size},
+        m_capacity{round_up(size)},
+        m_mask{m_capacity - 1},
+        m_cells{new cell_t[m_capacity]},
+        m_write_pos{0},
+        m_read_pos{0}
+    {
+        for (size_t i = 0; i < m_capacity; i++) {
+            m_cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    RingBuffer(const RingBuffer &) = delete;
+
+    bool push(const T &item)
+    {
+        // varios productores pueden pasar esta verificación a la vez, pero
+        // el arreglo los detiene al llenarse
+        if (count() >= m_size) return false;
+
+        size_t pos = m_write_pos.load(std::memory_order_relaxed);
+        cell_t *cell;
+
+        while (true) {
+            cell = &m_cells[pos & m_mask];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = (intptr_t)sequence - (intptr_t)pos;
+
+            if (diff == 0) {
+                // reserva la celda
+                if (m_write_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                // la celda aún no se lee: el búfer está lleno
+                return false;
+            } else {
+                // otro productor tomó la posición
+                pos = m_write_pos.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->item = item;
+        // publica el elemento para el consumidor
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(T &item)
+    {
+        if (!peek(item)) return false;
+
+        size_t pos = m_read_pos.load(std::memory_order_relaxed);
+        // libera la celda para la siguiente vuelta de los productores
+        m_cells[pos & m_mask].sequence.store(pos + m_capacity, std::memory_order_release);
+        m_read_pos.store(pos + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    bool peek(T &item) const
+    {
+        size_t pos = m_read_pos.load(std::memory_order_relaxed);
+        const cell_t &cell = m_cells[pos & m_mask];
+
+        // la celda está vacía o un productor aún la está escribiendo
+        if (!is_ready()) return false;
+
+        item = cell.item;
+        return true;
+    }
+
+    /**
+     * @brief Indica si el siguiente elemento ya puede leerse (count() incluye
+     * los que un productor aún está escribiendo).
+     */
+    bool is_ready() const
+    {
+        size_t pos = m_read_pos.load(std::memory_order_relaxed);
+        return m_cells[pos & m_mask].sequence.load(std::memory_order_acquire) == pos + 1;
+    }
+
+    size_t count() const
+    {
+        size_t write_pos = m_write_pos.load(std::memory_order_relaxed);
+        size_t read_pos = m_read_pos.load(std::memory_order_relaxed);
+        return write_pos - read_pos;
+    }
+
+    size_t size() const { return m_size; }
+
+    RingBuffer &operator=(const RingBuffer &) = delete;
+
+private:
+    struct cell_t
+    {
+        std::atomic<size_t> sequence;
+        T item;
+    };
+
+    const size_t m_size;
+    const size_t m_capacity;
+    const size_t m_mask;
+    std::unique_ptr<cell_t[]> m_cells;
+    std::atomic<size_t> m_write_pos;
+    std::atomic<size_t> m_read_pos;
+
+    static size_t round_up(size_t size)
+    {
+        size_t capacity = 2;
+        while (capacity < size) capacity <<= 1;
+        return capacity;
+    }
+};
+
+/**
+ * @brief Cola de eventos sin bloqueos con la misma interfaz que EventQueue,
+ * pensada para productores de alta frecuencia (sensores, GNSS). Enviar y
+ * recibir no entra al kernel ni deshabilita interrupciones; solo se notifica
+ * a la tarea consumidora cuando está esperando.
+ *
+ * Admite varios productores pero un solo consumidor (receive(), peek() y
+ * reset() deben llamarse desde la misma tarea). Los elementos enviados con
+ * send_to_front() van a un carril aparte que se lee primero.
+ */
+template <typename T>
+class EventRing
+{
+friend class EventQueueSet;
+
+public:
+    constexpr static const size_t FRONT_LANE_SIZE = 4;
+
+    /**
+     * @param notifier Notificador compartido con otras colas (p. ej. el de
+     * EventQueueSet); si es nulo, la cola usa el suyo.
+     */
+    explicit EventRing(size_t size, const EventNotifier *notifier = nullptr) :
+        m_size{size},
+        m_back{size},
+        m_front{std::min(size, FRONT_LANE_SIZE)},
+        m_own_notifier{notifier == nullptr ? new EventNotifier() : nullptr},
+        m_notifier{notifier != nullptr ? notifier : m_own_notifier.get()}
+    { }
+
+    EventRing(const EventRing &) = delete;
+    EventRing(EventRing &&) = delete;
+
+    bool send_to_back(const T &item, TickType_t ticks_to_wait = portMAX_DELAY) const
+    {
+        return send(m_back, item, ticks_to_wait);
+    }
+
+    bool send_to_front(const T &item, TickType_t ticks_to_wait = portMAX_DELAY) const
+    {
+        return send(m_front, item, ticks_to_wait);
+    }
+
+    bool receive(T &item, TickType_t ticks_to_wait = portMAX_DELAY) const
+    {
+        return wait_for_item([&] { return m_front.pop(item) || m_back.pop(item); }, ticks_to_wait);
+    }
+
+    size_t count_items_waiting() const
+    {
+        return m_front.count() + m_back.count();
+    }
+
+    size_t count_free_spaces() const
+    {
+        size_t count = m_back.count();
+        return count < m_size ? m_size - count : 0;
+    }
+
+    size_t size() const
+    {
+        return m_size;
+    }
+
+    /**
+     * @brief Descarta los elementos pendientes (solo desde el consumidor).
+     */
+    void reset() const
+    {
+        T item;
+        while (m_front.pop(item) || m_back.pop(item)) { }
+    }
+
+    bool peek(T &item, TickType_t ticks_to_wait = portMAX_DELAY) const
+    {
+        return wait_for_item([&] { return m_front.peek(item) || m_back.peek(item); }, ticks_to_wait);
+    }
+
+    /**
+     * @brief Envía el elemento al frente sin esperar. A diferencia de
+     * xQueueOverwrite(), si la cola está llena se conserva el elemento
+     * pendiente, ya que solo el consumidor puede retirar elementos.
+     */
+    bool overwrite(const T &item) const
+    {
+        return send_to_front(item, 0);
+    }
+
+    EventRing &operator=(const EventRing &) = delete;
+    EventRing &operator=(EventRing &&) = delete;
+
+private:
+    const size_t m_size;
+    mutable RingBuffer<T> m_back;
+    mutable RingBuffer<T> m_front;
+    std::unique_ptr<EventNotifier> m_own_notifier;
+    const EventNotifier *m_notifier;
+
+    bool has_items() const
+    {
+        return m_front.is_ready() || m_back.is_ready();
+    }
+
+    bool send(RingBuffer<T> &lane, const T &item, TickType_t ticks_to_wait) const
+    {
+        const TickType_t started_at = xTaskGetTickCount();
+
+        while (!lane.push(item)) {
+            // sin un objeto del kernel no hay forma de esperar a que se libere
+            // espacio, por lo que se reintenta cada tick
+            if (xTaskGetTickCount() - started_at >= ticks_to_wait) return false;
+            vTaskDelay(1);
+        }
+
+        m_notifier->notify();
+        return true;
+    }
+
+    template <typename Fn>
+    bool wait_for_item(Fn &&try_take, TickType_t ticks_to_wait) const
+    {
+        const TickType_t started_at = xTaskGetTickCount();
+
+        while (true) {
+            if (try_take()) return true;
+
+            TickType_t elapsed = xTaskGetTickCount() - started_at;
+            if (elapsed >= ticks_to_wait) return false;
+
+            // verifica de nuevo después de anunciar la espera para no perder
+            // una notificación
+            m_notifier->prepare_wait();
+            if (try_take()) {
+                m_notifier->cancel_wait();
+                return true;
+            }
+
+            if (!m_notifier->wait(ticks_to_wait - elapsed)) {
+                return try_take();
+            }
+        }
+    }
+};
+
+} // namespace axomotor::events
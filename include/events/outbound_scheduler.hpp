@@ -0,0 +1,104 @@
+#pragma once
+
+#include <array>
+#include <memory>
+
+#include <freertos/FreeRTOS.h>
+#include "event_queue.hpp"
+
+namespace axomotor::events {
+
+/**
+ * @brief Clases del tráfico de subida, de mayor a menor prioridad.
+ */
+enum class traffic_class_t : uint8_t
+{
+    SAFETY,     // botón de pánico e impactos
+    DEVICE,     // demás eventos del dispositivo
+    PING,       // respuestas al ping del servidor
+    POSITION,   // posiciones del viaje
+    BULK,       // datos masivos (reservada)
+    MAX,
+};
+
+struct traffic_class_config_t
+{
+    uint8_t weight;             // parte de los envíos frente a las demás clases (SAFETY no la usa)
+    uint16_t rate_per_minute;   // envíos por minuto sostenidos (0: sin límite)
+    uint8_t burst;              // envíos seguidos sin esperar a que se recarguen
+    uint8_t capacity;           // elementos que pueden esperar su turno
+    bool drop_oldest;           // si está llena descarta el más antiguo en lugar del nuevo
+};
+
+struct traffic_class_stats_t
+{
+    uint32_t sent;
+    uint32_t dropped;
+};
+
+/**
+ * @brief Ordena los eventos que se publican al servidor. Los eventos de
+ * seguridad tienen prioridad estricta y no tienen límite de envíos; el resto
+ * de las clases se reparten los envíos según su peso (round robin
+ * ponderado) y tienen además un límite de envíos por minuto (token bucket),
+ * de modo que una ráfaga de posiciones o de giros bruscos no retrasa al
+ * botón de pánico ni acapara al modem.
+ *
+ * No es seguro entre tareas: solo debe usarse desde la tarea que publica.
+ */
+class OutboundScheduler
+{
+public:
+    OutboundScheduler();
+    OutboundScheduler(const OutboundScheduler &) = delete;
+
+    /**
+     * @brief Agrega un evento a la cola de su clase.
+     * @return false si la clase estaba llena y se descartó el evento nuevo.
+     * Los eventos de seguridad nunca se rechazan: si la clase está llena se
+     * descarta el más antiguo.
+     */
+    bool enqueue(const queued_event_t &event);
+
+    /**
+     * @brief Obtiene el siguiente evento que puede enviarse.
+     * @return false si no hay eventos o todas las clases con eventos
+     * alcanzaron su límite.
+     */
+    bool dequeue(queued_event_t &event);
+
+    /**
+     * @brief Ticks que faltan para que algún evento pueda enviarse (0 si ya
+     * hay uno listo, portMAX_DELAY si no hay eventos).
+     */
+    TickType_t get_ticks_to_ready();
+
+    size_t count_pending() const;
+    traffic_class_stats_t get_stats(traffic_class_t tclass) const;
+
+    static traffic_class_t classify(const queued_event_t &event);
+    static bool is_safety_event(event_code_t code);
+
+    OutboundScheduler &operator=(const OutboundScheduler &) = delete;
+
+private:
+    struct class_state_t
+    {
+        traffic_class_config_t config;
+        std::unique_ptr<queued_event_t[]> items;
+        size_t head;
+        size_t count;
+        // en fracciones de 1 / TOKEN_COST para recargar sin redondeos
+        uint32_t tokens;
+        TickType_t refilled_at;
+        int32_t current_weight;
+        traffic_class_stats_t stats;
+    };
+
+    std::array<class_state_t, (size_t)traffic_class_t::MAX> m_classes;
+
+    bool is_ready(class_state_t &state, TickType_t now);
+    void pop(class_state_t &state, queued_event_t &event);
+};
+
+} // namespace axomotor::events
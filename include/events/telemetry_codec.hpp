@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+
+#include <esp_err.h>
+#include "definitions.hpp"
+
+/*
+ * Formato binario de la telemetría (little endian, sin relleno):
+ *
+ * Encabezado (1 byte): versión del formato en los 4 bits altos y tipo de
+ * mensaje en los 4 bajos.
+ *
+ * POSITIONS:    encabezado, cantidad (u8) y por cada posición:
+ *               timestamp (u32, s), latitud y longitud (i32, 1e-6 grados),
+ *               velocidad (u16, 0.01 km/h) y rumbo (u16, 0.01 grados).
+ * DEVICE_EVENT: encabezado, código (u8, event_code_t) y timestamp (u32, s).
+ * PONG:         encabezado y timestamp (u32).
+ */
+
+namespace axomotor::events::telemetry {
+
+constexpr static const uint8_t TELEMETRY_FORMAT_VERSION = 1;
+
+enum class message_type_t : uint8_t
+{
+    NONE = 0,
+    POSITIONS = 1,
+    DEVICE_EVENT = 2,
+    PONG = 3,
+};
+
+constexpr static const size_t HEADER_SIZE = 1;
+constexpr static const size_t POSITION_RECORD_SIZE = 16;
+constexpr static const size_t MAX_POSITIONS_PER_MESSAGE = UINT8_MAX;
+constexpr static const size_t DEVICE_EVENT_MESSAGE_SIZE = HEADER_SIZE + 5;
+constexpr static const size_t PONG_MESSAGE_SIZE = HEADER_SIZE + 4;
+
+constexpr static size_t get_positions_message_size(size_t count)
+{
+    return HEADER_SIZE + 1 + count * POSITION_RECORD_SIZE;
+}
+
+/**
+ * @brief Codifica un lote de posiciones.
+ * @param length Bytes escritos en el búfer.
+ * @return ESP_ERR_INVALID_SIZE si el búfer no alcanza.
+ */
+esp_err_t encode_positions(
+    std::span<const position_event_t> positions,
+    std::span<uint8_t> buffer,
+    size_t &length);
+esp_err_t encode_device_event(const device_event_t &event, std::span<uint8_t> buffer, size_t &length);
+esp_err_t encode_pong(const ping_event_t &event, std::span<uint8_t> buffer, size_t &length);
+
+/**
+ * @brief Tipo de un mensaje codificado (NONE si está vacío o es de otra
+ * versión del formato).
+ */
+message_type_t get_message_type(std::span<const uint8_t> message);
+
+/*
+ * Decodificadores de referencia, para verificar los mensajes y como guía del
+ * servidor. Las coordenadas, la velocidad y el rumbo se recuperan con la
+ * resolución del formato.
+ */
+
+esp_err_t decode_positions(
+    std::span<const uint8_t> message,
+    std::span<position_event_t> positions,
+    size_t &count);
+esp_err_t decode_device_event(std::span<const uint8_t> message, device_event_t &event);
+esp_err_t decode_pong(std::span<const uint8_t> message, ping_event_t &event);
+
+} // namespace axomotor::events::telemetry
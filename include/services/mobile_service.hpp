@@ -1,14 +1,19 @@
 #pragma once
 
 #include <service_base.hpp>
+#include <executor.hpp>
 #include <sim7000_modem.hpp>
 #include <sim7000_gnss_service.hpp>
 #include <sim7000_mqtt_service.hpp>
 
+#include <array>
+#include <atomic>
 #include <memory>
 #include <mutex>
 
 #include "events/event_queue.hpp"
+#include "events/outbound_scheduler.hpp"
+#include "constants/general.hpp"
 
 namespace axomotor::services {
 
@@ -18,19 +23,48 @@ public:
     MobileService();
 
 private:
+    struct position_batch_t
+    {
+        std::array<events::position_event_t, constants::general::POSITION_BATCH_SIZE> items;
+        size_t count;
+        char trip_id[constants::general::TRIP_ID_LENGTH + 1];
+    };
+
     std::shared_ptr<lte_modem::SIM7000_Modem> m_modem;
     std::shared_ptr<lte_modem::SIM7000_GNSS> m_gnss;
     std::shared_ptr<lte_modem::SIM7000_MQTT> m_mqtt;
 
+    threading::Executor m_executor;
+    std::array<events::queued_event_t, constants::general::MOBILE_EVENT_BATCH_SIZE> m_event_batch;
+    TickType_t m_next_housekeeping;
+    events::OutboundScheduler m_scheduler;
+    position_batch_t m_position_batch;
+    TickType_t m_position_batch_started_at;
+
     bool m_gps_enabled;
     bool m_gps_signal_lost;
+    bool m_status_refresh_pending;
+    bool m_mqtt_resubscribe;
+    // lo activa el manejador de eventos del modem (tarea del event loop)
+    std::atomic<bool> m_modem_recovered;
 
     esp_err_t setup() override;
     void loop() override;
 
-    esp_err_t publish_position(events::position_event_t &event);
-    esp_err_t publish_pong(events::ping_event_t &event);
-    esp_err_t publish_event(events::device_event_t &event);
+    esp_err_t configure_mqtt();
+    void check_mqtt_connection();
+    void restore_after_recovery();
+    void run_housekeeping();
+    void dispatch_event(const events::queued_event_t &event);
+    void add_position(const events::position_event_t &event);
+    void flush_positions();
+
+    threading::AsyncTask connect_mqtt();
+    threading::AsyncTask set_nav_urc(uint8_t interval);
+    threading::AsyncTask refresh_network_status();
+    threading::AsyncTask publish_positions(position_batch_t batch);
+    threading::AsyncTask publish_pong(events::ping_event_t event);
+    threading::AsyncTask publish_event(events::device_event_t event);
 
     static void on_event(void *args, esp_event_base_t base, int32_t id, void *data);
 };
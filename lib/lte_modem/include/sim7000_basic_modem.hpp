@@ -1,21 +1,52 @@
 #pragma once
 
 #include "sim7000_types.hpp"
+#include "sim7000_line_framer.hpp"
+#include "sim7000_cmd_pool.hpp"
+#include "sim7000_cmd_stats.hpp"
+#include "sim7000_response_sink.hpp"
+#include "sim7000_cancel_token.hpp"
 
+#include <atomic>
 #include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
 #include <esp_err.h>
+#include <freertos/semphr.h>
 #include <event_group.hpp>
+#include <executor.hpp>
 
 namespace axomotor::lte_modem
 {
+    // cantidad máxima de comandos en espera al mismo tiempo (un bit de
+    // finalización por comando)
+    static const int MAX_PENDING_COMMANDS = 16;
+    // cantidad de espacios de comando reservados para los servicios
+    static const int DEFAULT_CMD_POOL_SIZE = 4;
+    static const int DEFAULT_CMD_SLOT_RESPONSE_SIZE = 128;
+    // tiempo máximo de respuesta de los comandos de consulta ("AT+XXX?")
+    static const uint32_t QUERY_CMD_TIMEOUT_MS = 1500;
+    // intervalo con el que las corrutinas reintentan tomar un lugar en la
+    // cola o en la reserva de comandos
+    static const uint32_t ASYNC_RETRY_INTERVAL_MS = 10;
+    // un comando urgente solo interrumpe al comando en curso si a éste le
+    // queda más de este tiempo de espera
+    static const uint32_t CMD_PREEMPT_THRESHOLD_MS = 500;
+    // tiempo máximo para descartar la respuesta de un comando cancelado antes
+    // de enviar el siguiente
+    static const uint32_t CMD_DRAIN_TIMEOUT_MS = 2000;
+
     class SIM7000_BasicModem
     {
     public:
-        SIM7000_BasicModem(size_t buffer_size);        
-        
+        SIM7000_BasicModem(size_t buffer_size);
+        ~SIM7000_BasicModem();
+
         esp_err_t execute_cmd(
             internal::at_cmd_t command,
-            std::shared_ptr<internal::sim7000_cmd_result_info_t> result_info,
+            internal::sim7000_cmd_result_info_t &result_info,
             TickType_t ticks_to_wait = 0,
             bool ignore_response = false,
             bool is_partial = false,
@@ -24,31 +55,190 @@ namespace axomotor::lte_modem
         esp_err_t execute_cmd(
             internal::at_cmd_t command,
             const std::span<const char> &payload,
-            std::shared_ptr<internal::sim7000_cmd_result_info_t> result_info,
+            internal::sim7000_cmd_result_info_t &result_info,
             TickType_t ticks_to_wait = 0,
             bool ignore_response = false,
             bool is_partial = false,
             bool is_raw = false);
-    
+
         esp_err_t execute_cmd(
+            internal::at_cmd_t command,
+            SIM7000_CmdSlot &slot,
+            TickType_t ticks_to_wait = 0);
+
+        esp_err_t execute_cmd(
+            internal::sim7000_cmd_context_t &context,
+            TickType_t ticks_to_wait = 0
+        );
+
+        /**
+         * @brief Agrega un comando a la cola de envío sin esperar su
+         * respuesta. El contexto debe permanecer válido hasta que se llame a
+         * wait_for_cmd().
+         *
+         * Si ticks_to_wait es 0, el tiempo de espera se calcula a partir de
+         * la latencia observada del comando, sin exceder su tiempo máximo de
+         * respuesta.
+         */
+        esp_err_t submit_cmd(
             internal::sim7000_cmd_context_t &context,
             TickType_t ticks_to_wait = 0
         );
 
+        /**
+         * @brief Espera a que finalice un comando enviado con submit_cmd().
+         */
+        esp_err_t wait_for_cmd(internal::sim7000_cmd_context_t &context);
+
+        /**
+         * @brief Verifica sin bloquear si finalizó un comando enviado con
+         * submit_cmd() (o si se agotó su tiempo de espera).
+         * @return ESP_ERR_NOT_FINISHED si aún no termina; de lo contrario el
+         * resultado del comando, como wait_for_cmd().
+         */
+        esp_err_t poll_cmd(internal::sim7000_cmd_context_t &context);
+
+        /**
+         * @brief Cancela un comando enviado con submit_cmd(). Si aún está en
+         * la cola se descarta; si está en curso, el modem deja de esperarlo
+         * y descarta su respuesta antes de enviar el siguiente comando.
+         *
+         * El solicitante debe llamar a wait_for_cmd() (o poll_cmd()), que
+         * devuelve ESP_ERR_TIMEOUT.
+         * @return ESP_ERR_INVALID_STATE si el comando ya había finalizado.
+         */
+        esp_err_t cancel_cmd(internal::sim7000_cmd_context_t &context);
+
+        /**
+         * @brief Versión asíncrona de execute_cmd() para corrutinas que se
+         * ejecutan en un threading::Executor: la corrutina se suspende hasta
+         * que llega el resultado en lugar de bloquear la tarea.
+         *
+         * El contexto debe permanecer válido hasta que termine la espera.
+         */
+        threading::Async<esp_err_t> exec(
+            internal::sim7000_cmd_context_t &context,
+            TickType_t ticks_to_wait = 0);
+
+        threading::Async<esp_err_t> exec(
+            internal::at_cmd_t command,
+            SIM7000_CmdSlot &slot,
+            TickType_t ticks_to_wait = 0);
+
+        /**
+         * @brief Toma un espacio de la reserva de comandos sin bloquear la
+         * tarea: si no hay uno libre, suspende la corrutina y reintenta.
+         */
+        threading::Async<SIM7000_CmdSlot> acquire_cmd_slot_async();
+
+        /**
+         * @brief Toma un espacio de la reserva de comandos para formatear los
+         * parámetros y recibir el resultado sin reservar memoria.
+         */
+        SIM7000_CmdSlot acquire_cmd_slot(TickType_t ticks_to_wait = portMAX_DELAY);
+
+        /**
+         * @brief Obtiene las estadísticas de latencia y errores por comando.
+         */
+        SIM7000_CmdStats &get_cmd_stats() { return m_cmd_stats; }
+
+        /**
+         * @brief Indica si el modem está en modo de datos (después de que un
+         * comando de marcado respondió CONNECT). En este modo no se aceptan
+         * comandos y los datos recibidos se entregan a on_data_received().
+         */
+        bool is_data_mode() const { return m_is_data_mode; }
+
+        /**
+         * @brief Cantidad de comandos seguidos que no recibieron respuesta;
+         * vuelve a 0 en cuanto el modem responde a un comando.
+         */
+        uint32_t get_consecutive_timeouts() const { return m_consecutive_timeouts; }
+
     protected:
         void feed_buffer(const char *buffer, size_t length);
-        virtual void on_urc_message(std::string &) = 0;
+        std::span<char> get_parser_window();
+        void commit_parser_window(size_t length);
+
+        /**
+         * @brief Regresa al modo de comandos una vez que el modem terminó la
+         * llamada de datos.
+         */
+        void leave_data_mode();
+        void reset_consecutive_timeouts() { m_consecutive_timeouts = 0; }
+
+        virtual void on_urc_message(
+            std::string_view line,
+            const internal::urc_def_t &def) = 0;
         virtual int on_cmd_write(const char *, size_t) = 0;
+        virtual void on_data_received(const char *, size_t) { }
+        /**
+         * @brief Se llama desde la tarea del solicitante cada vez que un
+         * comando se queda sin respuesta; no debe bloquearse.
+         */
+        virtual void on_cmd_timeout(uint32_t consecutive_timeouts) { }
         bool m_is_running;
 
     private:
+        friend class SIM7000_CancelToken;
+        struct cmd_awaiter_t;
+
         internal::sim7000_cmd_context_t *m_cmd_context;
-        std::string m_parser_buffer;
-        threading::EventGroup m_parser_event_group;
+        internal::sim7000_cmd_context_t *m_queue_head;
+        internal::sim7000_cmd_context_t *m_queue_tail;
+        uint32_t m_free_bits;
+        // se está descartando la respuesta de un comando cancelado o que
+        // agotó su tiempo de espera
+        bool m_is_draining;
+        bool m_drain_expects_prompt;
+        TickType_t m_drain_started_at;
+        // códigos de resultado que aún debe enviar un comando cancelado que no
+        // terminó dentro del tiempo de descarte
+        uint32_t m_stale_results;
+        std::atomic<bool> m_is_data_mode;
+        std::atomic<uint32_t> m_consecutive_timeouts;
+        std::mutex m_queue_mutex;
+        SemaphoreHandle_t m_slot_semaphore;
+        SIM7000_LineFramer m_framer;
+        char m_cmd_line[internal::MAX_CMD_LINE_LENGTH];
+        threading::EventGroup m_completion_event_group;
+        SIM7000_CmdPool m_cmd_pool;
+        SIM7000_CmdStats m_cmd_stats;
 
         void try_parse();
-        static bool is_urc(const std::string &line);
-        static int read_error_code(const std::string &line);
+        void parse_line(std::string_view line);
+        TickType_t get_cmd_timeout(const internal::at_cmd_def_t &cmd_def, bool is_query);
+        void start_next_cmd();
+        void finish_cmd();
+        void complete_cmd(internal::sim7000_cmd_context_t &context);
+        bool cancel_cmd_locked(internal::sim7000_cmd_context_t &context);
+        void cancel_by_token(SIM7000_CancelToken &token);
+        void cancel_running_cmd();
+        void abandon_running_cmd(internal::at_cmd_result_t result);
+        void preempt_running_cmd();
+        void drain_line(std::string_view line);
+        void check_drain_timeout();
+        void end_drain();
+        void write_response(std::string_view chunk);
+        void forward_data();
+        void release_slot(internal::sim7000_cmd_context_t &context);
+        esp_err_t enqueue_cmd(
+            internal::sim7000_cmd_context_t &context,
+            TickType_t ticks_to_wait,
+            TickType_t queue_ticks);
+        bool check_cmd_timeout(internal::sim7000_cmd_context_t &context);
+        bool set_cmd_waiter(
+            internal::sim7000_cmd_context_t &context,
+            threading::Waiter *waiter);
+        TickType_t get_cmd_remaining_ticks(const internal::sim7000_cmd_context_t &context);
+        static esp_err_t get_cmd_err(const internal::sim7000_cmd_result_info_t &info);
+        static bool is_urc(std::string_view line);
+        static bool is_final_result(std::string_view line);
+        static bool is_dial_cmd(const internal::sim7000_cmd_context_t &context);
+        static bool is_query_response(
+            const internal::sim7000_cmd_context_t &context,
+            const internal::urc_def_t &def);
+        static int read_error_code(std::string_view line);
     };
 
 } // namespace axomotor::lte_modem
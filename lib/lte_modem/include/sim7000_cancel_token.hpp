@@ -0,0 +1,44 @@
+#pragma once
+
+#include <atomic>
+
+namespace axomotor::lte_modem
+{
+    class SIM7000_BasicModem;
+
+    namespace internal {
+        struct sim7000_cmd_context_t;
+    }
+
+    /**
+     * @brief Permite cancelar desde otra tarea los comandos que lo tengan
+     * asignado en su contexto (sim7000_cmd_context_t::cancel_token).
+     *
+     * Un comando en la cola se descarta; uno en curso deja de esperarse y su
+     * respuesta se descarta al llegar. En ambos casos el solicitante recibe
+     * ESP_ERR_TIMEOUT. Mientras el token esté cancelado, los comandos que lo
+     * usen fallan de inmediato, hasta que se llame a reset().
+     */
+    class SIM7000_CancelToken
+    {
+    public:
+        SIM7000_CancelToken();
+        SIM7000_CancelToken(const SIM7000_CancelToken &) = delete;
+
+        void cancel();
+        void reset() { m_is_cancelled = false; }
+        bool is_cancelled() const { return m_is_cancelled; }
+
+        SIM7000_CancelToken &operator=(const SIM7000_CancelToken &) = delete;
+
+    private:
+        friend class SIM7000_BasicModem;
+
+        std::atomic<bool> m_is_cancelled;
+        // modem y comando al que está asignado (los modifica el modem con su
+        // cola bloqueada)
+        std::atomic<SIM7000_BasicModem *> m_modem;
+        internal::sim7000_cmd_context_t *m_context;
+    };
+
+} // namespace axomotor::lte_modem
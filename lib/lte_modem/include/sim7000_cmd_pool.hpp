@@ -0,0 +1,87 @@
+#pragma once
+
+#include "sim7000_types.hpp"
+
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <esp_err.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+namespace axomotor::lte_modem
+{
+    class SIM7000_CmdPool;
+
+    /**
+     * @brief Espacio prestado de la reserva de comandos. Contiene el buffer de
+     * parámetros y el resultado del comando, y se devuelve a la reserva al
+     * destruirse.
+     */
+    class SIM7000_CmdSlot
+    {
+    public:
+        SIM7000_CmdSlot();
+        SIM7000_CmdSlot(SIM7000_CmdPool *pool, internal::sim7000_cmd_slot_t *slot);
+        SIM7000_CmdSlot(const SIM7000_CmdSlot &) = delete;
+        SIM7000_CmdSlot(SIM7000_CmdSlot &&other);
+        ~SIM7000_CmdSlot();
+
+        /**
+         * @brief Escribe los parámetros del comando con formato printf.
+         * @return ESP_ERR_INVALID_SIZE si no caben en el buffer.
+         */
+        esp_err_t format_params(const char *format, ...) 
+            __attribute__((format(printf, 2, 3)));
+
+        std::span<const char> get_params() const;
+        internal::sim7000_cmd_result_info_t &get_result_info();
+        std::string &get_response();
+
+        explicit operator bool() const { return m_slot != nullptr; }
+
+        SIM7000_CmdSlot &operator=(const SIM7000_CmdSlot &) = delete;
+        SIM7000_CmdSlot &operator=(SIM7000_CmdSlot &&other);
+
+    private:
+        SIM7000_CmdPool *m_pool;
+        internal::sim7000_cmd_slot_t *m_slot;
+
+        void release();
+    };
+
+    /**
+     * @brief Reserva de espacios de comando asignados al construirse, de modo
+     * que ejecutar un comando no requiere memoria dinámica.
+     */
+    class SIM7000_CmdPool
+    {
+    friend class SIM7000_CmdSlot;
+
+    public:
+        SIM7000_CmdPool(size_t slot_count, size_t response_size);
+        SIM7000_CmdPool(const SIM7000_CmdPool &) = delete;
+        SIM7000_CmdPool(SIM7000_CmdPool &&) = delete;
+        ~SIM7000_CmdPool();
+
+        /**
+         * @brief Toma un espacio libre de la reserva.
+         * @return Espacio vacío si se agotó el tiempo de espera.
+         */
+        SIM7000_CmdSlot acquire(TickType_t ticks_to_wait = portMAX_DELAY);
+
+        SIM7000_CmdPool &operator=(const SIM7000_CmdPool &) = delete;
+        SIM7000_CmdPool &operator=(SIM7000_CmdPool &&) = delete;
+
+    private:
+        const size_t m_slot_count;
+        std::unique_ptr<internal::sim7000_cmd_slot_t[]> m_slots;
+        uint32_t m_free_mask;
+        std::mutex m_mutex;
+        SemaphoreHandle_t m_semaphore;
+
+        void release(internal::sim7000_cmd_slot_t *slot);
+    };
+
+} // namespace axomotor::lte_modem
@@ -0,0 +1,120 @@
+#pragma once
+
+#include "sim7000_types.hpp"
+
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include <span>
+
+namespace axomotor::lte_modem
+{
+    // cantidad de intervalos de los histogramas de latencia; el intervalo 0
+    // corresponde a menos de 1 ms, el intervalo i a [2^(i-1), 2^i) ms y el
+    // último acumula todo lo que lo exceda (~16 s)
+    static const size_t CMD_HISTOGRAM_BUCKETS = 16;
+    // cantidad máxima de comandos distintos de los que se guardan estadísticas
+    static const size_t MAX_CMD_STATS_ENTRIES = 32;
+    // cantidad de muestras a partir de la cual los histogramas se reducen a la
+    // mitad, de modo que reflejan la latencia reciente
+    static const uint32_t CMD_HISTOGRAM_WINDOW = 512;
+
+    /* Tiempo de espera adaptativo */
+
+    // muestras necesarias antes de ajustar el tiempo de espera de un comando
+    static const uint32_t ADAPTIVE_TIMEOUT_MIN_SAMPLES = 16;
+    static const uint8_t ADAPTIVE_TIMEOUT_PERCENTILE = 99;
+    static const uint32_t ADAPTIVE_TIMEOUT_MARGIN = 2;
+    static const uint32_t ADAPTIVE_TIMEOUT_MIN_MS = 500;
+
+    struct cmd_histogram_t
+    {
+        std::array<uint16_t, CMD_HISTOGRAM_BUCKETS> buckets;
+
+        void add(uint32_t time_ms);
+        uint32_t total() const;
+
+        /**
+         * @brief Obtiene el límite superior (en ms) del intervalo en el que
+         * se encuentra el percentil indicado (0-100).
+         * @return 0 si el histograma está vacío.
+         */
+        uint32_t percentile(uint8_t percent) const;
+
+        static size_t get_bucket(uint32_t time_ms);
+        static uint32_t get_bucket_limit(size_t bucket);
+    };
+
+    struct cmd_stats_t
+    {
+        internal::at_cmd_t command;
+        uint32_t count;
+        uint16_t timeouts;
+        uint16_t errors;
+        uint16_t cancellations;
+        uint16_t consecutive_timeouts;
+        int16_t last_error_code;
+        uint32_t bytes_sent;
+        uint32_t bytes_received;
+        cmd_histogram_t first_byte;     // tiempo hasta el primer byte
+        cmd_histogram_t final_result;   // tiempo hasta el resultado final
+    };
+
+    /**
+     * @brief Estadísticas de ejecución de comandos AT agrupadas por comando.
+     *
+     * La memoria es fija; si se ejecutan más comandos distintos de los que
+     * caben, los nuevos no se registran.
+     */
+    class SIM7000_CmdStats
+    {
+    public:
+        SIM7000_CmdStats();
+        SIM7000_CmdStats(const SIM7000_CmdStats &) = delete;
+        SIM7000_CmdStats(SIM7000_CmdStats &&) = delete;
+
+        /**
+         * @brief Registra una ejecución finalizada del comando.
+         */
+        void record(const internal::sim7000_cmd_context_t &context, int64_t finished_at);
+
+        /**
+         * @brief Calcula el tiempo de espera de un comando a partir de la
+         * latencia observada (percentil 99 por un margen), sin exceder el
+         * límite indicado.
+         *
+         * @param limit_ms Tiempo máximo de respuesta del comando.
+         * @return El límite si aún no hay suficientes muestras o si la última
+         * ejecución agotó su tiempo de espera.
+         */
+        uint32_t get_adaptive_timeout(internal::at_cmd_t command, uint32_t limit_ms) const;
+
+        bool get(internal::at_cmd_t command, cmd_stats_t &stats) const;
+        bool get_entry(size_t index, cmd_stats_t &stats) const;
+        size_t size() const;
+        void reset();
+
+        /**
+         * @brief Escribe las estadísticas en formato JSON.
+         * @return Longitud escrita, o 0 si no caben en el buffer.
+         */
+        size_t serialize(std::span<char> buffer) const;
+
+        /**
+         * @brief Imprime un resumen de las estadísticas en el registro.
+         */
+        void dump() const;
+
+        SIM7000_CmdStats &operator=(const SIM7000_CmdStats &) = delete;
+        SIM7000_CmdStats &operator=(SIM7000_CmdStats &&) = delete;
+
+    private:
+        std::array<cmd_stats_t, MAX_CMD_STATS_ENTRIES> m_entries;
+        size_t m_count;
+        mutable std::mutex m_mutex;
+
+        cmd_stats_t *find(internal::at_cmd_t command);
+        const cmd_stats_t *find(internal::at_cmd_t command) const;
+    };
+
+} // namespace axomotor::lte_modem
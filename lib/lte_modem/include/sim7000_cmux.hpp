@@ -0,0 +1,140 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <freertos/FreeRTOS.h>
+
+#include <esp_err.h>
+#include <event_group.hpp>
+
+namespace axomotor::lte_modem
+{
+    // canales virtuales (DLCI) del multiplexor
+    static const uint8_t CMUX_CONTROL_CHANNEL = 0;
+    static const uint8_t CMUX_AT_CHANNEL = 1;
+    static const uint8_t CMUX_PPP_CHANNEL = 2;
+    static const uint8_t CMUX_NMEA_CHANNEL = 3;
+    static const uint8_t CMUX_MAX_CHANNELS = 4;
+    // tamaño máximo del campo de información de las tramas enviadas (N1
+    // predeterminado del SIM7000)
+    static const size_t CMUX_MAX_FRAME_SIZE = 127;
+    // tamaño máximo que se acepta al recibir, por si el modem usa un N1 mayor
+    static const size_t CMUX_MAX_RX_FRAME_SIZE = 256;
+    // tiempo de espera de la respuesta (UA) al abrir o cerrar un canal
+    static const uint32_t CMUX_CHANNEL_TIMEOUT_MS = 1000;
+
+    /**
+     * @brief Multiplexor 3GPP TS 27.010 (modo básico) sobre la UART del
+     * modem. Cada canal virtual (DLCI) se comporta como un puerto serie
+     * independiente: el de AT recibe comandos y URC mientras otro transporta
+     * la conexión PPP.
+     *
+     * Los datos recibidos de la UART se entregan con feed(); el multiplexor
+     * separa las tramas y entrega su contenido al receptor de cada canal. Las
+     * escrituras pueden hacerse desde cualquier tarea.
+     */
+    class SIM7000_CMux
+    {
+    public:
+        typedef int (*write_fn_t)(void *ctx, const char *data, size_t length);
+        typedef void (*receive_fn_t)(void *ctx, const char *data, size_t length);
+
+        SIM7000_CMux(write_fn_t write, void *write_ctx);
+        SIM7000_CMux(const SIM7000_CMux &) = delete;
+
+        /**
+         * @brief Asigna la función que recibe los datos de un canal.
+         */
+        void set_receiver(uint8_t dlci, receive_fn_t receive, void *ctx);
+
+        /**
+         * @brief Abre un canal (SABM) y espera la confirmación del modem (UA).
+         * El canal de control debe abrirse primero.
+         */
+        esp_err_t open(uint8_t dlci, TickType_t ticks_to_wait = pdMS_TO_TICKS(CMUX_CHANNEL_TIMEOUT_MS));
+
+        /**
+         * @brief Cierra los canales abiertos y termina el multiplexor (CLD);
+         * el modem regresa al modo de comandos en la UART.
+         */
+        esp_err_t close(TickType_t ticks_to_wait = pdMS_TO_TICKS(CMUX_CHANNEL_TIMEOUT_MS));
+
+        /**
+         * @brief Marca todos los canales como cerrados sin enviar nada, para
+         * cuando el modem se reinició y perdió el multiplexor.
+         */
+        void reset();
+
+        /**
+         * @brief Envía datos por un canal, divididos en tramas UIH.
+         * @return Cantidad de bytes enviados o -1 si el canal no está abierto.
+         */
+        int write(uint8_t dlci, const char *data, size_t length);
+
+        /**
+         * @brief Procesa datos recibidos de la UART.
+         */
+        void feed(const char *data, size_t length);
+
+        bool is_open(uint8_t dlci) const;
+
+        /**
+         * @brief Tramas descartadas por un FCS inválido o por exceder el
+         * tamaño máximo.
+         */
+        uint32_t get_dropped_frames() const { return m_dropped_frames; }
+
+        SIM7000_CMux &operator=(const SIM7000_CMux &) = delete;
+
+    private:
+        enum class rx_state_t
+        {
+            FLAG,
+            ADDRESS,
+            CONTROL,
+            LENGTH,
+            LENGTH_EXT,
+            INFO,
+            FCS,
+            END_FLAG
+        };
+
+        struct channel_t
+        {
+            receive_fn_t receive;
+            void *ctx;
+            bool is_open;
+        };
+
+        write_fn_t m_write;
+        void *m_write_ctx;
+        std::array<channel_t, CMUX_MAX_CHANNELS> m_channels;
+        threading::EventGroup m_event_group;
+        std::mutex m_write_mutex;
+        // trama que se está enviando (encabezado, información y cierre)
+        std::array<uint8_t, CMUX_MAX_FRAME_SIZE + 7> m_tx_frame;
+
+        /* Recepción */
+
+        rx_state_t m_rx_state;
+        uint8_t m_rx_address;
+        uint8_t m_rx_control;
+        uint8_t m_rx_header[4];
+        size_t m_rx_header_length;
+        size_t m_rx_length;
+        size_t m_rx_received;
+        uint8_t m_rx_fcs;
+        std::array<uint8_t, CMUX_MAX_RX_FRAME_SIZE> m_rx_info;
+        uint32_t m_dropped_frames;
+
+        esp_err_t send_command(uint8_t dlci, uint8_t control, TickType_t ticks_to_wait);
+        int send_frame(uint8_t dlci, uint8_t control, bool is_command, const uint8_t *info, size_t length);
+        void end_header();
+        bool check_fcs() const;
+        void process_frame();
+        void process_control_message();
+    };
+
+} // namespace axomotor::lte_modem
@@ -16,6 +16,12 @@ namespace axomotor::lte_modem
         esp_err_t disable_nav_urc();
         esp_err_t get_nav_urc_state(bool &state);
         esp_err_t get_nav_info(gnss_nav_info_t &info);
+
+        /**
+         * @brief Versión asíncrona de enable_nav_urc() / disable_nav_urc()
+         * para corrutinas; un intervalo de 0 desactiva el reporte.
+         */
+        threading::Async<esp_err_t> set_nav_urc_async(uint8_t interval);
     };
 
 } // namespace axomotor::lte_modem
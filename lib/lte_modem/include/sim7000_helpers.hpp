@@ -3,6 +3,7 @@
 #include <cstddef>
 #include <ctime>
 #include <string>
+#include <string_view>
 #include <array>
 #include <type_traits>
 #include <span>
@@ -112,7 +113,7 @@ namespace axomotor::lte_modem::helpers
     }
 
     template <typename T>
-    T to_number(const std::string &str, size_t pos = 0, size_t len = 0)
+    T to_number(std::string_view str, size_t pos = 0, size_t len = 0)
     {
         if (str.length() == 0 || pos >= str.length() || len > str.length())
             return 0;
@@ -199,6 +200,12 @@ namespace axomotor::lte_modem::helpers
         return negative ? -result : result;
     }
 
+    template <typename T>
+    T to_number(const std::string &str, size_t pos = 0, size_t len = 0)
+    {
+        return to_number<T>(std::string_view(str), pos, len);
+    }
+
     template <typename T>
     T to_number(const std::span<char> &buffer, size_t len = 0)
     {
@@ -285,6 +292,9 @@ namespace axomotor::lte_modem::helpers
      */
     time_t parse_to_epoch(std::string &payload);
 
-    void parse_gnss_info(std::string &payload, gnss_nav_info_t &info);
+    /**
+     * @brief Lee la información de navegación de una respuesta +CGNSINF.
+     */
+    void parse_gnss_info(std::string_view payload, gnss_nav_info_t &info);
 
 } // namespace axomotor::lte_modem
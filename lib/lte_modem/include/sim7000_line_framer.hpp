@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <string_view>
+
+namespace axomotor::lte_modem
+{
+    /**
+     * @brief Buffer circular de capacidad fija que separa en líneas (CRLF) los
+     * datos recibidos del modem.
+     *
+     * Los datos se escriben directamente en la ventana libre del buffer y cada
+     * línea se entrega como un std::string_view, por lo que no se realizan
+     * reservas de memoria después de la construcción. Solo las líneas que
+     * cruzan el final del buffer se copian a un área auxiliar para entregarlas
+     * de forma contigua.
+     */
+    class SIM7000_LineFramer
+    {
+    public:
+        explicit SIM7000_LineFramer(size_t capacity);
+        SIM7000_LineFramer(const SIM7000_LineFramer &) = delete;
+        SIM7000_LineFramer(SIM7000_LineFramer &&) = delete;
+
+        /**
+         * @brief Obtiene la región contigua libre en la que se pueden escribir
+         * datos nuevos (p. ej. con uart_read_bytes).
+         */
+        std::span<char> get_write_window();
+
+        /**
+         * @brief Confirma la escritura de bytes en la ventana de escritura.
+         */
+        void commit(size_t length);
+
+        /**
+         * @brief Copia datos al buffer.
+         * @return Cantidad de bytes copiados (puede ser menor si está lleno).
+         */
+        size_t write(const char *data, size_t length);
+
+        /**
+         * @brief Extrae la siguiente línea completa (sin CRLF).
+         *
+         * La vista devuelta es válida hasta la siguiente llamada a cualquier
+         * método que modifique el buffer. Si el buffer está lleno y no contiene
+         * un fin de línea, se entrega todo su contenido como una línea.
+         *
+         * @return true si se extrajo una línea.
+         */
+        bool next_line(std::string_view &line);
+
+        /**
+         * @brief Obtiene la porción contigua de datos pendientes sin consumirla.
+         */
+        std::string_view peek() const;
+
+        /**
+         * @brief Descarta bytes del inicio de los datos pendientes.
+         */
+        void discard(size_t length);
+
+        bool starts_with(std::string_view seq) const;
+        bool ends_with(std::string_view seq) const;
+
+        size_t size() const { return m_tail - m_head; }
+        size_t capacity() const { return m_capacity; }
+        bool is_empty() const { return m_tail == m_head; }
+        bool is_full() const { return size() == m_capacity; }
+        void clear();
+
+        SIM7000_LineFramer &operator=(const SIM7000_LineFramer &) = delete;
+        SIM7000_LineFramer &operator=(SIM7000_LineFramer &&) = delete;
+
+    private:
+        const size_t m_capacity;
+        const size_t m_mask;
+        std::unique_ptr<char[]> m_buffer;
+        std::unique_ptr<char[]> m_line;
+        // índices absolutos (se enmascaran al acceder al buffer)
+        size_t m_head;
+        size_t m_tail;
+        // posición hasta la que ya se buscó un fin de línea
+        size_t m_scan;
+
+        char at(size_t index) const { return m_buffer[index & m_mask]; }
+        std::string_view take(size_t length, size_t skip);
+    };
+
+} // namespace axomotor::lte_modem
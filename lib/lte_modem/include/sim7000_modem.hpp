@@ -2,7 +2,13 @@
 
 #include "sim7000_types.hpp"
 #include "sim7000_basic_modem.hpp"
+#include "sim7000_transcript.hpp"
+#include "sim7000_status_cache.hpp"
+#include "sim7000_ppp.hpp"
+#include "sim7000_cmux.hpp"
+#include "sim7000_supervisor.hpp"
 
+#include <atomic>
 #include <memory>
 #include <mutex>
 #include <freertos/FreeRTOS.h>
@@ -32,15 +38,54 @@ namespace axomotor::lte_modem
         MODEM_EVENT_SIM_CARD_NOT_INSERTED,
         MODEM_EVENT_MQTT_MESSAGE_RECEIVED,
         MODEM_EVENT_GNSS_NAVIGATION_REPORT,
+        MODEM_EVENT_PPP_CONNECTED,
+        MODEM_EVENT_PPP_DISCONNECTED,
+        MODEM_EVENT_GNSS_NMEA_SENTENCE,
+        MODEM_EVENT_HANG_DETECTED,
+        MODEM_EVENT_RECOVERED,
     };
 
     /* Constantes */
 
     static const int DEFAULT_BAUD_RATE = 115200;
+    // velocidades que se intentan negociar con AT+IPR, de mayor a menor
+    static const int HIGH_SPEED_BAUD_RATES[] = { 921600, 460800, 230400 };
+    // tiempo que se espera a que el modem aplique la nueva velocidad
+    static const uint32_t BAUD_RATE_SWITCH_DELAY_MS = 50;
+    // intentos de verificación (AT) después de cambiar de velocidad
+    static const int BAUD_RATE_VERIFY_ATTEMPTS = 3;
+    static const uint32_t BAUD_RATE_VERIFY_TIMEOUT_MS = 300;
+    // comandos que se ejecutan para medir la velocidad efectiva del enlace
+    static const size_t LINK_BENCHMARK_ITERATIONS = 10;
+    // tiempo de espera de la consulta combinada de estado de red
+    static const uint32_t STATUS_BUNDLE_TIMEOUT_MS = 3000;
+    // tiempo máximo de respuesta de ATD*99# (CONNECT)
+    static const uint32_t PPP_DIAL_TIMEOUT_MS = 30000;
+    // tiempo máximo para obtener una dirección IP por PPP
+    static const uint32_t PPP_CONNECT_TIMEOUT_MS = 30000;
+    // silencio requerido antes y después de la secuencia de escape "+++"
+    static const uint32_t DATA_MODE_GUARD_TIME_MS = 1000;
+    // duración de los pulsos de PWRKEY: al menos 1 s enciende el modem y al
+    // menos 1.2 s lo apaga
+    static const uint32_t PWRKEY_ON_PULSE_MS = 1000;
+    static const uint32_t PWRKEY_OFF_PULSE_MS = 1500;
+    // espera entre el apagado y el siguiente encendido
+    static const uint32_t POWER_OFF_DELAY_MS = 2500;
+    // tiempo máximo para que el modem responda después de reiniciarse
+    static const uint32_t MODEM_BOOT_TIMEOUT_MS = 15000;
+    // tiempo máximo de respuesta de AT+CFUN=1,1
+    static const uint32_t MODEM_RESET_TIMEOUT_MS = 10000;
+    // tiempo máximo para registrarse en la red después de un reinicio
+    static const uint32_t NETWORK_REG_TIMEOUT_MS = 60000;
+    static const uint32_t NETWORK_REG_POLL_INTERVAL_MS = 2000;
     static const int DEFAULT_RX_BUF_SIZE = 1024;
     static const int DEFAULT_RESPONSE_BUF_SIZE = 1024;
     static const int DEFAULT_PARSER_BUFFER_SIZE = 1024;
+    static const int DEFAULT_URC_BUF_SIZE = 256;
+    static const int DEFAULT_NMEA_BUF_SIZE = 128;
     static const int DEFAULT_EVENT_QUEUE_SIZE = 16;
+    // posiciones de fin de línea que puede registrar el controlador UART
+    static const int DEFAULT_PATTERN_QUEUE_SIZE = 32;
 
     static const int DEFAULT_MQTT_RX_BUF_SIZE = 128;
     static const int DEFAULT_MQTT_TX_BUF_SIZE = 128;
@@ -87,18 +132,141 @@ namespace axomotor::lte_modem
         esp_err_t get_system_time(std::string &date_time);
         esp_err_t sync_time();
 
+        /**
+         * @brief Selecciona cómo se leen los datos de la UART. En modo
+         * LINE_EVENTS el analizador se ejecuta solo cuando llega un fin de
+         * línea ('\n') o cuando la línea queda inactiva (indicador "> " o
+         * datos en crudo). Debe llamarse antes de init().
+         */
+        esp_err_t set_rx_mode(uart_rx_mode_t mode);
+
+        /* Diagnóstico */
+
+        /**
+         * @brief Comienza a grabar los datos enviados y recibidos por la UART
+         * en un archivo (p. ej. en la tarjeta SD) para reproducirlos después
+         * con SIM7000_ReplayModem.
+         */
+        esp_err_t start_transcript(const char *path);
+        esp_err_t stop_transcript();
+
+        /**
+         * @brief Mide la velocidad efectiva del enlace (bytes enviados y
+         * recibidos por segundo) ejecutando varias veces un comando de
+         * consulta.
+         *
+         * No forma parte de la negociación de velocidad, ya que ocupa el
+         * enlace durante varios comandos; para conocer la ganancia se llama
+         * antes y después de negotiate_baud_rate().
+         */
+        esp_err_t measure_link_throughput(
+            uint32_t &bytes_per_second,
+            size_t iterations = LINK_BENCHMARK_ITERATIONS);
+
+        /* Velocidad de comunicación */
+
+        /**
+         * @brief Negocia con AT+IPR la mayor velocidad que no exceda la
+         * indicada. La velocidad que funciona se guarda en NVS para usarse
+         * desde el siguiente arranque.
+         *
+         * Debe llamarse después de init() y antes de que otros servicios
+         * comiencen a enviar comandos.
+         */
+        esp_err_t negotiate_baud_rate(int max_baud_rate);
+
+        /**
+         * @brief Cambia la velocidad del modem y de la UART. Si el modem no
+         * responde a la nueva velocidad, regresa a la anterior.
+         */
+        esp_err_t set_baud_rate(int baud_rate);
+        int get_baud_rate() const { return m_baud_rate; }
+
         /* Control de red */
 
         esp_err_t get_signal_strength(int8_t &value, signal_strength_t *strength = nullptr);
         esp_err_t get_network_reg_status(network_reg_status_t &status);
         esp_err_t get_connection_status(connection_status_t &status);
         esp_err_t get_current_operator(std::string &op_name, operator_netact_t *op_nectact = nullptr);
+
+        /**
+         * @brief Obtiene la intensidad de señal, el operador y el estado de
+         * registro en una sola línea de comando (AT+CSQ;+COPS?;+CGREG?).
+         */
+        esp_err_t query_status_bundle(network_status_t &status);
+
+        /**
+         * @brief Obtiene el estado de red desde la memoria; solo consulta al
+         * modem si algún campo venció o si se indica force_refresh.
+         */
+        esp_err_t get_network_status(network_status_t &status, bool force_refresh = false);
+
+        /* Versiones asíncronas (para corrutinas en un threading::Executor) */
+
+        threading::Async<esp_err_t> query_status_bundle_async(network_status_t &status);
+        threading::Async<esp_err_t> get_network_status_async(
+            network_status_t &status,
+            bool force_refresh = false);
+        SIM7000_NetworkStatusCache &get_status_cache() { return m_status_cache; }
         esp_err_t get_local_ip(std::string &ip);
         esp_err_t activate_network();
         esp_err_t deactivate_network();
         esp_err_t enable_comm();
         esp_err_t disable_comm();
 
+        /* Modo de datos (PPP) */
+
+        /**
+         * @brief Establece una conexión PPP con el contexto PDP del APN
+         * (ATD*99***<cid>#) y la conecta a esp_netif, de modo que la red
+         * celular puede usarse con sockets de lwIP o clientes estándar
+         * (esp-mqtt, esp_http_client). Mientras dure, el modem no acepta
+         * comandos AT ni envía URC.
+         *
+         * Requiere que la aplicación haya llamado a esp_netif_init() y creado
+         * el loop de eventos predeterminado.
+         */
+        esp_err_t enter_data_mode(TickType_t ticks_to_wait = pdMS_TO_TICKS(PPP_CONNECT_TIMEOUT_MS));
+
+        /**
+         * @brief Termina la conexión PPP y regresa al modo de comandos.
+         */
+        esp_err_t exit_data_mode();
+
+        /* Multiplexor (CMUX) */
+
+        /**
+         * @brief Activa el multiplexor 27.010 (AT+CMUX=0) y abre un canal para
+         * comandos AT y URC y otro para datos, de modo que la conexión PPP de
+         * enter_data_mode() no bloquea los comandos ni los reportes del GNSS.
+         *
+         * Con enable_nmea se abre además un canal por el que el GNSS envía
+         * sus sentencias NMEA (AT+CGNSTST=1), que se publican con el evento
+         * MODEM_EVENT_GNSS_NMEA_SENTENCE.
+         */
+        esp_err_t start_cmux(bool enable_nmea = false);
+
+        /**
+         * @brief Termina la conexión PPP (si existe) y el multiplexor.
+         */
+        esp_err_t stop_cmux();
+        bool is_cmux_active() const { return m_is_cmux; }
+
+        bool is_ppp_connected() const { return m_ppp.is_connected(); }
+        esp_netif_t *get_ppp_netif() { return m_ppp.get_netif(); }
+
+        /* Supervisión */
+
+        /**
+         * @brief Inicia el supervisor que detecta cuando el modem deja de
+         * responder y lo recupera sin reiniciar el microcontrolador (ver
+         * SIM7000_Supervisor). Debe llamarse después de init().
+         */
+        esp_err_t enable_supervisor();
+        esp_err_t disable_supervisor();
+        bool is_recovering() const { return m_supervisor.is_recovering(); }
+        recovery_stats_t get_recovery_stats() const { return m_supervisor.get_stats(); }
+
         /* Control de GRPS */
 
     protected:
@@ -122,22 +290,48 @@ namespace axomotor::lte_modem
         esp_err_t set_net_active_mode(network_active_mode_t mode, TickType_t tick_count = pdMS_TO_TICKS(1000));
 
     private:
+        friend class SIM7000_Supervisor;
+
         /* Constantes */
 
         const uart_port_t m_port;
         const gpio_num_t m_pin_pwr;
+        const int m_default_baud_rate;
 
         /* Datos */
 
         char m_rx_buffer[DEFAULT_RX_BUF_SIZE];
+        std::string m_urc_buffer;
         apn_config_t m_apn;
         internal::sim7000_status_t m_status;
-        std::shared_ptr<internal::sim7000_cmd_result_info_t> m_result_info;
+        internal::sim7000_cmd_result_info_t m_result_info;
         std::recursive_mutex m_mutex;
+        SIM7000_TranscriptWriter m_transcript;
+        SIM7000_NetworkStatusCache m_status_cache;
+        SIM7000_PPP m_ppp;
+        SIM7000_CMux m_cmux;
+        // el multiplexor está activo y la UART solo transporta tramas
+        std::atomic<bool> m_is_cmux;
+        // el canal de datos del multiplexor está en modo de datos
+        std::atomic<bool> m_is_ppp_channel_online;
+        // líneas incompletas de la respuesta del marcado y de las sentencias
+        // NMEA recibidas por sus canales
+        char m_ppp_dial_buffer[DEFAULT_URC_BUF_SIZE];
+        size_t m_ppp_dial_length;
+        char m_nmea_buffer[DEFAULT_NMEA_BUF_SIZE];
+        size_t m_nmea_length;
+        SIM7000_Supervisor m_supervisor;
+        // lo que estaba activo antes de reiniciar el modem y debe
+        // restablecerse al recuperarlo
+        bool m_restore_cmux;
+        bool m_restore_nmea;
+        bool m_restore_ppp;
         QueueHandle_t m_uart_event_queue;
         threading::EventGroup m_event_group;
         esp_event_loop_handle_t *m_event_loop;
         bool m_enable_events;
+        int m_baud_rate;
+        uart_rx_mode_t m_rx_mode;
 
         esp_err_t setup() override;
         void loop() override;
@@ -145,8 +339,35 @@ namespace axomotor::lte_modem
         /* Funciones de bajo nivel */
 
         void receive_uart_data(size_t length);
-        void on_urc_message(std::string &payload) override;
+        void receive_buffered_data();
+        void receive_line_data();
+        void receive_raw_data();
+        void receive_ppp_channel_data(const char *data, size_t length);
+        void receive_nmea_data(const char *data, size_t length);
+        esp_err_t dial_ppp_channel(const std::span<const char> &params);
+        esp_err_t hang_up_ppp_channel();
+        esp_err_t enable_line_events();
+        void restore_rx_mode();
+        esp_err_t apply_uart_baud_rate(int baud_rate);
+        esp_err_t verify_link();
+
+        /* Recuperación (desde el supervisor) */
+
+        esp_err_t probe_link();
+        esp_err_t reset_modem();
+        esp_err_t power_cycle();
+        esp_err_t wait_for_boot();
+        esp_err_t wait_for_network(TickType_t ticks_to_wait);
+        esp_err_t restore_state();
+        void reset_link_state();
+        void pulse_pwrkey(uint32_t duration_ms);
+
+        void on_cmd_timeout(uint32_t consecutive_timeouts) override;
+        void on_urc_message(
+            std::string_view line,
+            const internal::urc_def_t &def) override;
         int on_cmd_write(const char *data, size_t length) override;
+        void on_data_received(const char *data, size_t length) override;
         
         void post_event(int32_t id, TickType_t ticks_to_wait = portMAX_DELAY);
         
@@ -160,6 +381,13 @@ namespace axomotor::lte_modem
         void post_gnss_event(std::string &payload);
         void post_mqtt_event(std::string &payload);
 
+        static int write_uart(void *ctx, const char *data, size_t length);
+        static int write_ppp_data(void *ctx, const char *data, size_t length);
+        static void on_at_channel_data(void *ctx, const char *data, size_t length);
+        static void on_ppp_channel_data(void *ctx, const char *data, size_t length);
+        static void on_nmea_channel_data(void *ctx, const char *data, size_t length);
+        static void on_ppp_status(void *ctx, ppp_status_t status);
+
         esp_err_t execute_internal_cmd_no_answer(
             internal::at_cmd_t command,
             TickType_t ticks_to_wait = 0);
@@ -197,7 +425,7 @@ namespace axomotor::lte_modem
         esp_err_t check_modem_ptr();
 
         std::weak_ptr<SIM7000_Modem> m_modem;
-        std::shared_ptr<internal::sim7000_cmd_result_info_t> m_result_info;
+        internal::sim7000_cmd_result_info_t m_result_info;
     };
 
 } // namespace axomotor::lte_modem
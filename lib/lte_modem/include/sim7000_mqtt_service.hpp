@@ -28,10 +28,35 @@ namespace axomotor::lte_modem
         esp_err_t disconnect();
         esp_err_t get_state(bool &state);
         esp_err_t publish(const char *topic, uint8_t qos = 1, bool retain = false);
-        esp_err_t publish(const char *topic, std::span<const char> msg, uint8_t qos = 1, bool retain = false);
+        esp_err_t publish(
+            const char *topic,
+            std::span<const char> msg,
+            uint8_t qos = 1,
+            bool retain = false,
+            cmd_priority_t priority = cmd_priority_t::NORMAL);
         esp_err_t subscribe(const char *topic, uint8_t qos = 1);
         esp_err_t unsubscribe(const char *topic);
 
+        /**
+         * @brief Conecta con el broker sin bloquear la tarea (la conexión
+         * puede tardar minutos). La red debe estar activa.
+         */
+        threading::Async<esp_err_t> connect_async(TickType_t ticks_to_wait = 0);
+
+        /**
+         * @brief Versión asíncrona de publish() para corrutinas. El tema y el
+         * mensaje deben permanecer válidos hasta que termine la espera.
+         *
+         * Con prioridad URGENT, la publicación se envía antes que los demás
+         * comandos en espera e interrumpe al comando en curso si éste tardará.
+         */
+        threading::Async<esp_err_t> publish_async(
+            const char *topic,
+            std::span<const char> msg,
+            uint8_t qos = 1,
+            bool retain = false,
+            cmd_priority_t priority = cmd_priority_t::NORMAL);
+
     private:
     };
 
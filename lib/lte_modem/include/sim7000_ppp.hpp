@@ -0,0 +1,116 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <freertos/FreeRTOS.h>
+
+#include <esp_err.h>
+#include <esp_event.h>
+#include <esp_netif.h>
+#include <event_group.hpp>
+
+namespace axomotor::lte_modem
+{
+    // tiempo máximo para que el enlace PPP termine al detenerlo (LCP
+    // Terminate-Request)
+    static const uint32_t PPP_STOP_TIMEOUT_MS = 5000;
+
+    enum class ppp_status_t
+    {
+        CONNECTED,      // se obtuvo una dirección IP
+        DISCONNECTED,   // se perdió la dirección IP
+        LINK_LOST,      // el enlace terminó sin que se detuviera (p. ej. NO CARRIER)
+    };
+
+    /**
+     * @brief Interfaz de red PPP (esp_netif + lwIP) sobre el canal de datos
+     * del modem. Una vez conectada, las aplicaciones pueden usar sockets de
+     * lwIP o clientes estándar (esp-mqtt, esp_http_client) sobre la red
+     * celular.
+     *
+     * Los datos que envía lwIP se escriben con la función indicada en init(),
+     * de modo que el canal puede ser la UART completa o un canal multiplexado.
+     * Los datos recibidos del modem se entregan con receive().
+     */
+    class SIM7000_PPP
+    {
+    public:
+        typedef int (*write_fn_t)(void *ctx, const char *data, size_t length);
+        typedef void (*status_fn_t)(void *ctx, ppp_status_t status);
+
+        SIM7000_PPP();
+        SIM7000_PPP(const SIM7000_PPP &) = delete;
+        ~SIM7000_PPP();
+
+        /**
+         * @brief Crea la interfaz de red. Requiere que la aplicación haya
+         * llamado a esp_netif_init() y creado el loop de eventos
+         * predeterminado.
+         */
+        esp_err_t init(
+            write_fn_t write,
+            void *write_ctx,
+            status_fn_t on_status = nullptr,
+            void *status_ctx = nullptr);
+
+        /**
+         * @brief Usuario y contraseña (PAP) del APN; sin usuario no se
+         * autentica.
+         */
+        esp_err_t set_auth(const char *user, const char *pwd);
+
+        /**
+         * @brief Inicia la negociación PPP (el modem ya debe estar en modo de
+         * datos).
+         */
+        esp_err_t start();
+
+        /**
+         * @brief Termina el enlace y espera a que lwIP lo cierre.
+         */
+        esp_err_t stop(TickType_t ticks_to_wait = pdMS_TO_TICKS(PPP_STOP_TIMEOUT_MS));
+
+        /**
+         * @brief Espera hasta que la interfaz obtenga una dirección IP.
+         */
+        esp_err_t wait_for_ip(TickType_t ticks_to_wait);
+
+        /**
+         * @brief Entrega a lwIP datos recibidos del modem. Se descartan si la
+         * interfaz no está iniciada.
+         */
+        void receive(const char *data, size_t length);
+
+        bool is_started() const { return m_is_started; }
+        bool is_connected() const;
+        esp_netif_t *get_netif() { return m_netif; }
+
+        SIM7000_PPP &operator=(const SIM7000_PPP &) = delete;
+
+    private:
+        // controlador de E/S de la interfaz; esp_netif requiere que la base
+        // sea el primer miembro
+        struct driver_t
+        {
+            esp_netif_driver_base_t base;
+            SIM7000_PPP *ppp;
+        };
+
+        esp_netif_t *m_netif;
+        driver_t m_driver;
+        write_fn_t m_write;
+        void *m_write_ctx;
+        status_fn_t m_on_status;
+        void *m_status_ctx;
+        std::atomic<bool> m_is_started;
+        threading::EventGroup m_event_group;
+
+        void notify(ppp_status_t status);
+
+        static esp_err_t post_attach(esp_netif_t *netif, esp_netif_iodriver_handle handle);
+        static esp_err_t transmit(void *handle, void *buffer, size_t length);
+        static void on_ip_event(void *args, esp_event_base_t base, int32_t id, void *data);
+        static void on_ppp_event(void *args, esp_event_base_t base, int32_t id, void *data);
+    };
+
+} // namespace axomotor::lte_modem
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "sim7000_helpers.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace axomotor::lte_modem
+{
+    // cantidad máxima de campos que se separan de una respuesta (CGNSINF
+    // entrega 21)
+    static const size_t MAX_RESPONSE_FIELDS = 24;
+
+    /**
+     * @brief Separa una respuesta con formato "+CMD: a,b,\"c\"" en campos.
+     *
+     * La respuesta se recorre una sola vez y cada campo se guarda como un
+     * std::string_view (sin comillas), por lo que no se copian datos. Las
+     * vistas son válidas mientras la cadena original no se modifique.
+     */
+    class SIM7000_ResponseFields
+    {
+    public:
+        SIM7000_ResponseFields();
+        explicit SIM7000_ResponseFields(std::string_view response, char delimiter = ',');
+
+        /**
+         * @brief Separa la respuesta en campos, omitiendo el prefijo "+CMD: "
+         * si existe. Los delimitadores dentro de comillas se ignoran.
+         *
+         * @return Cantidad de campos encontrados.
+         */
+        size_t split(std::string_view response, char delimiter = ',');
+
+        size_t size() const { return m_count; }
+        bool is_empty(size_t index) const { return get_string(index).empty(); }
+
+        /**
+         * @brief Obtiene el campo indicado sin comillas (vacío si no existe).
+         */
+        std::string_view get_string(size_t index) const;
+
+        /**
+         * @brief Copia el campo indicado a una cadena.
+         * @return true si el campo existe.
+         */
+        bool get_string(size_t index, std::string &value) const;
+
+        template <typename T = int>
+        T get_int(size_t index, T default_value = 0) const
+        {
+            std::string_view field = get_string(index);
+            if (field.empty()) return default_value;
+            return helpers::to_number<T>(field);
+        }
+
+        float get_float(size_t index, float default_value = 0.0f) const;
+
+        /**
+         * @brief Obtiene un campo decimal como entero escalado por
+         * 10^decimals (p. ej. "19.4326" con 6 decimales es 19432600), sin
+         * perder precisión por el uso de punto flotante.
+         */
+        int32_t get_fixed(size_t index, uint8_t decimals, int32_t default_value = 0) const;
+
+        std::string_view operator[](size_t index) const { return get_string(index); }
+
+    private:
+        std::array<std::string_view, MAX_RESPONSE_FIELDS> m_fields;
+        size_t m_count;
+    };
+
+} // namespace axomotor::lte_modem
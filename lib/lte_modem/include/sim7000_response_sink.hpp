@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdio>
+#include <span>
+#include <string_view>
+
+namespace axomotor::lte_modem
+{
+    /**
+     * @brief Receptor de los fragmentos de respuesta de un comando a medida
+     * que son recibidos.
+     *
+     * Cuando un comando tiene un receptor asignado, su respuesta no se
+     * acumula en sim7000_cmd_result_info_t::response, por lo que la memoria
+     * utilizada no depende del tamaño de la respuesta. El método se invoca
+     * desde la tarea del modem, por lo que no debe bloquearse por mucho tiempo.
+     */
+    class SIM7000_ResponseSink
+    {
+    public:
+        virtual ~SIM7000_ResponseSink() = default;
+
+        /**
+         * @brief Recibe un fragmento de la respuesta.
+         * @return false si no fue posible almacenar el fragmento.
+         */
+        virtual bool write(std::string_view chunk) = 0;
+    };
+
+    /**
+     * @brief Receptor que copia la respuesta en un buffer de tamaño fijo
+     * (p. ej. reservado en PSRAM).
+     */
+    class SIM7000_BufferSink : public SIM7000_ResponseSink
+    {
+    public:
+        SIM7000_BufferSink(std::span<char> buffer);
+
+        bool write(std::string_view chunk) override;
+        void clear() { m_length = 0; }
+
+        size_t length() const { return m_length; }
+        std::string_view data() const { return { m_buffer.data(), m_length }; }
+
+    private:
+        std::span<char> m_buffer;
+        size_t m_length;
+    };
+
+    /**
+     * @brief Receptor que escribe la respuesta en un archivo abierto (p. ej.
+     * en la tarjeta SD).
+     */
+    class SIM7000_FileSink : public SIM7000_ResponseSink
+    {
+    public:
+        SIM7000_FileSink(FILE *file);
+
+        bool write(std::string_view chunk) override;
+        size_t length() const { return m_length; }
+
+    private:
+        FILE *m_file;
+        size_t m_length;
+    };
+
+} // namespace axomotor::lte_modem
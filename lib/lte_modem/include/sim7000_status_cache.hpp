@@ -0,0 +1,76 @@
+#pragma once
+
+#include "sim7000_types.hpp"
+
+#include <array>
+#include <cstdint>
+#include <mutex>
+
+namespace axomotor::lte_modem
+{
+    // tiempo de vida predeterminado de cada campo del estado de red; los
+    // cambios importantes llegan por URC, por lo que pueden ser largos
+    static const uint32_t SIGNAL_STATUS_TTL_MS = 120 * 1000;
+    static const uint32_t OPERATOR_STATUS_TTL_MS = 10 * 60 * 1000;
+    static const uint32_t REGISTRATION_STATUS_TTL_MS = 5 * 60 * 1000;
+    static const uint32_t MQTT_STATUS_TTL_MS = 5 * 60 * 1000;
+
+    enum class network_status_field_t
+    {
+        SIGNAL,
+        OPERATOR,
+        REGISTRATION,
+        MQTT_STATE,
+        COUNT
+    };
+
+    /**
+     * @brief Copia en memoria del estado de red. Cada campo vence después de
+     * su tiempo de vida o cuando se invalida (p. ej. al recibir un URC).
+     */
+    class SIM7000_NetworkStatusCache
+    {
+    public:
+        SIM7000_NetworkStatusCache();
+        SIM7000_NetworkStatusCache(const SIM7000_NetworkStatusCache &) = delete;
+
+        /**
+         * @brief Copia el estado guardado.
+         * @return false si alguno de los campos de red (señal, operador o
+         * registro) está vencido.
+         */
+        bool get(network_status_t &status) const;
+
+        /**
+         * @brief Obtiene el estado de la conexión MQTT.
+         * @return false si el campo está vencido.
+         */
+        bool get_mqtt_state(bool &connected) const;
+
+        /**
+         * @brief Guarda una consulta completa (señal, operador y registro).
+         */
+        void update(const network_status_t &status);
+        void set_reg_status(network_reg_status_t reg_status);
+        void set_mqtt_state(bool connected);
+
+        void invalidate(network_status_field_t field);
+        void invalidate_all();
+        void set_ttl(network_status_field_t field, uint32_t ttl_ms);
+
+        SIM7000_NetworkStatusCache &operator=(const SIM7000_NetworkStatusCache &) = delete;
+
+    private:
+        static constexpr size_t FIELD_COUNT = (size_t)network_status_field_t::COUNT;
+
+        network_status_t m_status;
+        bool m_mqtt_connected;
+        std::array<int64_t, FIELD_COUNT> m_updated_at; // us, 0 = vencido
+        std::array<uint32_t, FIELD_COUNT> m_ttl_ms;
+        mutable std::mutex m_mutex;
+
+        bool is_valid(network_status_field_t field, int64_t now) const;
+        void touch(network_status_field_t field, int64_t now);
+    };
+
+} // namespace axomotor::lte_modem
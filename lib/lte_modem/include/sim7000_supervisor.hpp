@@ -0,0 +1,93 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <freertos/FreeRTOS.h>
+
+#include <esp_err.h>
+#include <service_base.hpp>
+#include <event_group.hpp>
+
+namespace axomotor::lte_modem
+{
+    // comandos seguidos sin respuesta para considerar que el modem se bloqueó
+    static const uint32_t SUPERVISOR_TIMEOUT_THRESHOLD = 3;
+    // intervalo con el que la tarea revisa si debe detenerse
+    static const uint32_t SUPERVISOR_POLL_INTERVAL_MS = 1000;
+    // espera antes del segundo paso de recuperación; se duplica en cada paso
+    // siguiente hasta el máximo
+    static const uint32_t RECOVERY_BACKOFF_MS = 2000;
+    static const uint32_t RECOVERY_MAX_BACKOFF_MS = 5 * 60 * 1000;
+
+    enum class recovery_level_t
+    {
+        NONE,
+        PROBE,          // el modem respondió de nuevo a AT
+        SOFT_RESET,     // reinicio con AT+CFUN=1,1
+        POWER_CYCLE,    // apagado y encendido con PWRKEY
+    };
+
+    struct recovery_stats_t
+    {
+        uint32_t hang_count;        // bloqueos detectados
+        uint32_t recovery_count;    // recuperaciones exitosas
+        uint32_t power_cycle_count; // ciclos de encendido realizados
+        recovery_level_t last_level;
+        uint32_t last_recovery_ms;
+        uint32_t mean_recovery_ms;  // tiempo medio de recuperación (MTTR)
+    };
+
+    class SIM7000_Modem;
+
+    /**
+     * @brief Supervisor del modem. Cuando varios comandos seguidos se quedan
+     * sin respuesta, intenta recuperar al modem en su propia tarea (la del
+     * modem debe seguir leyendo la UART), escalando de una prueba con AT a
+     * AT+CFUN=1,1 y después a un ciclo de encendido con PWRKEY, con esperas
+     * que crecen de forma exponencial entre cada paso.
+     *
+     * Al recuperarse, el modem restablece su configuración (APN, contexto de
+     * la aplicación, multiplexor) y publica MODEM_EVENT_RECOVERED para que la
+     * aplicación restablezca lo demás (p. ej. la sesión MQTT).
+     */
+    class SIM7000_Supervisor : private threading::ServiceBase
+    {
+    public:
+        SIM7000_Supervisor(SIM7000_Modem &modem);
+        SIM7000_Supervisor(const SIM7000_Supervisor &) = delete;
+        ~SIM7000_Supervisor();
+
+        esp_err_t enable();
+        esp_err_t disable();
+        bool is_enabled() const { return is_active(); }
+        bool is_recovering() const { return m_is_recovering; }
+
+        /**
+         * @brief Informa que un comando se quedó sin respuesta. Se llama
+         * desde la tarea del solicitante, por lo que no se bloquea.
+         */
+        void notify_timeout(uint32_t consecutive_timeouts);
+
+        recovery_stats_t get_stats() const;
+
+        SIM7000_Supervisor &operator=(const SIM7000_Supervisor &) = delete;
+
+    private:
+        SIM7000_Modem &m_modem;
+        threading::EventGroup m_event_group;
+        std::atomic<bool> m_is_recovering;
+        mutable std::mutex m_stats_mutex;
+        recovery_stats_t m_stats;
+        uint64_t m_total_recovery_us;
+
+        void loop() override;
+
+        void recover();
+        esp_err_t run_step(recovery_level_t level);
+        bool wait_backoff(uint32_t delay_ms);
+
+        static const char *get_level_name(recovery_level_t level);
+    };
+
+} // namespace axomotor::lte_modem
@@ -0,0 +1,155 @@
+#pragma once
+
+#include "sim7000_basic_modem.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <esp_err.h>
+
+namespace axomotor::lte_modem
+{
+    /*
+     * Formato de las grabaciones (little endian):
+     *
+     *  Encabezado: "S7TR" | versión (u8) | 3 bytes reservados
+     *  Registro:   delta_us (u32) | longitud (u16) | dirección (u8) | datos
+     *
+     * delta_us es el tiempo transcurrido desde el registro anterior.
+     */
+    static const char TRANSCRIPT_MAGIC[4] = { 'S', '7', 'T', 'R' };
+    static const uint8_t TRANSCRIPT_VERSION = 1;
+    static const size_t TRANSCRIPT_HEADER_SIZE = 8;
+    static const size_t TRANSCRIPT_RECORD_HEADER_SIZE = 7;
+    static const size_t TRANSCRIPT_MAX_RECORD_LENGTH = UINT16_MAX;
+    static const size_t DEFAULT_TRANSCRIPT_BUF_SIZE = 4096;
+
+    enum class transcript_dir_t : uint8_t
+    {
+        TX = 0, // datos enviados al modem
+        RX = 1  // datos recibidos del modem
+    };
+
+    struct transcript_record_t
+    {
+        uint32_t delta_us;
+        transcript_dir_t direction;
+        uint16_t length;
+    };
+
+    /**
+     * @brief Graba el flujo de bytes de la UART (enviados y recibidos) en un
+     * archivo binario con marcas de tiempo.
+     */
+    class SIM7000_TranscriptWriter
+    {
+    public:
+        SIM7000_TranscriptWriter();
+        SIM7000_TranscriptWriter(const SIM7000_TranscriptWriter &) = delete;
+        SIM7000_TranscriptWriter(SIM7000_TranscriptWriter &&) = delete;
+        ~SIM7000_TranscriptWriter();
+
+        /**
+         * @brief Crea el archivo indicado y comienza la grabación.
+         */
+        esp_err_t start(const char *path, size_t buffer_size = DEFAULT_TRANSCRIPT_BUF_SIZE);
+        esp_err_t stop();
+
+        /**
+         * @brief Agrega un registro a la grabación (no hace nada si la
+         * grabación no está activa).
+         */
+        void record(transcript_dir_t direction, const char *data, size_t length);
+
+        bool is_recording() const { return m_is_recording; }
+        size_t get_bytes_recorded() const { return m_bytes_recorded; }
+
+        SIM7000_TranscriptWriter &operator=(const SIM7000_TranscriptWriter &) = delete;
+        SIM7000_TranscriptWriter &operator=(SIM7000_TranscriptWriter &&) = delete;
+
+    private:
+        FILE *m_file;
+        std::atomic<bool> m_is_recording;
+        int64_t m_last_time;
+        size_t m_bytes_recorded;
+        std::mutex m_mutex;
+    };
+
+    /**
+     * @brief Lee los registros de una grabación.
+     */
+    class SIM7000_TranscriptReader
+    {
+    public:
+        SIM7000_TranscriptReader(FILE *file);
+
+        /**
+         * @brief Verifica el encabezado del archivo.
+         */
+        esp_err_t open();
+
+        /**
+         * @brief Lee el encabezado del siguiente registro (omite los datos
+         * que no se hayan leído del registro anterior).
+         * @return ESP_ERR_NOT_FOUND al llegar al final del archivo.
+         */
+        esp_err_t next(transcript_record_t &record);
+
+        /**
+         * @brief Lee los datos del registro actual.
+         * @return Cantidad de bytes leídos (0 si ya no quedan).
+         */
+        size_t read(std::span<char> buffer);
+
+    private:
+        FILE *m_file;
+        size_t m_remaining;
+    };
+
+    struct transcript_replay_stats_t
+    {
+        uint32_t records;
+        uint32_t bytes_rx;
+        uint32_t bytes_tx;
+        uint32_t urc_count;
+        int64_t elapsed_us;     // tiempo de proceso (sin contar las esperas)
+        int64_t recorded_us;    // duración de la grabación
+        // tiempo, según la grabación, desde un envío hasta el primer dato
+        // recibido después
+        uint32_t responses;
+        int64_t total_latency_us;
+        uint32_t max_latency_us;
+    };
+
+    /**
+     * @brief Modem sin UART que reproduce una grabación a través del
+     * analizador (feed_buffer), para medir el rendimiento del análisis y del
+     * despacho de URC con tráfico real.
+     */
+    class SIM7000_ReplayModem : public SIM7000_BasicModem
+    {
+    public:
+        SIM7000_ReplayModem(size_t buffer_size = 1024);
+
+        /**
+         * @brief Reproduce la grabación.
+         * @param realtime Si es true, respeta los tiempos originales entre
+         * registros; de lo contrario, reproduce a la máxima velocidad.
+         */
+        esp_err_t replay(
+            FILE *file,
+            bool realtime,
+            transcript_replay_stats_t &stats);
+
+    protected:
+        void on_urc_message(
+            std::string_view line,
+            const internal::urc_def_t &def) override;
+        int on_cmd_write(const char *data, size_t length) override;
+
+    private:
+        uint32_t m_urc_count;
+    };
+
+} // namespace axomotor::lte_modem
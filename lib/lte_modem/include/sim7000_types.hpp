@@ -3,10 +3,28 @@
 #include <span>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <array>
+#include <freertos/FreeRTOS.h>
+
+namespace axomotor::threading {
+
+class Waiter;
+
+} // namespace axomotor::threading
 
 namespace axomotor::lte_modem {
 
+class SIM7000_ResponseSink;
+class SIM7000_CancelToken;
+
+enum class cmd_priority_t
+{
+    NORMAL,     // puede ser interrumpido por un comando urgente
+    URGENT,     // se envía antes que los comandos normales en la cola
+    CRITICAL    // nunca se interrumpe (p. ej. cambios de configuración)
+};
+
 namespace internal {
 
 enum class at_cmd_t
@@ -71,6 +89,7 @@ enum class at_cmd_t
     CBC         = 122, // Battery Charge
     CUSD        = 123, // Unstructured Supplementary Service Data
     CNUM        = 124, // Subscriber Number
+    CMUX        = 125, // Multiplexer Control
 
     CMGD        = 201, // Delete SMS Message
     CMGF        = 202, // Select SMS Message Fo at
@@ -250,7 +269,16 @@ enum class at_cmd_result_t
     CME_ERROR,
     CMS_ERROR,
     NO_ANSWER,
-    BUFFER_OVF
+    BUFFER_OVF,
+    CANCELLED
+};
+
+enum class at_cmd_state_t
+{
+    IDLE,       // no se ha enviado al planificador
+    QUEUED,     // en espera de ser enviado al modem
+    IN_PROGRESS,// enviado, esperando el código de resultado final
+    COMPLETED   // se recibió el código de resultado final o se agotó el tiempo
 };
 
 enum class cme_error_code_t
@@ -539,7 +567,9 @@ enum class urc_t
     APP_PDP_ACTIVE,
     APP_PDP_DEACTIVE,
     UGNSINF,
-    SMSUB
+    SMSUB,
+    CGREG,
+    SMSTATE
 };
 
 enum class urc_match_t 
@@ -562,7 +592,8 @@ struct at_cmd_def_t
     at_cmd_t command;
     at_cmd_type_t type;
     const char *string;
-    int max_response_time; // 0 = indefined
+    std::string_view prefix; // "AT+XXXX", "ATX" o "ATSn"
+    int max_response_time; // en segundos (0 = indefined)
 };
 
 struct sim7000_cmd_result_info_t
@@ -579,6 +610,17 @@ struct sim7000_cmd_result_info_t
     }
 };
 
+// longitud máxima de una línea de comando (incluye retorno de carro)
+static constexpr size_t MAX_CMD_LINE_LENGTH = 256;
+
+// espacio reutilizable para ejecutar un comando sin reservar memoria
+struct sim7000_cmd_slot_t
+{
+    sim7000_cmd_result_info_t result_info;
+    char params[MAX_CMD_LINE_LENGTH];
+    size_t params_length;
+};
+
 struct sim7000_cmd_context_t
 {
     sim7000_cmd_context_t() { reset(); }
@@ -586,24 +628,65 @@ struct sim7000_cmd_context_t
     at_cmd_t command;
     std::span<const char> params;
     std::span<const char> payload;
-    std::shared_ptr<sim7000_cmd_result_info_t> result_info;
+    sim7000_cmd_result_info_t *result_info;
+    // receptor opcional de la respuesta (si se asigna, la respuesta no se
+    // guarda en result_info->response)
+    SIM7000_ResponseSink *sink;
+    // token opcional para cancelar el comando desde otra tarea
+    SIM7000_CancelToken *cancel_token;
+    cmd_priority_t priority;
     bool is_raw;
     bool is_partial;
     bool send_payload;
+    bool payload_sent;
     bool ignore_response;
     bool response_received;
+    bool sink_failed;
+    size_t lines_received;
+
+    /* Datos del planificador de comandos */
+
+    at_cmd_state_t state;
+    sim7000_cmd_context_t *next;    // siguiente comando en la cola
+    uint32_t completion_bit;        // bit de notificación de finalización
+    TickType_t ticks_to_wait;       // tiempo máximo de espera de respuesta
+    TickType_t started_at;          // instante de envío o de inicio de respuesta
+    threading::Waiter *waiter;      // corrutina que espera el resultado (opcional)
+
+    /* Datos de instrumentación */
+
+    int64_t sent_time;              // instante de envío (us)
+    int64_t first_byte_time;        // instante del primer byte de respuesta (us)
+    uint32_t bytes_sent;
+    uint32_t bytes_received;
 
     void reset()
     {
         command = at_cmd_t::NONE;
         params = std::span<const char>();
         payload = std::span<const char>();
-        result_info.reset();
+        result_info = nullptr;
+        sink = nullptr;
+        cancel_token = nullptr;
+        priority = cmd_priority_t::NORMAL;
         is_raw = false;
         is_partial = false;
         send_payload = false;
+        payload_sent = false;
         ignore_response = false;
         response_received = false;
+        sink_failed = false;
+        lines_received = 0;
+        state = at_cmd_state_t::IDLE;
+        next = nullptr;
+        completion_bit = 0;
+        ticks_to_wait = 0;
+        started_at = 0;
+        waiter = nullptr;
+        sent_time = 0;
+        first_byte_time = 0;
+        bytes_sent = 0;
+        bytes_received = 0;
     }
 };
 
@@ -630,9 +713,20 @@ struct sim7000_status_t
 
 const at_cmd_def_t *get_command_def(at_cmd_t command);
 
-const urc_def_t *get_urc_def(const std::string &urc);
+/**
+ * @brief Escribe la línea de comando (prefijo + parámetros + CR) en el buffer
+ * indicado, seguida de un terminador nulo.
+ * 
+ * @return Longitud de la línea sin el terminador, o 0 si no cabe en el buffer.
+ */
+size_t build_cmd_line(
+    const at_cmd_def_t &cmd_def,
+    std::span<const char> params,
+    std::span<char> buffer);
+
+const urc_def_t *get_urc_def(std::string_view urc);
 
-bool check_if_is_urc(const std::string &urc);
+bool check_if_is_urc(std::string_view urc);
 
 } // namespace internal
 
@@ -714,6 +808,23 @@ enum class operator_netact_t
     LTE_NB_S1
 };
 
+struct network_status_t
+{
+    int8_t signal_dbm;                  // 0 si no es detectable
+    signal_strength_t signal_strength;
+    network_reg_status_t reg_status;
+    operator_netact_t netact;
+    char operator_name[32];
+};
+
+enum class uart_rx_mode_t
+{
+    // lee los datos en cada evento de la UART
+    DATA_EVENTS,
+    // lee solo cuando se detecta un fin de línea o la línea queda inactiva
+    LINE_EVENTS,
+};
+
 struct apn_config_t
 {
     char apn[64];
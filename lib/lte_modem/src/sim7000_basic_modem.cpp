@@ -2,20 +2,21 @@
 #include "sim7000_types.hpp"
 #include "sim7000_helpers.hpp"
 
+#include <algorithm>
 #include <cstring>
 #include <string>
 #include <esp_log.h>
+#include <esp_timer.h>
 
 namespace axomotor::lte_modem {
 
-#define MODEM_AVAILABLE_BIT     BIT0
-#define RESPONSE_STARTED_BIT    BIT1
-#define RESPONSE_COMPLETED_BIT  BIT2
-#define WAITING_CMD_PAYLOAD_BIT BIT3
+// máscara con los bits disponibles para notificar la finalización de comandos
+#define COMPLETION_BITS_MASK    ((1UL << MAX_PENDING_COMMANDS) - 1)
 
 #define NULL_CH     '\0'
 #define CRLF        "\r\n"
 #define CR          "\r"
+#define ESC         "\x1b"
 #define LF          '\n'
 
 using namespace axomotor::lte_modem::internal;
@@ -28,15 +29,35 @@ static const char *TAG = "sim7000:basic_modem";
 SIM7000_BasicModem::SIM7000_BasicModem(size_t buffer_size) :
     m_is_running{false},
     m_cmd_context{nullptr},
-    m_parser_event_group{}
+    m_queue_head{nullptr},
+    m_queue_tail{nullptr},
+    m_free_bits{COMPLETION_BITS_MASK},
+    m_is_draining{false},
+    m_drain_expects_prompt{false},
+    m_drain_started_at{0},
+    m_stale_results{0},
+    m_is_data_mode{false},
+    m_consecutive_timeouts{0},
+    m_framer{buffer_size},
+    m_completion_event_group{},
+    m_cmd_pool{DEFAULT_CMD_POOL_SIZE, DEFAULT_CMD_SLOT_RESPONSE_SIZE},
+    m_cmd_stats{}
 {
-    m_parser_buffer.reserve(buffer_size);
-    m_parser_event_group.set_flags(MODEM_AVAILABLE_BIT);
+    m_slot_semaphore = xSemaphoreCreateCounting(
+        MAX_PENDING_COMMANDS,
+        MAX_PENDING_COMMANDS
+    );
+    assert(m_slot_semaphore);
+}
+
+SIM7000_BasicModem::~SIM7000_BasicModem()
+{
+    vSemaphoreDelete(m_slot_semaphore);
 }
 
 esp_err_t SIM7000_BasicModem::execute_cmd(
     internal::at_cmd_t command,
-    std::shared_ptr<internal::sim7000_cmd_result_info_t> result_info,
+    internal::sim7000_cmd_result_info_t &result_info,
     TickType_t ticks_to_wait,
     bool ignore_response,
     bool is_partial,
@@ -45,18 +66,18 @@ esp_err_t SIM7000_BasicModem::execute_cmd(
 {
     sim7000_cmd_context_t context;
     context.command = command;
-    context.result_info = result_info;
+    context.result_info = &result_info;
     context.ignore_response = ignore_response;
     context.is_raw = is_raw;
     context.is_partial = is_partial;
-    
+
     return execute_cmd(context, ticks_to_wait);
 }
 
 esp_err_t SIM7000_BasicModem::execute_cmd(
     internal::at_cmd_t command,
     const std::span<const char> &params,
-    std::shared_ptr<internal::sim7000_cmd_result_info_t> result_info,
+    internal::sim7000_cmd_result_info_t &result_info,
     TickType_t ticks_to_wait,
     bool ignore_response,
     bool is_partial,
@@ -66,238 +87,711 @@ esp_err_t SIM7000_BasicModem::execute_cmd(
     sim7000_cmd_context_t context;
     context.command = command;
     context.params = params;
-    context.result_info = result_info;
+    context.result_info = &result_info;
     context.ignore_response = ignore_response;
     context.is_raw = is_raw;
     context.is_partial = is_partial;
-    
+
     return execute_cmd(context, ticks_to_wait);
 }
 
 esp_err_t SIM7000_BasicModem::execute_cmd(
+    internal::at_cmd_t command,
+    SIM7000_CmdSlot &slot,
+    TickType_t ticks_to_wait
+)
+{
+    if (!slot) return ESP_ERR_INVALID_ARG;
+
+    sim7000_cmd_context_t context;
+    context.command = command;
+    context.params = slot.get_params();
+    context.result_info = &slot.get_result_info();
+
+    return execute_cmd(context, ticks_to_wait);
+}
+
+esp_err_t SIM7000_BasicModem::execute_cmd(
+    internal::sim7000_cmd_context_t &context,
+    TickType_t ticks_to_wait
+)
+{
+    esp_err_t err = submit_cmd(context, ticks_to_wait);
+    if (err == ESP_OK) {
+        err = wait_for_cmd(context);
+    }
+
+    return err;
+}
+
+SIM7000_CmdSlot SIM7000_BasicModem::acquire_cmd_slot(TickType_t ticks_to_wait)
+{
+    return m_cmd_pool.acquire(ticks_to_wait);
+}
+
+esp_err_t SIM7000_BasicModem::submit_cmd(
     internal::sim7000_cmd_context_t &context,
     TickType_t ticks_to_wait
 )
+{
+    return enqueue_cmd(context, ticks_to_wait, portMAX_DELAY);
+}
+
+esp_err_t SIM7000_BasicModem::enqueue_cmd(
+    internal::sim7000_cmd_context_t &context,
+    TickType_t ticks_to_wait,
+    TickType_t queue_ticks
+)
 {
     // verifica si el receptor está en ejecución
     if (!m_is_running) return ESP_ERR_NOT_ALLOWED;
+    // en modo de datos el canal lo ocupa la conexión (PPP)
+    if (m_is_data_mode) return ESP_ERR_INVALID_STATE;
 
     // verifica si se recibió un puntero en donde guardar el resultado del
     // comando
-    if (!context.result_info) return ESP_ERR_INVALID_ARG;
-    auto result_info = context.result_info;
-    result_info->reset();
-    
+    if (context.result_info == nullptr) return ESP_ERR_INVALID_ARG;
+    context.result_info->reset();
+
     // obtiene la definición del comando recibido
     const at_cmd_def_t *cmd_def = get_command_def(context.command);
     if (cmd_def == nullptr) return ESP_ERR_INVALID_ARG;
-    
-    // espera hasta que el modem esté disponible
-    m_parser_event_group.wait_for_flags(MODEM_AVAILABLE_BIT, true, true);
 
-    std::string cmd_line = "AT";
-    const char *cmd_string = cmd_def->string;
-    esp_err_t err;
-    bool ack;
-    bool is_query_cmd = !context.params.empty() && context.params.front() == '?';
-
-    // establece el contexto del comando
-    m_cmd_context = &context;
+    // verifica si no se establecio un tiempo de espera
+    if (ticks_to_wait == 0) {
+        bool is_query_cmd = !context.params.empty() && context.params.front() == '?';
+        ticks_to_wait = get_cmd_timeout(*cmd_def, is_query_cmd);
+    }
 
-    switch (cmd_def->type) {
-        case at_cmd_type_t::BASIC:
-            cmd_line.append(cmd_string);
-            break;
-        case at_cmd_type_t::S_PARAM:
-            cmd_line.append(cmd_line);
-            cmd_line.append("=");
-            break;
-        case at_cmd_type_t::EXTENDED:
-            cmd_line.append("+");
-            cmd_line.append(cmd_string);
-            break;
-        default:
-            break;
+    // un token cancelado hace fallar los comandos siguientes
+    if (context.cancel_token != nullptr && context.cancel_token->is_cancelled()) {
+        context.result_info->result = at_cmd_result_t::CANCELLED;
+        return ESP_ERR_TIMEOUT;
     }
 
-    // verifica si hay datos adicionales a enviar
-    if (!context.params.empty()) {
-        cmd_line.append(context.params.data(), context.params.size());
+    // espera hasta que haya un lugar disponible en la cola
+    if (xSemaphoreTake(m_slot_semaphore, queue_ticks) != pdTRUE) {
+        return ESP_ERR_TIMEOUT;
     }
 
-    // escribe un caracter de retorno de carro para indicar ejecutar el comando
-    ESP_LOGD(TAG, "Executing '%s'...", cmd_line.c_str());
-    cmd_line.append(CR);
-    on_cmd_write(cmd_line.data(), cmd_line.length());
+    std::lock_guard lock(m_queue_mutex);
 
-    // verifica si el comando es de consulta (no hay espera)
-    if (is_query_cmd) {
-        ticks_to_wait = 150;
-    }
-    // de lo contrario, verifica si no se establecio un tiempo de espera
-    else if (ticks_to_wait == 0)
-    {
-        // verifica si el comando define un tiempo máximo de respuesta
-        if (cmd_def->max_response_time != 0) {
-            // ignora el tiempo indicado en la función y  en su lugar utiliza
-            // el que está definido para el comando (está en segundos)
-            ticks_to_wait = cmd_def->max_response_time * 1000;
+    // asigna el bit de finalización del comando
+    context.completion_bit = m_free_bits & (~m_free_bits + 1);
+    m_free_bits &= ~context.completion_bit;
+    m_completion_event_group.clear_flags(context.completion_bit);
+
+    context.ticks_to_wait = ticks_to_wait;
+    context.response_received = false;
+    context.sink_failed = false;
+    context.lines_received = 0;
+    context.state = at_cmd_state_t::QUEUED;
+    context.next = nullptr;
+    context.waiter = nullptr;
+    context.first_byte_time = 0;
+    context.bytes_sent = 0;
+    context.bytes_received = 0;
+
+    // agrega el comando al final de la cola; los urgentes van después de
+    // los urgentes que ya estaban en ella
+    sim7000_cmd_context_t *prev = m_queue_tail;
+    if (context.priority == cmd_priority_t::URGENT) {
+        prev = nullptr;
+        for (auto it = m_queue_head; it != nullptr && it->priority == cmd_priority_t::URGENT; it = it->next) {
+            prev = it;
         }
+    }
 
-        // añade 100 ms al tiempo de espera
-        ticks_to_wait += pdMS_TO_TICKS(100);
+    context.next = prev != nullptr ? prev->next : m_queue_head;
+    if (prev != nullptr) {
+        prev->next = &context;
+    } else {
+        m_queue_head = &context;
+    }
+    if (context.next == nullptr) {
+        m_queue_tail = &context;
     }
 
-    // espera hasta recibir la confirmación de que se ha empezado a leer la 
-    // respuesta o hasta que el tiempo de espera se haya agotado
-    ack = m_parser_event_group.wait_for_flags(
-        RESPONSE_STARTED_BIT, // bit de confirmación
-        true, // borra el bit una vez recibido
-        true, // solo espera un bit
-        ticks_to_wait // tiempo de espera
-    );
+    // asigna el token después de agregar el comando, por si se canceló
+    // mientras tanto
+    if (context.cancel_token != nullptr) {
+        context.cancel_token->m_context = &context;
+        context.cancel_token->m_modem = this;
 
-    // verifica si el comando requiere enviar una carga útil de datos
-    if (ack && context.send_payload) {
-        // espera hasta recibir el bit de confirmación
-        m_parser_event_group.wait_for_flags(
-            WAITING_CMD_PAYLOAD_BIT,
-            true,
-            true,
-            portMAX_DELAY
-        );
+        if (context.cancel_token->is_cancelled()) {
+            cancel_cmd_locked(context);
+            return ESP_OK;
+        }
+    }
 
-        ESP_LOGI(
-            TAG, 
-            "Writing command payload (%u bytes)",
-            context.payload.size()
-        );
+    check_drain_timeout();
 
-        // escribe la carga útil
-        on_cmd_write(context.payload.data(), context.payload.size());
-        // envia un enter
-        on_cmd_write(CR, 1);
+    // si no hay un comando en curso, envía el siguiente de inmediato
+    if (m_cmd_context == nullptr) {
+        if (!m_is_draining) start_next_cmd();
+    } else if (context.priority == cmd_priority_t::URGENT) {
+        preempt_running_cmd();
     }
 
-    // verifica si se recibio la confirmación de respuesta recibida
-    if (ack) {
-        // espera hasta recibir la confirmación de respuesta completada
-        ack = m_parser_event_group.wait_for_flags(
-            RESPONSE_COMPLETED_BIT, // bit de confirmación
+    return ESP_OK;
+}
+
+esp_err_t SIM7000_BasicModem::wait_for_cmd(internal::sim7000_cmd_context_t &context)
+{
+    if (context.state == at_cmd_state_t::IDLE) return ESP_ERR_INVALID_STATE;
+
+    const uint32_t bit = context.completion_bit;
+    uint32_t flags;
+
+    while (true) {
+        // espera hasta recibir la notificación de finalización
+        flags = m_completion_event_group.wait_for_flags(
+            bit, // bit de confirmación
             true, // borra el bit una vez recibido
             true, // solo espera un bit
-            ticks_to_wait // tiempo de espera
+            std::max<TickType_t>(get_cmd_remaining_ticks(context), 1)
         );
+
+        if (flags & bit) break;
+
+        std::lock_guard lock(m_queue_mutex);
+
+        // verifica si el comando finalizó justo después de agotarse la espera
+        if (context.state == at_cmd_state_t::COMPLETED) continue;
+
+        // un comando cancelado que no termina no debe detener la cola
+        check_drain_timeout();
+        if (context.state == at_cmd_state_t::COMPLETED) continue;
+
+        // verifica si el comando está en curso y se agotó su tiempo de espera
+        // (mientras está en la cola no corre el tiempo de respuesta)
+        if (check_cmd_timeout(context)) return ESP_ERR_TIMEOUT;
     }
 
-    // verifica si se ha recibido la respuesta
-    if (ack) {
-        switch (result_info->result) {
-            case at_cmd_result_t::OK:
-                if (result_info->response.length() > 0) {
-                    ESP_LOGD(
-                        TAG,
-                        "Command execution successful (%u bytes received)",
-                        result_info->response.length()
-                    );
-
-                    /* ESP_LOG_BUFFER_HEX(
-                        TAG, 
-                        result_info->response.c_str(),
-                        result_info->response.length()
-                    ); */
-                } else {
-                    ESP_LOGD(TAG, "Command execution successful");
-                }
-                err = ESP_OK;
-                break;
-            case at_cmd_result_t::ERROR:
-                ESP_LOGE(TAG, "Command execution failed");
-                err = ESP_FAIL;
-                break;
-            case at_cmd_result_t::CME_ERROR:
-                ESP_LOGE(
-                    TAG,
-                    "Command execution failed due to Mobbile Equipment error (%d)",
-                    result_info->error_code
-                );
-                err = ESP_ERR_INVALID_STATE;
-                break;
-            case at_cmd_result_t::CMS_ERROR:
-                ESP_LOGE(
-                    TAG,
-                    "Command execution failed due to Message or Network error (%d)",
-                    result_info->error_code
-                );
-                err = ESP_ERR_NOT_ALLOWED;
-                break;
-            case at_cmd_result_t::BUFFER_OVF:
-                ESP_LOGE(TAG, "Failed to read command response (buffer overflow)");
-                err = ESP_ERR_INVALID_SIZE;
-                break;
-            default:
-                ESP_LOGE(TAG, "Unrecognized command response");
-                err = ESP_ERR_INVALID_RESPONSE;
-                break;
+    std::lock_guard lock(m_queue_mutex);
+    release_slot(context);
+
+    return get_cmd_err(*context.result_info);
+}
+
+esp_err_t SIM7000_BasicModem::poll_cmd(internal::sim7000_cmd_context_t &context)
+{
+    std::lock_guard lock(m_queue_mutex);
+
+    switch (context.state)
+    {
+        case at_cmd_state_t::IDLE:
+            return ESP_ERR_INVALID_STATE;
+        case at_cmd_state_t::COMPLETED:
+            m_completion_event_group.clear_flags(context.completion_bit);
+            release_slot(context);
+            return get_cmd_err(*context.result_info);
+        default:
+            check_drain_timeout();
+            return check_cmd_timeout(context) ? ESP_ERR_TIMEOUT : ESP_ERR_NOT_FINISHED;
+    }
+}
+
+esp_err_t SIM7000_BasicModem::cancel_cmd(internal::sim7000_cmd_context_t &context)
+{
+    std::lock_guard lock(m_queue_mutex);
+    return cancel_cmd_locked(context) ? ESP_OK : ESP_ERR_INVALID_STATE;
+}
+
+/* Ejecución asíncrona */
+
+// suspende la corrutina hasta que el comando finaliza o hasta que se cumple
+// su tiempo de espera, lo que ocurra primero
+struct SIM7000_BasicModem::cmd_awaiter_t
+{
+    SIM7000_BasicModem &modem;
+    sim7000_cmd_context_t &context;
+    threading::Executor &executor;
+    threading::Waiter waiter;
+
+    bool await_ready() const { return false; }
+
+    bool await_suspend(std::coroutine_handle<> handle)
+    {
+        waiter.arm(handle, executor);
+
+        // mientras el comando está en la cola se revisa de nuevo al cumplirse
+        // el tiempo de espera completo
+        TickType_t ticks = std::max<TickType_t>(modem.get_cmd_remaining_ticks(context), 1);
+        if (!executor.add_timer(waiter, ticks)) {
+            // sin temporizador no se puede suspender; cede la CPU y reintenta
+            vTaskDelay(1);
+            return false;
         }
-    } else {
-        ESP_LOGW(TAG, "Response timed out");
-        err = ESP_ERR_TIMEOUT;
+
+        // si el comando ya terminó, continúa sin suspenderse
+        if (!modem.set_cmd_waiter(context, &waiter)) {
+            executor.cancel_timer(waiter);
+            return false;
+        }
+
+        return true;
+    }
+
+    void await_resume()
+    {
+        modem.set_cmd_waiter(context, nullptr);
+    }
+};
+
+threading::Async<esp_err_t> SIM7000_BasicModem::exec(
+    internal::sim7000_cmd_context_t &context,
+    TickType_t ticks_to_wait)
+{
+    threading::Executor *executor = threading::Executor::current();
+    esp_err_t err;
+
+    if (executor == nullptr) co_return ESP_ERR_INVALID_STATE;
+
+    // espera un lugar en la cola sin bloquear la tarea del ejecutor, puesto
+    // que los lugares los liberan otras corrutinas de la misma tarea
+    while ((err = enqueue_cmd(context, ticks_to_wait, 0)) == ESP_ERR_TIMEOUT) {
+        co_await threading::Executor::sleep(pdMS_TO_TICKS(ASYNC_RETRY_INTERVAL_MS));
     }
 
-    // restablece el contexto del comando
-    //context.reset();
+    if (err != ESP_OK) co_return err;
+
+    while ((err = poll_cmd(context)) == ESP_ERR_NOT_FINISHED) {
+        co_await cmd_awaiter_t{*this, context, *executor, {}};
+    }
+
+    co_return err;
+}
+
+threading::Async<esp_err_t> SIM7000_BasicModem::exec(
+    internal::at_cmd_t command,
+    SIM7000_CmdSlot &slot,
+    TickType_t ticks_to_wait)
+{
+    if (!slot) co_return ESP_ERR_INVALID_ARG;
+
+    sim7000_cmd_context_t context;
+    context.command = command;
+    context.params = slot.get_params();
+    context.result_info = &slot.get_result_info();
+
+    co_return co_await exec(context, ticks_to_wait);
+}
+
+threading::Async<SIM7000_CmdSlot> SIM7000_BasicModem::acquire_cmd_slot_async()
+{
+    // fuera de un ejecutor no es posible suspenderse
+    if (threading::Executor::current() == nullptr) {
+        co_return m_cmd_pool.acquire();
+    }
+
+    SIM7000_CmdSlot slot;
+    while (!(slot = m_cmd_pool.acquire(0))) {
+        co_await threading::Executor::sleep(pdMS_TO_TICKS(ASYNC_RETRY_INTERVAL_MS));
+    }
+
+    co_return std::move(slot);
+}
+
+bool SIM7000_BasicModem::check_cmd_timeout(internal::sim7000_cmd_context_t &context)
+{
+    if (context.state != at_cmd_state_t::IN_PROGRESS ||
+        xTaskGetTickCount() - context.started_at < context.ticks_to_wait) {
+        return false;
+    }
+
+    ESP_LOGW(
+        TAG,
+        "Response timed out (%s)",
+        get_command_def(context.command)->string
+    );
+
+    // la respuesta aún puede llegar; se descarta antes de enviar el
+    // siguiente comando
+    abandon_running_cmd(at_cmd_result_t::NO_ANSWER);
+    m_completion_event_group.clear_flags(context.completion_bit);
+    release_slot(context);
+    on_cmd_timeout(++m_consecutive_timeouts);
+
+    return true;
+}
+
+bool SIM7000_BasicModem::set_cmd_waiter(
+    internal::sim7000_cmd_context_t &context,
+    threading::Waiter *waiter)
+{
+    std::lock_guard lock(m_queue_mutex);
+
+    // finish_cmd() ya no despertará a la corrutina
+    if (waiter != nullptr && context.state == at_cmd_state_t::COMPLETED) {
+        return false;
+    }
+
+    context.waiter = waiter;
+    return true;
+}
+
+TickType_t SIM7000_BasicModem::get_cmd_remaining_ticks(const internal::sim7000_cmd_context_t &context)
+{
+    std::lock_guard lock(m_queue_mutex);
+
+    if (context.state == at_cmd_state_t::QUEUED) {
+        // se revisa de nuevo cuando vence la espera de un comando cancelado
+        if (m_is_draining) {
+            TickType_t elapsed = xTaskGetTickCount() - m_drain_started_at;
+            TickType_t limit = pdMS_TO_TICKS(CMD_DRAIN_TIMEOUT_MS);
+            return std::min(context.ticks_to_wait, elapsed < limit ? limit - elapsed : 0);
+        }
+
+        return context.ticks_to_wait;
+    }
+
+    if (context.state == at_cmd_state_t::IN_PROGRESS) {
+        TickType_t elapsed = xTaskGetTickCount() - context.started_at;
+        return elapsed < context.ticks_to_wait ? context.ticks_to_wait - elapsed : 0;
+    }
+
+    return 0;
+}
+
+TickType_t SIM7000_BasicModem::get_cmd_timeout(const at_cmd_def_t &cmd_def, bool is_query)
+{
+    uint32_t limit_ms = 0;
+
+    // los comandos de consulta responden de inmediato
+    if (is_query) {
+        limit_ms = QUERY_CMD_TIMEOUT_MS;
+    }
+    // verifica si el comando define un tiempo máximo de respuesta (está en
+    // segundos)
+    else if (cmd_def.max_response_time != 0) {
+        limit_ms = cmd_def.max_response_time * 1000;
+    }
+
+    // añade 100 ms al tiempo de espera
+    limit_ms += 100;
+
+    // ajusta el tiempo de espera según la latencia observada del comando
+    uint32_t timeout_ms = m_cmd_stats.get_adaptive_timeout(cmd_def.command, limit_ms);
+    return pdMS_TO_TICKS(timeout_ms);
+}
+
+void SIM7000_BasicModem::start_next_cmd()
+{
+    sim7000_cmd_context_t *context = m_queue_head;
+    if (context == nullptr || m_is_data_mode) return;
+
+    // quita el comando de la cola
+    m_queue_head = context->next;
+    if (m_queue_head == nullptr) {
+        m_queue_tail = nullptr;
+    }
+
+    context->next = nullptr;
+    context->state = at_cmd_state_t::IN_PROGRESS;
+    context->started_at = xTaskGetTickCount();
+    context->sent_time = esp_timer_get_time();
+    m_cmd_context = context;
+
+    const at_cmd_def_t *cmd_def = get_command_def(context->command);
+    size_t length = build_cmd_line(*cmd_def, context->params, m_cmd_line);
+
+    if (length == 0) {
+        ESP_LOGE(TAG, "Command line is too long (%s)", cmd_def->string);
+        context->result_info->result = at_cmd_result_t::BUFFER_OVF;
+        finish_cmd();
+        return;
+    }
+
+    // escribe la línea con el retorno de carro para indicar ejecutar el comando
+    ESP_LOGD(TAG, "Executing '%.*s'...", (int)length - 1, m_cmd_line);
+    on_cmd_write(m_cmd_line, length);
+    context->bytes_sent += length;
+}
+
+void SIM7000_BasicModem::finish_cmd()
+{
+    if (m_cmd_context == nullptr) return;
+
+    sim7000_cmd_context_t *context = m_cmd_context;
     m_cmd_context = nullptr;
-    // hace que el modem esté disponible de nuevo
-    m_parser_event_group.set_flags(MODEM_AVAILABLE_BIT);
+    m_cmd_stats.record(*context, esp_timer_get_time());
+
+    // envía el siguiente comando en cuanto se libera el canal (si se canceló
+    // el comando, hasta que se descarte su respuesta)
+    if (!m_is_draining) start_next_cmd();
+    complete_cmd(*context);
+}
+
+void SIM7000_BasicModem::complete_cmd(internal::sim7000_cmd_context_t &context)
+{
+    context.state = at_cmd_state_t::COMPLETED;
+
+    // notifica al solicitante que el comando ha finalizado
+    m_completion_event_group.set_flags(context.completion_bit);
+    if (context.waiter != nullptr) {
+        context.waiter->wake();
+    }
+}
+
+bool SIM7000_BasicModem::cancel_cmd_locked(internal::sim7000_cmd_context_t &context)
+{
+    if (context.state == at_cmd_state_t::IN_PROGRESS) {
+        cancel_running_cmd();
+        return true;
+    }
+
+    if (context.state != at_cmd_state_t::QUEUED) return false;
+
+    // quita el comando de la cola sin enviarlo
+    sim7000_cmd_context_t *prev = nullptr;
+    for (auto it = m_queue_head; it != nullptr; prev = it, it = it->next) {
+        if (it != &context) continue;
+
+        if (prev != nullptr) {
+            prev->next = it->next;
+        } else {
+            m_queue_head = it->next;
+        }
+        if (m_queue_tail == it) {
+            m_queue_tail = prev;
+        }
+        break;
+    }
+
+    ESP_LOGW(TAG, "Queued command cancelled (%s)", get_command_def(context.command)->string);
+    context.next = nullptr;
+    context.result_info->result = at_cmd_result_t::CANCELLED;
+    complete_cmd(context);
+
+    return true;
+}
+
+void SIM7000_BasicModem::cancel_by_token(SIM7000_CancelToken &token)
+{
+    std::lock_guard lock(m_queue_mutex);
+
+    if (token.m_context != nullptr) {
+        cancel_cmd_locked(*token.m_context);
+    }
+}
+
+void SIM7000_BasicModem::cancel_running_cmd()
+{
+    sim7000_cmd_context_t *context = m_cmd_context;
+
+    ESP_LOGW(TAG, "Command in progress cancelled (%s)", get_command_def(context->command)->string);
+
+    // el modem aborta los comandos que lo permiten al recibir cualquier
+    // carácter; los demás lo ignoran
+    on_cmd_write(CR, 1);
+    abandon_running_cmd(at_cmd_result_t::CANCELLED);
+}
+
+void SIM7000_BasicModem::abandon_running_cmd(at_cmd_result_t result)
+{
+    sim7000_cmd_context_t *context = m_cmd_context;
+
+    // el contexto ya no se utiliza; el resto de la respuesta se descarta
+    // hasta recibir el código de resultado final, para que no se atribuya al
+    // siguiente comando
+    m_is_draining = true;
+    m_drain_expects_prompt = context->send_payload && !context->payload_sent;
+    m_drain_started_at = xTaskGetTickCount();
+
+    context->result_info->result = result;
+    finish_cmd();
+}
+
+void SIM7000_BasicModem::preempt_running_cmd()
+{
+    sim7000_cmd_context_t *context = m_cmd_context;
+
+    // los comandos con carga útil no se interrumpen para no dejar una
+    // publicación a medias
+    if (context->priority != cmd_priority_t::NORMAL || context->send_payload) return;
+
+    // un comando que terminará pronto no se interrumpe
+    TickType_t elapsed = xTaskGetTickCount() - context->started_at;
+    if (elapsed >= context->ticks_to_wait ||
+        context->ticks_to_wait - elapsed <= pdMS_TO_TICKS(CMD_PREEMPT_THRESHOLD_MS)) {
+        return;
+    }
+
+    ESP_LOGW(TAG, "Preempting command for urgent request");
+    cancel_running_cmd();
+}
+
+void SIM7000_BasicModem::drain_line(std::string_view line)
+{
+    // termina al recibir el código de resultado del comando abandonado
+    if (is_final_result(line)) {
+        ESP_LOGD(TAG, "Abandoned command response discarded");
+        end_drain();
+    }
+}
+
+void SIM7000_BasicModem::check_drain_timeout()
+{
+    if (!m_is_draining ||
+        xTaskGetTickCount() - m_drain_started_at < pdMS_TO_TICKS(CMD_DRAIN_TIMEOUT_MS)) {
+        return;
+    }
+
+    ESP_LOGW(TAG, "Abandoned command did not finish, sending next command");
+    m_stale_results++;
+    end_drain();
+}
+
+void SIM7000_BasicModem::end_drain()
+{
+    m_is_draining = false;
+    m_drain_expects_prompt = false;
+    start_next_cmd();
+}
+
+void SIM7000_BasicModem::release_slot(internal::sim7000_cmd_context_t &context)
+{
+    m_free_bits |= context.completion_bit;
+    context.completion_bit = 0;
+    context.state = at_cmd_state_t::IDLE;
+
+    // el token ya no puede cancelar este contexto
+    if (context.cancel_token != nullptr && context.cancel_token->m_context == &context) {
+        context.cancel_token->m_context = nullptr;
+        context.cancel_token->m_modem = nullptr;
+    }
+
+    xSemaphoreGive(m_slot_semaphore);
+}
+
+esp_err_t SIM7000_BasicModem::get_cmd_err(const internal::sim7000_cmd_result_info_t &info)
+{
+    esp_err_t err;
+
+    switch (info.result) {
+        case at_cmd_result_t::OK:
+            if (info.response.length() > 0) {
+                ESP_LOGD(
+                    TAG,
+                    "Command execution successful (%u bytes received)",
+                    info.response.length()
+                );
+            } else {
+                ESP_LOGD(TAG, "Command execution successful");
+            }
+            err = ESP_OK;
+            break;
+        case at_cmd_result_t::ERROR:
+            ESP_LOGE(TAG, "Command execution failed");
+            err = ESP_FAIL;
+            break;
+        case at_cmd_result_t::CME_ERROR:
+            ESP_LOGE(
+                TAG,
+                "Command execution failed due to Mobbile Equipment error (%d)",
+                info.error_code
+            );
+            err = ESP_ERR_INVALID_STATE;
+            break;
+        case at_cmd_result_t::CMS_ERROR:
+            ESP_LOGE(
+                TAG,
+                "Command execution failed due to Message or Network error (%d)",
+                info.error_code
+            );
+            err = ESP_ERR_NOT_ALLOWED;
+            break;
+        case at_cmd_result_t::BUFFER_OVF:
+            ESP_LOGE(TAG, "Failed to read command response (buffer overflow)");
+            err = ESP_ERR_INVALID_SIZE;
+            break;
+        case at_cmd_result_t::CANCELLED:
+            ESP_LOGW(TAG, "Command execution cancelled");
+            err = ESP_ERR_TIMEOUT;
+            break;
+        default:
+            ESP_LOGE(TAG, "Unrecognized command response");
+            err = ESP_ERR_INVALID_RESPONSE;
+            break;
+    }
 
     return err;
 }
 
 void SIM7000_BasicModem::feed_buffer(const char *buffer, size_t length)
 {
-    // agrega la parte recibida al buffer
-    m_parser_buffer.append(buffer, length);
+    while (length > 0) {
+        // copia la parte que quepa en el buffer y la procesa
+        size_t written = m_framer.write(buffer, length);
+        if (written == 0) {
+            ESP_LOGE(TAG, "Parser buffer is full, dropping %u bytes", length);
+            return;
+        }
+
+        buffer += written;
+        length -= written;
+        try_parse();
+    }
+}
+
+std::span<char> SIM7000_BasicModem::get_parser_window()
+{
+    return m_framer.get_write_window();
+}
+
+void SIM7000_BasicModem::commit_parser_window(size_t length)
+{
+    m_framer.commit(length);
     try_parse();
 }
 
 void SIM7000_BasicModem::try_parse()
 {
-    bool is_completed = false;
-    size_t position;
-    
+    std::unique_lock lock(m_queue_mutex);
+    std::string_view line;
+    const urc_def_t *urc_def;
+
+    check_drain_timeout();
+
+    // los datos de la conexión no se separan en líneas
+    if (m_is_data_mode) {
+        forward_data();
+        return;
+    }
+
     // verifica si actualmente se está ejecutando un comando
     if (m_cmd_context != nullptr) {
         // verifica si no se ha marcado el comienzo de la respuesta
         if (!m_cmd_context->response_received) {
-            // notifica al receptor que se ha comenzado a recibir una respuesta
-            m_parser_event_group.set_flags(RESPONSE_STARTED_BIT);
+            // el tiempo de espera se cuenta de nuevo desde que comienza a
+            // recibirse la respuesta
+            m_cmd_context->started_at = xTaskGetTickCount();
+            m_cmd_context->first_byte_time = esp_timer_get_time();
             m_cmd_context->response_received = true;
         }
 
-        // verifica si se está ejecutando un comando que requiere enviar datos
-        if (m_cmd_context->send_payload && 
-            (position = m_parser_buffer.find(CRLF "> ")) != std::string::npos) {
-            m_parser_buffer.erase(position, 4);
-            m_parser_event_group.set_flags(WAITING_CMD_PAYLOAD_BIT);
-        }
-
         // verifica si se debe recibir una respuesta en crudo
         if (m_cmd_context->is_raw) {
             auto cmd_result = m_cmd_context->result_info;
-            // agrega el contenido obtenido
-            cmd_result->response.append(m_parser_buffer);
-            
             // verifica si el contenido del buffer termina en \r\n
-            if (m_parser_buffer.ends_with(CRLF)) {
+            bool is_completed = m_framer.ends_with(CRLF);
+
+            // entrega el contenido obtenido y lo borra del buffer
+            while (!(line = m_framer.peek()).empty()) {
+                m_cmd_context->bytes_received += line.length();
+                write_response(line);
+                m_framer.discard(line.length());
+            }
+
+            if (is_completed) {
+                m_consecutive_timeouts = 0;
                 // establece los valores de resultado
-                cmd_result->result = at_cmd_result_t::OK;
+                cmd_result->result = m_cmd_context->sink_failed ?
+                    at_cmd_result_t::BUFFER_OVF : at_cmd_result_t::OK;
                 // notifica que se ha recibido una respuesta
-                m_parser_event_group.set_flags(RESPONSE_COMPLETED_BIT);  
-            } 
-
-            // borra el contenido del buffer
-            m_parser_buffer.clear();
+                finish_cmd();
+            }
 
             // termina la función puesto que no necesita comprobar el formato
             // de la respuesta
@@ -305,72 +799,253 @@ void SIM7000_BasicModem::try_parse()
         }
     }
 
-    // busca el siguiente salto de línea
-    while ((position = m_parser_buffer.find(CRLF)) != std::string::npos) {
-        // copia la linea y la borra del buffer
-        std::string line = m_parser_buffer.substr(0, position);
-        m_parser_buffer.erase(0, position + 2);
+    do {
+        // verifica si se está ejecutando un comando que requiere enviar datos
+        // y si el modem ya envió el indicador "> " (sin salto de línea)
+        if (m_cmd_context != nullptr &&
+            m_cmd_context->send_payload &&
+            m_framer.starts_with("> ")) {
+            m_framer.discard(2);
+
+            ESP_LOGI(
+                TAG,
+                "Writing command payload (%u bytes)",
+                m_cmd_context->payload.size()
+            );
+
+            // escribe la carga útil
+            on_cmd_write(
+                m_cmd_context->payload.data(),
+                m_cmd_context->payload.size()
+            );
+            // envia un enter
+            on_cmd_write(CR, 1);
+            m_cmd_context->bytes_sent += m_cmd_context->payload.size() + 1;
+            m_cmd_context->payload_sent = true;
+        }
+        // la carga útil de un comando cancelado pudo haberse liberado, por lo
+        // que se cancela el envío con ESC
+        else if (m_is_draining &&
+                 m_drain_expects_prompt &&
+                 m_framer.starts_with("> ")) {
+            m_framer.discard(2);
+            on_cmd_write(ESC, 1);
+            m_drain_expects_prompt = false;
+        }
 
+        // busca el siguiente salto de línea
+        if (!m_framer.next_line(line)) break;
         // omite el proceso si la línea está vacía
         if (line.empty()) continue;
 
-        // verifica si el mensaje es un URC
-        if (check_if_is_urc(line)) {
-            on_urc_message(line);
+        // clasifica la línea una sola vez y verifica si el mensaje es un URC
+        urc_def = get_urc_def(line);
+        // las respuestas a consultas (p. ej. "+CGREG: 0,1") tienen el mismo
+        // formato que su URC; si el comando en ejecución las solicitó, forman
+        // parte de su respuesta
+        if (urc_def != nullptr &&
+            m_cmd_context != nullptr &&
+            is_query_response(*m_cmd_context, *urc_def)) {
+            urc_def = nullptr;
+        }
+        // durante una llamada de datos, CONNECT es el resultado del comando
+        // de marcado y no un URC
+        if (urc_def != nullptr &&
+            m_cmd_context != nullptr &&
+            is_dial_cmd(*m_cmd_context) &&
+            line.starts_with("CONNECT")) {
+            urc_def = nullptr;
+        }
+
+        if (urc_def != nullptr) {
+            // libera la cola mientras se procesa el mensaje para no bloquear
+            // a los solicitantes de comandos
+            lock.unlock();
+            on_urc_message(line, *urc_def);
+            lock.lock();
         }
         // de lo contrario,verifica si actualmente se está ejecutando un comando
-        else if (m_cmd_context != nullptr) { 
-            auto cmd_result = m_cmd_context->result_info;
-            std::string &response = cmd_result->response;
-
-            // verifica el contenido de la línea
-            if (line == "OK") {
-                cmd_result->result = at_cmd_result_t::OK;
-                is_completed = true;
-            } else if (line == "ERROR") {
-                cmd_result->result = at_cmd_result_t::ERROR;
-                is_completed = true;
-            } else if (line.starts_with("+CME ERROR")) {
-                cmd_result->result = at_cmd_result_t::CME_ERROR;
-                cmd_result->error_code = read_error_code(line);
-                is_completed = true;
-            } else if (line.starts_with("+CMS ERROR")) {
-                cmd_result->result = at_cmd_result_t::CMS_ERROR;
-                cmd_result->error_code = read_error_code(line);
-                is_completed = true;
-            } 
-                
-            // verifica si el comando se ha completado
-            if (is_completed) {
-                // borra del final cualquier salto de línea excedente
-                while (response.ends_with(CRLF)) {
-                    response.erase(response.length() -2, 2);
-                }
-                
-                // notifica que se ha recibido una respuesta
-                m_parser_event_group.set_flags(RESPONSE_COMPLETED_BIT);
-            } else {
-                // si no ha terminado, agrega la línea al final de la respuesta
-                // junto a un final de la línea, puesto que forma parte de la
-                // respuesta
-                response.append(line);
-                response.append(CRLF);
+        else if (m_cmd_context != nullptr) {
+            parse_line(line);
+
+            // lo que sigue a CONNECT ya son datos de la conexión
+            if (m_is_data_mode) {
+                forward_data();
+                return;
             }
-        } 
+        }
+        // o si se descarta la respuesta de un comando cancelado
+        else if (m_is_draining) {
+            drain_line(line);
+        }
+        // resultado tardío de un comando cancelado
+        else if (m_stale_results > 0 && is_final_result(line)) {
+            m_stale_results--;
+        }
+    } while (true);
+}
+
+void SIM7000_BasicModem::parse_line(std::string_view line)
+{
+    bool is_completed = false;
+    auto cmd_result = m_cmd_context->result_info;
+    // cuenta la línea con su final (CRLF)
+    m_cmd_context->bytes_received += line.length() + 2;
+
+    // verifica el contenido de la línea
+    if (line == "OK") {
+        cmd_result->result = at_cmd_result_t::OK;
+        is_completed = true;
+    } else if (line == "ERROR") {
+        cmd_result->result = at_cmd_result_t::ERROR;
+        is_completed = true;
+    } else if (line.starts_with("+CME ERROR")) {
+        cmd_result->result = at_cmd_result_t::CME_ERROR;
+        cmd_result->error_code = read_error_code(line);
+        is_completed = true;
+    } else if (line.starts_with("+CMS ERROR")) {
+        cmd_result->result = at_cmd_result_t::CMS_ERROR;
+        cmd_result->error_code = read_error_code(line);
+        is_completed = true;
+    } else if (line.starts_with("CONNECT") && is_dial_cmd(*m_cmd_context)) {
+        // el modem pasa a modo de datos
+        cmd_result->result = at_cmd_result_t::OK;
+        m_is_data_mode = true;
+        is_completed = true;
+    } else if (line == "NO CARRIER") {
+        cmd_result->result = at_cmd_result_t::ERROR;
+        is_completed = true;
+    }
+
+    // un comando con carga útil no puede terminar con éxito antes de
+    // enviarla, por lo que el OK es de un comando cancelado anteriormente
+    if (is_completed &&
+        m_stale_results > 0 &&
+        cmd_result->result == at_cmd_result_t::OK &&
+        m_cmd_context->send_payload &&
+        !m_cmd_context->payload_sent) {
+        ESP_LOGW(TAG, "Discarding late result of a cancelled command");
+        cmd_result->result = at_cmd_result_t::UNKNOWN;
+        m_stale_results--;
+        return;
+    }
+
+    // verifica si el comando se ha completado
+    if (is_completed) {
+        // cualquier resultado indica que el modem sigue respondiendo
+        m_consecutive_timeouts = 0;
+
+        // verifica si el receptor de la respuesta no pudo almacenarla
+        if (m_cmd_context->sink_failed && 
+            cmd_result->result == at_cmd_result_t::OK) {
+            cmd_result->result = at_cmd_result_t::BUFFER_OVF;
+        }
+
+        // notifica que se ha recibido una respuesta
+        finish_cmd();
+
+        // los comandos en espera no pueden enviarse mientras el canal
+        // transporta datos
+        while (m_is_data_mode && m_queue_head != nullptr) {
+            cancel_cmd_locked(*m_queue_head);
+        }
+    } else {
+        // si no ha terminado, agrega la línea a la respuesta separándola de
+        // la anterior con un final de línea, puesto que forma parte de la
+        // respuesta
+        if (m_cmd_context->lines_received++ > 0) {
+            write_response(CRLF);
+        }
+
+        write_response(line);
     }
 }
 
-bool SIM7000_BasicModem::is_urc(const std::string &line)
+void SIM7000_BasicModem::write_response(std::string_view chunk)
+{
+    sim7000_cmd_context_t *context = m_cmd_context;
+
+    // verifica si la respuesta se entrega a un receptor externo
+    if (context->sink != nullptr) {
+        // una vez que falla se descarta el resto de la respuesta
+        if (!context->sink_failed && !context->sink->write(chunk)) {
+            ESP_LOGW(TAG, "Response sink rejected %u bytes", chunk.length());
+            context->sink_failed = true;
+        }
+    } else {
+        context->result_info->response.append(chunk);
+    }
+}
+
+void SIM7000_BasicModem::forward_data()
+{
+    std::string_view chunk;
+
+    while (!(chunk = m_framer.peek()).empty()) {
+        on_data_received(chunk.data(), chunk.length());
+        m_framer.discard(chunk.length());
+    }
+}
+
+void SIM7000_BasicModem::leave_data_mode()
+{
+    std::lock_guard lock(m_queue_mutex);
+    if (!m_is_data_mode) return;
+
+    // descarta los datos de la conexión que no se entregaron
+    m_framer.clear();
+    m_is_data_mode = false;
+    ESP_LOGI(TAG, "Command mode restored");
+}
+
+bool SIM7000_BasicModem::is_urc(std::string_view line)
 {
     return check_if_is_urc(line);
 }
 
-int SIM7000_BasicModem::read_error_code(const std::string &line)
+bool SIM7000_BasicModem::is_final_result(std::string_view line)
+{
+    return line == "OK" ||
+        line == "ERROR" ||
+        line.starts_with("+CME ERROR") ||
+        line.starts_with("+CMS ERROR") ||
+        line == "NO CARRIER";
+}
+
+bool SIM7000_BasicModem::is_dial_cmd(const internal::sim7000_cmd_context_t &context)
+{
+    // ATD*99# (o ATD*99***<cid>#) solicita un contexto PDP en modo de datos
+    return context.command == at_cmd_t::D;
+}
+
+bool SIM7000_BasicModem::is_query_response(
+    const internal::sim7000_cmd_context_t &context,
+    const internal::urc_def_t &def)
+{
+    const at_cmd_def_t *cmd_def = get_command_def(context.command);
+    std::string_view identifier = def.identifier;
+    std::string_view params(context.params.data(), context.params.size());
+    size_t pos;
+
+    if (cmd_def == nullptr || identifier.empty()) return false;
+
+    // consulta del propio comando ("AT+CPIN?")
+    if (params.starts_with('?') && cmd_def->prefix.substr(2) == identifier) {
+        return true;
+    }
+
+    // consultas concatenadas en la misma línea ("AT+CSQ;+CGREG?")
+    pos = params.find(identifier);
+    return pos != std::string_view::npos &&
+        params.substr(pos + identifier.length()).starts_with('?');
+}
+
+int SIM7000_BasicModem::read_error_code(std::string_view line)
 {
-    int offset = line.find_first_of(": ");
+    size_t offset = line.find_first_of(": ");
     int code = -1;
 
-    if (offset != std::string::npos && offset + 2 < line.length()) {
+    if (offset != std::string_view::npos && offset + 2 < line.length()) {
         code = helpers::to_number<int>(line, offset + 2);
     }
 
@@ -0,0 +1,26 @@
+#include "sim7000_cancel_token.hpp"
+#include "sim7000_basic_modem.hpp"
+
+namespace axomotor::lte_modem {
+
+/* SIM7000 Cancel Token */
+
+SIM7000_CancelToken::SIM7000_CancelToken() :
+    m_is_cancelled{false},
+    m_modem{nullptr},
+    m_context{nullptr}
+{ }
+
+void SIM7000_CancelToken::cancel()
+{
+    // se marca antes de consultar el modem para que un comando que se está
+    // agregando a la cola también lo detecte
+    m_is_cancelled = true;
+
+    SIM7000_BasicModem *modem = m_modem;
+    if (modem != nullptr) {
+        modem->cancel_by_token(*this);
+    }
+}
+
+} // namespace axomotor::lte_modem
@@ -0,0 +1,139 @@
+#include "sim7000_cmd_pool.hpp"
+
+#include <cstdarg>
+#include <cstdio>
+#include <utility>
+
+namespace axomotor::lte_modem {
+
+using namespace axomotor::lte_modem::internal;
+
+/* SIM7000 Command Slot */
+
+SIM7000_CmdSlot::SIM7000_CmdSlot() :
+    m_pool{nullptr},
+    m_slot{nullptr}
+{ }
+
+SIM7000_CmdSlot::SIM7000_CmdSlot(SIM7000_CmdPool *pool, sim7000_cmd_slot_t *slot) :
+    m_pool{pool},
+    m_slot{slot}
+{ }
+
+SIM7000_CmdSlot::SIM7000_CmdSlot(SIM7000_CmdSlot &&other) :
+    m_pool{std::exchange(other.m_pool, nullptr)},
+    m_slot{std::exchange(other.m_slot, nullptr)}
+{ }
+
+SIM7000_CmdSlot::~SIM7000_CmdSlot()
+{
+    release();
+}
+
+esp_err_t SIM7000_CmdSlot::format_params(const char *format, ...)
+{
+    if (m_slot == nullptr) return ESP_ERR_INVALID_STATE;
+
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(m_slot->params, sizeof(m_slot->params), format, args);
+    va_end(args);
+
+    if (length < 0 || (size_t)length >= sizeof(m_slot->params)) {
+        m_slot->params_length = 0;
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    m_slot->params_length = length;
+    return ESP_OK;
+}
+
+std::span<const char> SIM7000_CmdSlot::get_params() const
+{
+    if (m_slot == nullptr) return std::span<const char>();
+    return std::span<const char>(m_slot->params, m_slot->params_length);
+}
+
+sim7000_cmd_result_info_t &SIM7000_CmdSlot::get_result_info()
+{
+    return m_slot->result_info;
+}
+
+std::string &SIM7000_CmdSlot::get_response()
+{
+    return m_slot->result_info.response;
+}
+
+SIM7000_CmdSlot &SIM7000_CmdSlot::operator=(SIM7000_CmdSlot &&other)
+{
+    if (this != &other) {
+        release();
+        m_pool = std::exchange(other.m_pool, nullptr);
+        m_slot = std::exchange(other.m_slot, nullptr);
+    }
+
+    return *this;
+}
+
+void SIM7000_CmdSlot::release()
+{
+    if (m_pool != nullptr && m_slot != nullptr) {
+        m_pool->release(m_slot);
+    }
+
+    m_pool = nullptr;
+    m_slot = nullptr;
+}
+
+/* SIM7000 Command Pool */
+
+SIM7000_CmdPool::SIM7000_CmdPool(size_t slot_count, size_t response_size) :
+    m_slot_count{slot_count},
+    m_slots{new sim7000_cmd_slot_t[slot_count]},
+    m_free_mask{(uint32_t)((1ULL << slot_count) - 1)}
+{
+    assert(slot_count > 0 && slot_count <= 32);
+
+    m_semaphore = xSemaphoreCreateCounting(slot_count, slot_count);
+    assert(m_semaphore);
+
+    // reserva la memoria de las respuestas desde el inicio
+    for (size_t i = 0; i < m_slot_count; i++) {
+        m_slots[i].result_info.response.reserve(response_size);
+        m_slots[i].params_length = 0;
+    }
+}
+
+SIM7000_CmdPool::~SIM7000_CmdPool()
+{
+    vSemaphoreDelete(m_semaphore);
+}
+
+SIM7000_CmdSlot SIM7000_CmdPool::acquire(TickType_t ticks_to_wait)
+{
+    // espera hasta que haya un espacio disponible
+    if (xSemaphoreTake(m_semaphore, ticks_to_wait) != pdTRUE) {
+        return SIM7000_CmdSlot();
+    }
+
+    std::lock_guard lock(m_mutex);
+    // toma el primer espacio libre
+    size_t index = __builtin_ctz(m_free_mask);
+    m_free_mask &= ~(1UL << index);
+
+    sim7000_cmd_slot_t *slot = &m_slots[index];
+    slot->params_length = 0;
+    slot->result_info.reset();
+
+    return SIM7000_CmdSlot(this, slot);
+}
+
+void SIM7000_CmdPool::release(sim7000_cmd_slot_t *slot)
+{
+    std::lock_guard lock(m_mutex);
+    size_t index = slot - m_slots.get();
+    m_free_mask |= 1UL << index;
+    xSemaphoreGive(m_semaphore);
+}
+
+} // namespace axomotor::lte_modem
@@ -0,0 +1,283 @@
+#include "sim7000_cmd_stats.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstdio>
+#include <esp_log.h>
+
+namespace axomotor::lte_modem {
+
+using namespace axomotor::lte_modem::internal;
+
+static const char *TAG = "sim7000:stats";
+
+/* Histograma */
+
+void cmd_histogram_t::add(uint32_t time_ms)
+{
+    buckets[get_bucket(time_ms)]++;
+
+    // reduce los contadores a la mitad para dar más peso a las muestras
+    // recientes (también evita que se desborden)
+    if (total() >= CMD_HISTOGRAM_WINDOW) {
+        for (uint16_t &count : buckets) count >>= 1;
+    }
+}
+
+uint32_t cmd_histogram_t::total() const
+{
+    uint32_t total = 0;
+    for (uint16_t count : buckets) total += count;
+    return total;
+}
+
+uint32_t cmd_histogram_t::percentile(uint8_t percent) const
+{
+    uint32_t count = total();
+    if (count == 0) return 0;
+
+    // cantidad de muestras que deben quedar por debajo del percentil
+    uint32_t target = (count * percent + 99) / 100;
+    uint32_t accumulated = 0;
+
+    for (size_t i = 0; i < CMD_HISTOGRAM_BUCKETS; i++) {
+        accumulated += buckets[i];
+        if (accumulated >= target && accumulated > 0) {
+            return get_bucket_limit(i);
+        }
+    }
+
+    return get_bucket_limit(CMD_HISTOGRAM_BUCKETS - 1);
+}
+
+size_t cmd_histogram_t::get_bucket(uint32_t time_ms)
+{
+    size_t bucket = std::bit_width(time_ms);
+    return bucket < CMD_HISTOGRAM_BUCKETS ? bucket : CMD_HISTOGRAM_BUCKETS - 1;
+}
+
+uint32_t cmd_histogram_t::get_bucket_limit(size_t bucket)
+{
+    return 1UL << bucket;
+}
+
+/* Estadísticas de comandos */
+
+SIM7000_CmdStats::SIM7000_CmdStats() :
+    m_entries{},
+    m_count{0}
+{ }
+
+void SIM7000_CmdStats::record(const sim7000_cmd_context_t &context, int64_t finished_at)
+{
+    std::lock_guard lock(m_mutex);
+    cmd_stats_t *stats = find(context.command);
+
+    // agrega el comando si es la primera vez que se ejecuta
+    if (stats == nullptr) {
+        if (m_count == MAX_CMD_STATS_ENTRIES) return;
+
+        stats = &m_entries[m_count++];
+        *stats = cmd_stats_t{};
+        stats->command = context.command;
+        stats->last_error_code = -1;
+    }
+
+    const sim7000_cmd_result_info_t *info = context.result_info;
+
+    stats->count++;
+    stats->bytes_sent += context.bytes_sent;
+    stats->bytes_received += context.bytes_received;
+
+    // los tiempos se guardan en ms
+    if (context.first_byte_time != 0) {
+        stats->first_byte.add((context.first_byte_time - context.sent_time) / 1000);
+    }
+
+    if (info->result == at_cmd_result_t::NO_ANSWER) {
+        stats->timeouts++;
+        stats->consecutive_timeouts++;
+    } else if (info->result == at_cmd_result_t::CANCELLED) {
+        // no llegó a terminar, por lo que no cuenta para la latencia
+        stats->cancellations++;
+    } else {
+        stats->final_result.add((finished_at - context.sent_time) / 1000);
+        stats->consecutive_timeouts = 0;
+    }
+
+    switch (info->result) {
+        case at_cmd_result_t::ERROR:
+        case at_cmd_result_t::CME_ERROR:
+        case at_cmd_result_t::CMS_ERROR:
+        case at_cmd_result_t::BUFFER_OVF:
+            stats->errors++;
+            stats->last_error_code = info->error_code;
+            break;
+        default:
+            break;
+    }
+}
+
+uint32_t SIM7000_CmdStats::get_adaptive_timeout(at_cmd_t command, uint32_t limit_ms) const
+{
+    std::lock_guard lock(m_mutex);
+    const cmd_stats_t *stats = find(command);
+
+    // sin datos suficientes se utiliza el límite; también después de agotarse
+    // el tiempo de espera, por si el modem se volvió más lento
+    if (stats == nullptr ||
+        stats->consecutive_timeouts > 0 ||
+        stats->final_result.total() < ADAPTIVE_TIMEOUT_MIN_SAMPLES) {
+        return limit_ms;
+    }
+
+    uint32_t timeout = stats->final_result.percentile(ADAPTIVE_TIMEOUT_PERCENTILE);
+    timeout *= ADAPTIVE_TIMEOUT_MARGIN;
+
+    return std::clamp(timeout, std::min(ADAPTIVE_TIMEOUT_MIN_MS, limit_ms), limit_ms);
+}
+
+bool SIM7000_CmdStats::get(at_cmd_t command, cmd_stats_t &stats) const
+{
+    std::lock_guard lock(m_mutex);
+    const cmd_stats_t *entry = find(command);
+    if (entry == nullptr) return false;
+
+    stats = *entry;
+    return true;
+}
+
+bool SIM7000_CmdStats::get_entry(size_t index, cmd_stats_t &stats) const
+{
+    std::lock_guard lock(m_mutex);
+    if (index >= m_count) return false;
+
+    stats = m_entries[index];
+    return true;
+}
+
+size_t SIM7000_CmdStats::size() const
+{
+    std::lock_guard lock(m_mutex);
+    return m_count;
+}
+
+void SIM7000_CmdStats::reset()
+{
+    std::lock_guard lock(m_mutex);
+    m_count = 0;
+}
+
+size_t SIM7000_CmdStats::serialize(std::span<char> buffer) const
+{
+    std::lock_guard lock(m_mutex);
+    char *out = buffer.data();
+    size_t remaining = buffer.size();
+    int length;
+
+    // agrega texto al buffer y verifica que quepa
+    auto append = [&](const char *format, auto... args) {
+        if (remaining == 0) return false;
+        length = snprintf(out, remaining, format, args...);
+        if (length < 0 || (size_t)length >= remaining) {
+            remaining = 0;
+            return false;
+        }
+
+        out += length;
+        remaining -= length;
+        return true;
+    };
+
+    auto append_histogram = [&](const char *name, const cmd_histogram_t &histogram) {
+        if (!append(",\"%s\":[", name)) return false;
+
+        for (size_t i = 0; i < CMD_HISTOGRAM_BUCKETS; i++) {
+            if (!append(i == 0 ? "%u" : ",%u", (unsigned)histogram.buckets[i])) {
+                return false;
+            }
+        }
+
+        return append("]");
+    };
+
+    if (!append("{\"cmds\":[")) return 0;
+
+    for (size_t i = 0; i < m_count; i++) {
+        const cmd_stats_t &stats = m_entries[i];
+        const at_cmd_def_t *def = get_command_def(stats.command);
+
+        bool is_ok = append(
+            "%s{\"cmd\":\"%s\",\"n\":%lu,\"to\":%u,\"err\":%u,\"cx\":%u,\"ec\":%d,"
+            "\"tx\":%lu,\"rx\":%lu",
+            i == 0 ? "" : ",",
+            def != nullptr ? def->string : "",
+            (unsigned long)stats.count,
+            (unsigned)stats.timeouts,
+            (unsigned)stats.errors,
+            (unsigned)stats.cancellations,
+            (int)stats.last_error_code,
+            (unsigned long)stats.bytes_sent,
+            (unsigned long)stats.bytes_received
+        );
+
+        is_ok = is_ok &&
+            append_histogram("ttfb", stats.first_byte) &&
+            append_histogram("ttf", stats.final_result) &&
+            append("}");
+
+        if (!is_ok) return 0;
+    }
+
+    if (!append("]}")) return 0;
+
+    return buffer.size() - remaining;
+}
+
+void SIM7000_CmdStats::dump() const
+{
+    std::lock_guard lock(m_mutex);
+
+    for (size_t i = 0; i < m_count; i++) {
+        const cmd_stats_t &stats = m_entries[i];
+        const at_cmd_def_t *def = get_command_def(stats.command);
+
+        ESP_LOGI(
+            TAG,
+            "%-8s n=%lu timeouts=%u errors=%u (last %d) cancelled=%u tx=%lu rx=%lu | "
+            "ttfb p50<=%lums p99<=%lums | final p50<=%lums p99<=%lums",
+            def != nullptr ? def->string : "?",
+            (unsigned long)stats.count,
+            (unsigned)stats.timeouts,
+            (unsigned)stats.errors,
+            (int)stats.last_error_code,
+            (unsigned)stats.cancellations,
+            (unsigned long)stats.bytes_sent,
+            (unsigned long)stats.bytes_received,
+            (unsigned long)stats.first_byte.percentile(50),
+            (unsigned long)stats.first_byte.percentile(99),
+            (unsigned long)stats.final_result.percentile(50),
+            (unsigned long)stats.final_result.percentile(99)
+        );
+    }
+}
+
+cmd_stats_t *SIM7000_CmdStats::find(at_cmd_t command)
+{
+    for (size_t i = 0; i < m_count; i++) {
+        if (m_entries[i].command == command) return &m_entries[i];
+    }
+
+    return nullptr;
+}
+
+const cmd_stats_t *SIM7000_CmdStats::find(at_cmd_t command) const
+{
+    for (size_t i = 0; i < m_count; i++) {
+        if (m_entries[i].command == command) return &m_entries[i];
+    }
+
+    return nullptr;
+}
+
+} // namespace axomotor::lte_modem
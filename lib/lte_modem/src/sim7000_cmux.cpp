@@ -0,0 +1,366 @@
+#include "sim7000_cmux.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <esp_log.h>
+
+// delimitador de tramas
+#define CMUX_FLAG           0xF9
+// bits del campo de dirección y de longitud
+#define CMUX_EA             0x01
+#define CMUX_CR             0x02
+// bit de sondeo/final del campo de control
+#define CMUX_PF             0x10
+
+// tipos de trama (campo de control sin el bit P/F)
+#define CMUX_SABM           0x2F
+#define CMUX_UA             0x63
+#define CMUX_DM             0x0F
+#define CMUX_DISC           0x43
+#define CMUX_UIH            0xEF
+#define CMUX_UI             0x03
+
+// mensajes del canal de control (tipo sin el bit C/R)
+#define CMUX_MSG_CLD        0xC1
+
+// valor del CRC de una trama válida calculado incluyendo su FCS
+#define CMUX_FCS_GOOD       0xCF
+
+#define CMUX_UA_BIT(dlci)   (1UL << (dlci))
+#define CMUX_DM_BIT(dlci)   (1UL << ((dlci) + 8))
+#define CMUX_CLD_BIT        (1UL << 16)
+
+namespace axomotor::lte_modem {
+
+static const char *TAG = "sim7000:cmux";
+
+// tabla del CRC de 8 bits de 27.010 (polinomio x^8 + x^2 + x + 1, reflejado)
+static constexpr auto CRC_TABLE = []
+{
+    std::array<uint8_t, 256> table{};
+
+    for (size_t i = 0; i < table.size(); i++) {
+        uint8_t crc = i;
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 1) ? (crc >> 1) ^ 0xE0 : crc >> 1;
+        }
+        table[i] = crc;
+    }
+
+    return table;
+}();
+
+static uint8_t calc_crc(const uint8_t *data, size_t length, uint8_t crc = 0xFF)
+{
+    while (length--) {
+        crc = CRC_TABLE[crc ^ *data++];
+    }
+
+    return crc;
+}
+
+/* SIM7000 CMux */
+
+SIM7000_CMux::SIM7000_CMux(write_fn_t write, void *write_ctx) :
+    m_write{write},
+    m_write_ctx{write_ctx},
+    m_channels{},
+    m_event_group{},
+    m_tx_frame{},
+    m_rx_state{rx_state_t::FLAG},
+    m_rx_address{0},
+    m_rx_control{0},
+    m_rx_header{},
+    m_rx_header_length{0},
+    m_rx_length{0},
+    m_rx_received{0},
+    m_rx_fcs{0},
+    m_rx_info{},
+    m_dropped_frames{0}
+{ }
+
+void SIM7000_CMux::set_receiver(uint8_t dlci, receive_fn_t receive, void *ctx)
+{
+    if (dlci >= CMUX_MAX_CHANNELS) return;
+
+    m_channels[dlci].receive = receive;
+    m_channels[dlci].ctx = ctx;
+}
+
+esp_err_t SIM7000_CMux::open(uint8_t dlci, TickType_t ticks_to_wait)
+{
+    if (dlci >= CMUX_MAX_CHANNELS) return ESP_ERR_INVALID_ARG;
+    if (dlci != CMUX_CONTROL_CHANNEL && !m_channels[CMUX_CONTROL_CHANNEL].is_open) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (m_channels[dlci].is_open) return ESP_OK;
+
+    esp_err_t err = send_command(dlci, CMUX_SABM, ticks_to_wait);
+    if (err == ESP_OK) {
+        ESP_LOGI(TAG, "Channel %u opened", dlci);
+        m_channels[dlci].is_open = true;
+    } else {
+        ESP_LOGW(TAG, "Failed to open channel %u (%s)", dlci, esp_err_to_name(err));
+    }
+
+    return err;
+}
+
+esp_err_t SIM7000_CMux::close(TickType_t ticks_to_wait)
+{
+    if (!m_channels[CMUX_CONTROL_CHANNEL].is_open) return ESP_ERR_INVALID_STATE;
+
+    // cierra primero los canales de datos
+    for (uint8_t dlci = CMUX_MAX_CHANNELS - 1; dlci > CMUX_CONTROL_CHANNEL; dlci--) {
+        if (m_channels[dlci].is_open) {
+            send_command(dlci, CMUX_DISC, ticks_to_wait);
+            m_channels[dlci].is_open = false;
+        }
+    }
+
+    // termina el multiplexor; el modem confirma con el mismo mensaje
+    const uint8_t message[] = { CMUX_MSG_CLD | CMUX_CR | CMUX_EA, CMUX_EA };
+    m_event_group.clear_flags(CMUX_CLD_BIT);
+    send_frame(CMUX_CONTROL_CHANNEL, CMUX_UIH, true, message, sizeof(message));
+
+    uint32_t flags = m_event_group.wait_for_flags(CMUX_CLD_BIT, true, false, ticks_to_wait);
+    m_channels[CMUX_CONTROL_CHANNEL].is_open = false;
+    m_rx_state = rx_state_t::FLAG;
+
+    if (!(flags & CMUX_CLD_BIT)) {
+        ESP_LOGW(TAG, "Multiplexer close down was not confirmed");
+        return ESP_ERR_TIMEOUT;
+    }
+
+    ESP_LOGI(TAG, "Multiplexer closed");
+    return ESP_OK;
+}
+
+void SIM7000_CMux::reset()
+{
+    for (channel_t &channel : m_channels) {
+        channel.is_open = false;
+    }
+
+    m_rx_state = rx_state_t::FLAG;
+    ESP_LOGW(TAG, "Multiplexer reset");
+}
+
+int SIM7000_CMux::write(uint8_t dlci, const char *data, size_t length)
+{
+    if (!is_open(dlci)) return -1;
+
+    size_t offset = 0;
+
+    while (offset < length) {
+        size_t chunk = std::min(length - offset, CMUX_MAX_FRAME_SIZE);
+        int written = send_frame(dlci, CMUX_UIH, true, (const uint8_t *)data + offset, chunk);
+        if (written < 0) return offset > 0 ? offset : -1;
+        offset += chunk;
+    }
+
+    return length;
+}
+
+void SIM7000_CMux::feed(const char *data, size_t length)
+{
+    for (size_t i = 0; i < length; i++) {
+        uint8_t byte = data[i];
+
+        switch (m_rx_state)
+        {
+            case rx_state_t::FLAG:
+                if (byte == CMUX_FLAG) m_rx_state = rx_state_t::ADDRESS;
+                break;
+            case rx_state_t::ADDRESS:
+                // varios delimitadores seguidos
+                if (byte == CMUX_FLAG) break;
+                m_rx_address = byte;
+                m_rx_header[0] = byte;
+                m_rx_header_length = 1;
+                m_rx_state = rx_state_t::CONTROL;
+                break;
+            case rx_state_t::CONTROL:
+                m_rx_control = byte;
+                m_rx_header[m_rx_header_length++] = byte;
+                m_rx_state = rx_state_t::LENGTH;
+                break;
+            case rx_state_t::LENGTH:
+                m_rx_header[m_rx_header_length++] = byte;
+                m_rx_length = byte >> 1;
+                if (byte & CMUX_EA) {
+                    end_header();
+                } else {
+                    m_rx_state = rx_state_t::LENGTH_EXT;
+                }
+                break;
+            case rx_state_t::LENGTH_EXT:
+                m_rx_header[m_rx_header_length++] = byte;
+                m_rx_length |= (size_t)byte << 7;
+                end_header();
+                break;
+            case rx_state_t::INFO:
+                m_rx_info[m_rx_received++] = byte;
+                if (m_rx_received == m_rx_length) {
+                    m_rx_state = rx_state_t::FCS;
+                }
+                break;
+            case rx_state_t::FCS:
+                m_rx_fcs = byte;
+                m_rx_state = rx_state_t::END_FLAG;
+                break;
+            case rx_state_t::END_FLAG:
+                if (byte != CMUX_FLAG) {
+                    m_dropped_frames++;
+                    m_rx_state = rx_state_t::FLAG;
+                    break;
+                }
+
+                if (check_fcs()) {
+                    process_frame();
+                } else {
+                    ESP_LOGW(TAG, "Frame with invalid FCS dropped");
+                    m_dropped_frames++;
+                }
+
+                // el delimitador final puede ser el inicial de la siguiente
+                m_rx_state = rx_state_t::ADDRESS;
+                break;
+        }
+    }
+}
+
+bool SIM7000_CMux::is_open(uint8_t dlci) const
+{
+    return dlci < CMUX_MAX_CHANNELS && m_channels[dlci].is_open;
+}
+
+esp_err_t SIM7000_CMux::send_command(uint8_t dlci, uint8_t control, TickType_t ticks_to_wait)
+{
+    const uint32_t bits = CMUX_UA_BIT(dlci) | CMUX_DM_BIT(dlci);
+
+    m_event_group.clear_flags(bits);
+    if (send_frame(dlci, control | CMUX_PF, true, nullptr, 0) < 0) {
+        return ESP_FAIL;
+    }
+
+    uint32_t flags = m_event_group.wait_for_flags(bits, true, false, ticks_to_wait);
+
+    if (flags & CMUX_UA_BIT(dlci)) return ESP_OK;
+    return flags & CMUX_DM_BIT(dlci) ? ESP_FAIL : ESP_ERR_TIMEOUT;
+}
+
+int SIM7000_CMux::send_frame(
+    uint8_t dlci,
+    uint8_t control,
+    bool is_command,
+    const uint8_t *info,
+    size_t length)
+{
+    std::lock_guard lock(m_write_mutex);
+    uint8_t *frame = m_tx_frame.data();
+    size_t pos = 0;
+
+    frame[pos++] = CMUX_FLAG;
+    frame[pos++] = (dlci << 2) | (is_command ? CMUX_CR : 0) | CMUX_EA;
+    frame[pos++] = control;
+    frame[pos++] = (length << 1) | CMUX_EA;
+
+    uint8_t crc = calc_crc(frame + 1, pos - 1);
+
+    if (length > 0) {
+        memcpy(frame + pos, info, length);
+        pos += length;
+    }
+
+    frame[pos++] = 0xFF - crc;
+    frame[pos++] = CMUX_FLAG;
+
+    if (m_write(m_write_ctx, (const char *)frame, pos) != (int)pos) {
+        ESP_LOGW(TAG, "Failed to write frame (channel %u)", dlci);
+        return -1;
+    }
+
+    return length;
+}
+
+void SIM7000_CMux::end_header()
+{
+    if (m_rx_length > m_rx_info.size()) {
+        ESP_LOGW(TAG, "Frame is too long (%u bytes)", m_rx_length);
+        m_dropped_frames++;
+        m_rx_state = rx_state_t::FLAG;
+        return;
+    }
+
+    m_rx_received = 0;
+    m_rx_state = m_rx_length > 0 ? rx_state_t::INFO : rx_state_t::FCS;
+}
+
+bool SIM7000_CMux::check_fcs() const
+{
+    // el FCS de las tramas UIH solo cubre el encabezado; el de las demás
+    // (UI) también cubre la información
+    uint8_t crc = calc_crc(m_rx_header, m_rx_header_length);
+    if ((m_rx_control & ~CMUX_PF) != CMUX_UIH) {
+        crc = calc_crc(m_rx_info.data(), m_rx_length, crc);
+    }
+
+    return calc_crc(&m_rx_fcs, 1, crc) == CMUX_FCS_GOOD;
+}
+
+void SIM7000_CMux::process_frame()
+{
+    uint8_t dlci = m_rx_address >> 2;
+    uint8_t control = m_rx_control & ~CMUX_PF;
+
+    if (dlci >= CMUX_MAX_CHANNELS) return;
+
+    channel_t &channel = m_channels[dlci];
+
+    switch (control)
+    {
+        case CMUX_UA:
+            m_event_group.set_flags(CMUX_UA_BIT(dlci));
+            break;
+        case CMUX_DM:
+            channel.is_open = false;
+            m_event_group.set_flags(CMUX_DM_BIT(dlci));
+            break;
+        case CMUX_DISC:
+            // el modem cerró el canal
+            ESP_LOGW(TAG, "Channel %u closed by modem", dlci);
+            channel.is_open = false;
+            send_frame(dlci, CMUX_UA | CMUX_PF, false, nullptr, 0);
+            break;
+        case CMUX_UIH:
+        case CMUX_UI:
+            if (dlci == CMUX_CONTROL_CHANNEL) {
+                process_control_message();
+            } else if (channel.receive != nullptr && m_rx_length > 0) {
+                channel.receive(channel.ctx, (const char *)m_rx_info.data(), m_rx_length);
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+void SIM7000_CMux::process_control_message()
+{
+    if (m_rx_length < 2) return;
+
+    uint8_t type = m_rx_info[0];
+
+    // los comandos del modem (p. ej. MSC) se confirman con el mismo mensaje
+    // marcado como respuesta
+    if (type & CMUX_CR) {
+        if (m_rx_length > CMUX_MAX_FRAME_SIZE) return;
+        m_rx_info[0] = type & ~CMUX_CR;
+        send_frame(CMUX_CONTROL_CHANNEL, CMUX_UIH, true, m_rx_info.data(), m_rx_length);
+    } else if ((type & ~CMUX_EA) == (CMUX_MSG_CLD & ~CMUX_EA)) {
+        m_event_group.set_flags(CMUX_CLD_BIT);
+    }
+}
+
+} // namespace axomotor::lte_modem
@@ -11,7 +11,7 @@ static const char *TAG = "sim7000:gnss";
 SIM7000_GNSS::SIM7000_GNSS(std::weak_ptr<SIM7000_Modem> modem) :
     SIM7000_Service(modem)
 { 
-    m_result_info->response.reserve(120);
+    m_result_info.response.reserve(120);
 }
 
 esp_err_t SIM7000_GNSS::turn_on()
@@ -51,7 +51,7 @@ esp_err_t SIM7000_GNSS::get_state(bool &state)
 
     ESP_LOGI(TAG, "Getting GNSS state...");
     esp_err_t err = modem->execute_cmd(at_cmd_t::CGNSPWR, "?", m_result_info);
-    std::string &response = m_result_info->response;
+    std::string &response = m_result_info.response;
     
     if (err == ESP_OK) {
         helpers::remove_before(response, ": ");
@@ -67,12 +67,15 @@ esp_err_t SIM7000_GNSS::enable_nav_urc(uint8_t interval)
 {
     if (m_modem.expired()) return ESP_ERR_INVALID_STATE;
     auto modem = m_modem.lock();
-    std::string params = "=";
-    params.append(std::to_string(interval));
+    SIM7000_CmdSlot slot = modem->acquire_cmd_slot();
 
     ESP_LOGI(TAG, "Enabling GNSS reporting...");
 
-    esp_err_t err = modem->execute_cmd(at_cmd_t::CGNSURC, params, m_result_info);        
+    esp_err_t err = slot.format_params("=%u", (unsigned)interval);
+    if (err == ESP_OK) {
+        err = modem->execute_cmd(at_cmd_t::CGNSURC, slot);
+    }
+
     if (err != ESP_OK) {
         ESP_LOGE(TAG, "Failed to enable GNSS reporting");
     }
@@ -95,11 +98,31 @@ esp_err_t SIM7000_GNSS::disable_nav_urc()
     return err;
 }
 
+threading::Async<esp_err_t> SIM7000_GNSS::set_nav_urc_async(uint8_t interval)
+{
+    if (m_modem.expired()) co_return ESP_ERR_INVALID_STATE;
+    auto modem = m_modem.lock();
+    SIM7000_CmdSlot slot = co_await modem->acquire_cmd_slot_async();
+
+    ESP_LOGI(TAG, "Setting GNSS reporting interval to %u...", (unsigned)interval);
+
+    esp_err_t err = slot.format_params("=%u", (unsigned)interval);
+    if (err == ESP_OK) {
+        err = co_await modem->exec(at_cmd_t::CGNSURC, slot);
+    }
+
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to set GNSS reporting interval");
+    }
+
+    co_return err;
+}
+
 esp_err_t SIM7000_GNSS::get_nav_urc_state(bool &state)
 {
     if (m_modem.expired()) return ESP_ERR_INVALID_STATE;
     auto modem = m_modem.lock();
-    std::string &res = m_result_info->response;
+    std::string &res = m_result_info.response;
 
     ESP_LOGI(TAG, "Getting GNSS reporting state...");
 
@@ -121,7 +144,7 @@ esp_err_t SIM7000_GNSS::get_nav_info(gnss_nav_info_t &info)
     // espera hasta que el modulo esté disponible
     ESP_LOGI(TAG, "Getting GNSS navigation information...");
     esp_err_t result = modem->execute_cmd(at_cmd_t::CGNSINF, m_result_info);
-    std::string &response = m_result_info->response;
+    std::string &response = m_result_info.response;
     std::string aux;
 
     if (result == ESP_OK) {
@@ -1,4 +1,5 @@
 #include "sim7000_helpers.hpp"
+#include "sim7000_response_fields.hpp"
 #include <string.h>
 
 namespace axomotor::lte_modem::helpers
@@ -105,45 +106,32 @@ namespace axomotor::lte_modem::helpers
         return epoch;
     }
 
-    void parse_gnss_info(std::string &payload, gnss_nav_info_t &info)
+    void parse_gnss_info(std::string_view payload, gnss_nav_info_t &info)
     {
-        std::string aux;
+        SIM7000_ResponseFields fields(payload);
 
-        // quita el inicio del comando
-        remove_before(payload, ": ");
         // obtiene el estado de ejecución
-        extract_token(payload, 0, ",", aux, true);
-        info.run_status = to_number<uint8_t>(aux);
+        info.run_status = fields.get_int<uint8_t>(0);
         // obtiene el indicador FIX
-        extract_token(payload, 1, ",", aux, true);
-        info.fix_status = to_number<uint8_t>(aux);//fields[1]);
+        info.fix_status = fields.get_int<uint8_t>(1);
         // obtiene la fecha y hora
-        extract_token(payload, 2, ",", aux, true);
-        info.date_time = to_number<uint64_t>(aux);//fields[2]);
+        info.date_time = fields.get_int<uint64_t>(2);
         // obtiene la latitud
-        extract_token(payload, 3, ",", aux, true);
-        info.latitude = to_number<float>(aux);//fields[3]);
+        info.latitude = fields.get_float(3);
         // obtiene la longitud
-        extract_token(payload, 4, ",", aux, true);
-        info.longitude = to_number<float>(aux);//fields[4]);
+        info.longitude = fields.get_float(4);
         // obtiene la altitud
-        extract_token(payload, 5, ",", aux, true);
-        info.msl_altitude = to_number<float>(aux);//fields[5]);
+        info.msl_altitude = fields.get_float(5);
         // obtiene la velocidad
-        extract_token(payload, 6, ",", aux, true);
-        info.speed_over_ground = to_number<float>(aux);//fields[6]);
+        info.speed_over_ground = fields.get_float(6);
         // obtiene el curso sobre la tierra
-        extract_token(payload, 7, ",", aux, true);
-        info.course_over_ground = to_number<float>(aux);//fields[7]);
+        info.course_over_ground = fields.get_float(7);
         // obtiene el indicador FIX MODE
-        extract_token(payload, 8, ",", aux, true);
-        info.fix_mode = to_number<uint8_t>(aux);//fields[8]);
+        info.fix_mode = fields.get_int<uint8_t>(8);
         // obtiene la cantidad de satelites de GNSS en vista
-        extract_token(payload, 14, ",", aux, true);
-        info.gnss_satellites = to_number<uint8_t>(aux);//fields[14]);
+        info.gnss_satellites = fields.get_int<uint8_t>(14);
         // obtiene la cantidad de satelites de GPS en vista
-        extract_token(payload, 15, ",", aux, true);
-        info.gps_satellites = to_number<uint8_t>(aux);//fields[15]);
+        info.gps_satellites = fields.get_int<uint8_t>(15);
     }
 
     time_t parse_to_epoch(std::string &payload)
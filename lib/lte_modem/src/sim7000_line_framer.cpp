@@ -0,0 +1,159 @@
+#include "sim7000_line_framer.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace axomotor::lte_modem {
+
+// redondea la capacidad a la siguiente potencia de 2 para poder enmascarar
+// los índices en lugar de calcular el módulo
+static size_t round_capacity(size_t capacity)
+{
+    size_t value = 16;
+    while (value < capacity) value <<= 1;
+    return value;
+}
+
+SIM7000_LineFramer::SIM7000_LineFramer(size_t capacity) :
+    m_capacity{round_capacity(capacity)},
+    m_mask{m_capacity - 1},
+    m_buffer{new char[m_capacity]},
+    m_line{new char[m_capacity]},
+    m_head{0},
+    m_tail{0},
+    m_scan{0}
+{ }
+
+std::span<char> SIM7000_LineFramer::get_write_window()
+{
+    size_t free = m_capacity - size();
+    size_t offset = m_tail & m_mask;
+    // la ventana termina en el final físico del buffer
+    size_t length = std::min(free, m_capacity - offset);
+
+    return std::span<char>(&m_buffer[offset], length);
+}
+
+void SIM7000_LineFramer::commit(size_t length)
+{
+    m_tail += std::min(length, m_capacity - size());
+}
+
+size_t SIM7000_LineFramer::write(const char *data, size_t length)
+{
+    size_t written = 0;
+
+    while (written < length) {
+        auto window = get_write_window();
+        if (window.empty()) break;
+
+        size_t chunk = std::min(window.size(), length - written);
+        memcpy(window.data(), data + written, chunk);
+        commit(chunk);
+        written += chunk;
+    }
+
+    return written;
+}
+
+bool SIM7000_LineFramer::next_line(std::string_view &line)
+{
+    size_t index = std::max(m_scan, m_head);
+
+    // busca la secuencia CRLF a partir de la última posición revisada
+    for (; index + 1 < m_tail; index++) {
+        if (at(index) == '\r' && at(index + 1) == '\n') {
+            line = take(index - m_head, 2);
+            return true;
+        }
+    }
+
+    // recuerda la posición para no volver a revisar los mismos bytes
+    m_scan = index;
+
+    // si el buffer está lleno y no hay fin de línea, entrega todo su
+    // contenido para evitar que el receptor quede bloqueado
+    if (is_full()) {
+        line = take(size(), 0);
+        return true;
+    }
+
+    return false;
+}
+
+std::string_view SIM7000_LineFramer::peek() const
+{
+    size_t offset = m_head & m_mask;
+    size_t length = std::min(size(), m_capacity - offset);
+
+    return std::string_view(&m_buffer[offset], length);
+}
+
+void SIM7000_LineFramer::discard(size_t length)
+{
+    m_head += std::min(length, size());
+
+    if (m_head == m_tail) {
+        clear();
+    }
+}
+
+bool SIM7000_LineFramer::starts_with(std::string_view seq) const
+{
+    if (seq.length() > size()) return false;
+
+    for (size_t i = 0; i < seq.length(); i++) {
+        if (at(m_head + i) != seq[i]) return false;
+    }
+
+    return true;
+}
+
+bool SIM7000_LineFramer::ends_with(std::string_view seq) const
+{
+    if (seq.length() > size()) return false;
+    size_t start = m_tail - seq.length();
+
+    for (size_t i = 0; i < seq.length(); i++) {
+        if (at(start + i) != seq[i]) return false;
+    }
+
+    return true;
+}
+
+void SIM7000_LineFramer::clear()
+{
+    m_head = 0;
+    m_tail = 0;
+    m_scan = 0;
+}
+
+std::string_view SIM7000_LineFramer::take(size_t length, size_t skip)
+{
+    size_t offset = m_head & m_mask;
+    const char *data;
+
+    // verifica si la línea es contigua en el buffer
+    if (offset + length <= m_capacity) {
+        data = &m_buffer[offset];
+    } else {
+        // copia las dos partes de la línea al área auxiliar
+        size_t first = m_capacity - offset;
+        memcpy(&m_line[0], &m_buffer[offset], first);
+        memcpy(&m_line[first], &m_buffer[0], length - first);
+        data = &m_line[0];
+    }
+
+    m_head += length + skip;
+    m_scan = m_head;
+
+    // los datos siguen siendo válidos aunque los índices se reinicien, puesto
+    // que no se sobrescriben hasta la siguiente escritura
+    if (m_head == m_tail) {
+        m_head = m_tail = m_scan = 0;
+    }
+
+    return std::string_view(data, length);
+}
+
+} // namespace axomotor::lte_modem
@@ -1,18 +1,24 @@
 #include "sim7000_modem.hpp"
 #include "sim7000_types.hpp"
 #include "sim7000_helpers.hpp"
+#include "sim7000_response_fields.hpp"
 
 #include <cstring>
 #include <string>
 #include <array>
+#include <algorithm>
 
 #include <esp_log.h>
+#include <esp_timer.h>
+#include <nvs.h>
 #include <driver/uart.h>
 #include <driver/gpio.h>
 
 #define PDP_DEACT_BIT                   BIT0
 #define APP_PDP_ACTIVE_BIT              BIT1
 #define APP_PDP_DEACTIVE_BIT            BIT2
+#define PPP_CHANNEL_CONNECT_BIT         BIT3
+#define PPP_CHANNEL_FAILED_BIT          BIT4
 
 #define NULL_CH     '\0'
 #define CRLF        "\r\n"
@@ -27,6 +33,238 @@ using namespace axomotor::lte_modem::internal;
 using Parser = SIM7000_BasicModem;
 
 static const char *TAG = "sim7000:modem";
+static const char *NVS_NAMESPACE = "sim7000";
+static const char *NVS_BAUD_RATE_KEY = "baud_rate";
+
+// agrega datos a un buffer de líneas de tamaño fijo y entrega a on_line cada
+// línea completa, sin CR/LF y terminada en NULL_CH; si el buffer se llena sin
+// un fin de línea se descarta su contenido. Si on_line devuelve false, se
+// descarta lo que resta
+template <size_t N, typename Fn>
+static void split_lines(char (&buffer)[N], size_t &length, const char *data, size_t size, Fn &&on_line)
+{
+    while (size > 0) {
+        size_t chunk = std::min(size, N - length);
+        memcpy(buffer + length, data, chunk);
+        length += chunk;
+        data += chunk;
+        size -= chunk;
+
+        size_t start = 0;
+        const char *end;
+
+        while ((end = (const char *)memchr(buffer + start, LF, length - start)) != nullptr) {
+            size_t line_end = end - buffer;
+            size_t line_length = line_end - start;
+            if (line_length > 0 && buffer[line_end - 1] == CR) line_length--;
+
+            buffer[start + line_length] = NULL_CH;
+            if (!on_line(std::string_view(buffer + start, line_length))) {
+                length = 0;
+                return;
+            }
+
+            start = line_end + 1;
+        }
+
+        // conserva la línea incompleta al inicio del buffer
+        length -= start;
+        memmove(buffer, buffer + start, length);
+
+        // evita detenerse con datos sin fin de línea
+        if (length == N) length = 0;
+    }
+}
+
+// lee la última velocidad con la que el modem respondió correctamente
+static int load_baud_rate()
+{
+    nvs_handle_t handle;
+    uint32_t baud_rate = 0;
+
+    if (nvs_open(NVS_NAMESPACE, NVS_READONLY, &handle) != ESP_OK) return 0;
+    nvs_get_u32(handle, NVS_BAUD_RATE_KEY, &baud_rate);
+    nvs_close(handle);
+
+    return (int)baud_rate;
+}
+
+static void save_baud_rate(int baud_rate)
+{
+    nvs_handle_t handle;
+    esp_err_t err = nvs_open(NVS_NAMESPACE, NVS_READWRITE, &handle);
+
+    if (err == ESP_OK) {
+        err = nvs_set_u32(handle, NVS_BAUD_RATE_KEY, (uint32_t)baud_rate);
+        if (err == ESP_OK) err = nvs_commit(handle);
+        nvs_close(handle);
+    }
+
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to save baud rate (%s)", esp_err_to_name(err));
+    }
+}
+
+// busca en una respuesta de varias líneas la que corresponde al CID indicado
+// (primer campo) y la separa en campos
+static bool find_cid_fields(
+    std::string_view response,
+    uint8_t cid,
+    SIM7000_ResponseFields &fields)
+{
+    while (!response.empty()) {
+        size_t end = response.find(CRLF);
+        std::string_view line = response.substr(0, end);
+
+        if (fields.split(line) > 0 && fields.get_int<uint8_t>(0) == cid) {
+            return true;
+        }
+
+        if (end == std::string_view::npos) break;
+        response.remove_prefix(end + 2);
+    }
+
+    fields.split(std::string_view());
+    return false;
+}
+
+// convierte el valor RSSI de +CSQ a dBm (0 si no es detectable)
+static int8_t rssi_to_dbm(uint8_t rssi)
+{
+    if (rssi == 0) {
+        return -115;
+    } else if (rssi == 1) {
+        return -111;
+    } else if (rssi >= 2 && rssi <= 30) {
+        float factor = (rssi - 2) / 28.0f;
+        float delta = (110 - 54) * factor;
+        return -110 + (int8_t)(delta);
+    } else if (rssi == 31) {
+        return -52;
+    }
+
+    return 0;
+}
+
+static signal_strength_t to_signal_strength(int8_t dbm)
+{
+    if (dbm == 0) {
+        return signal_strength_t::NOT_DETECTABLE;
+    } else if (dbm > -60) {
+        return signal_strength_t::EXCELLENT;
+    } else if (dbm > -85) {
+        return signal_strength_t::GOOD;
+    }
+
+    return signal_strength_t::MARGINAL;
+}
+
+static network_reg_status_t to_network_reg_status(uint8_t value)
+{
+    switch (value)
+    {
+        case 0: return network_reg_status_t::NOT_REGISTERED;
+        case 1: return network_reg_status_t::REGISTERED;
+        case 2: return network_reg_status_t::TRYING_TO_REGISTER;
+        case 3: return network_reg_status_t::REGISTRATION_DENIED;
+        case 5: return network_reg_status_t::REGISTERED_ROAMING;
+        default: return network_reg_status_t::UNKNOWN;
+    }
+}
+
+static void log_network_reg_status(network_reg_status_t status)
+{
+    switch (status)
+    {
+        case network_reg_status_t::NOT_REGISTERED:
+            ESP_LOGI(TAG, "Module is not registered in network");
+            break;
+        case network_reg_status_t::REGISTERED:
+            ESP_LOGI(TAG, "Module is registered in network");
+            break;
+        case network_reg_status_t::TRYING_TO_REGISTER:
+            ESP_LOGI(TAG, "Module is trying to register in network");
+            break;
+        case network_reg_status_t::REGISTRATION_DENIED:
+            ESP_LOGI(TAG, "Module registration in network was denied");
+            break;
+        case network_reg_status_t::REGISTERED_ROAMING:
+            ESP_LOGI(TAG, "Module is registered in network (roaming)");
+            break;
+        default:
+            ESP_LOGI(TAG, "Module is in unknown resgistration state");
+            break;
+    }
+}
+
+static operator_netact_t to_operator_netact(std::string_view netact)
+{
+    if (netact == "0") {
+        return operator_netact_t::USER_SPECIFIED;
+    } else if (netact == "1") {
+        return operator_netact_t::GSM_COMPACT;
+    } else if (netact == "3") {
+        return operator_netact_t::GSM_EGPRS;
+    } else if (netact == "7") {
+        return operator_netact_t::LTE_M1_A_GB;
+    } else if (netact == "9") {
+        return operator_netact_t::LTE_NB_S1;
+    }
+
+    return operator_netact_t::UNKNOWN;
+}
+
+// consultas que se agregan a AT+CSQ para obtener el estado de red completo
+static const char STATUS_BUNDLE_PARAMS[] = ";+COPS?;+CGREG?";
+
+// lee la respuesta de AT+CSQ;+COPS?;+CGREG?
+static esp_err_t parse_status_bundle(std::string_view response, network_status_t &status)
+{
+    SIM7000_ResponseFields fields;
+    bool has_csq = false, has_cops = false, has_cgreg = false;
+
+    status = network_status_t{};
+
+    while (!response.empty()) {
+        size_t end = response.find(CRLF);
+        std::string_view line = response.substr(0, end);
+        fields.split(line);
+
+        if (line.starts_with("+CSQ:")) {
+            status.signal_dbm = rssi_to_dbm(fields.get_int<uint8_t>(0, 99));
+            status.signal_strength = to_signal_strength(status.signal_dbm);
+            has_csq = true;
+        } else if (line.starts_with("+COPS:")) {
+            std::string_view name = fields.get_string(2);
+            name = name.substr(0, sizeof(status.operator_name) - 1);
+            memcpy(status.operator_name, name.data(), name.length());
+            status.operator_name[name.length()] = NULL_CH;
+            status.netact = to_operator_netact(fields.get_string(3));
+            has_cops = true;
+        } else if (line.starts_with("+CGREG:")) {
+            status.reg_status = to_network_reg_status(fields.get_int<uint8_t>(1, 4));
+            has_cgreg = true;
+        }
+
+        if (end == std::string_view::npos) break;
+        response.remove_prefix(end + 2);
+    }
+
+    if (!has_csq || !has_cops || !has_cgreg) {
+        ESP_LOGW(TAG, "Incomplete network status response");
+        return ESP_ERR_INVALID_RESPONSE;
+    }
+
+    ESP_LOGI(
+        TAG,
+        "Network status | signal: %d dBm, operator: %s, registration: %d",
+        status.signal_dbm,
+        status.operator_name[0] ? status.operator_name : "Unknown",
+        (int)status.reg_status
+    );
+
+    return ESP_OK;
+}
 
 /* SIM7000 Modem */
 
@@ -44,15 +282,32 @@ SIM7000_Modem::SIM7000_Modem(
     SIM7000_BasicModem(parser_buffer_size),
     m_port{port},
     m_pin_pwr{(gpio_num_t)pin_pwr},
+    m_default_baud_rate{baud_rate},
     m_apn{},
     m_status{},
+    m_cmux{write_uart, this},
+    m_is_cmux{false},
+    m_is_ppp_channel_online{false},
+    m_ppp_dial_length{0},
+    m_nmea_length{0},
+    m_supervisor{*this},
+    m_restore_cmux{false},
+    m_restore_nmea{false},
+    m_restore_ppp{false},
     m_uart_event_queue{nullptr},
     m_event_loop{nullptr},
-    m_enable_events{false}
+    m_enable_events{false},
+    m_baud_rate{baud_rate},
+    m_rx_mode{uart_rx_mode_t::DATA_EVENTS}
 {
-    // crea la instancia compartida de resultado de comando
-    m_result_info = std::make_shared<internal::sim7000_cmd_result_info_t>();
-    m_result_info->response.reserve(DEFAULT_RESPONSE_BUF_SIZE);
+    // reserva la memoria del resultado de comandos internos
+    m_result_info.response.reserve(DEFAULT_RESPONSE_BUF_SIZE);
+    m_urc_buffer.reserve(DEFAULT_URC_BUF_SIZE);
+
+    // receptores de los canales del multiplexor
+    m_cmux.set_receiver(CMUX_AT_CHANNEL, on_at_channel_data, this);
+    m_cmux.set_receiver(CMUX_PPP_CHANNEL, on_ppp_channel_data, this);
+    m_cmux.set_receiver(CMUX_NMEA_CHANNEL, on_nmea_channel_data, this);
     
     // configuración del puerto UART
     uart_config_t uart_config{};
@@ -66,6 +321,7 @@ SIM7000_Modem::SIM7000_Modem(
     // configura el pin de control (PWR)
     gpio_reset_pin(m_pin_pwr);
     gpio_set_direction(m_pin_pwr, GPIO_MODE_OUTPUT);
+    gpio_set_level(m_pin_pwr, 0);
 
     // instalación de controlador UART
     ESP_ERROR_CHECK(uart_driver_install(
@@ -96,7 +352,7 @@ esp_err_t SIM7000_Modem::init()
     std::lock_guard lock(m_mutex);
     esp_err_t err;
     at_cmd_t cmd;
-    std::string &res = m_result_info->response;
+    std::string &res = m_result_info.response;
 
     ESP_LOGI(TAG, "Waiting for module starting...");
     
@@ -147,6 +403,13 @@ esp_err_t SIM7000_Modem::init()
     if (err == ESP_OK) {
         helpers::remove_before(res, ": ");
         ESP_LOGI(TAG, "SIM status: %s", res.c_str());
+        // habilita el URC de cambios en el registro de red para no tener
+        // que consultarlo periódicamente
+        cmd = at_cmd_t::CGREG;
+        err = execute_internal_cmd_no_answer(cmd, "=1");
+    }
+    if (err == ESP_OK) {
+        ESP_LOGI(TAG, "Network registration URC is enabled");
     } else {
         ESP_LOGE(
             TAG,
@@ -159,6 +422,13 @@ esp_err_t SIM7000_Modem::init()
     return err;
 }
 
+esp_err_t SIM7000_Modem::set_rx_mode(uart_rx_mode_t mode)
+{
+    if (m_is_running) return ESP_ERR_INVALID_STATE;
+    m_rx_mode = mode;
+    return ESP_OK;
+}
+
 esp_err_t SIM7000_Modem::enable_events(esp_event_loop_handle_t *event_loop)
 {
     if (m_enable_events) return ESP_ERR_INVALID_STATE;
@@ -237,7 +507,7 @@ esp_err_t SIM7000_Modem::get_sim_status(sim_status_t &status)
     // espera hasta que el modulo esté disponible
     std::lock_guard lock(m_mutex);
     esp_err_t err;
-    std::string &res = m_result_info->response;
+    std::string &res = m_result_info.response;
 
     err = execute_internal_cmd(at_cmd_t::CPIN, "?");
 
@@ -265,7 +535,7 @@ esp_err_t SIM7000_Modem::get_imei(std::string &imei)
     // espera hasta que el modulo esté disponible
     std::lock_guard lock(m_mutex);
     esp_err_t err;
-    std::string &res = m_result_info->response;
+    std::string &res = m_result_info.response;
 
     err = execute_internal_cmd(at_cmd_t::CGSN);
     if (err == ESP_OK) {
@@ -281,13 +551,13 @@ esp_err_t SIM7000_Modem::get_system_time(std::string &date_time)
     // espera hasta que el modulo esté disponible
     std::lock_guard lock(m_mutex);
     esp_err_t err;
-    std::string &res = m_result_info->response;
+    std::string &res = m_result_info.response;
 
     // espera hasta que el modulo esté disponible
     err = execute_internal_cmd(at_cmd_t::CCLK, "?");
     if (err == ESP_OK) {
-        helpers::extract_token(res, 1, "\"");
-        date_time.assign(res);
+        SIM7000_ResponseFields fields(res);
+        fields.get_string(0, date_time);
 
         ESP_LOGI(TAG, "Current time is %s", date_time.c_str());
     }
@@ -329,44 +599,158 @@ esp_err_t SIM7000_Modem::sync_time()
     return err;
 }
 
+esp_err_t SIM7000_Modem::start_transcript(const char *path)
+{
+    return m_transcript.start(path);
+}
+
+esp_err_t SIM7000_Modem::stop_transcript()
+{
+    return m_transcript.stop();
+}
+
+esp_err_t SIM7000_Modem::measure_link_throughput(uint32_t &bytes_per_second, size_t iterations)
+{
+    std::lock_guard lock(m_mutex);
+    SIM7000_CmdStats &stats = get_cmd_stats();
+    cmd_stats_t before{}, after{};
+    esp_err_t err = ESP_OK;
+
+    // AT+GSV responde con varias líneas, de modo que el tiempo de
+    // transmisión pesa más que el de procesamiento del modem
+    stats.get(at_cmd_t::GSV, before);
+    int64_t start = esp_timer_get_time();
+
+    for (size_t i = 0; i < iterations && err == ESP_OK; i++) {
+        err = execute_internal_cmd(at_cmd_t::GSV);
+    }
+
+    int64_t elapsed = esp_timer_get_time() - start;
+    stats.get(at_cmd_t::GSV, after);
+
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Link benchmark failed (%s)", esp_err_to_name(err));
+        return err;
+    }
+
+    uint64_t bytes = (after.bytes_sent - before.bytes_sent) +
+        (after.bytes_received - before.bytes_received);
+    bytes_per_second = elapsed > 0 ? (uint32_t)(bytes * 1000000 / elapsed) : 0;
+
+    ESP_LOGI(
+        TAG,
+        "Link throughput at %d baud: %lu B/s (%llu bytes in %lld us)",
+        m_baud_rate,
+        (unsigned long)bytes_per_second,
+        (unsigned long long)bytes,
+        elapsed
+    );
+
+    return ESP_OK;
+}
+
+esp_err_t SIM7000_Modem::negotiate_baud_rate(int max_baud_rate)
+{
+    std::lock_guard lock(m_mutex);
+    esp_err_t err = ESP_ERR_NOT_SUPPORTED;
+
+    for (int baud_rate : HIGH_SPEED_BAUD_RATES) {
+        if (baud_rate > max_baud_rate) continue;
+        // si ya se encuentra a una velocidad igual o mayor no hay nada que hacer
+        if (baud_rate <= m_baud_rate) {
+            ESP_LOGI(TAG, "Already running at %d baud", m_baud_rate);
+            return ESP_OK;
+        }
+
+        err = set_baud_rate(baud_rate);
+        if (err == ESP_OK) break;
+    }
+
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Keeping %d baud", m_baud_rate);
+    }
+
+    return err;
+}
+
+esp_err_t SIM7000_Modem::set_baud_rate(int baud_rate)
+{
+    if (baud_rate <= 0) return ESP_ERR_INVALID_ARG;
+
+    std::lock_guard lock(m_mutex);
+    const int old_baud_rate = m_baud_rate;
+    char params[16];
+    int length;
+    esp_err_t err;
+
+    if (baud_rate == old_baud_rate) return ESP_OK;
+
+    // el modem responde OK a la velocidad actual y después cambia; solo se
+    // envían los caracteres escritos, no el resto del arreglo
+    length = snprintf(params, sizeof(params), "=%d", baud_rate);
+    err = execute_internal_cmd_no_answer(
+        at_cmd_t::IPR,
+        std::span<const char>(params, length),
+        pdMS_TO_TICKS(1000));
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Modem rejected %d baud (%s)", baud_rate, esp_err_to_name(err));
+        return err;
+    }
+
+    err = apply_uart_baud_rate(baud_rate);
+    if (err == ESP_OK) {
+        err = verify_link();
+    }
+
+    if (err == ESP_OK) {
+        ESP_LOGI(TAG, "Baud rate changed to %d", baud_rate);
+        save_baud_rate(baud_rate);
+        return ESP_OK;
+    }
+
+    ESP_LOGW(TAG, "No response at %d baud, falling back to %d", baud_rate, old_baud_rate);
+
+    // puede que el modem no haya cambiado de velocidad
+    apply_uart_baud_rate(old_baud_rate);
+    if (verify_link() == ESP_OK) {
+        return ESP_FAIL;
+    }
+
+    // el modem cambió pero la UART no puede comunicarse bien a esa velocidad;
+    // se le pide regresar a la anterior aunque la respuesta llegue dañada
+    apply_uart_baud_rate(baud_rate);
+    length = snprintf(params, sizeof(params), "=%d", old_baud_rate);
+    execute_internal_cmd_no_answer(
+        at_cmd_t::IPR,
+        std::span<const char>(params, length),
+        pdMS_TO_TICKS(BAUD_RATE_VERIFY_TIMEOUT_MS));
+    apply_uart_baud_rate(old_baud_rate);
+
+    if (verify_link() != ESP_OK) {
+        ESP_LOGE(TAG, "Modem is not responding after baud rate fallback");
+        return ESP_ERR_INVALID_RESPONSE;
+    }
+
+    return ESP_FAIL;
+}
+
 esp_err_t SIM7000_Modem::get_signal_strength(int8_t &value, signal_strength_t *strength)
 {
     // espera hasta que el modulo esté disponible
     std::lock_guard lock(m_mutex);
     esp_err_t result;
     uint8_t rssi;
-    std::string &response = m_result_info->response;
+    std::string &response = m_result_info.response;
 
     // espera hasta que el modulo esté disponible;
     result = execute_internal_cmd(at_cmd_t::CSQ);
     if (result == ESP_OK) {
-        helpers::remove_before(response, ": ");
-        rssi = helpers::to_number<uint8_t>(response);
-
-        if (rssi == 0) {
-            value = -115;
-        } else if (rssi == 1) {
-            value = -111;
-        } else if (rssi >= 2 && rssi <= 30) {
-            float factor = (rssi - 2) / 28.0f;
-            float delta = (110 - 54) * factor;
-            value = -110 + (int8_t)(delta);
-        } else if (rssi == 31) {
-            value = -52;
-        } else {
-            value = 0;
-        }
+        SIM7000_ResponseFields fields(response);
+        rssi = fields.get_int<uint8_t>(0, 99);
+        value = rssi_to_dbm(rssi);
 
         if (strength != nullptr) {
-            if (value == 0) {
-                *strength = signal_strength_t::NOT_DETECTABLE;
-            } else if (value > -60) {
-                *strength = signal_strength_t::EXCELLENT;
-            } else if (value > -85) {
-                *strength = signal_strength_t::GOOD;
-            } else {
-                *strength = signal_strength_t::MARGINAL;
-            }
+            *strength = to_signal_strength(value);
         }
 
         ESP_LOGI(TAG, "RSSI: %u (%d dBm)", rssi, value);
@@ -380,42 +764,15 @@ esp_err_t SIM7000_Modem::get_network_reg_status(network_reg_status_t &status)
     // espera hasta que el modulo esté disponible
     std::lock_guard lock(m_mutex);
     esp_err_t result;
-    uint8_t value;
-    std::string &response = m_result_info->response;
+    std::string &response = m_result_info.response;
 
     // espera hasta que el modulo esté disponible
     result = execute_internal_cmd(at_cmd_t::CGREG, "?");
     if (result == ESP_OK) {
-        helpers::remove_before(response, ",");
-        value = helpers::to_number<uint8_t>(response);
-
-        switch (value)
-        {
-            case 0:
-                status = network_reg_status_t::NOT_REGISTERED;
-                ESP_LOGI(TAG, "Module is not registered in network");
-                break;
-            case 1:
-                status = network_reg_status_t::REGISTERED;
-                ESP_LOGI(TAG, "Module is registered in network");
-                break;
-            case 2:
-                status = network_reg_status_t::TRYING_TO_REGISTER;
-                ESP_LOGI(TAG, "Module is trying to register in network");
-                break;
-            case 3:
-                status = network_reg_status_t::REGISTRATION_DENIED;
-                ESP_LOGI(TAG, "Module registration in network was denied");
-                break;
-            case 5:
-                status = network_reg_status_t::REGISTERED_ROAMING;
-                ESP_LOGI(TAG, "Module is registered in network (roaming)");
-                break;
-            default:
-                ESP_LOGI(TAG, "Module is in unknown resgistration state");
-                status = network_reg_status_t::UNKNOWN;
-                break;
-        }
+        SIM7000_ResponseFields fields(response);
+        status = to_network_reg_status(fields.get_int<uint8_t>(1, 4));
+        m_status_cache.set_reg_status(status);
+        log_network_reg_status(status);
     }
 
     return result;
@@ -425,7 +782,7 @@ esp_err_t SIM7000_Modem::get_connection_status(connection_status_t &status)
 {
     std::lock_guard lock(m_mutex);
     esp_err_t result;
-    std::string &response = m_result_info->response;
+    std::string &response = m_result_info.response;
 
     // obtiene el estado de conexión
     result = execute_internal_cmd(at_cmd_t::CIPSTATUS, 0, false, true);
@@ -480,33 +837,17 @@ esp_err_t SIM7000_Modem::get_current_operator(std::string &op_name, operator_net
     // espera hasta que el modulo esté disponible
     std::lock_guard lock(m_mutex);
     esp_err_t result;
-    std::string &response = m_result_info->response;
+    std::string &response = m_result_info.response;
 
     // espera hasta que el modulo esté disponible
     result = execute_internal_cmd(at_cmd_t::COPS, "?");
     if (result == ESP_OK) {
-        // remueve el comando de la cadena
-        helpers::remove_before(response, ": ");
-        // extrae el nombre del operador y quita comillas (si las hay)
-        helpers::extract_token(response, 2, ",", op_name, true);
-        helpers::trim(op_name);
+        SIM7000_ResponseFields fields(response);
+        // extrae el nombre del operador (sin comillas)
+        fields.get_string(2, op_name);
         // extrae el indicador tipo de conexión
-        helpers::extract_token(response, 3, ",", true);
-        
         if (nectact != nullptr) {
-            if (response == "0") {
-                *nectact = operator_netact_t::USER_SPECIFIED;
-            } else if (response == "1") {
-                *nectact = operator_netact_t::GSM_COMPACT;
-            } else if (response == "3") {
-                *nectact = operator_netact_t::GSM_EGPRS;
-            } else if (response == "7") {
-                *nectact = operator_netact_t::LTE_M1_A_GB;
-            } else if (response == "9") {
-                *nectact = operator_netact_t::LTE_NB_S1;
-            } else {
-                *nectact = operator_netact_t::UNKNOWN;
-            }
+            *nectact = to_operator_netact(fields.get_string(3));
         }
 
         if (op_name.empty()) {
@@ -519,11 +860,80 @@ esp_err_t SIM7000_Modem::get_current_operator(std::string &op_name, operator_net
     return result;
 }
 
+esp_err_t SIM7000_Modem::query_status_bundle(network_status_t &status)
+{
+    std::lock_guard lock(m_mutex);
+    esp_err_t result;
+
+    // el modem responde cada comando en su propia línea y un solo OK al final
+    result = execute_internal_cmd(
+        at_cmd_t::CSQ,
+        STATUS_BUNDLE_PARAMS,
+        pdMS_TO_TICKS(STATUS_BUNDLE_TIMEOUT_MS)
+    );
+    if (result == ESP_OK) {
+        result = parse_status_bundle(m_result_info.response, status);
+    }
+
+    if (result == ESP_OK) {
+        m_status_cache.update(status);
+    } else {
+        ESP_LOGW(TAG, "Failed to query network status (%s)", esp_err_to_name(result));
+    }
+
+    return result;
+}
+
+threading::Async<esp_err_t> SIM7000_Modem::query_status_bundle_async(network_status_t &status)
+{
+    SIM7000_CmdSlot slot = co_await acquire_cmd_slot_async();
+    esp_err_t result = slot.format_params("%s", STATUS_BUNDLE_PARAMS);
+
+    if (result == ESP_OK) {
+        result = co_await exec(
+            at_cmd_t::CSQ,
+            slot,
+            pdMS_TO_TICKS(STATUS_BUNDLE_TIMEOUT_MS)
+        );
+    }
+    if (result == ESP_OK) {
+        result = parse_status_bundle(slot.get_response(), status);
+    }
+
+    if (result == ESP_OK) {
+        m_status_cache.update(status);
+    } else {
+        ESP_LOGW(TAG, "Failed to query network status (%s)", esp_err_to_name(result));
+    }
+
+    co_return result;
+}
+
+esp_err_t SIM7000_Modem::get_network_status(network_status_t &status, bool force_refresh)
+{
+    if (!force_refresh && m_status_cache.get(status)) {
+        return ESP_OK;
+    }
+
+    return query_status_bundle(status);
+}
+
+threading::Async<esp_err_t> SIM7000_Modem::get_network_status_async(
+    network_status_t &status,
+    bool force_refresh)
+{
+    if (!force_refresh && m_status_cache.get(status)) {
+        co_return ESP_OK;
+    }
+
+    co_return co_await query_status_bundle_async(status);
+}
+
 esp_err_t SIM7000_Modem::get_local_ip(std::string &ip)
 {
     std::lock_guard lock(m_mutex);
     esp_err_t result;
-    std::string &response = m_result_info->response;
+    std::string &response = m_result_info.response;
 
     // obtiene el APN actual
     result = execute_internal_cmd(at_cmd_t::CIFSR, 0, false, true);
@@ -572,35 +982,224 @@ esp_err_t SIM7000_Modem::deactivate_network()
     return result;
 }
 
-esp_err_t SIM7000_Modem::enable_comm()
+esp_err_t SIM7000_Modem::enable_comm()
+{
+    ESP_LOGI(TAG, "Configuring GRPS...");
+    esp_err_t err = config_gprs();
+
+    if (err == ESP_OK) {
+        ESP_LOGI(TAG, "Configuring TCP APP Toolkit...");
+        err = config_tcp_tk();
+    }
+    if (err == ESP_OK) {
+        ESP_LOGI(TAG, "Configuring IP...");
+        err = config_ip_app();
+    }
+
+    return err;
+}
+
+esp_err_t SIM7000_Modem::enter_data_mode(TickType_t ticks_to_wait)
+{
+    std::lock_guard lock(m_mutex);
+    esp_err_t err = ESP_OK;
+
+    if (!m_is_running || is_data_mode() || m_is_ppp_channel_online) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    // la interfaz de red se crea la primera vez
+    if (m_ppp.get_netif() == nullptr) {
+        err = m_ppp.init(write_ppp_data, this, on_ppp_status, this);
+    }
+    if (err == ESP_OK) {
+        err = m_ppp.set_auth(m_apn.user, m_apn.pwd);
+    }
+    if (err != ESP_OK) return err;
+
+    uint8_t cid = m_apn.cid != 0 ? m_apn.cid : 1;
+    char buffer[16];
+    int length = snprintf(buffer, sizeof(buffer), "*99***%u#", cid);
+    std::span<const char> params(buffer, length);
+
+    if (m_is_cmux) {
+        // la llamada ocupa solo el canal de datos
+        ESP_LOGI(TAG, "Dialing PPP connection on multiplexer (CID %u)", cid);
+        err = dial_ppp_channel(params);
+    } else {
+        // los datos de la conexión no tienen líneas que detectar
+        if (m_rx_mode == uart_rx_mode_t::LINE_EVENTS) {
+            uart_disable_pattern_det_intr(m_port);
+        }
+
+        ESP_LOGI(TAG, "Dialing PPP connection (CID %u)", cid);
+        err = execute_internal_cmd_no_answer(at_cmd_t::D, params, pdMS_TO_TICKS(PPP_DIAL_TIMEOUT_MS));
+
+        // un OK sin CONNECT no inicia el modo de datos
+        if (err == ESP_OK && !is_data_mode()) {
+            err = ESP_ERR_INVALID_RESPONSE;
+        }
+    }
+
+    if (err == ESP_OK) {
+        err = m_ppp.start();
+    }
+    if (err == ESP_OK) {
+        err = m_ppp.wait_for_ip(ticks_to_wait);
+    }
+
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to establish PPP connection (%s)", esp_err_to_name(err));
+
+        if (is_data_mode() || m_is_ppp_channel_online) {
+            exit_data_mode();
+        } else if (!m_is_cmux) {
+            restore_rx_mode();
+        }
+    }
+
+    return err;
+}
+
+esp_err_t SIM7000_Modem::exit_data_mode()
+{
+    std::lock_guard lock(m_mutex);
+    esp_err_t err;
+
+    if (m_is_ppp_channel_online) return hang_up_ppp_channel();
+    if (!is_data_mode()) return ESP_ERR_INVALID_STATE;
+
+    // termina el enlace (LCP Terminate-Request); el modem cuelga al recibirlo
+    // y regresa al modo de comandos
+    m_ppp.stop();
+    vTaskDelay(pdMS_TO_TICKS(DATA_MODE_GUARD_TIME_MS));
+
+    leave_data_mode();
+    uart_flush_input(m_port);
+    restore_rx_mode();
+
+    err = verify_link();
+    if (err != ESP_OK) {
+        // el modem sigue en modo de datos (p. ej. el enlace se perdió sin
+        // terminar la llamada), por lo que se usa la secuencia de escape
+        ESP_LOGW(TAG, "Modem is still in data mode, sending escape sequence");
+        vTaskDelay(pdMS_TO_TICKS(DATA_MODE_GUARD_TIME_MS));
+        uart_write_bytes(m_port, "+++", 3);
+        vTaskDelay(pdMS_TO_TICKS(DATA_MODE_GUARD_TIME_MS));
+
+        err = verify_link();
+        if (err == ESP_OK) {
+            err = execute_internal_cmd_no_answer(at_cmd_t::H);
+        }
+    }
+
+    if (err == ESP_OK) {
+        ESP_LOGI(TAG, "PPP connection closed");
+    } else {
+        ESP_LOGE(TAG, "Modem did not return to command mode (%s)", esp_err_to_name(err));
+    }
+
+    return err;
+}
+
+esp_err_t SIM7000_Modem::start_cmux(bool enable_nmea)
+{
+    std::lock_guard lock(m_mutex);
+    esp_err_t err;
+
+    if (!m_is_running || m_is_cmux || is_data_mode()) return ESP_ERR_INVALID_STATE;
+
+    ESP_LOGI(TAG, "Starting multiplexer...");
+    err = execute_internal_cmd_no_answer(at_cmd_t::CMUX, "=0");
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Modem rejected multiplexer mode (%s)", esp_err_to_name(err));
+        return err;
+    }
+
+    // a partir de aquí la UART solo transporta tramas
+    if (m_rx_mode == uart_rx_mode_t::LINE_EVENTS) {
+        uart_disable_pattern_det_intr(m_port);
+    }
+    m_is_cmux = true;
+
+    err = m_cmux.open(CMUX_CONTROL_CHANNEL);
+    if (err == ESP_OK) {
+        err = m_cmux.open(CMUX_AT_CHANNEL);
+    }
+    if (err == ESP_OK) {
+        err = m_cmux.open(CMUX_PPP_CHANNEL);
+    }
+    if (err == ESP_OK && enable_nmea) {
+        err = m_cmux.open(CMUX_NMEA_CHANNEL);
+
+        // el GNSS envía las sentencias por el canal que las solicita
+        if (err == ESP_OK) {
+            const char *command = "AT+CGNSTST=1\r";
+            m_nmea_length = 0;
+            m_cmux.write(CMUX_NMEA_CHANNEL, command, strlen(command));
+        }
+    }
+    if (err == ESP_OK) {
+        err = verify_link();
+    }
+
+    if (err == ESP_OK) {
+        ESP_LOGI(TAG, "Multiplexer started");
+    } else {
+        ESP_LOGE(TAG, "Failed to start multiplexer (%s)", esp_err_to_name(err));
+        stop_cmux();
+    }
+
+    return err;
+}
+
+esp_err_t SIM7000_Modem::stop_cmux()
 {
-    ESP_LOGI(TAG, "Configuring GRPS...");
-    esp_err_t err = config_gprs();
+    std::lock_guard lock(m_mutex);
 
-    if (err == ESP_OK) {
-        ESP_LOGI(TAG, "Configuring TCP APP Toolkit...");
-        err = config_tcp_tk();
+    if (!m_is_cmux) return ESP_ERR_INVALID_STATE;
+
+    if (m_is_ppp_channel_online) {
+        hang_up_ppp_channel();
     }
+
+    // el modem regresa al modo de comandos en la UART después de CLD
+    m_cmux.close();
+    m_is_cmux = false;
+    vTaskDelay(pdMS_TO_TICKS(BAUD_RATE_SWITCH_DELAY_MS));
+    uart_flush_input(m_port);
+    restore_rx_mode();
+
+    esp_err_t err = verify_link();
     if (err == ESP_OK) {
-        ESP_LOGI(TAG, "Configuring IP...");
-        err = config_ip_app();
+        ESP_LOGI(TAG, "Multiplexer stopped");
+    } else {
+        ESP_LOGE(TAG, "Modem did not respond after closing multiplexer");
     }
 
     return err;
 }
 
+esp_err_t SIM7000_Modem::enable_supervisor()
+{
+    if (!m_is_running) return ESP_ERR_INVALID_STATE;
+    return m_supervisor.enable();
+}
+
+esp_err_t SIM7000_Modem::disable_supervisor()
+{
+    return m_supervisor.disable();
+}
+
 /* Métodos generales de inicialización */
 
 esp_err_t SIM7000_Modem::config_gprs()
 {
     std::lock_guard lock(m_mutex);
-    std::string &response = m_result_info->response;
+    std::string &response = m_result_info.response;
+    SIM7000_ResponseFields fields;
     std::string payload;
-    std::string cid = std::to_string(m_apn.cid);
-    std::string cid_str = ": " + cid + ",";
     esp_err_t result;
-    size_t index, len;
-    uint8_t value;
 
     // valida valor de CID
     if (m_apn.cid == 0 || m_apn.cid > 24) {
@@ -608,14 +1207,15 @@ esp_err_t SIM7000_Modem::config_gprs()
         m_apn.cid = 1;
     }
 
+    std::string cid = std::to_string(m_apn.cid);
+
     // obtiene los estados de activación de contexto PDP
     result = execute_internal_cmd(at_cmd_t::CGACT, "?");
     if (result == ESP_OK) {
+        // +CGACT: <cid>,<state>
+        find_cid_fields(response, m_apn.cid, fields);
 
-        index = response.find_first_of(cid_str) + cid_str.length();
-        value = helpers::to_number<uint8_t>(response, index, 1);
-
-        if (value == 1) {
+        if (fields.get_int<uint8_t>(1) == 1) {
             ESP_LOGI(TAG, "PDP Context is active");
         } else {
             ESP_LOGW(TAG, "PDP Context is not active");
@@ -626,22 +1226,23 @@ esp_err_t SIM7000_Modem::config_gprs()
     }
 
     if (result == ESP_OK) {
-        index = response.find_first_of(cid_str) + cid_str.length();
-        payload = response.substr(index);
+        // +CGPADDR: <cid>,<address>
+        find_cid_fields(response, m_apn.cid, fields);
+        std::string_view address = fields.get_string(1);
 
-        ESP_LOGI(TAG, "PDP address: %s", payload.c_str());
+        ESP_LOGI(TAG, "PDP address: %.*s", (int)address.length(), address.data());
         // obtiene la definición de contexto PDP
         result = execute_internal_cmd(at_cmd_t::CGDCONT, "?", 0);
     }
 
     if (result == ESP_OK) {
-        index = response.find_first_of(cid_str) + cid_str.length();
-        len = response.find_first_of(CR, index) - index;
-        payload = response.substr(index, len);
+        // +CGDCONT: <cid>,<type>,<apn>,...
+        find_cid_fields(response, m_apn.cid, fields);
+        std::string_view apn = fields.get_string(2);
 
-        ESP_LOGI(TAG, "PDP context: %s", payload.c_str());
+        ESP_LOGI(TAG, "PDP context APN: %.*s", (int)apn.length(), apn.data());
 
-        if (payload.find_first_of(m_apn.apn) == std::string::npos) {
+        if (apn != m_apn.apn) {
             ESP_LOGI(TAG, "APN is not set in PDP context, setting it...");
             payload = "=" + cid + ",\"" + m_apn.apn + "\"";
             result = execute_internal_cmd(at_cmd_t::CGDCONT, payload);
@@ -658,16 +1259,12 @@ esp_err_t SIM7000_Modem::config_gprs()
     }
 
     if (result == ESP_OK) {
-        ESP_LOGI(TAG, "%s", response.c_str());
-        index = response.find_first_of(":") + 2;
-        value = helpers::to_number<uint8_t>(response, index, 1);
+        // +CGNAPN: <valid>,<apn>
+        fields.split(response);
 
-        if (value == 1) {
-            index = response.find_first_of('\"') + 1;
-            len = response.find_last_of('\"') - index;
-            payload = response.substr(index, len);
-
-            ESP_LOGI(TAG, "Network APN: %s", payload.c_str());
+        if (fields.get_int<uint8_t>(0) == 1) {
+            std::string_view apn = fields.get_string(1);
+            ESP_LOGI(TAG, "Network APN: %.*s", (int)apn.length(), apn.data());
         } else {
             ESP_LOGW(TAG, "Network did not send APN parameter");
             result = ESP_FAIL;
@@ -791,14 +1388,13 @@ esp_err_t SIM7000_Modem::read_tcptk_apn(std::string &apn)
 {
     std::lock_guard lock(m_mutex);
     esp_err_t err;
-    std::string &response = m_result_info->response;
+    std::string &response = m_result_info.response;
 
     ESP_LOGI(TAG, "Reading TCP APN...");
     err = execute_internal_cmd(at_cmd_t::CSTT, "?");
     if (err == ESP_OK) {
-        helpers::remove_before(response, ": ");
-        helpers::extract_token(response, 0, ",", apn, true);
-        helpers::trim(apn);
+        SIM7000_ResponseFields fields(response);
+        fields.get_string(0, apn);
     } 
 
     if (err == ESP_OK) {
@@ -900,30 +1496,29 @@ esp_err_t SIM7000_Modem::query_bearer(bearer_status_t &status, std::string *ip)
 {
     std::lock_guard lock(m_mutex);
     esp_err_t err;
-    std::string &response = m_result_info->response;
+    std::string &response = m_result_info.response;
     std::string payload = "=2,";
     payload.append(std::to_string(m_apn.cid));
     
     ESP_LOGI(TAG, "Querying bearer...");
     err = execute_internal_cmd(at_cmd_t::SAPBR, payload);
     if (err == ESP_OK) {
-        helpers::remove_before(response, ": ");
+        SIM7000_ResponseFields fields(response);
         // verifica y extrae la IP del portador (si se requiere)
         if (ip != nullptr) {
-            helpers::extract_token(response, 2, ",", *ip, true);
-            helpers::trim(*ip);
+            fields.get_string(2, *ip);
         }
         
         // extrae el estado del portador
-        helpers::extract_token(response, 1, ",", true);
+        std::string_view value = fields.get_string(1);
 
-        if (response == "0") {
+        if (value == "0") {
             status = bearer_status_t::CONNECTING;
-        } else if (response == "1") {
+        } else if (value == "1") {
             status = bearer_status_t::CONNECTED;
-        } else if (response == "2") {
+        } else if (value == "2") {
             status = bearer_status_t::CLOSING;
-        } else if (response == "3") {
+        } else if (value == "3") {
             status = bearer_status_t::CLOSED;
         } else {
             status = bearer_status_t::UNKNOWN;
@@ -961,26 +1556,25 @@ esp_err_t SIM7000_Modem::set_bearer_param(const char *param_name, const char *pa
 esp_err_t SIM7000_Modem::get_net_active_status(network_active_status_t &status, std::string *ip)
 {
     std::lock_guard lock(m_mutex);
-    std::string &response = m_result_info->response;
+    std::string &response = m_result_info.response;
     esp_err_t err;
 
     ESP_LOGI(TAG, "Getting network active status...");
     err = execute_internal_cmd(at_cmd_t::CNACT, "?");
     if (err == ESP_OK) {
-        helpers::remove_before(response, ": ");
+        SIM7000_ResponseFields fields(response);
         // verifica y extrae la dirección ip
         if (ip != nullptr) {
-            helpers::extract_token(response, 1, ",", *ip);
-            helpers::trim(*ip);
+            fields.get_string(1, *ip);
         }
 
         // extrae el estado de la red
-        helpers::remove_after(response, ",");
-        if (response == "0") {
+        std::string_view value = fields.get_string(0);
+        if (value == "0") {
             status = network_active_status_t::DEACTIVED;
-        } else if (response == "1") {
+        } else if (value == "1") {
             status = network_active_status_t::ACTIVED;
-        } else if (response == "2") {
+        } else if (value == "2") {
             status = network_active_status_t::IN_OPERATION;
         } else {
             status = network_active_status_t::UNKNOWN;
@@ -1042,19 +1636,37 @@ esp_err_t SIM7000_Modem::set_net_active_mode(network_active_mode_t mode, TickTyp
 esp_err_t SIM7000_Modem::setup()
 {
     // tiempo de espara de 7.5 segundos para recibir una respuesta
-    const TickType_t timeout_ms = pdMS_TO_TICKS(7500);
+    TickType_t timeout_ms = pdMS_TO_TICKS(7500);
     // intervalo de muestreo
     const TickType_t poll_interval = pdMS_TO_TICKS(100); // ms
     // envía el comando AT\r para verifica si el módulo está activo
     const char *at_cmd = "AT\r";
     esp_err_t result = ESP_ERR_TIMEOUT;
-    int elapsed = 0;
+    TickType_t elapsed = 0;
+    bool is_power_pulse_sent = false;
     int bytes_read = 0;
     uart_event_t event;
     std::string response;
 
-    // enciende el módulo
-    //gpio_set_level(m_pin_pwr, 1);
+    // velocidades con las que se intenta comunicar: primero la última que
+    // funcionó, después la predeterminada y al final las de alta velocidad
+    // (por si se perdió el valor guardado)
+    std::array<int, std::size(HIGH_SPEED_BAUD_RATES) + 2> baud_rates{};
+    size_t baud_rate_count = 0;
+    size_t attempt = 0;
+    int stored_baud_rate = load_baud_rate();
+
+    auto add_baud_rate = [&](int baud_rate) {
+        auto end = baud_rates.begin() + baud_rate_count;
+        if (baud_rate > 0 && std::find(baud_rates.begin(), end, baud_rate) == end) {
+            baud_rates[baud_rate_count++] = baud_rate;
+        }
+    };
+
+    add_baud_rate(stored_baud_rate);
+    add_baud_rate(m_default_baud_rate);
+    for (int baud_rate : HIGH_SPEED_BAUD_RATES) add_baud_rate(baud_rate);
+
     // espera para estabilizar
     vTaskDelay(pdMS_TO_TICKS(100));
 
@@ -1063,6 +1675,13 @@ esp_err_t SIM7000_Modem::setup()
 
     // bucle que se ejecuta hasta que haya transcurrido el tiempo de espera máximo
     while (elapsed < timeout_ms) {
+        // alterna la velocidad en cada intento
+        int baud_rate = baud_rates[attempt++ % baud_rate_count];
+        if (baud_rate != m_baud_rate) {
+            uart_set_baudrate(m_port, baud_rate);
+            m_baud_rate = baud_rate;
+        }
+
         uart_write_bytes(m_port, at_cmd, strlen(at_cmd));
 
         // espera hasta que se produzca un evento de datos recibidos
@@ -1085,6 +1704,25 @@ esp_err_t SIM7000_Modem::setup()
 
         // incrementa el tiempo transcurrido
         elapsed += poll_interval;
+
+        // si no responde a la mitad del tiempo puede estar apagado, por lo
+        // que se enciende con PWRKEY (un pulso menor a 1.2 s no lo apaga si
+        // ya estaba encendido) y se le da tiempo para arrancar
+        if (!is_power_pulse_sent && elapsed >= timeout_ms / 2) {
+            ESP_LOGW(TAG, "Module is not responding, turning it on...");
+            pulse_pwrkey(PWRKEY_ON_PULSE_MS);
+            is_power_pulse_sent = true;
+            timeout_ms += pdMS_TO_TICKS(MODEM_BOOT_TIMEOUT_MS);
+        }
+    }
+
+    // la detección de fin de línea se habilita hasta aquí para que la prueba
+    // anterior solo reciba eventos de datos
+    if (result == ESP_OK && m_rx_mode == uart_rx_mode_t::LINE_EVENTS) {
+        if (enable_line_events() != ESP_OK) {
+            ESP_LOGW(TAG, "Pattern detection not available, using data events");
+            m_rx_mode = uart_rx_mode_t::DATA_EVENTS;
+        }
     }
 
     // limpia el buffer UART
@@ -1094,7 +1732,11 @@ esp_err_t SIM7000_Modem::setup()
 
     if (result == ESP_OK) {
         m_is_running = true;
-        ESP_LOGI(TAG, "SIM7000 module ready");
+        ESP_LOGI(TAG, "SIM7000 module ready (%d baud)", m_baud_rate);
+        // actualiza el valor guardado si el modem respondió a otra velocidad
+        if (m_baud_rate != (stored_baud_rate ? stored_baud_rate : m_default_baud_rate)) {
+            save_baud_rate(m_baud_rate);
+        }
     } else {
         ESP_LOGE(TAG, "Failed to initialize SIM7000 module");
     }
@@ -1108,19 +1750,43 @@ void SIM7000_Modem::loop()
 
     // espera hasta recibir un evento
     if (xQueueReceive(m_uart_event_queue, &event, portMAX_DELAY)) {
+        // con el multiplexor o en modo de datos se entrega todo lo recibido
+        // sin separarlo en líneas
+        if ((m_is_cmux || is_data_mode()) &&
+            (event.type == UART_DATA ||
+             event.type == UART_PATTERN_DET ||
+             event.type == UART_BUFFER_FULL)) {
+            receive_raw_data();
+            return;
+        }
+
         switch (event.type) 
         {
             case UART_DATA:
-                if (event.size != 0) {
+                if (m_rx_mode == uart_rx_mode_t::LINE_EVENTS) {
+                    // los datos se quedan en el buffer del controlador hasta
+                    // que se complete la línea, salvo que la línea quede
+                    // inactiva sin un fin de línea ("> " o datos en crudo)
+                    if (event.timeout_flag) {
+                        receive_buffered_data();
+                    }
+                } else if (event.size != 0) {
                     ESP_LOGD(TAG, "Received data from UART (%u bytes)", event.size);
                     receive_uart_data(event.size);
                 }
                 break;
+            case UART_PATTERN_DET:
+                receive_line_data();
+                break;
             case UART_FIFO_OVF:
                 ESP_LOGW(TAG, "UART FIFO overflow");
                 break;
             case UART_BUFFER_FULL:
                 ESP_LOGW(TAG, "UART buffer full");
+                // libera espacio aunque la línea no esté completa
+                if (m_rx_mode == uart_rx_mode_t::LINE_EVENTS) {
+                    receive_buffered_data();
+                }
                 break;
             case UART_PARITY_ERR:
             case UART_FRAME_ERR:
@@ -1134,28 +1800,213 @@ void SIM7000_Modem::loop()
 
 void SIM7000_Modem::receive_uart_data(size_t length)
 {
-    if (uart_read_bytes(m_port, m_rx_buffer, length, 0) != length) {
-        ESP_LOGE(TAG, "Failed to read data");
+    int bytes_read;
+
+    while (length > 0) {
+        // obtiene la región libre del buffer del analizador para leer los 
+        // datos directamente en él
+        auto window = get_parser_window();
+        if (window.empty()) {
+            ESP_LOGE(TAG, "Parser buffer is full");
+            return;
+        }
+
+        bytes_read = uart_read_bytes(
+            m_port,
+            window.data(),
+            std::min(length, window.size()),
+            0
+        );
+
+        if (bytes_read <= 0) {
+            ESP_LOGE(TAG, "Failed to read data");
+            return;
+        }
+
+        m_transcript.record(transcript_dir_t::RX, window.data(), bytes_read);
+
+        length -= bytes_read;
+        commit_parser_window(bytes_read);
+    }
+}
+
+void SIM7000_Modem::receive_buffered_data()
+{
+    size_t length = 0;
+    uart_get_buffered_data_len(m_port, &length);
+    if (length > 0) {
+        receive_uart_data(length);
+    }
+}
+
+void SIM7000_Modem::receive_line_data()
+{
+    int pos;
+    int last_pos = -1;
+
+    // un mismo evento puede corresponder a varias líneas; se toma hasta la
+    // última detectada para analizarlas de una sola vez
+    while ((pos = uart_pattern_pop_pos(m_port)) >= 0) {
+        last_pos = pos;
+    }
+
+    // si no hay posiciones, las líneas ya se leyeron con un evento anterior
+    // (la cola se actualiza conforme se leen los datos)
+    if (last_pos >= 0) {
+        ESP_LOGD(TAG, "Received line(s) from UART (%d bytes)", last_pos + 1);
+        receive_uart_data(last_pos + 1);
+    }
+}
+
+void SIM7000_Modem::receive_raw_data()
+{
+    size_t length = 0;
+    int bytes_read;
+
+    uart_get_buffered_data_len(m_port, &length);
+
+    while (length > 0) {
+        bytes_read = uart_read_bytes(
+            m_port,
+            m_rx_buffer,
+            std::min(length, sizeof(m_rx_buffer)),
+            0
+        );
+
+        if (bytes_read <= 0) break;
+
+        if (m_is_cmux) {
+            // el multiplexor entrega el contenido de cada trama a su canal
+            m_cmux.feed(m_rx_buffer, bytes_read);
+        } else {
+            m_ppp.receive(m_rx_buffer, bytes_read);
+        }
+
+        length -= bytes_read;
+    }
+}
+
+void SIM7000_Modem::receive_ppp_channel_data(const char *data, size_t length)
+{
+    if (m_is_ppp_channel_online) {
+        m_ppp.receive(data, length);
         return;
     }
-    
-    feed_buffer(m_rx_buffer, length);
+
+    // respuesta del marcado en el canal de datos
+    split_lines(m_ppp_dial_buffer, m_ppp_dial_length, data, length, [this](std::string_view line)
+    {
+        if (line.starts_with("CONNECT")) {
+            // lo que sigue ya son datos de la conexión, que lwIP aún no
+            // espera (el modem repite su solicitud LCP)
+            m_is_ppp_channel_online = true;
+            m_event_group.set_flags(PPP_CHANNEL_CONNECT_BIT);
+            return false;
+        }
+
+        if (line == "NO CARRIER" || line == "ERROR" || line.starts_with("+CME ERROR")) {
+            ESP_LOGW(TAG, "PPP dial failed (%.*s)", (int)line.length(), line.data());
+            m_event_group.set_flags(PPP_CHANNEL_FAILED_BIT);
+        }
+
+        return true;
+    });
+}
+
+void SIM7000_Modem::receive_nmea_data(const char *data, size_t length)
+{
+    split_lines(m_nmea_buffer, m_nmea_length, data, length, [this](std::string_view line)
+    {
+        if (line.starts_with('$')) {
+            // la sentencia se publica sin el fin de línea; no espera lugar en
+            // la cola para no detener el multiplexor
+            post_event(MODEM_EVENT_GNSS_NMEA_SENTENCE, (void *)line.data(), line.length() + 1, 0);
+        }
+
+        return true;
+    });
+}
+
+esp_err_t SIM7000_Modem::dial_ppp_channel(const std::span<const char> &params)
+{
+    char line[32];
+    size_t length = build_cmd_line(*get_command_def(at_cmd_t::D), params, line);
+    if (length == 0) return ESP_ERR_INVALID_SIZE;
+
+    m_ppp_dial_length = 0;
+    m_event_group.clear_flags(PPP_CHANNEL_CONNECT_BIT | PPP_CHANNEL_FAILED_BIT);
+
+    if (m_cmux.write(CMUX_PPP_CHANNEL, line, length) < 0) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    uint32_t flags = m_event_group.wait_for_flags(
+        PPP_CHANNEL_CONNECT_BIT | PPP_CHANNEL_FAILED_BIT,
+        true,
+        false,
+        pdMS_TO_TICKS(PPP_DIAL_TIMEOUT_MS)
+    );
+
+    if (flags & PPP_CHANNEL_CONNECT_BIT) return ESP_OK;
+    return flags & PPP_CHANNEL_FAILED_BIT ? ESP_FAIL : ESP_ERR_TIMEOUT;
+}
+
+esp_err_t SIM7000_Modem::hang_up_ppp_channel()
+{
+    // el modem termina la llamada al recibir LCP Terminate-Request
+    esp_err_t err = m_ppp.stop();
+
+    if (err != ESP_OK) {
+        // si no respondió, usa la secuencia de escape y cuelga en el mismo
+        // canal
+        ESP_LOGW(TAG, "Sending escape sequence on data channel");
+        vTaskDelay(pdMS_TO_TICKS(DATA_MODE_GUARD_TIME_MS));
+        m_cmux.write(CMUX_PPP_CHANNEL, "+++", 3);
+        vTaskDelay(pdMS_TO_TICKS(DATA_MODE_GUARD_TIME_MS));
+        m_cmux.write(CMUX_PPP_CHANNEL, "ATH\r", 4);
+        err = ESP_OK;
+    }
+
+    m_is_ppp_channel_online = false;
+    ESP_LOGI(TAG, "PPP connection closed");
+
+    return err;
+}
+
+esp_err_t SIM7000_Modem::enable_line_events()
+{
+    // detecta cada '\n' sin requerir tiempo de inactividad antes o después
+    esp_err_t err = uart_enable_pattern_det_baud_intr(m_port, LF, 1, 9, 0, 0);
+    if (err == ESP_OK) {
+        err = uart_pattern_queue_reset(m_port, DEFAULT_PATTERN_QUEUE_SIZE);
+    }
+    if (err != ESP_OK) {
+        uart_disable_pattern_det_intr(m_port);
+    }
+
+    return err;
+}
+
+void SIM7000_Modem::restore_rx_mode()
+{
+    if (m_rx_mode == uart_rx_mode_t::LINE_EVENTS && enable_line_events() != ESP_OK) {
+        ESP_LOGW(TAG, "Pattern detection not available, using data events");
+        m_rx_mode = uart_rx_mode_t::DATA_EVENTS;
+    }
 }
 
-void SIM7000_Modem::on_urc_message(std::string &payload)
+void SIM7000_Modem::on_urc_message(std::string_view line, const urc_def_t &def)
 {
+    // copia la línea al buffer de URC (reservado previamente)
+    std::string &payload = m_urc_buffer;
+    payload.assign(line);
     helpers::trim(payload, CRLF " ");
     if (payload.empty()) return;
 
     ESP_LOGI(TAG, "URC message received (%u bytes)", payload.length());
     ESP_LOGI(TAG, "URC: %s", payload.c_str());
-
-    auto def = get_urc_def(payload);
-    if (def == nullptr) {
-        return;
-    }
     
-    switch (def->urc)
+    switch (def.urc)
     {
         case urc_t::DST:
         {
@@ -1167,8 +2018,31 @@ void SIM7000_Modem::on_urc_message(std::string &payload)
             ESP_LOGI(TAG, "Refresh date and time by network");
             post_event(MODEM_EVENT_DATE_TIME_UPDATED);
             break;
+        case urc_t::CREG:
+        case urc_t::CGREG:
+        {
+            // "+CGREG: <stat>[,<lac>,<ci>]"
+            SIM7000_ResponseFields fields(payload);
+            network_reg_status_t status = to_network_reg_status(fields.get_int<uint8_t>(0, 4));
+            log_network_reg_status(status);
+            m_status_cache.set_reg_status(status);
+            // el operador y la señal pueden cambiar junto con el registro
+            m_status_cache.invalidate(network_status_field_t::OPERATOR);
+            m_status_cache.invalidate(network_status_field_t::SIGNAL);
+            break;
+        }
+        case urc_t::SMSTATE:
+        {
+            SIM7000_ResponseFields fields(payload);
+            bool connected = fields.get_int<uint8_t>(0) != 0;
+            ESP_LOGI(TAG, "MQTT connection state changed (%d)", connected);
+            m_status_cache.set_mqtt_state(connected);
+            break;
+        }
         case urc_t::PDP_DEACT:
             ESP_LOGI(TAG, "GRPS is disconnected by network");
+            m_status_cache.invalidate(network_status_field_t::REGISTRATION);
+            m_status_cache.set_mqtt_state(false);
             m_event_group.set_flags(PDP_DEACT_BIT);
             post_event(MODEM_EVENT_PDP_DEACTIVE);
             break;
@@ -1180,16 +2054,20 @@ void SIM7000_Modem::on_urc_message(std::string &payload)
             break;
         case urc_t::APP_PDP_DEACTIVE:
             ESP_LOGI(TAG, "TCP APP Tookit is now active");
+            // la conexión MQTT depende del contexto de la aplicación
+            m_status_cache.set_mqtt_state(false);
             m_event_group.set_flags(APP_PDP_DEACTIVE_BIT);
             m_event_group.clear_flags(APP_PDP_ACTIVE_BIT);
             post_event(MODEM_EVENT_APP_PDP_DEACTIVE);
             break;
         case urc_t::CFUN:
             ESP_LOGI(TAG, "Phone functionality has changed");
+            m_status_cache.invalidate_all();
             post_event(MODEM_EVENT_FUNC_CHANGED);
             break;
         case urc_t::CPIN:
             ESP_LOGI(TAG, "SIM Card status has changed");
+            m_status_cache.invalidate_all();
             post_cpin_event(payload);
             break;
         case urc_t::SMSUB:
@@ -1205,11 +2083,236 @@ void SIM7000_Modem::on_urc_message(std::string &payload)
     }
 }
 
+esp_err_t SIM7000_Modem::apply_uart_baud_rate(int baud_rate)
+{
+    // espera a que termine de enviarse lo pendiente a la velocidad actual
+    uart_wait_tx_done(m_port, pdMS_TO_TICKS(100));
+    vTaskDelay(pdMS_TO_TICKS(BAUD_RATE_SWITCH_DELAY_MS));
+
+    esp_err_t err = uart_set_baudrate(m_port, baud_rate);
+    if (err == ESP_OK) {
+        m_baud_rate = baud_rate;
+        // descarta lo recibido durante el cambio
+        uart_flush_input(m_port);
+    }
+
+    return err;
+}
+
+esp_err_t SIM7000_Modem::verify_link()
+{
+    esp_err_t err = ESP_ERR_TIMEOUT;
+
+    for (int i = 0; i < BAUD_RATE_VERIFY_ATTEMPTS && err != ESP_OK; i++) {
+        err = execute_internal_cmd_no_answer(
+            at_cmd_t::AT,
+            pdMS_TO_TICKS(BAUD_RATE_VERIFY_TIMEOUT_MS)
+        );
+    }
+
+    return err;
+}
+
+esp_err_t SIM7000_Modem::probe_link()
+{
+    std::lock_guard lock(m_mutex);
+
+    // sin multiplexor, el modo de datos no acepta comandos
+    if (is_data_mode()) return ESP_ERR_INVALID_STATE;
+
+    return verify_link();
+}
+
+esp_err_t SIM7000_Modem::reset_modem()
+{
+    std::lock_guard lock(m_mutex);
+    esp_err_t err;
+
+    if (is_data_mode()) return ESP_ERR_INVALID_STATE;
+
+    // el modem responde OK y se reinicia
+    ESP_LOGW(TAG, "Resetting modem (AT+CFUN=1,1)...");
+    err = execute_internal_cmd_no_answer(
+        at_cmd_t::CFUN,
+        "=1,1",
+        pdMS_TO_TICKS(MODEM_RESET_TIMEOUT_MS)
+    );
+
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Modem did not accept reset (%s)", esp_err_to_name(err));
+        return err;
+    }
+
+    // el multiplexor y la conexión PPP terminan con el reinicio
+    reset_link_state();
+    return wait_for_boot();
+}
+
+esp_err_t SIM7000_Modem::power_cycle()
+{
+    std::lock_guard lock(m_mutex);
+
+    ESP_LOGW(TAG, "Power cycling modem (PWRKEY)...");
+    reset_link_state();
+
+    // sin una señal de estado no se sabe si el modem sigue encendido: si lo
+    // está, el primer pulso (más de 1.2 s) lo apaga y el segundo (menos de
+    // 1.2 s) lo enciende; si ya estaba apagado, el primero lo enciende y el
+    // segundo es demasiado corto para apagarlo
+    pulse_pwrkey(PWRKEY_OFF_PULSE_MS);
+    vTaskDelay(pdMS_TO_TICKS(POWER_OFF_DELAY_MS));
+    pulse_pwrkey(PWRKEY_ON_PULSE_MS);
+
+    return wait_for_boot();
+}
+
+esp_err_t SIM7000_Modem::wait_for_boot()
+{
+    const int64_t started_at = esp_timer_get_time();
+    const int64_t timeout_us = (int64_t)MODEM_BOOT_TIMEOUT_MS * 1000;
+    const int baud_rate = m_baud_rate;
+    // el modem conserva la velocidad de AT+IPR, pero se prueba también la
+    // predeterminada por si la perdió
+    const int baud_rates[] = { baud_rate, m_default_baud_rate };
+
+    while (esp_timer_get_time() - started_at < timeout_us) {
+        for (int rate : baud_rates) {
+            if (rate != m_baud_rate) apply_uart_baud_rate(rate);
+            if (verify_link() != ESP_OK) continue;
+
+            ESP_LOGI(TAG, "Modem is responding again (%d baud)", rate);
+            if (rate != baud_rate) {
+                ESP_LOGW(TAG, "Modem lost its baud rate, restoring %d", baud_rate);
+                set_baud_rate(baud_rate);
+            }
+
+            return ESP_OK;
+        }
+    }
+
+    apply_uart_baud_rate(baud_rate);
+    ESP_LOGE(TAG, "Modem did not respond after restarting");
+    return ESP_ERR_TIMEOUT;
+}
+
+esp_err_t SIM7000_Modem::wait_for_network(TickType_t ticks_to_wait)
+{
+    const TickType_t started_at = xTaskGetTickCount();
+    network_reg_status_t status = network_reg_status_t::UNKNOWN;
+
+    while (xTaskGetTickCount() - started_at < ticks_to_wait) {
+        if (get_network_reg_status(status) == ESP_OK &&
+            (status == network_reg_status_t::REGISTERED ||
+             status == network_reg_status_t::REGISTERED_ROAMING)) {
+            return ESP_OK;
+        }
+
+        vTaskDelay(pdMS_TO_TICKS(NETWORK_REG_POLL_INTERVAL_MS));
+    }
+
+    return ESP_ERR_TIMEOUT;
+}
+
+esp_err_t SIM7000_Modem::restore_state()
+{
+    std::lock_guard lock(m_mutex);
+    esp_err_t err;
+
+    ESP_LOGI(TAG, "Restoring modem configuration...");
+    m_status_cache.invalidate_all();
+
+    // la misma configuración que init()
+    err = execute_internal_cmd_no_answer(at_cmd_t::E, "0", pdMS_TO_TICKS(1000));
+    if (err == ESP_OK) {
+        err = execute_internal_cmd_no_answer(at_cmd_t::CGREG, "=1");
+    }
+    // el APN de la red solo se conoce después del registro
+    if (err == ESP_OK) {
+        err = wait_for_network(pdMS_TO_TICKS(NETWORK_REG_TIMEOUT_MS));
+    }
+    if (err == ESP_OK) {
+        err = enable_comm();
+    }
+    if (err == ESP_OK) {
+        err = activate_network();
+    }
+
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to restore modem configuration (%s)", esp_err_to_name(err));
+        return err;
+    }
+
+    // el multiplexor y la conexión PPP se restablecen si es posible; la
+    // aplicación puede reintentarlos
+    if (m_restore_cmux && start_cmux(m_restore_nmea) != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to restore multiplexer");
+    }
+    if (m_restore_ppp && enter_data_mode() != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to restore PPP connection");
+    }
+
+    m_restore_cmux = false;
+    m_restore_nmea = false;
+    m_restore_ppp = false;
+
+    return ESP_OK;
+}
+
+void SIM7000_Modem::reset_link_state()
+{
+    // se conserva lo que estaba activo por si ya se había llamado antes
+    // (p. ej. AT+CFUN=1,1 y después un ciclo de encendido)
+    m_restore_ppp |= m_ppp.is_started() || m_is_ppp_channel_online || is_data_mode();
+    m_restore_cmux |= m_is_cmux.load();
+    m_restore_nmea |= m_cmux.is_open(CMUX_NMEA_CHANNEL);
+
+    // el modem ya no puede responder a LCP, por lo que no se espera
+    if (m_ppp.is_started()) {
+        m_ppp.stop(0);
+    }
+
+    m_is_ppp_channel_online = false;
+    leave_data_mode();
+
+    if (m_is_cmux) {
+        m_cmux.reset();
+        m_is_cmux = false;
+    }
+
+    uart_flush_input(m_port);
+    restore_rx_mode();
+}
+
+void SIM7000_Modem::pulse_pwrkey(uint32_t duration_ms)
+{
+    // el pin activa PWRKEY a través de un transistor
+    gpio_set_level(m_pin_pwr, 1);
+    vTaskDelay(pdMS_TO_TICKS(duration_ms));
+    gpio_set_level(m_pin_pwr, 0);
+}
+
+void SIM7000_Modem::on_cmd_timeout(uint32_t consecutive_timeouts)
+{
+    m_supervisor.notify_timeout(consecutive_timeouts);
+}
+
 int SIM7000_Modem::on_cmd_write(const char *data, size_t length)
 {
+    m_transcript.record(transcript_dir_t::TX, data, length);
+
+    // con el multiplexor los comandos van por su propio canal
+    if (m_is_cmux) {
+        return m_cmux.write(CMUX_AT_CHANNEL, data, length);
+    }
+
     return uart_write_bytes(m_port, data, length); 
 }
 
+void SIM7000_Modem::on_data_received(const char *data, size_t length)
+{
+    m_ppp.receive(data, length);
+}
+
 void SIM7000_Modem::post_event(int32_t id, TickType_t ticks_to_wait)
 {
     post_event(id, NULL, 0, ticks_to_wait);
@@ -1301,6 +2404,57 @@ void SIM7000_Modem::post_mqtt_event(std::string &payload)
     );
 }
 
+int SIM7000_Modem::write_uart(void *ctx, const char *data, size_t length)
+{
+    SIM7000_Modem *modem = (SIM7000_Modem *)ctx;
+    return uart_write_bytes(modem->m_port, data, length);
+}
+
+int SIM7000_Modem::write_ppp_data(void *ctx, const char *data, size_t length)
+{
+    SIM7000_Modem *modem = (SIM7000_Modem *)ctx;
+
+    // los datos de la conexión no se graban en la transcripción
+    if (modem->m_is_cmux) {
+        return modem->m_cmux.write(CMUX_PPP_CHANNEL, data, length);
+    }
+
+    return uart_write_bytes(modem->m_port, data, length);
+}
+
+void SIM7000_Modem::on_at_channel_data(void *ctx, const char *data, size_t length)
+{
+    SIM7000_Modem *modem = (SIM7000_Modem *)ctx;
+
+    modem->m_transcript.record(transcript_dir_t::RX, data, length);
+    modem->feed_buffer(data, length);
+}
+
+void SIM7000_Modem::on_ppp_channel_data(void *ctx, const char *data, size_t length)
+{
+    ((SIM7000_Modem *)ctx)->receive_ppp_channel_data(data, length);
+}
+
+void SIM7000_Modem::on_nmea_channel_data(void *ctx, const char *data, size_t length)
+{
+    ((SIM7000_Modem *)ctx)->receive_nmea_data(data, length);
+}
+
+void SIM7000_Modem::on_ppp_status(void *ctx, ppp_status_t status)
+{
+    SIM7000_Modem *modem = (SIM7000_Modem *)ctx;
+
+    // se ejecuta en el loop de eventos, por lo que no espera a que haya lugar
+    // en su cola
+    if (status == ppp_status_t::CONNECTED) {
+        modem->post_event(MODEM_EVENT_PPP_CONNECTED, 0);
+    } else {
+        // tras perder el enlace el modem puede seguir en modo de datos;
+        // exit_data_mode() lo regresa al modo de comandos
+        modem->post_event(MODEM_EVENT_PPP_DISCONNECTED, 0);
+    }
+}
+
 esp_err_t SIM7000_Modem::execute_internal_cmd_no_answer(
     internal::at_cmd_t command,
     TickType_t ticks_to_wait)
@@ -1363,10 +2517,10 @@ esp_err_t SIM7000_Modem::execute_internal_cmd(
 
 /* SIM7000_Service */
 
-SIM7000_Service::SIM7000_Service(std::weak_ptr<SIM7000_Modem> modem) : m_modem(modem)
-{ 
-    m_result_info = std::make_shared<internal::sim7000_cmd_result_info_t>();
-}
+SIM7000_Service::SIM7000_Service(std::weak_ptr<SIM7000_Modem> modem) :
+    m_modem(modem),
+    m_result_info{}
+{ }
 
 esp_err_t SIM7000_Service::check_modem_ptr()
 {
@@ -14,8 +14,7 @@ namespace axomotor::lte_modem
         int message_buffer_size,
         int response_buffer_size) : SIM7000_Service(modem)
     { 
-        m_result_info = std::make_shared<internal::sim7000_cmd_result_info_t>();
-        m_result_info->response.reserve(response_buffer_size);
+        m_result_info.response.reserve(response_buffer_size);
     }
 
     esp_err_t SIM7000_MQTT::init()
@@ -33,7 +32,7 @@ namespace axomotor::lte_modem
 
     esp_err_t SIM7000_MQTT::deinit()
     {
-        m_result_info->reset();
+        m_result_info.reset();
         return ESP_OK;
     }
 
@@ -42,7 +41,6 @@ namespace axomotor::lte_modem
         if (m_modem.expired()) return ESP_ERR_INVALID_STATE;
         auto modem = m_modem.lock();
         esp_err_t err;
-        std::string cmd_params;
 
         // veifica la URL del broker
         if (!config.broker || strlen(config.broker) == 0) {
@@ -50,74 +48,80 @@ namespace axomotor::lte_modem
             return ESP_ERR_INVALID_ARG;
         }
 
+        SIM7000_CmdSlot slot = modem->acquire_cmd_slot();
+
         // establece la url y el puerto
-        cmd_params.append("=\"URL\",\"").append(config.broker).append("\"");
         if (config.port != 0) {
-            cmd_params.append(",\"")
-                .append(std::to_string(config.port))
-                .append("\"");
+            err = slot.format_params(
+                "=\"URL\",\"%s\",\"%u\"",
+                config.broker,
+                (unsigned)config.port);
+        } else {
+            err = slot.format_params("=\"URL\",\"%s\"", config.broker);
+        }
+
+        if (err == ESP_OK) {
+            err = modem->execute_cmd(at_cmd_t::SMCONF, slot);
         }
 
-        err = modem->execute_cmd(at_cmd_t::SMCONF, cmd_params, m_result_info);
         // verifica si se recibió un identificador de cliente
         if (err == ESP_OK && config.client_id) {
-            cmd_params.clear();
-            cmd_params.append("=\"CLIENTID\",\"")
-                .append(config.client_id)
-                .append("\"");
-            err = modem->execute_cmd(at_cmd_t::SMCONF, cmd_params, m_result_info);
+            err = slot.format_params("=\"CLIENTID\",\"%s\"", config.client_id);
+            if (err == ESP_OK) {
+                err = modem->execute_cmd(at_cmd_t::SMCONF, slot);
+            }
         }
 
         // verifica si se recibió un nombre de usuario
         if (err == ESP_OK && config.username) {
-            cmd_params.clear();
-            cmd_params.append("=\"USERNAME\",\"")
-                .append(config.username)
-                .append("\"");
-            err = modem->execute_cmd(at_cmd_t::SMCONF, cmd_params, m_result_info);
+            err = slot.format_params("=\"USERNAME\",\"%s\"", config.username);
+            if (err == ESP_OK) {
+                err = modem->execute_cmd(at_cmd_t::SMCONF, slot);
+            }
         }
 
         // verifica si se recibió una contraseña
         if (err == ESP_OK && config.password) {
-            cmd_params.clear();
-            cmd_params.append("=\"PASSWORD\",\"")
-                .append(config.password)
-                .append("\"");
-            err = modem->execute_cmd(at_cmd_t::SMCONF, cmd_params, m_result_info);
+            err = slot.format_params("=\"PASSWORD\",\"%s\"", config.password);
+            if (err == ESP_OK) {
+                err = modem->execute_cmd(at_cmd_t::SMCONF, slot);
+            }
         }
 
         // verifica si se recibió un keep time diferente de 60
         if (err == ESP_OK && config.keep_time != 60) {
-            cmd_params.clear();
-            cmd_params.append("=\"KEEPTIME\",")
-                .append(std::to_string(config.keep_time));
-            err = modem->execute_cmd(at_cmd_t::SMCONF, cmd_params, m_result_info);
+            err = slot.format_params("=\"KEEPTIME\",%u", (unsigned)config.keep_time);
+            if (err == ESP_OK) {
+                err = modem->execute_cmd(at_cmd_t::SMCONF, slot);
+            }
         }
 
         // verifica si se recibió un session cleaning diferente de 60
         if (err == ESP_OK && config.session_cleaning != 0) {
-            cmd_params.clear();
-            cmd_params.append("=\"CLEANSS\",")
-                .append(std::to_string(config.session_cleaning));
-
-            err = modem->execute_cmd(at_cmd_t::SMCONF, cmd_params, m_result_info);
+            err = slot.format_params("=\"CLEANSS\",%u", (unsigned)config.session_cleaning);
+            if (err == ESP_OK) {
+                err = modem->execute_cmd(at_cmd_t::SMCONF, slot);
+            }
         }
 
         // verifica si se recibió un QoS diferente de 60
         if (err == ESP_OK && config.qos != 0) {
-            cmd_params.clear();
-            cmd_params.append("=\"QOS\",")
-                .append(std::to_string(config.qos));
-            err = modem->execute_cmd(at_cmd_t::SMCONF, cmd_params, m_result_info);
+            err = slot.format_params("=\"QOS\",%u", (unsigned)config.qos);
+            if (err == ESP_OK) {
+                err = modem->execute_cmd(at_cmd_t::SMCONF, slot);
+            }
         }
 
         if (err != ESP_OK) {
-            cmd_params.erase(0, 1);
+            auto params = slot.get_params();
+            // omite el signo "=" inicial
+            int length = params.empty() ? 0 : (int)params.size() - 1;
 
             ESP_LOGE(
                 TAG,
-                "Failed to set MQTT configuration (param: %s)",
-                cmd_params.c_str()
+                "Failed to set MQTT configuration (param: %.*s)",
+                length,
+                params.empty() ? "" : params.data() + 1
             );
         }
          
@@ -148,6 +152,7 @@ namespace axomotor::lte_modem
 
                     if (err == ESP_OK) {
                         ESP_LOGI(TAG, "MQTT connection successful");
+                        modem->get_status_cache().set_mqtt_state(true);
                     } else {
                         ESP_LOGE(
                             TAG,
@@ -186,6 +191,7 @@ namespace axomotor::lte_modem
                 
                 if (err == ESP_OK) {
                     ESP_LOGI(TAG, "MQTT disconnection successful");
+                    modem->get_status_cache().set_mqtt_state(false);
                 } else {
                     ESP_LOGE(
                         TAG,
@@ -206,12 +212,19 @@ namespace axomotor::lte_modem
         if (m_modem.expired()) return ESP_ERR_INVALID_STATE;
         auto modem = m_modem.lock();
         esp_err_t err;
-        std::string &res = m_result_info->response;
+        std::string &res = m_result_info.response;
+
+        // el estado se actualiza al conectar, desconectar y con el URC
+        // +SMSTATE, de modo que solo se consulta cuando vence
+        if (modem->get_status_cache().get_mqtt_state(state)) {
+            return ESP_OK;
+        }
 
         err = modem->execute_cmd(at_cmd_t::SMSTATE, "?", m_result_info);
         if (err == ESP_OK) {
             // verifica si la respuesta termina en 1
             state = res.ends_with("1");
+            modem->get_status_cache().set_mqtt_state(state);
         } else {
             ESP_LOGE(TAG, "Failed to get MQTT state");
         }
@@ -228,50 +241,119 @@ namespace axomotor::lte_modem
         const char *topic,
         std::span<const char> msg,
         uint8_t qos,
-        bool retain)
+        bool retain,
+        cmd_priority_t priority)
     {
         if (!topic || strlen(topic) == 0) return ESP_ERR_INVALID_ARG;
         if (m_modem.expired()) return ESP_ERR_INVALID_STATE;
         
         auto modem = m_modem.lock();
-        esp_err_t err;
-        std::string params = "=\"";
-        params.append(topic);
-        params.append("\",");
-        params.append(std::to_string(msg.size()));
-        params.append(",");
-        params.append(std::to_string(qos));
-        params.append(",");
-        params.append(retain ? "1" : "0");
-        
-        sim7000_cmd_context_t context;
-        context.command = at_cmd_t::SMPUB;
-        context.params = params;
-        context.payload = msg;
-        context.send_payload = true;
-        context.result_info = m_result_info;
-
-        err = modem->execute_cmd(context);
+        SIM7000_CmdSlot slot = modem->acquire_cmd_slot();
+        esp_err_t err = slot.format_params(
+            "=\"%s\",%u,%u,%u",
+            topic,
+            (unsigned)msg.size(),
+            (unsigned)qos,
+            retain ? 1U : 0U);
+
+        if (err == ESP_OK) {
+            sim7000_cmd_context_t context;
+            context.command = at_cmd_t::SMPUB;
+            context.params = slot.get_params();
+            context.payload = msg;
+            context.send_payload = true;
+            context.priority = priority;
+            context.result_info = &slot.get_result_info();
+
+            err = modem->execute_cmd(context);
+        }
+
         if (err != ESP_OK) {
             ESP_LOGE(TAG, "Failed to publish MQTT message");
+            // la conexión puede haberse perdido; se verifica en la siguiente
+            // consulta de estado
+            modem->get_status_cache().invalidate(network_status_field_t::MQTT_STATE);
         }
 
         return err;
     }
 
+    threading::Async<esp_err_t> SIM7000_MQTT::connect_async(TickType_t ticks_to_wait)
+    {
+        if (m_modem.expired()) co_return ESP_ERR_INVALID_STATE;
+
+        auto modem = m_modem.lock();
+        SIM7000_CmdSlot slot = co_await modem->acquire_cmd_slot_async();
+
+        ESP_LOGI(TAG, "Connecting to MQTT broker...");
+        esp_err_t err = co_await modem->exec(at_cmd_t::SMCONN, slot, ticks_to_wait);
+
+        if (err == ESP_OK) {
+            ESP_LOGI(TAG, "MQTT connection successful");
+            modem->get_status_cache().set_mqtt_state(true);
+        } else {
+            ESP_LOGE(
+                TAG,
+                "Failed to connect to MQTT broker (%s)",
+                esp_err_to_name(err)
+            );
+        }
+
+        co_return err;
+    }
+
+    threading::Async<esp_err_t> SIM7000_MQTT::publish_async(
+        const char *topic,
+        std::span<const char> msg,
+        uint8_t qos,
+        bool retain,
+        cmd_priority_t priority)
+    {
+        if (!topic || strlen(topic) == 0) co_return ESP_ERR_INVALID_ARG;
+        if (m_modem.expired()) co_return ESP_ERR_INVALID_STATE;
+
+        auto modem = m_modem.lock();
+        SIM7000_CmdSlot slot = co_await modem->acquire_cmd_slot_async();
+        esp_err_t err = slot.format_params(
+            "=\"%s\",%u,%u,%u",
+            topic,
+            (unsigned)msg.size(),
+            (unsigned)qos,
+            retain ? 1U : 0U);
+
+        if (err == ESP_OK) {
+            sim7000_cmd_context_t context;
+            context.command = at_cmd_t::SMPUB;
+            context.params = slot.get_params();
+            context.payload = msg;
+            context.send_payload = true;
+            context.priority = priority;
+            context.result_info = &slot.get_result_info();
+
+            err = co_await modem->exec(context);
+        }
+
+        if (err != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to publish MQTT message");
+            modem->get_status_cache().invalidate(network_status_field_t::MQTT_STATE);
+        }
+
+        co_return err;
+    }
+
     esp_err_t SIM7000_MQTT::subscribe(const char *topic, uint8_t qos)
     {
         if (!topic || strlen(topic) == 0) return ESP_ERR_INVALID_ARG;
         if (m_modem.expired()) return ESP_ERR_INVALID_STATE;
         
         auto modem = m_modem.lock();
-        esp_err_t err;
-        std::string params = "=\"";
-        params.append(topic);
-        params.append("\",");
-        params.append(std::to_string(qos));
+        SIM7000_CmdSlot slot = modem->acquire_cmd_slot();
+        esp_err_t err = slot.format_params("=\"%s\",%u", topic, (unsigned)qos);
+
+        if (err == ESP_OK) {
+            err = modem->execute_cmd(at_cmd_t::SMSUB, slot);
+        }
 
-        err = modem->execute_cmd(at_cmd_t::SMSUB, params, m_result_info);
         if (err != ESP_OK) {
             ESP_LOGE(TAG, "Failed to subscribe to MQTT topic");
         }
@@ -285,12 +367,13 @@ namespace axomotor::lte_modem
         if (m_modem.expired()) return ESP_ERR_INVALID_STATE;
         
         auto modem = m_modem.lock();
-        esp_err_t err;
-        std::string params = "=\"";
-        params.append(topic);
-        params.append("\"");
+        SIM7000_CmdSlot slot = modem->acquire_cmd_slot();
+        esp_err_t err = slot.format_params("=\"%s\"", topic);
+
+        if (err == ESP_OK) {
+            err = modem->execute_cmd(at_cmd_t::SMUNSUB, slot);
+        }
 
-        err = modem->execute_cmd(at_cmd_t::SMUNSUB, params, m_result_info);
         if (err != ESP_OK) {
             ESP_LOGE(TAG, "Failed to unsubscribe from MQTT topic");
         }
@@ -0,0 +1,233 @@
+#include "sim7000_ppp.hpp"
+
+#include <esp_log.h>
+#include <esp_netif_ppp.h>
+
+#define PPP_GOT_IP_BIT      BIT0
+#define PPP_STOPPED_BIT     BIT1
+
+namespace axomotor::lte_modem {
+
+static const char *TAG = "sim7000:ppp";
+
+/* SIM7000 PPP */
+
+SIM7000_PPP::SIM7000_PPP() :
+    m_netif{nullptr},
+    m_driver{},
+    m_write{nullptr},
+    m_write_ctx{nullptr},
+    m_on_status{nullptr},
+    m_status_ctx{nullptr},
+    m_is_started{false},
+    m_event_group{}
+{ }
+
+SIM7000_PPP::~SIM7000_PPP()
+{
+    if (m_netif == nullptr) return;
+
+    if (m_is_started) stop();
+
+    esp_event_handler_unregister(IP_EVENT, ESP_EVENT_ANY_ID, on_ip_event);
+    esp_event_handler_unregister(NETIF_PPP_STATUS, ESP_EVENT_ANY_ID, on_ppp_event);
+    esp_netif_destroy(m_netif);
+}
+
+esp_err_t SIM7000_PPP::init(
+    write_fn_t write,
+    void *write_ctx,
+    status_fn_t on_status,
+    void *status_ctx)
+{
+    if (m_netif != nullptr) return ESP_ERR_INVALID_STATE;
+    if (write == nullptr) return ESP_ERR_INVALID_ARG;
+
+    esp_err_t err;
+    esp_netif_config_t config = ESP_NETIF_DEFAULT_PPP();
+
+    m_write = write;
+    m_write_ctx = write_ctx;
+    m_on_status = on_status;
+    m_status_ctx = status_ctx;
+
+    m_netif = esp_netif_new(&config);
+    if (m_netif == nullptr) {
+        ESP_LOGE(TAG, "Failed to create PPP interface");
+        return ESP_FAIL;
+    }
+
+    // los eventos de fase y error indican cuándo termina el enlace
+    esp_netif_ppp_config_t ppp_config{};
+    ppp_config.ppp_phase_event_enabled = true;
+    ppp_config.ppp_error_event_enabled = true;
+    err = esp_netif_ppp_set_params(m_netif, &ppp_config);
+
+    if (err == ESP_OK) {
+        m_driver.base.post_attach = post_attach;
+        m_driver.ppp = this;
+        err = esp_netif_attach(m_netif, &m_driver);
+    }
+    if (err == ESP_OK) {
+        err = esp_event_handler_register(IP_EVENT, ESP_EVENT_ANY_ID, on_ip_event, this);
+    }
+    if (err == ESP_OK) {
+        err = esp_event_handler_register(NETIF_PPP_STATUS, ESP_EVENT_ANY_ID, on_ppp_event, this);
+    }
+
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to configure PPP interface (%s)", esp_err_to_name(err));
+        esp_event_handler_unregister(IP_EVENT, ESP_EVENT_ANY_ID, on_ip_event);
+        esp_netif_destroy(m_netif);
+        m_netif = nullptr;
+    }
+
+    return err;
+}
+
+esp_err_t SIM7000_PPP::set_auth(const char *user, const char *pwd)
+{
+    if (m_netif == nullptr) return ESP_ERR_INVALID_STATE;
+
+    if (user == nullptr || user[0] == '\0') {
+        return esp_netif_ppp_set_auth(m_netif, NETIF_PPP_AUTHTYPE_NONE, nullptr, nullptr);
+    }
+
+    return esp_netif_ppp_set_auth(m_netif, NETIF_PPP_AUTHTYPE_PAP, user, pwd);
+}
+
+esp_err_t SIM7000_PPP::start()
+{
+    if (m_netif == nullptr || m_is_started) return ESP_ERR_INVALID_STATE;
+
+    ESP_LOGI(TAG, "Starting PPP");
+    m_event_group.clear_flags(PPP_GOT_IP_BIT | PPP_STOPPED_BIT);
+    m_is_started = true;
+    esp_netif_action_start(m_netif, nullptr, 0, nullptr);
+
+    return ESP_OK;
+}
+
+esp_err_t SIM7000_PPP::stop(TickType_t ticks_to_wait)
+{
+    if (m_netif == nullptr) return ESP_ERR_INVALID_STATE;
+    // el enlace ya terminó por sí solo
+    if (!m_is_started) return ESP_OK;
+
+    ESP_LOGI(TAG, "Stopping PPP");
+    // se marca antes para que el evento de fin no se reporte como pérdida
+    m_is_started = false;
+    esp_netif_action_stop(m_netif, nullptr, 0, nullptr);
+
+    uint32_t flags = m_event_group.wait_for_flags(PPP_STOPPED_BIT, false, false, ticks_to_wait);
+    if (!(flags & PPP_STOPPED_BIT)) {
+        ESP_LOGW(TAG, "PPP did not terminate in time");
+        return ESP_ERR_TIMEOUT;
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t SIM7000_PPP::wait_for_ip(TickType_t ticks_to_wait)
+{
+    uint32_t flags = m_event_group.wait_for_flags(
+        PPP_GOT_IP_BIT | PPP_STOPPED_BIT,
+        false,
+        false,
+        ticks_to_wait
+    );
+
+    if (flags & PPP_GOT_IP_BIT) return ESP_OK;
+    return flags & PPP_STOPPED_BIT ? ESP_FAIL : ESP_ERR_TIMEOUT;
+}
+
+void SIM7000_PPP::receive(const char *data, size_t length)
+{
+    if (!m_is_started || length == 0) return;
+
+    // lwIP copia los datos, por lo que el buffer puede reutilizarse
+    esp_err_t err = esp_netif_receive(m_netif, (void *)data, length, nullptr);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to pass %u bytes to PPP (%s)", length, esp_err_to_name(err));
+    }
+}
+
+bool SIM7000_PPP::is_connected() const
+{
+    return m_event_group.get_flags() & PPP_GOT_IP_BIT;
+}
+
+void SIM7000_PPP::notify(ppp_status_t status)
+{
+    if (m_on_status != nullptr) {
+        m_on_status(m_status_ctx, status);
+    }
+}
+
+esp_err_t SIM7000_PPP::post_attach(esp_netif_t *netif, esp_netif_iodriver_handle handle)
+{
+    driver_t *driver = (driver_t *)handle;
+    esp_netif_driver_ifconfig_t config{};
+
+    config.handle = driver;
+    config.transmit = transmit;
+    driver->base.netif = netif;
+
+    return esp_netif_set_driver_config(netif, &config);
+}
+
+esp_err_t SIM7000_PPP::transmit(void *handle, void *buffer, size_t length)
+{
+    SIM7000_PPP *ppp = ((driver_t *)handle)->ppp;
+
+    int written = ppp->m_write(ppp->m_write_ctx, (const char *)buffer, length);
+    if (written != (int)length) {
+        ESP_LOGW(TAG, "Failed to write PPP frame (%d of %u bytes)", written, length);
+        return ESP_FAIL;
+    }
+
+    return ESP_OK;
+}
+
+void SIM7000_PPP::on_ip_event(void *args, esp_event_base_t base, int32_t id, void *data)
+{
+    SIM7000_PPP *ppp = (SIM7000_PPP *)args;
+    ip_event_got_ip_t *event = (ip_event_got_ip_t *)data;
+
+    if (event == nullptr || event->esp_netif != ppp->m_netif) return;
+
+    if (id == IP_EVENT_PPP_GOT_IP) {
+        ESP_LOGI(TAG, "PPP connected | IP: " IPSTR, IP2STR(&event->ip_info.ip));
+        ppp->m_event_group.set_flags(PPP_GOT_IP_BIT);
+        ppp->notify(ppp_status_t::CONNECTED);
+    } else if (id == IP_EVENT_PPP_LOST_IP) {
+        ESP_LOGW(TAG, "PPP lost IP address");
+        ppp->m_event_group.clear_flags(PPP_GOT_IP_BIT);
+        ppp->notify(ppp_status_t::DISCONNECTED);
+    }
+}
+
+void SIM7000_PPP::on_ppp_event(void *args, esp_event_base_t base, int32_t id, void *data)
+{
+    SIM7000_PPP *ppp = (SIM7000_PPP *)args;
+    esp_netif_t *netif = data != nullptr ? *(esp_netif_t **)data : nullptr;
+
+    if (netif != ppp->m_netif) return;
+
+    // solo interesa el fin del enlace: la fase "dead" o un error
+    if (id == NETIF_PPP_ERRORNONE || (id > NETIF_PPP_PHASE_DEAD && id < NETIF_PPP_CONNECT_FAILED)) {
+        return;
+    }
+
+    ppp->m_event_group.clear_flags(PPP_GOT_IP_BIT);
+    ppp->m_event_group.set_flags(PPP_STOPPED_BIT);
+
+    // el enlace terminó sin que se llamara a stop()
+    bool expected = true;
+    if (ppp->m_is_started.compare_exchange_strong(expected, false)) {
+        ESP_LOGW(TAG, "PPP link lost (%d)", (int)id);
+        ppp->notify(ppp_status_t::LINK_LOST);
+    }
+}
+
+} // namespace axomotor::lte_modem
@@ -0,0 +1,122 @@
+#include "sim7000_response_fields.hpp"
+
+namespace axomotor::lte_modem {
+
+SIM7000_ResponseFields::SIM7000_ResponseFields() :
+    m_fields{},
+    m_count{0}
+{ }
+
+SIM7000_ResponseFields::SIM7000_ResponseFields(std::string_view response, char delimiter) :
+    SIM7000_ResponseFields()
+{
+    split(response, delimiter);
+}
+
+size_t SIM7000_ResponseFields::split(std::string_view response, char delimiter)
+{
+    m_count = 0;
+
+    // omite el prefijo del comando ("+CMD: ")
+    if (response.starts_with('+')) {
+        size_t index = response.find(": ");
+        if (index != std::string_view::npos) {
+            response.remove_prefix(index + 2);
+        }
+    }
+
+    if (response.empty()) return 0;
+
+    size_t pos = 0;
+    size_t length = response.length();
+
+    while (m_count < MAX_RESPONSE_FIELDS) {
+        size_t start = pos;
+        size_t end;
+
+        if (pos < length && response[pos] == '"') {
+            // el campo termina en la siguiente comilla
+            start = pos + 1;
+            end = response.find('"', start);
+            if (end == std::string_view::npos) end = length;
+            m_fields[m_count++] = response.substr(start, end - start);
+            // avanza hasta el siguiente delimitador
+            pos = response.find(delimiter, end);
+        } else {
+            pos = response.find(delimiter, pos);
+            end = pos == std::string_view::npos ? length : pos;
+            m_fields[m_count++] = response.substr(start, end - start);
+        }
+
+        if (pos == std::string_view::npos) break;
+        pos++;
+    }
+
+    return m_count;
+}
+
+std::string_view SIM7000_ResponseFields::get_string(size_t index) const
+{
+    return index < m_count ? m_fields[index] : std::string_view();
+}
+
+bool SIM7000_ResponseFields::get_string(size_t index, std::string &value) const
+{
+    if (index >= m_count) return false;
+    value.assign(m_fields[index]);
+    return true;
+}
+
+float SIM7000_ResponseFields::get_float(size_t index, float default_value) const
+{
+    std::string_view field = get_string(index);
+    if (field.empty()) return default_value;
+    return helpers::to_number<float>(field);
+}
+
+int32_t SIM7000_ResponseFields::get_fixed(
+    size_t index,
+    uint8_t decimals,
+    int32_t default_value) const
+{
+    std::string_view field = get_string(index);
+    if (field.empty()) return default_value;
+
+    size_t pos = 0;
+    bool negative = false;
+    bool found = false;
+    bool decimal = false;
+    int32_t result = 0;
+
+    // verifica el signo
+    if (field[pos] == '-' || field[pos] == '+') {
+        negative = field[pos] == '-';
+        pos++;
+    }
+
+    for (; pos < field.length(); pos++) {
+        char c = field[pos];
+
+        if (c >= '0' && c <= '9') {
+            // descarta los decimales que excedan la escala
+            if (decimal && decimals == 0) continue;
+            if (decimal) decimals--;
+
+            result = (result * 10) + (c - '0');
+            found = true;
+        } else if (c == '.' && !decimal) {
+            decimal = true;
+        } else {
+            break;
+        }
+    }
+
+    if (!found) return default_value;
+
+    // completa la escala si el campo tiene menos decimales
+    while (decimals-- > 0) result *= 10;
+
+    return negative ? -result : result;
+}
+
+} // namespace axomotor::lte_modem
@@ -0,0 +1,42 @@
+#include "sim7000_response_sink.hpp"
+
+#include <cstring>
+
+namespace axomotor::lte_modem {
+
+/* SIM7000 Buffer Sink */
+
+SIM7000_BufferSink::SIM7000_BufferSink(std::span<char> buffer) :
+    m_buffer{buffer},
+    m_length{0}
+{ }
+
+bool SIM7000_BufferSink::write(std::string_view chunk)
+{
+    // verifica si el fragmento cabe en el espacio restante
+    if (chunk.length() > m_buffer.size() - m_length) return false;
+
+    memcpy(m_buffer.data() + m_length, chunk.data(), chunk.length());
+    m_length += chunk.length();
+
+    return true;
+}
+
+/* SIM7000 File Sink */
+
+SIM7000_FileSink::SIM7000_FileSink(FILE *file) :
+    m_file{file},
+    m_length{0}
+{ }
+
+bool SIM7000_FileSink::write(std::string_view chunk)
+{
+    if (m_file == nullptr) return false;
+
+    size_t written = fwrite(chunk.data(), 1, chunk.length(), m_file);
+    m_length += written;
+
+    return written == chunk.length();
+}
+
+} // namespace axomotor::lte_modem
@@ -0,0 +1,102 @@
+#include "sim7000_status_cache.hpp"
+
+#include <esp_timer.h>
+
+namespace axomotor::lte_modem {
+
+SIM7000_NetworkStatusCache::SIM7000_NetworkStatusCache() :
+    m_status{},
+    m_mqtt_connected{false},
+    m_updated_at{},
+    m_ttl_ms{
+        SIGNAL_STATUS_TTL_MS,
+        OPERATOR_STATUS_TTL_MS,
+        REGISTRATION_STATUS_TTL_MS,
+        MQTT_STATUS_TTL_MS
+    }
+{ }
+
+bool SIM7000_NetworkStatusCache::get(network_status_t &status) const
+{
+    std::lock_guard lock(m_mutex);
+    int64_t now = esp_timer_get_time();
+
+    status = m_status;
+
+    return is_valid(network_status_field_t::SIGNAL, now) &&
+        is_valid(network_status_field_t::OPERATOR, now) &&
+        is_valid(network_status_field_t::REGISTRATION, now);
+}
+
+bool SIM7000_NetworkStatusCache::get_mqtt_state(bool &connected) const
+{
+    std::lock_guard lock(m_mutex);
+
+    connected = m_mqtt_connected;
+    return is_valid(network_status_field_t::MQTT_STATE, esp_timer_get_time());
+}
+
+void SIM7000_NetworkStatusCache::update(const network_status_t &status)
+{
+    std::lock_guard lock(m_mutex);
+    int64_t now = esp_timer_get_time();
+
+    m_status = status;
+    touch(network_status_field_t::SIGNAL, now);
+    touch(network_status_field_t::OPERATOR, now);
+    touch(network_status_field_t::REGISTRATION, now);
+}
+
+void SIM7000_NetworkStatusCache::set_reg_status(network_reg_status_t reg_status)
+{
+    std::lock_guard lock(m_mutex);
+
+    m_status.reg_status = reg_status;
+    touch(network_status_field_t::REGISTRATION, esp_timer_get_time());
+}
+
+void SIM7000_NetworkStatusCache::set_mqtt_state(bool connected)
+{
+    std::lock_guard lock(m_mutex);
+
+    m_mqtt_connected = connected;
+    touch(network_status_field_t::MQTT_STATE, esp_timer_get_time());
+}
+
+void SIM7000_NetworkStatusCache::invalidate(network_status_field_t field)
+{
+    if (field >= network_status_field_t::COUNT) return;
+
+    std::lock_guard lock(m_mutex);
+    m_updated_at[(size_t)field] = 0;
+}
+
+void SIM7000_NetworkStatusCache::invalidate_all()
+{
+    std::lock_guard lock(m_mutex);
+    m_updated_at.fill(0);
+}
+
+void SIM7000_NetworkStatusCache::set_ttl(network_status_field_t field, uint32_t ttl_ms)
+{
+    if (field >= network_status_field_t::COUNT) return;
+
+    std::lock_guard lock(m_mutex);
+    m_ttl_ms[(size_t)field] = ttl_ms;
+}
+
+bool SIM7000_NetworkStatusCache::is_valid(network_status_field_t field, int64_t now) const
+{
+    int64_t updated_at = m_updated_at[(size_t)field];
+    if (updated_at == 0) return false;
+
+    return now - updated_at < (int64_t)m_ttl_ms[(size_t)field] * 1000;
+}
+
+void SIM7000_NetworkStatusCache::touch(network_status_field_t field, int64_t now)
+{
+    // 0 indica que el campo está vencido
+    m_updated_at[(size_t)field] = now != 0 ? now : 1;
+}
+
+} // namespace axomotor::lte_modem
@@ -0,0 +1,211 @@
+#include "sim7000_supervisor.hpp"
+#include "sim7000_modem.hpp"
+
+#include <algorithm>
+#include <esp_log.h>
+#include <esp_timer.h>
+
+#define HANG_DETECTED_BIT       BIT0
+#define STOP_REQUESTED_BIT      BIT1
+
+namespace axomotor::lte_modem {
+
+static const char *TAG = "sim7000:supervisor";
+
+/* SIM7000 Supervisor */
+
+SIM7000_Supervisor::SIM7000_Supervisor(SIM7000_Modem &modem) :
+    ServiceBase{TAG, 4 * 1024, 5},
+    m_modem{modem},
+    m_event_group{},
+    m_is_recovering{false},
+    m_stats{},
+    m_total_recovery_us{0}
+{ }
+
+SIM7000_Supervisor::~SIM7000_Supervisor()
+{
+    // la recuperación en curso usa al modem, que se está destruyendo
+    if (is_active()) disable();
+}
+
+esp_err_t SIM7000_Supervisor::enable()
+{
+    m_event_group.clear_flags(HANG_DETECTED_BIT | STOP_REQUESTED_BIT);
+    return start();
+}
+
+esp_err_t SIM7000_Supervisor::disable()
+{
+    // interrumpe la espera entre pasos de una recuperación en curso
+    m_event_group.set_flags(STOP_REQUESTED_BIT);
+    return stop();
+}
+
+void SIM7000_Supervisor::notify_timeout(uint32_t consecutive_timeouts)
+{
+    // los comandos de la propia recuperación también pueden agotarse
+    if (!is_active() || m_is_recovering) return;
+
+    if (consecutive_timeouts >= SUPERVISOR_TIMEOUT_THRESHOLD) {
+        m_event_group.set_flags(HANG_DETECTED_BIT);
+    }
+}
+
+recovery_stats_t SIM7000_Supervisor::get_stats() const
+{
+    std::lock_guard lock(m_stats_mutex);
+    return m_stats;
+}
+
+void SIM7000_Supervisor::loop()
+{
+    uint32_t flags = m_event_group.wait_for_flags(
+        HANG_DETECTED_BIT | STOP_REQUESTED_BIT,
+        false,
+        false,
+        pdMS_TO_TICKS(SUPERVISOR_POLL_INTERVAL_MS)
+    );
+
+    if (flags & STOP_REQUESTED_BIT) {
+        // evita consumir el procesador mientras termina de detenerse
+        vTaskDelay(1);
+        return;
+    }
+
+    if (flags & HANG_DETECTED_BIT) {
+        recover();
+    }
+}
+
+void SIM7000_Supervisor::recover()
+{
+    const int64_t started_at = esp_timer_get_time();
+    recovery_level_t level = recovery_level_t::PROBE;
+    esp_err_t err = ESP_FAIL;
+    uint32_t step = 0;
+
+    m_is_recovering = true;
+
+    {
+        std::lock_guard lock(m_stats_mutex);
+        m_stats.hang_count++;
+    }
+
+    ESP_LOGW(
+        TAG,
+        "Modem is not responding (%lu commands timed out), starting recovery",
+        (unsigned long)m_modem.get_consecutive_timeouts()
+    );
+    m_modem.post_event(MODEM_EVENT_HANG_DETECTED, 0);
+
+    while (true) {
+        // el primer paso se ejecuta de inmediato; los siguientes esperan el
+        // doble que el anterior
+        if (step > 0) {
+            uint32_t delay_ms = RECOVERY_BACKOFF_MS << std::min<uint32_t>(step - 1, 16);
+            if (!wait_backoff(std::min(delay_ms, RECOVERY_MAX_BACKOFF_MS))) break;
+        }
+
+        ESP_LOGI(TAG, "Recovery step %lu: %s", (unsigned long)step + 1, get_level_name(level));
+        if (level == recovery_level_t::POWER_CYCLE) {
+            std::lock_guard lock(m_stats_mutex);
+            m_stats.power_cycle_count++;
+        }
+
+        err = run_step(level);
+
+        // si el modem se reinició, perdió su configuración
+        if (err == ESP_OK && level != recovery_level_t::PROBE) {
+            err = m_modem.restore_state();
+        }
+        if (err == ESP_OK) break;
+
+        ESP_LOGW(TAG, "Recovery step failed (%s)", esp_err_to_name(err));
+
+        // después del ciclo de encendido solo queda repetirlo
+        if (level != recovery_level_t::POWER_CYCLE) {
+            level = (recovery_level_t)((int)level + 1);
+        }
+        step++;
+    }
+
+    m_modem.reset_consecutive_timeouts();
+    m_event_group.clear_flags(HANG_DETECTED_BIT);
+    m_is_recovering = false;
+
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Recovery interrupted");
+        return;
+    }
+
+    uint32_t elapsed_ms = (esp_timer_get_time() - started_at) / 1000;
+    recovery_stats_t stats;
+
+    {
+        std::lock_guard lock(m_stats_mutex);
+        m_total_recovery_us += esp_timer_get_time() - started_at;
+        m_stats.recovery_count++;
+        m_stats.last_level = level;
+        m_stats.last_recovery_ms = elapsed_ms;
+        m_stats.mean_recovery_ms = m_total_recovery_us / m_stats.recovery_count / 1000;
+        stats = m_stats;
+    }
+
+    ESP_LOGI(
+        TAG,
+        "Modem recovered by %s in %lu ms (MTTR: %lu ms over %lu recoveries)",
+        get_level_name(level),
+        (unsigned long)elapsed_ms,
+        (unsigned long)stats.mean_recovery_ms,
+        (unsigned long)stats.recovery_count
+    );
+
+    m_modem.post_event(MODEM_EVENT_RECOVERED, &stats, sizeof(stats), 0);
+}
+
+esp_err_t SIM7000_Supervisor::run_step(recovery_level_t level)
+{
+    switch (level)
+    {
+        case recovery_level_t::PROBE:
+            return m_modem.probe_link();
+        case recovery_level_t::SOFT_RESET:
+            return m_modem.reset_modem();
+        case recovery_level_t::POWER_CYCLE:
+            return m_modem.power_cycle();
+        default:
+            return ESP_ERR_INVALID_ARG;
+    }
+}
+
+bool SIM7000_Supervisor::wait_backoff(uint32_t delay_ms)
+{
+    ESP_LOGI(TAG, "Next recovery step in %lu ms", (unsigned long)delay_ms);
+
+    uint32_t flags = m_event_group.wait_for_flags(
+        STOP_REQUESTED_BIT,
+        false,
+        false,
+        pdMS_TO_TICKS(delay_ms)
+    );
+
+    return (flags & STOP_REQUESTED_BIT) == 0;
+}
+
+const char *SIM7000_Supervisor::get_level_name(recovery_level_t level)
+{
+    switch (level)
+    {
+        case recovery_level_t::PROBE:
+            return "AT probe";
+        case recovery_level_t::SOFT_RESET:
+            return "functionality reset";
+        case recovery_level_t::POWER_CYCLE:
+            return "power cycle";
+        default:
+            return "none";
+    }
+}
+
+} // namespace axomotor::lte_modem
@@ -0,0 +1,283 @@
+#include "sim7000_transcript.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <esp_log.h>
+#include <esp_timer.h>
+#include <freertos/task.h>
+
+namespace axomotor::lte_modem {
+
+using namespace axomotor::lte_modem::internal;
+
+static const char *TAG = "sim7000:transcript";
+
+// tamaño de los fragmentos que se entregan al analizador durante la
+// reproducción
+static const size_t REPLAY_CHUNK_SIZE = 256;
+
+/* SIM7000 Transcript Writer */
+
+SIM7000_TranscriptWriter::SIM7000_TranscriptWriter() :
+    m_file{nullptr},
+    m_is_recording{false},
+    m_last_time{0},
+    m_bytes_recorded{0}
+{ }
+
+SIM7000_TranscriptWriter::~SIM7000_TranscriptWriter()
+{
+    stop();
+}
+
+esp_err_t SIM7000_TranscriptWriter::start(const char *path, size_t buffer_size)
+{
+    if (path == nullptr) return ESP_ERR_INVALID_ARG;
+
+    std::lock_guard lock(m_mutex);
+    if (m_file != nullptr) return ESP_ERR_INVALID_STATE;
+
+    m_file = fopen(path, "wb");
+    if (m_file == nullptr) {
+        ESP_LOGE(TAG, "Failed to create transcript file '%s'", path);
+        return ESP_FAIL;
+    }
+
+    // utiliza un buffer grande para agrupar las escrituras en la SD
+    setvbuf(m_file, nullptr, _IOFBF, buffer_size);
+
+    uint8_t header[TRANSCRIPT_HEADER_SIZE] = {};
+    memcpy(header, TRANSCRIPT_MAGIC, sizeof(TRANSCRIPT_MAGIC));
+    header[4] = TRANSCRIPT_VERSION;
+
+    if (fwrite(header, 1, sizeof(header), m_file) != sizeof(header)) {
+        ESP_LOGE(TAG, "Failed to write transcript header");
+        fclose(m_file);
+        m_file = nullptr;
+        return ESP_FAIL;
+    }
+
+    m_last_time = esp_timer_get_time();
+    m_bytes_recorded = 0;
+    m_is_recording = true;
+
+    ESP_LOGI(TAG, "Recording UART transcript to '%s'", path);
+    return ESP_OK;
+}
+
+esp_err_t SIM7000_TranscriptWriter::stop()
+{
+    std::lock_guard lock(m_mutex);
+    if (m_file == nullptr) return ESP_ERR_INVALID_STATE;
+
+    m_is_recording = false;
+    int result = fclose(m_file);
+    m_file = nullptr;
+
+    ESP_LOGI(TAG, "UART transcript stopped (%u bytes)", m_bytes_recorded);
+    return result == 0 ? ESP_OK : ESP_FAIL;
+}
+
+void SIM7000_TranscriptWriter::record(
+    transcript_dir_t direction,
+    const char *data,
+    size_t length)
+{
+    if (!m_is_recording || length == 0) return;
+
+    std::lock_guard lock(m_mutex);
+    if (m_file == nullptr) return;
+
+    int64_t now = esp_timer_get_time();
+    int64_t delta = now - m_last_time;
+    m_last_time = now;
+
+    while (length > 0) {
+        size_t chunk = std::min(length, TRANSCRIPT_MAX_RECORD_LENGTH);
+        uint32_t delta_us = (uint32_t)std::min<int64_t>(delta, UINT32_MAX);
+        uint8_t header[TRANSCRIPT_RECORD_HEADER_SIZE] = {
+            (uint8_t)(delta_us),
+            (uint8_t)(delta_us >> 8),
+            (uint8_t)(delta_us >> 16),
+            (uint8_t)(delta_us >> 24),
+            (uint8_t)(chunk),
+            (uint8_t)(chunk >> 8),
+            (uint8_t)direction
+        };
+
+        bool is_ok = fwrite(header, 1, sizeof(header), m_file) == sizeof(header) &&
+            fwrite(data, 1, chunk, m_file) == chunk;
+
+        if (!is_ok) {
+            // detiene la grabación para no bloquear al modem con más errores
+            ESP_LOGE(TAG, "Failed to write transcript, stopping");
+            m_is_recording = false;
+            fclose(m_file);
+            m_file = nullptr;
+            return;
+        }
+
+        m_bytes_recorded += sizeof(header) + chunk;
+        data += chunk;
+        length -= chunk;
+        delta = 0;
+    }
+}
+
+/* SIM7000 Transcript Reader */
+
+SIM7000_TranscriptReader::SIM7000_TranscriptReader(FILE *file) :
+    m_file{file},
+    m_remaining{0}
+{ }
+
+esp_err_t SIM7000_TranscriptReader::open()
+{
+    if (m_file == nullptr) return ESP_ERR_INVALID_ARG;
+    uint8_t header[TRANSCRIPT_HEADER_SIZE];
+
+    if (fread(header, 1, sizeof(header), m_file) != sizeof(header) ||
+        memcmp(header, TRANSCRIPT_MAGIC, sizeof(TRANSCRIPT_MAGIC)) != 0) {
+        return ESP_ERR_INVALID_RESPONSE;
+    }
+
+    if (header[4] != TRANSCRIPT_VERSION) return ESP_ERR_NOT_SUPPORTED;
+
+    m_remaining = 0;
+    return ESP_OK;
+}
+
+esp_err_t SIM7000_TranscriptReader::next(transcript_record_t &record)
+{
+    // omite los datos restantes del registro anterior
+    if (m_remaining > 0) {
+        fseek(m_file, m_remaining, SEEK_CUR);
+        m_remaining = 0;
+    }
+
+    uint8_t header[TRANSCRIPT_RECORD_HEADER_SIZE];
+    size_t length = fread(header, 1, sizeof(header), m_file);
+
+    if (length == 0) return ESP_ERR_NOT_FOUND;
+    if (length != sizeof(header)) return ESP_ERR_INVALID_SIZE;
+
+    record.delta_us = header[0] | (header[1] << 8) | (header[2] << 16) |
+        ((uint32_t)header[3] << 24);
+    record.length = header[4] | (header[5] << 8);
+    record.direction = (transcript_dir_t)header[6];
+    m_remaining = record.length;
+
+    return ESP_OK;
+}
+
+size_t SIM7000_TranscriptReader::read(std::span<char> buffer)
+{
+    size_t length = std::min(buffer.size(), m_remaining);
+    if (length == 0) return 0;
+
+    length = fread(buffer.data(), 1, length, m_file);
+    m_remaining -= length;
+
+    return length;
+}
+
+/* SIM7000 Replay Modem */
+
+SIM7000_ReplayModem::SIM7000_ReplayModem(size_t buffer_size) :
+    SIM7000_BasicModem(buffer_size),
+    m_urc_count{0}
+{ }
+
+esp_err_t SIM7000_ReplayModem::replay(
+    FILE *file,
+    bool realtime,
+    transcript_replay_stats_t &stats)
+{
+    SIM7000_TranscriptReader reader(file);
+    transcript_record_t record;
+    char buffer[REPLAY_CHUNK_SIZE];
+    int64_t pending_delay = 0;
+    int64_t sent_at = -1;
+    esp_err_t err;
+
+    stats = transcript_replay_stats_t{};
+    m_urc_count = 0;
+
+    err = reader.open();
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Invalid transcript file");
+        return err;
+    }
+
+    while ((err = reader.next(record)) == ESP_OK) {
+        stats.records++;
+        stats.recorded_us += record.delta_us;
+
+        // los datos enviados solo se contabilizan, ya que el analizador
+        // únicamente procesa lo que se recibe
+        if (record.direction == transcript_dir_t::TX) {
+            stats.bytes_tx += record.length;
+            if (sent_at < 0) sent_at = stats.recorded_us;
+            continue;
+        }
+
+        if (sent_at >= 0) {
+            uint32_t latency = (uint32_t)(stats.recorded_us - sent_at);
+            stats.responses++;
+            stats.total_latency_us += latency;
+            stats.max_latency_us = std::max(stats.max_latency_us, latency);
+            sent_at = -1;
+        }
+
+        // espera el tiempo original entre registros (con resolución de ticks)
+        if (realtime) {
+            pending_delay += record.delta_us;
+            TickType_t ticks = pdMS_TO_TICKS(pending_delay / 1000);
+
+            if (ticks > 0) {
+                vTaskDelay(ticks);
+                pending_delay -= (int64_t)ticks * portTICK_PERIOD_MS * 1000;
+            }
+        }
+
+        int64_t start = esp_timer_get_time();
+        size_t length;
+
+        while ((length = reader.read(buffer)) > 0) {
+            feed_buffer(buffer, length);
+            stats.bytes_rx += length;
+        }
+
+        stats.elapsed_us += esp_timer_get_time() - start;
+    }
+
+    stats.urc_count = m_urc_count;
+
+    if (err != ESP_ERR_NOT_FOUND) {
+        ESP_LOGE(TAG, "Transcript is truncated");
+        return err;
+    }
+
+    ESP_LOGI(
+        TAG,
+        "Replayed %lu records (%lu bytes, %lu URC) in %lld us",
+        (unsigned long)stats.records,
+        (unsigned long)stats.bytes_rx,
+        (unsigned long)stats.urc_count,
+        stats.elapsed_us
+    );
+
+    return ESP_OK;
+}
+
+void SIM7000_ReplayModem::on_urc_message(std::string_view line, const urc_def_t &def)
+{
+    m_urc_count++;
+}
+
+int SIM7000_ReplayModem::on_cmd_write(const char *data, size_t length)
+{
+    return length;
+}
+
+} // namespace axomotor::lte_modem
@@ -1,232 +1,246 @@
 #include "sim7000_types.hpp"
 
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
 namespace axomotor::lte_modem::internal {
 
-static const at_cmd_def_t AT_COMMANDS_TABLE[] =
+// las macros generan la cadena del comando y su prefijo completo ("AT+XXXX")
+// en tiempo de compilación (los parámetros incluyen el "=" o "?" inicial)
+#define BASIC_CMD(cmd, str, time) \
+    { at_cmd_t::cmd, at_cmd_type_t::BASIC, str, "AT" str, time }
+#define S_PARAM_CMD(cmd, str, time) \
+    { at_cmd_t::cmd, at_cmd_type_t::S_PARAM, str, "AT" str, time }
+#define EXTENDED_CMD(cmd, time) \
+    { at_cmd_t::cmd, at_cmd_type_t::EXTENDED, #cmd, "AT+" #cmd, time }
+
+static constexpr at_cmd_def_t AT_COMMANDS_TABLE[] =
 {
-    { at_cmd_t::AT, at_cmd_type_t::BASIC, "", 0 },
-    { at_cmd_t::A_SLASH, at_cmd_type_t::BASIC, "A/", 0 },
-    { at_cmd_t::D, at_cmd_type_t::BASIC, "D", 0 },
-    { at_cmd_t::E, at_cmd_type_t::BASIC, "E", 0 },
-    { at_cmd_t::H, at_cmd_type_t::BASIC, "H", 20 },
-    { at_cmd_t::I, at_cmd_type_t::BASIC, "I", 0 },
-    { at_cmd_t::L, at_cmd_type_t::BASIC, "L", 0 },
-    { at_cmd_t::M, at_cmd_type_t::BASIC, "M", 0 },
-    { at_cmd_t::PLUS_TO_3RD, at_cmd_type_t::BASIC, "+++", 0 },
-    { at_cmd_t::O, at_cmd_type_t::BASIC, "O", 0 },
-    { at_cmd_t::Q, at_cmd_type_t::BASIC, "Q", 0 },
-    { at_cmd_t::S0, at_cmd_type_t::S_PARAM, "S0", 0 },
-    { at_cmd_t::S3, at_cmd_type_t::S_PARAM, "S3", 0 },
-    { at_cmd_t::S4, at_cmd_type_t::S_PARAM, "S4", 0 },
-    { at_cmd_t::S5, at_cmd_type_t::S_PARAM, "S5", 0 },
-    { at_cmd_t::S6, at_cmd_type_t::S_PARAM, "S6", 0 },
-    { at_cmd_t::S7, at_cmd_type_t::S_PARAM, "S7", 0 },
-    { at_cmd_t::S8, at_cmd_type_t::S_PARAM, "S8", 0 },
-    { at_cmd_t::S10, at_cmd_type_t::S_PARAM, "S10", 0 },
-    { at_cmd_t::V, at_cmd_type_t::BASIC, "V", 0 },
-    { at_cmd_t::X, at_cmd_type_t::BASIC, "X", 0 },
-    { at_cmd_t::AND_C, at_cmd_type_t::BASIC, "&C", 0 },
-    { at_cmd_t::AND_D, at_cmd_type_t::BASIC, "&D", 0 },
-    { at_cmd_t::AND_E, at_cmd_type_t::BASIC, "&E", 0 },
-    { at_cmd_t::GCAP, at_cmd_type_t::EXTENDED, "GCAP", 0 },
-    { at_cmd_t::GMI, at_cmd_type_t::EXTENDED, "GMI", 0 },
-    { at_cmd_t::GMM, at_cmd_type_t::EXTENDED, "GMM", 0 },
-    { at_cmd_t::GMR, at_cmd_type_t::EXTENDED, "GMR", 0 },
-    { at_cmd_t::GOI, at_cmd_type_t::EXTENDED, "GOI", 0 },
-    { at_cmd_t::GSN, at_cmd_type_t::EXTENDED, "GSN", 0 },
-    { at_cmd_t::ICF, at_cmd_type_t::EXTENDED, "ICF", 0 },
-    { at_cmd_t::IFC, at_cmd_type_t::EXTENDED, "IFC", 0 },
-    { at_cmd_t::IPR, at_cmd_type_t::EXTENDED, "IPR", 0 },
-
-    { at_cmd_t::CGMI, at_cmd_type_t::EXTENDED, "CGMI", },
-    { at_cmd_t::CGMM, at_cmd_type_t::EXTENDED, "CGMM", 0 },
-    { at_cmd_t::CGMR, at_cmd_type_t::EXTENDED, "CGMR", 0 },
-    { at_cmd_t::CGSN, at_cmd_type_t::EXTENDED, "CGSN", 0 },
-    { at_cmd_t::CSCS, at_cmd_type_t::EXTENDED, "CSCS", 0 },
-    { at_cmd_t::CIMI, at_cmd_type_t::EXTENDED, "CIMI", 20 },
-    { at_cmd_t::CLCK, at_cmd_type_t::EXTENDED, "CLCK", 15 },
-    { at_cmd_t::CMEE, at_cmd_type_t::EXTENDED, "CMEE", 0 },
-    { at_cmd_t::COPS, at_cmd_type_t::EXTENDED, "COPS", 120 },
-    { at_cmd_t::CPAS, at_cmd_type_t::EXTENDED, "CPAS", 0 },
-    { at_cmd_t::CPIN, at_cmd_type_t::EXTENDED, "CPIN", 5 },
-    { at_cmd_t::CPWD, at_cmd_type_t::EXTENDED, "CPWD", 15 },
-    { at_cmd_t::CRC, at_cmd_type_t::EXTENDED, "CRC", 0 },
-    { at_cmd_t::CREG, at_cmd_type_t::EXTENDED, "CREG", 0 },
-    { at_cmd_t::CRSM, at_cmd_type_t::EXTENDED, "CRSM", 0 },
-    { at_cmd_t::CSQ, at_cmd_type_t::EXTENDED, "CSQ", 0 },
-    { at_cmd_t::CPOL, at_cmd_type_t::EXTENDED, "CPOL", 0 },
-    { at_cmd_t::COPN, at_cmd_type_t::EXTENDED, "COPN", 0 },
-    { at_cmd_t::CFUN, at_cmd_type_t::EXTENDED, "CFUN", 10 },
-    { at_cmd_t::CCLK, at_cmd_type_t::EXTENDED, "CCLK", 0 },
-    { at_cmd_t::CSIM, at_cmd_type_t::EXTENDED, "CSIM", 0 },
-    { at_cmd_t::CBC, at_cmd_type_t::EXTENDED, "CBC", 0 },
-    { at_cmd_t::CUSD, at_cmd_type_t::EXTENDED, "CUSD", 0 },
-    { at_cmd_t::CNUM, at_cmd_type_t::EXTENDED, "CNUM", 0 },
-
-    { at_cmd_t::CMGD, at_cmd_type_t::EXTENDED, "CMGD", 25 },
-    { at_cmd_t::CMGF, at_cmd_type_t::EXTENDED, "CMGF", 0 },
-    { at_cmd_t::CMGL, at_cmd_type_t::EXTENDED, "CMGL", 20 },
-    { at_cmd_t::CMGR, at_cmd_type_t::EXTENDED, "CMGR", 5 },
-    { at_cmd_t::CMGS, at_cmd_type_t::EXTENDED, "CMGS", 60 },
-    { at_cmd_t::CMGW, at_cmd_type_t::EXTENDED, "CMGW", 5 },
-    { at_cmd_t::CMSS, at_cmd_type_t::EXTENDED, "CMSS", 0 },
-    { at_cmd_t::CNMI, at_cmd_type_t::EXTENDED, "CNMI", 0 },
-    { at_cmd_t::CPMS, at_cmd_type_t::EXTENDED, "CPMS", 0 },
-    { at_cmd_t::CRES, at_cmd_type_t::EXTENDED, "CRES", 5 },
-    { at_cmd_t::CSAS, at_cmd_type_t::EXTENDED, "CSAS", 5 },
-    { at_cmd_t::CSCA, at_cmd_type_t::EXTENDED, "CSCA", 5 },
-    { at_cmd_t::CSDH, at_cmd_type_t::EXTENDED, "CSDH", 0 },
-    { at_cmd_t::CSMP, at_cmd_type_t::EXTENDED, "CSMP", 0 },
-    { at_cmd_t::CSMS, at_cmd_type_t::EXTENDED, "CSMS", 0 },
-
-    { at_cmd_t::CPOWD, at_cmd_type_t::EXTENDED, "CPOWD", 0 },
-    { at_cmd_t::CADC, at_cmd_type_t::EXTENDED, "CADC", 2 },
-    { at_cmd_t::CFGRI, at_cmd_type_t::EXTENDED, "CFGRI", 0 },
-    { at_cmd_t::CLTS, at_cmd_type_t::EXTENDED, "CLTS", 0 },
-    { at_cmd_t::CBAND, at_cmd_type_t::EXTENDED, "CBAND", 0 },
-    { at_cmd_t::CNSMOD, at_cmd_type_t::EXTENDED, "CNSMOD", 0 },
-    { at_cmd_t::CSCLK, at_cmd_type_t::EXTENDED, "CSCLK", 0 },
-    { at_cmd_t::CCID, at_cmd_type_t::EXTENDED, "CCID", 2 },
-    { at_cmd_t::CDEVICE, at_cmd_type_t::EXTENDED, "CDEVICE", 0 },
-    { at_cmd_t::GSV, at_cmd_type_t::EXTENDED, "GSV", 0 },
-    { at_cmd_t::SGPIO, at_cmd_type_t::EXTENDED, "SGPIO", 0 },
-    { at_cmd_t::SLEDS, at_cmd_type_t::EXTENDED, "SLEDS", 0 },
-    { at_cmd_t::CNETLIGHT, at_cmd_type_t::EXTENDED, "CNETLIGHT", 0 },
-    { at_cmd_t::CSGS, at_cmd_type_t::EXTENDED, "CSGS", 0 },
-    { at_cmd_t::CGPIO, at_cmd_type_t::EXTENDED, "CGPIO", 0 },
-    { at_cmd_t::CBATCHK, at_cmd_type_t::EXTENDED, "CBATCHK", 0 },
-    { at_cmd_t::CNMP, at_cmd_type_t::EXTENDED, "CNMP", 0 },
-    { at_cmd_t::CMNB, at_cmd_type_t::EXTENDED, "CMNB", 0 },
-    { at_cmd_t::CPSMS, at_cmd_type_t::EXTENDED, "CPSMS", 0 },
-    { at_cmd_t::CEDRXS, at_cmd_type_t::EXTENDED, "CEDRXS", 0 },
-    { at_cmd_t::CPSI, at_cmd_type_t::EXTENDED, "CPSI", 0 },
-    { at_cmd_t::CGNAPN, at_cmd_type_t::EXTENDED, "CGNAPN", 0 },
-    { at_cmd_t::CSDP, at_cmd_type_t::EXTENDED, "CSDP", 0 },
-    { at_cmd_t::MCELLLOCK, at_cmd_type_t::EXTENDED, "MCELLLOCK", 0 },
-    { at_cmd_t::NCELLLOCK, at_cmd_type_t::EXTENDED, "NCELLLOCK", 0 },
-    { at_cmd_t::NBSC, at_cmd_type_t::EXTENDED, "NBSC", 0 },
-    { at_cmd_t::CAPNMODE, at_cmd_type_t::EXTENDED, "CAPNMODE", 0 },
-    { at_cmd_t::CRRCSTATE, at_cmd_type_t::EXTENDED, "CRRCSTATE", 0 },
-    { at_cmd_t::CBANDCFG, at_cmd_type_t::EXTENDED, "CBANDCFG", 0 },
-    { at_cmd_t::CNACT, at_cmd_type_t::EXTENDED, "CNACT", 0 },
-    { at_cmd_t::CNCFG, at_cmd_type_t::EXTENDED, "CNCFG", 0 },
-    { at_cmd_t::CEDUMP, at_cmd_type_t::EXTENDED, "CEDUMP", 0 },
-    { at_cmd_t::CNBS, at_cmd_type_t::EXTENDED, "CNBS", 0 },
-    { at_cmd_t::CNDS, at_cmd_type_t::EXTENDED, "CNDS", 0 },
-    { at_cmd_t::CENG, at_cmd_type_t::EXTENDED, "CENG", 0 },
-    { at_cmd_t::CNACTCFG, at_cmd_type_t::EXTENDED, "CNACTCFG", 0 },
-    { at_cmd_t::CTLIIC, at_cmd_type_t::EXTENDED, "CTLIIC", 0 },
-    { at_cmd_t::CWIIC, at_cmd_type_t::EXTENDED, "CWIIC", 0 },
-    { at_cmd_t::CRIIC, at_cmd_type_t::EXTENDED, "CRIIC", 0 },
-    { at_cmd_t::CMCFG, at_cmd_type_t::EXTENDED, "CMCFG", 0 },
-    { at_cmd_t::CSIMLOCK, at_cmd_type_t::EXTENDED, "CSIMLOCK", 0 },
-    { at_cmd_t::CRATSRCH, at_cmd_type_t::EXTENDED, "CRATSRCH", 0 },
-    { at_cmd_t::SPWM, at_cmd_type_t::EXTENDED, "SPWM", 0 },
-    { at_cmd_t::CASRIP, at_cmd_type_t::EXTENDED, "CASRIP", 0 },
-    { at_cmd_t::CEDRX, at_cmd_type_t::EXTENDED, "CEDRX", 0 },
-    { at_cmd_t::CPSMRDP, at_cmd_type_t::EXTENDED, "CPSMRDP", 0 },
-    { at_cmd_t::CPSMCFG, at_cmd_type_t::EXTENDED, "CPSMCFG", 0 },
-    { at_cmd_t::CPSMCFGEXT, at_cmd_type_t::EXTENDED, "CPSMCFGEXT", 0 },
-    { at_cmd_t::CPSMSTATUS, at_cmd_type_t::EXTENDED, "CPSMSTATUS", 0 },
-    { at_cmd_t::CEDRXRDP, at_cmd_type_t::EXTENDED, "CEDRXRDP", 0 },
-    { at_cmd_t::CRAI, at_cmd_type_t::EXTENDED, "CRAI", 0 },
-
-    { at_cmd_t::CGATT, at_cmd_type_t::EXTENDED, "CGATT", 75 },
-    { at_cmd_t::CGDCONT, at_cmd_type_t::EXTENDED, "CGDCONT", 0 },
-    { at_cmd_t::CGACT, at_cmd_type_t::EXTENDED, "CGACT", 150 },
-    { at_cmd_t::CGPADDR, at_cmd_type_t::EXTENDED, "CGPADDR", 0 },
-    { at_cmd_t::CGREG, at_cmd_type_t::EXTENDED, "CGREG", 0 },
-    { at_cmd_t::CGSMS, at_cmd_type_t::EXTENDED, "CGSMS", 0 },
-    { at_cmd_t::CEREG, at_cmd_type_t::EXTENDED, "CEREG", 0 },
-
-    { at_cmd_t::SAPBR, at_cmd_type_t::EXTENDED, "SAPBR", 85 },
-
-    { at_cmd_t::CIPMUX, at_cmd_type_t::EXTENDED, "CIPMUX", 0 },
-    { at_cmd_t::CIPSTART, at_cmd_type_t::EXTENDED, "CIPSTART", 160 },
-    { at_cmd_t::CIPSEND, at_cmd_type_t::EXTENDED, "CIPSEND", 645 },
-    { at_cmd_t::CIPQSEND, at_cmd_type_t::EXTENDED, "CIPQSEND", 0 },
-    { at_cmd_t::CIPACK, at_cmd_type_t::EXTENDED, "CIPACK", 0 },
-    { at_cmd_t::CIPCLOSE, at_cmd_type_t::EXTENDED, "CIPCLOSE", 0 },
-    { at_cmd_t::CIPSHUT, at_cmd_type_t::EXTENDED, "CIPSHUT", 65 },
-    { at_cmd_t::CLPORT, at_cmd_type_t::EXTENDED, "CLPORT", 0 },
-    { at_cmd_t::CSTT, at_cmd_type_t::EXTENDED, "CSTT", 0 },
-    { at_cmd_t::CIICR, at_cmd_type_t::EXTENDED, "CIICR", 85 },
-    { at_cmd_t::CIFSR, at_cmd_type_t::EXTENDED, "CIFSR", 0 },
-    { at_cmd_t::CIFSREX, at_cmd_type_t::EXTENDED, "CIFSREX", 0 },
-    { at_cmd_t::CIPSTATUS, at_cmd_type_t::EXTENDED, "CIPSTATUS", 0 },
-    { at_cmd_t::CDNSCFG, at_cmd_type_t::EXTENDED, "CDNSCFG", 0 },
-    { at_cmd_t::CDNSGIP, at_cmd_type_t::EXTENDED, "CDNSGIP", 0 },
-    { at_cmd_t::CIPHEAD, at_cmd_type_t::EXTENDED, "CIPHEAD", 0 },
-    { at_cmd_t::CIPATS, at_cmd_type_t::EXTENDED, "CIPATS", 0 },
-    { at_cmd_t::CIPSPRT, at_cmd_type_t::EXTENDED, "CIPSPRT", 0 },
-    { at_cmd_t::CIPSERVER, at_cmd_type_t::EXTENDED, "CIPSERVER", 0 },
-    { at_cmd_t::CIPCSGP, at_cmd_type_t::EXTENDED, "CIPCSGP", 0 },
-    { at_cmd_t::CIPSRIP, at_cmd_type_t::EXTENDED, "CIPSRIP", 0 },
-    { at_cmd_t::CIPDPDP, at_cmd_type_t::EXTENDED, "CIPDPDP", 0 },
-    { at_cmd_t::CIPMODE, at_cmd_type_t::EXTENDED, "CIPMODE", 0 },
-    { at_cmd_t::CIPCCFG, at_cmd_type_t::EXTENDED, "CIPCCFG", 0 },
-    { at_cmd_t::CIPSHOWTP, at_cmd_type_t::EXTENDED, "CIPSHOWTP", 0 },
-    { at_cmd_t::CIPUDPMODE, at_cmd_type_t::EXTENDED, "CIPUDPMODE", 0 },
-    { at_cmd_t::CIPRXGET, at_cmd_type_t::EXTENDED, "CIPRXGET", 0 },
-    { at_cmd_t::CIPRDTIMER, at_cmd_type_t::EXTENDED, "CIPRDTIMER", 0 },
-    { at_cmd_t::CIPSGTXT, at_cmd_type_t::EXTENDED, "CIPSGTXT", 0 },
-    { at_cmd_t::CIPSENDHEX, at_cmd_type_t::EXTENDED, "CIPSENDHEX", 0 },
-    { at_cmd_t::CIPHEXS, at_cmd_type_t::EXTENDED, "CIPHEXS", 0 },
-    { at_cmd_t::CIPTKA, at_cmd_type_t::EXTENDED, "CIPTKA", 0 },
-    { at_cmd_t::CIPOPTION, at_cmd_type_t::EXTENDED, "CIPOPTION", 0 },
-
-    { at_cmd_t::SHSSL, at_cmd_type_t::EXTENDED, "SHSSL", 0 },
-    { at_cmd_t::SHCONF, at_cmd_type_t::EXTENDED, "SHCONF", 0 },
-    { at_cmd_t::SHCONN, at_cmd_type_t::EXTENDED, "SHCONN", 0 },
-    { at_cmd_t::SHBOD, at_cmd_type_t::EXTENDED, "SHBOD", 0 },
-    { at_cmd_t::SHBODEXT, at_cmd_type_t::EXTENDED, "SHBODEXT", 0 },
-    { at_cmd_t::SHAHEAD, at_cmd_type_t::EXTENDED, "SHAHEAD", 0 },
-    { at_cmd_t::SHCHEAD, at_cmd_type_t::EXTENDED, "SHCHEAD", 0 },
-    { at_cmd_t::SHPARA, at_cmd_type_t::EXTENDED, "SHPARA", 0 },
-    { at_cmd_t::SHCPARA, at_cmd_type_t::EXTENDED, "SHCPARA", 0 },
-    { at_cmd_t::SHSTATE, at_cmd_type_t::EXTENDED, "SHSTATE", 0 },
-    { at_cmd_t::SHREQ, at_cmd_type_t::EXTENDED, "SHREQ", 0 },
-    { at_cmd_t::SHREAD, at_cmd_type_t::EXTENDED, "SHREAD", 0 },
-    { at_cmd_t::SHDISC, at_cmd_type_t::EXTENDED, "SHDISC", 0 },
-    { at_cmd_t::HTTPTOFS, at_cmd_type_t::EXTENDED, "HTTPTOFS", 0 },
-    { at_cmd_t::HTTPTOFSRL, at_cmd_type_t::EXTENDED, "HTTPTOFSRL", 0 },
-
-    { at_cmd_t::CNTPCID, at_cmd_type_t::EXTENDED, "CNTPCID", 0 },
-    { at_cmd_t::CNTP, at_cmd_type_t::EXTENDED, "CNTP", 0 },
-
-    { at_cmd_t::SMCONF, at_cmd_type_t::EXTENDED, "SMCONF", 0 },
-    { at_cmd_t::CSSLCFG, at_cmd_type_t::EXTENDED, "CSSLCFG", 0 },
-    { at_cmd_t::SMSSL, at_cmd_type_t::EXTENDED, "SMSSL", 0 },
-    { at_cmd_t::SMCONN, at_cmd_type_t::EXTENDED, "SMCONN", 300000 },
-    { at_cmd_t::SMPUB, at_cmd_type_t::EXTENDED, "SMPUB", 30000 },
-    { at_cmd_t::SMSUB, at_cmd_type_t::EXTENDED, "SMSUB", 0 },
-    { at_cmd_t::SMUNSUB, at_cmd_type_t::EXTENDED, "SMUNSUB", 0 },
-    { at_cmd_t::SMSTATE, at_cmd_type_t::EXTENDED, "SMSTATE", 0 },
-    { at_cmd_t::SMPUBHEX, at_cmd_type_t::EXTENDED, "SMPUBHEX", 0 },
-    { at_cmd_t::SMDISC, at_cmd_type_t::EXTENDED, "SMDISC", 0 },
-
-    { at_cmd_t::CGNSPWR, at_cmd_type_t::EXTENDED, "CGNSPWR", 0 },
-    { at_cmd_t::CGNSINF, at_cmd_type_t::EXTENDED, "CGNSINF", 0 },
-    { at_cmd_t::CGNSURC, at_cmd_type_t::EXTENDED, "CGNSURC", 0 },
-    { at_cmd_t::CGNSPORT, at_cmd_type_t::EXTENDED, "CGNSPORT", 0 },
-    { at_cmd_t::CGNSCOLD, at_cmd_type_t::EXTENDED, "CGNSCOLD", 0 },
-    { at_cmd_t::CGNSWARM, at_cmd_type_t::EXTENDED, "CGNSWARM", 0 },
-    { at_cmd_t::CGNSHOT, at_cmd_type_t::EXTENDED, "CGNSHOT", 0 },
-    { at_cmd_t::CGNSMOD, at_cmd_type_t::EXTENDED, "CGNSMOD", 0 },
-    { at_cmd_t::CGNSCFG, at_cmd_type_t::EXTENDED, "CGNSCFG", 0 },
-    { at_cmd_t::CGNSTST, at_cmd_type_t::EXTENDED, "CGNSTST", 0 },
-    { at_cmd_t::CGNSXTRA, at_cmd_type_t::EXTENDED, "CGNSXTRA", 0 },
-    { at_cmd_t::CGNSCPY, at_cmd_type_t::EXTENDED, "CGNSCPY", 0 },
-    { at_cmd_t::CGNSRTMS, at_cmd_type_t::EXTENDED, "CGNSRTMS", 0 },
-    { at_cmd_t::CGNSHOR, at_cmd_type_t::EXTENDED, "CGNSHOR", 0 },
-    { at_cmd_t::CGNSUTIPR, at_cmd_type_t::EXTENDED, "CGNSUTIPR", 0 },
-    { at_cmd_t::CGNSNMEA, at_cmd_type_t::EXTENDED, "CGNSNMEA", 0 },
-    { at_cmd_t::CGTP, at_cmd_type_t::EXTENDED, "CGTP", 0 },
-    { at_cmd_t::CGNSSUPLCFG, at_cmd_type_t::EXTENDED, "CGNSSUPLCFG", 0 },
-    { at_cmd_t::CGNSSUPL, at_cmd_type_t::EXTENDED, "CGNSSUPL", 0 }
+    BASIC_CMD(AT, "", 0),
+    BASIC_CMD(A_SLASH, "A/", 0),
+    BASIC_CMD(D, "D", 0),
+    BASIC_CMD(E, "E", 0),
+    BASIC_CMD(H, "H", 20),
+    BASIC_CMD(I, "I", 0),
+    BASIC_CMD(L, "L", 0),
+    BASIC_CMD(M, "M", 0),
+    BASIC_CMD(PLUS_TO_3RD, "+++", 0),
+    BASIC_CMD(O, "O", 0),
+    BASIC_CMD(Q, "Q", 0),
+    S_PARAM_CMD(S0, "S0", 0),
+    S_PARAM_CMD(S3, "S3", 0),
+    S_PARAM_CMD(S4, "S4", 0),
+    S_PARAM_CMD(S5, "S5", 0),
+    S_PARAM_CMD(S6, "S6", 0),
+    S_PARAM_CMD(S7, "S7", 0),
+    S_PARAM_CMD(S8, "S8", 0),
+    S_PARAM_CMD(S10, "S10", 0),
+    BASIC_CMD(V, "V", 0),
+    BASIC_CMD(X, "X", 0),
+    BASIC_CMD(AND_C, "&C", 0),
+    BASIC_CMD(AND_D, "&D", 0),
+    BASIC_CMD(AND_E, "&E", 0),
+    EXTENDED_CMD(GCAP, 0),
+    EXTENDED_CMD(GMI, 0),
+    EXTENDED_CMD(GMM, 0),
+    EXTENDED_CMD(GMR, 0),
+    EXTENDED_CMD(GOI, 0),
+    EXTENDED_CMD(GSN, 0),
+    EXTENDED_CMD(ICF, 0),
+    EXTENDED_CMD(IFC, 0),
+    EXTENDED_CMD(IPR, 0),
+
+    EXTENDED_CMD(CGMI, 0),
+    EXTENDED_CMD(CGMM, 0),
+    EXTENDED_CMD(CGMR, 0),
+    EXTENDED_CMD(CGSN, 0),
+    EXTENDED_CMD(CSCS, 0),
+    EXTENDED_CMD(CIMI, 20),
+    EXTENDED_CMD(CLCK, 15),
+    EXTENDED_CMD(CMEE, 0),
+    EXTENDED_CMD(COPS, 120),
+    EXTENDED_CMD(CPAS, 0),
+    EXTENDED_CMD(CPIN, 5),
+    EXTENDED_CMD(CPWD, 15),
+    EXTENDED_CMD(CRC, 0),
+    EXTENDED_CMD(CREG, 0),
+    EXTENDED_CMD(CRSM, 0),
+    EXTENDED_CMD(CSQ, 0),
+    EXTENDED_CMD(CPOL, 0),
+    EXTENDED_CMD(COPN, 0),
+    EXTENDED_CMD(CFUN, 10),
+    EXTENDED_CMD(CCLK, 0),
+    EXTENDED_CMD(CSIM, 0),
+    EXTENDED_CMD(CBC, 0),
+    EXTENDED_CMD(CUSD, 0),
+    EXTENDED_CMD(CNUM, 0),
+    EXTENDED_CMD(CMUX, 0),
+
+    EXTENDED_CMD(CMGD, 25),
+    EXTENDED_CMD(CMGF, 0),
+    EXTENDED_CMD(CMGL, 20),
+    EXTENDED_CMD(CMGR, 5),
+    EXTENDED_CMD(CMGS, 60),
+    EXTENDED_CMD(CMGW, 5),
+    EXTENDED_CMD(CMSS, 0),
+    EXTENDED_CMD(CNMI, 0),
+    EXTENDED_CMD(CPMS, 0),
+    EXTENDED_CMD(CRES, 5),
+    EXTENDED_CMD(CSAS, 5),
+    EXTENDED_CMD(CSCA, 5),
+    EXTENDED_CMD(CSDH, 0),
+    EXTENDED_CMD(CSMP, 0),
+    EXTENDED_CMD(CSMS, 0),
+
+    EXTENDED_CMD(CPOWD, 0),
+    EXTENDED_CMD(CADC, 2),
+    EXTENDED_CMD(CFGRI, 0),
+    EXTENDED_CMD(CLTS, 0),
+    EXTENDED_CMD(CBAND, 0),
+    EXTENDED_CMD(CNSMOD, 0),
+    EXTENDED_CMD(CSCLK, 0),
+    EXTENDED_CMD(CCID, 2),
+    EXTENDED_CMD(CDEVICE, 0),
+    EXTENDED_CMD(GSV, 0),
+    EXTENDED_CMD(SGPIO, 0),
+    EXTENDED_CMD(SLEDS, 0),
+    EXTENDED_CMD(CNETLIGHT, 0),
+    EXTENDED_CMD(CSGS, 0),
+    EXTENDED_CMD(CGPIO, 0),
+    EXTENDED_CMD(CBATCHK, 0),
+    EXTENDED_CMD(CNMP, 0),
+    EXTENDED_CMD(CMNB, 0),
+    EXTENDED_CMD(CPSMS, 0),
+    EXTENDED_CMD(CEDRXS, 0),
+    EXTENDED_CMD(CPSI, 0),
+    EXTENDED_CMD(CGNAPN, 0),
+    EXTENDED_CMD(CSDP, 0),
+    EXTENDED_CMD(MCELLLOCK, 0),
+    EXTENDED_CMD(NCELLLOCK, 0),
+    EXTENDED_CMD(NBSC, 0),
+    EXTENDED_CMD(CAPNMODE, 0),
+    EXTENDED_CMD(CRRCSTATE, 0),
+    EXTENDED_CMD(CBANDCFG, 0),
+    EXTENDED_CMD(CNACT, 0),
+    EXTENDED_CMD(CNCFG, 0),
+    EXTENDED_CMD(CEDUMP, 0),
+    EXTENDED_CMD(CNBS, 0),
+    EXTENDED_CMD(CNDS, 0),
+    EXTENDED_CMD(CENG, 0),
+    EXTENDED_CMD(CNACTCFG, 0),
+    EXTENDED_CMD(CTLIIC, 0),
+    EXTENDED_CMD(CWIIC, 0),
+    EXTENDED_CMD(CRIIC, 0),
+    EXTENDED_CMD(CMCFG, 0),
+    EXTENDED_CMD(CSIMLOCK, 0),
+    EXTENDED_CMD(CRATSRCH, 0),
+    EXTENDED_CMD(SPWM, 0),
+    EXTENDED_CMD(CASRIP, 0),
+    EXTENDED_CMD(CEDRX, 0),
+    EXTENDED_CMD(CPSMRDP, 0),
+    EXTENDED_CMD(CPSMCFG, 0),
+    EXTENDED_CMD(CPSMCFGEXT, 0),
+    EXTENDED_CMD(CPSMSTATUS, 0),
+    EXTENDED_CMD(CEDRXRDP, 0),
+    EXTENDED_CMD(CRAI, 0),
+
+    EXTENDED_CMD(CGATT, 75),
+    EXTENDED_CMD(CGDCONT, 0),
+    EXTENDED_CMD(CGACT, 150),
+    EXTENDED_CMD(CGPADDR, 0),
+    EXTENDED_CMD(CGREG, 0),
+    EXTENDED_CMD(CGSMS, 0),
+    EXTENDED_CMD(CEREG, 0),
+
+    EXTENDED_CMD(SAPBR, 85),
+
+    EXTENDED_CMD(CIPMUX, 0),
+    EXTENDED_CMD(CIPSTART, 160),
+    EXTENDED_CMD(CIPSEND, 645),
+    EXTENDED_CMD(CIPQSEND, 0),
+    EXTENDED_CMD(CIPACK, 0),
+    EXTENDED_CMD(CIPCLOSE, 0),
+    EXTENDED_CMD(CIPSHUT, 65),
+    EXTENDED_CMD(CLPORT, 0),
+    EXTENDED_CMD(CSTT, 0),
+    EXTENDED_CMD(CIICR, 85),
+    EXTENDED_CMD(CIFSR, 0),
+    EXTENDED_CMD(CIFSREX, 0),
+    EXTENDED_CMD(CIPSTATUS, 0),
+    EXTENDED_CMD(CDNSCFG, 0),
+    EXTENDED_CMD(CDNSGIP, 0),
+    EXTENDED_CMD(CIPHEAD, 0),
+    EXTENDED_CMD(CIPATS, 0),
+    EXTENDED_CMD(CIPSPRT, 0),
+    EXTENDED_CMD(CIPSERVER, 0),
+    EXTENDED_CMD(CIPCSGP, 0),
+    EXTENDED_CMD(CIPSRIP, 0),
+    EXTENDED_CMD(CIPDPDP, 0),
+    EXTENDED_CMD(CIPMODE, 0),
+    EXTENDED_CMD(CIPCCFG, 0),
+    EXTENDED_CMD(CIPSHOWTP, 0),
+    EXTENDED_CMD(CIPUDPMODE, 0),
+    EXTENDED_CMD(CIPRXGET, 0),
+    EXTENDED_CMD(CIPRDTIMER, 0),
+    EXTENDED_CMD(CIPSGTXT, 0),
+    EXTENDED_CMD(CIPSENDHEX, 0),
+    EXTENDED_CMD(CIPHEXS, 0),
+    EXTENDED_CMD(CIPTKA, 0),
+    EXTENDED_CMD(CIPOPTION, 0),
+
+    EXTENDED_CMD(SHSSL, 0),
+    EXTENDED_CMD(SHCONF, 0),
+    EXTENDED_CMD(SHCONN, 0),
+    EXTENDED_CMD(SHBOD, 0),
+    EXTENDED_CMD(SHBODEXT, 0),
+    EXTENDED_CMD(SHAHEAD, 0),
+    EXTENDED_CMD(SHCHEAD, 0),
+    EXTENDED_CMD(SHPARA, 0),
+    EXTENDED_CMD(SHCPARA, 0),
+    EXTENDED_CMD(SHSTATE, 0),
+    EXTENDED_CMD(SHREQ, 0),
+    EXTENDED_CMD(SHREAD, 0),
+    EXTENDED_CMD(SHDISC, 0),
+    EXTENDED_CMD(HTTPTOFS, 0),
+    EXTENDED_CMD(HTTPTOFSRL, 0),
+
+    EXTENDED_CMD(CNTPCID, 0),
+    EXTENDED_CMD(CNTP, 0),
+
+    EXTENDED_CMD(SMCONF, 0),
+    EXTENDED_CMD(CSSLCFG, 0),
+    EXTENDED_CMD(SMSSL, 0),
+    EXTENDED_CMD(SMCONN, 300),
+    EXTENDED_CMD(SMPUB, 30),
+    EXTENDED_CMD(SMSUB, 0),
+    EXTENDED_CMD(SMUNSUB, 0),
+    EXTENDED_CMD(SMSTATE, 0),
+    EXTENDED_CMD(SMPUBHEX, 0),
+    EXTENDED_CMD(SMDISC, 0),
+
+    EXTENDED_CMD(CGNSPWR, 0),
+    EXTENDED_CMD(CGNSINF, 0),
+    EXTENDED_CMD(CGNSURC, 0),
+    EXTENDED_CMD(CGNSPORT, 0),
+    EXTENDED_CMD(CGNSCOLD, 0),
+    EXTENDED_CMD(CGNSWARM, 0),
+    EXTENDED_CMD(CGNSHOT, 0),
+    EXTENDED_CMD(CGNSMOD, 0),
+    EXTENDED_CMD(CGNSCFG, 0),
+    EXTENDED_CMD(CGNSTST, 0),
+    EXTENDED_CMD(CGNSXTRA, 0),
+    EXTENDED_CMD(CGNSCPY, 0),
+    EXTENDED_CMD(CGNSRTMS, 0),
+    EXTENDED_CMD(CGNSHOR, 0),
+    EXTENDED_CMD(CGNSUTIPR, 0),
+    EXTENDED_CMD(CGNSNMEA, 0),
+    EXTENDED_CMD(CGTP, 0),
+    EXTENDED_CMD(CGNSSUPLCFG, 0),
+    EXTENDED_CMD(CGNSSUPL, 0)
 };
 
-static const urc_def_t URC_TABLE[] = 
+static constexpr urc_def_t URC_TABLE[] =
 {
     { urc_t::CRING, "+CRING", urc_match_t::AT_BEGINNING, at_cmd_t::CRC },
     { urc_t::CREG, "+CREG", urc_match_t::AT_BEGINNING, at_cmd_t::CREG },
@@ -262,53 +276,223 @@ static const urc_def_t URC_TABLE[] =
     { urc_t::APP_PDP_ACTIVE, "+APP PDP: ACTIVE", urc_match_t::WHOLE_TEXT, at_cmd_t::CNACT },
     { urc_t::APP_PDP_DEACTIVE, "+APP PDP: DEACTIVE", urc_match_t::WHOLE_TEXT, at_cmd_t::CNACT },
     { urc_t::UGNSINF, "+UGNSINF", urc_match_t::AT_BEGINNING, at_cmd_t::CGNSURC },
-    { urc_t::SMSUB, "+SMSUB", urc_match_t::AT_BEGINNING, at_cmd_t::SMSUB }
+    { urc_t::SMSUB, "+SMSUB", urc_match_t::AT_BEGINNING, at_cmd_t::SMSUB },
+    { urc_t::CGREG, "+CGREG", urc_match_t::AT_BEGINNING, at_cmd_t::CGREG },
+    { urc_t::SMSTATE, "+SMSTATE", urc_match_t::AT_BEGINNING, at_cmd_t::SMSTATE }
 };
 
-static const int AT_COMMANDS_TABLE_SIZE = sizeof(AT_COMMANDS_TABLE) / sizeof(at_cmd_def_t);
-static const int URC_TABLE_SIZE = sizeof(URC_TABLE) / sizeof(urc_def_t);
+/* Índice de comandos */
+
+// los valores de at_cmd_t se agrupan por centenas (p. ej. 1001..1010 para
+// MQTT), por lo que el índice se forma con el grupo y la posición en él
+static constexpr size_t CMD_GROUP_SIZE = 64;
+static constexpr size_t CMD_GROUP_COUNT = 13;
+static constexpr uint8_t NO_CMD_INDEX = 0xFF;
+
+static_assert(std::size(AT_COMMANDS_TABLE) < NO_CMD_INDEX);
+
+static constexpr size_t get_cmd_slot(at_cmd_t command)
+{
+    size_t value = static_cast<size_t>(command);
+    return (value / 100) * CMD_GROUP_SIZE + (value % 100);
+}
+
+static constexpr bool is_cmd_slot_valid(at_cmd_t command)
+{
+    int value = static_cast<int>(command);
+    return value >= 0 &&
+        value % 100 < (int)CMD_GROUP_SIZE &&
+        value / 100 < (int)CMD_GROUP_COUNT;
+}
 
+static constexpr auto AT_COMMANDS_INDEX = []
+{
+    std::array<uint8_t, CMD_GROUP_SIZE * CMD_GROUP_COUNT> index{};
+    index.fill(NO_CMD_INDEX);
+
+    for (size_t i = 0; i < std::size(AT_COMMANDS_TABLE); i++) {
+        index[get_cmd_slot(AT_COMMANDS_TABLE[i].command)] = i;
+    }
+
+    return index;
+}();
+
+// comprueba que cada comando de la tabla ocupa una posición única del índice
+static constexpr bool check_cmd_index()
+{
+    for (size_t i = 0; i < std::size(AT_COMMANDS_TABLE); i++) {
+        at_cmd_t command = AT_COMMANDS_TABLE[i].command;
+
+        if (!is_cmd_slot_valid(command) ||
+            AT_COMMANDS_INDEX[get_cmd_slot(command)] != i) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static_assert(check_cmd_index(), "AT command table has invalid or duplicated entries");
 
 const at_cmd_def_t *get_command_def(at_cmd_t command)
 {
-    for (size_t i = 0; i < AT_COMMANDS_TABLE_SIZE; i++) {
-        if (AT_COMMANDS_TABLE[i].command == command) {
-            return &AT_COMMANDS_TABLE[i];
+    if (!is_cmd_slot_valid(command)) return nullptr;
+
+    uint8_t index = AT_COMMANDS_INDEX[get_cmd_slot(command)];
+    return index != NO_CMD_INDEX ? &AT_COMMANDS_TABLE[index] : nullptr;
+}
+
+size_t build_cmd_line(
+    const at_cmd_def_t &cmd_def,
+    std::span<const char> params,
+    std::span<char> buffer)
+{
+    const std::string_view &prefix = cmd_def.prefix;
+
+    // los literales de cadena convertidos a std::span incluyen el terminador
+    // nulo, el cual no debe enviarse
+    if (!params.empty() && params.back() == '\0') {
+        params = params.first(params.size() - 1);
+    }
+
+    // prefijo + parámetros + retorno de carro + terminador nulo
+    size_t length = prefix.length() + params.size() + 1;
+    if (length + 1 > buffer.size()) return 0;
+
+    char *out = buffer.data();
+    memcpy(out, prefix.data(), prefix.length());
+    out += prefix.length();
+
+    if (!params.empty()) {
+        memcpy(out, params.data(), params.size());
+        out += params.size();
+    }
+
+    *out++ = '\r';
+    *out = '\0';
+
+    return length;
+}
+
+/* Clasificador de URC */
+
+// las entradas se agrupan según un hash de sus primeros 3 caracteres (o los
+// últimos 3 para las de tipo AT_END), de modo que cada línea solo se compara
+// con los pocos identificadores que comparten su grupo
+static constexpr size_t URC_KEY_LENGTH = 3;
+static constexpr size_t URC_BUCKET_COUNT = 64;
+static constexpr size_t URC_TABLE_SIZE = std::size(URC_TABLE);
+
+struct urc_index_t
+{
+    std::array<uint8_t, URC_TABLE_SIZE> entries;
+    std::array<uint8_t, URC_BUCKET_COUNT + 1> offsets;
+};
+
+static constexpr size_t get_urc_bucket(const char *key)
+{
+    uint8_t a = key[0], b = key[1], c = key[2];
+    return (a * 7 + b * 3 + c) % URC_BUCKET_COUNT;
+}
+
+static constexpr bool is_suffix_urc(const urc_def_t &def)
+{
+    return def.match == urc_match_t::AT_END;
+}
+
+static constexpr const char *get_urc_key(const urc_def_t &def)
+{
+    std::string_view id = def.identifier;
+    return is_suffix_urc(def) ? 
+        id.data() + id.length() - URC_KEY_LENGTH : id.data();
+}
+
+// ordena las entradas por grupo (conservando el orden de la tabla dentro de
+// cada grupo) y calcula el inicio de cada grupo
+static constexpr urc_index_t build_urc_index(bool suffix)
+{
+    urc_index_t index{};
+    size_t count = 0;
+
+    for (size_t bucket = 0; bucket < URC_BUCKET_COUNT; bucket++) {
+        index.offsets[bucket] = count;
+
+        for (size_t i = 0; i < URC_TABLE_SIZE; i++) {
+            const urc_def_t &def = URC_TABLE[i];
+            if (is_suffix_urc(def) != suffix) continue;
+
+            if (get_urc_bucket(get_urc_key(def)) == bucket) {
+                index.entries[count++] = i;
+            }
         }
     }
-    
-    return nullptr;
+
+    index.offsets[URC_BUCKET_COUNT] = count;
+    return index;
 }
 
-const urc_def_t *get_urc_def(const std::string &urc)
+static constexpr urc_index_t URC_PREFIX_INDEX = build_urc_index(false);
+static constexpr urc_index_t URC_SUFFIX_INDEX = build_urc_index(true);
+
+static constexpr bool check_urc_table()
 {
-    bool match = false;
-
-    for (size_t i = 0; i < URC_TABLE_SIZE; i++) {
-        const urc_def_t *def = &URC_TABLE[i];
-        
-        switch (def->match)
-        {
-            case urc_match_t::WHOLE_TEXT:
-                match = urc == def->identifier;
-                break;
-            case urc_match_t::AT_BEGINNING:
-                match = urc.starts_with(def->identifier);
-                break;
-            case urc_match_t::AT_END:
-                match = urc.ends_with(def->identifier);
-                break;
-            default:
-                break;
+    for (const urc_def_t &def : URC_TABLE) {
+        if (std::string_view(def.identifier).length() < URC_KEY_LENGTH) {
+            return false;
         }
+    }
+
+    return true;
+}
+
+static_assert(check_urc_table(), "URC identifiers must have at least 3 characters");
+
+static bool match_urc(const urc_def_t &def, std::string_view line)
+{
+    switch (def.match)
+    {
+        case urc_match_t::WHOLE_TEXT:
+            return line == def.identifier;
+        case urc_match_t::AT_BEGINNING:
+            return line.starts_with(def.identifier);
+        case urc_match_t::AT_END:
+            return line.ends_with(def.identifier);
+        default:
+            return false;
+    }
+}
 
-        if (match) return def;
+// devuelve el índice en la tabla de la primera entrada del grupo que
+// coincide con la línea, o URC_TABLE_SIZE si no hay coincidencias
+static size_t find_urc(const urc_index_t &index, const char *key, std::string_view line)
+{
+    size_t bucket = get_urc_bucket(key);
+
+    for (size_t i = index.offsets[bucket]; i < index.offsets[bucket + 1]; i++) {
+        size_t entry = index.entries[i];
+        if (match_urc(URC_TABLE[entry], line)) return entry;
     }
-    
-    return nullptr;
+
+    return URC_TABLE_SIZE;
+}
+
+const urc_def_t *get_urc_def(std::string_view urc)
+{
+    if (urc.length() < URC_KEY_LENGTH) return nullptr;
+
+    size_t prefix = find_urc(URC_PREFIX_INDEX, urc.data(), urc);
+    size_t suffix = find_urc(
+        URC_SUFFIX_INDEX,
+        urc.data() + urc.length() - URC_KEY_LENGTH,
+        urc
+    );
+
+    // si ambas coinciden tiene prioridad la que aparece primero en la tabla
+    size_t entry = std::min(prefix, suffix);
+    return entry < URC_TABLE_SIZE ? &URC_TABLE[entry] : nullptr;
 }
 
-bool check_if_is_urc(const std::string &urc)
+bool check_if_is_urc(std::string_view urc)
 {
     return get_urc_def(urc) != nullptr;
 }
@@ -0,0 +1,285 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <cstdlib>
+#include <utility>
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <esp_err.h>
+
+namespace axomotor::threading {
+
+constexpr static const size_t DEFAULT_EXECUTOR_QUEUE_SIZE = 16;
+constexpr static const size_t MAX_EXECUTOR_TIMERS = 16;
+// bloques de la reserva de marcos de corrutinas; los grandes son para
+// corrutinas con buffers locales, como la publicación de un lote de posiciones
+constexpr static const size_t SMALL_FRAME_SIZE = 256;
+constexpr static const size_t SMALL_FRAME_COUNT = 32;
+constexpr static const size_t LARGE_FRAME_SIZE = 2048;
+constexpr static const size_t LARGE_FRAME_COUNT = 2;
+
+class Executor;
+
+/**
+ * @brief Reserva estática de la que se toman los marcos de AsyncTask y Async,
+ * de modo que iniciar y esperar corrutinas no usa memoria dinámica. Si el
+ * marco no cabe en un bloque o no hay bloques libres se toma del heap.
+ */
+class FramePool
+{
+public:
+    /**
+     * @return nullptr si tampoco hay memoria en el heap.
+     */
+    static void *allocate(size_t size) noexcept;
+    static void deallocate(void *frame) noexcept;
+
+    /**
+     * @brief Marcos que se tomaron del heap desde el arranque.
+     */
+    static size_t get_heap_frame_count();
+};
+
+/**
+ * @brief Valor que devuelve co_await cuando no hubo memoria para el marco de
+ * un Async<T>.
+ */
+template <typename T>
+T get_allocation_failure_value() { return T{}; }
+
+template <>
+inline esp_err_t get_allocation_failure_value<esp_err_t>() { return ESP_ERR_NO_MEM; }
+
+/**
+ * @brief Punto de espera de una corrutina suspendida. Lo despierta la primera
+ * fuente que lo active (otra tarea o un temporizador del ejecutor); las
+ * siguientes se ignoran.
+ */
+class Waiter
+{
+public:
+    Waiter();
+    Waiter(const Waiter &) = delete;
+
+    void arm(std::coroutine_handle<> handle, Executor &executor);
+
+    /**
+     * @brief Encola la corrutina en su ejecutor. Puede llamarse desde
+     * cualquier tarea (no desde una ISR).
+     * @return false si ya se había despertado o si la cola está llena.
+     */
+    bool wake();
+
+    Waiter &operator=(const Waiter &) = delete;
+
+private:
+    friend class Executor;
+
+    std::coroutine_handle<> m_handle;
+    Executor *m_executor;
+    std::atomic<bool> m_woken;
+};
+
+/**
+ * @brief Corrutina sin valor de retorno que se inicia con Executor::spawn().
+ * La memoria de la corrutina se libera al terminar. Si no hubo memoria para
+ * el marco, spawn() devuelve ESP_ERR_NO_MEM.
+ */
+class AsyncTask
+{
+public:
+    struct promise_type
+    {
+        Waiter waiter;
+        Executor *executor = nullptr;
+
+        static void *operator new(size_t size) noexcept { return FramePool::allocate(size); }
+        static void operator delete(void *frame) noexcept { FramePool::deallocate(frame); }
+        static AsyncTask get_return_object_on_allocation_failure() { return AsyncTask{nullptr}; }
+
+        AsyncTask get_return_object();
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() { }
+        void unhandled_exception() { abort(); }
+        ~promise_type();
+    };
+
+    AsyncTask(AsyncTask &&other) : m_handle{std::exchange(other.m_handle, nullptr)} { }
+    AsyncTask(const AsyncTask &) = delete;
+    ~AsyncTask();
+
+    AsyncTask &operator=(const AsyncTask &) = delete;
+
+private:
+    friend class Executor;
+
+    explicit AsyncTask(std::coroutine_handle<promise_type> handle) : m_handle{handle} { }
+
+    std::coroutine_handle<promise_type> m_handle;
+};
+
+/**
+ * @brief Corrutina que devuelve un valor al ser esperada con co_await. No
+ * comienza a ejecutarse hasta que se espera. Si no hubo memoria para el
+ * marco, co_await devuelve get_allocation_failure_value<T>().
+ */
+template <typename T>
+class Async
+{
+public:
+    struct promise_type
+    {
+        T value{};
+        std::coroutine_handle<> continuation;
+
+        struct final_awaiter
+        {
+            bool await_ready() noexcept { return false; }
+            void await_resume() noexcept { }
+
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> handle) noexcept
+            {
+                // regresa directamente a la corrutina que la esperaba
+                auto continuation = handle.promise().continuation;
+                return continuation ? continuation : std::noop_coroutine();
+            }
+        };
+
+        static void *operator new(size_t size) noexcept { return FramePool::allocate(size); }
+        static void operator delete(void *frame) noexcept { FramePool::deallocate(frame); }
+        static Async get_return_object_on_allocation_failure() { return Async{nullptr}; }
+
+        Async get_return_object()
+        {
+            return Async{std::coroutine_handle<promise_type>::from_promise(*this)};
+        }
+
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        final_awaiter final_suspend() noexcept { return {}; }
+        void return_value(T result) { value = std::move(result); }
+        void unhandled_exception() { abort(); }
+    };
+
+    Async(Async &&other) : m_handle{std::exchange(other.m_handle, nullptr)} { }
+    Async(const Async &) = delete;
+
+    ~Async()
+    {
+        if (m_handle) m_handle.destroy();
+    }
+
+    bool await_ready() const noexcept { return !m_handle; }
+
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> caller) noexcept
+    {
+        m_handle.promise().continuation = caller;
+        return m_handle;
+    }
+
+    T await_resume()
+    {
+        if (!m_handle) return get_allocation_failure_value<T>();
+        return std::move(m_handle.promise().value);
+    }
+
+    Async &operator=(const Async &) = delete;
+
+private:
+    explicit Async(std::coroutine_handle<promise_type> handle) : m_handle{handle} { }
+
+    std::coroutine_handle<promise_type> m_handle;
+};
+
+/**
+ * @brief Ejecuta corrutinas en la tarea que llama a run() (normalmente el
+ * loop() de un servicio), de modo que varias operaciones pueden intercalarse
+ * sin pilas adicionales.
+ */
+class Executor
+{
+public:
+    Executor(size_t queue_size = DEFAULT_EXECUTOR_QUEUE_SIZE);
+    Executor(const Executor &) = delete;
+    Executor(Executor &&) = delete;
+    ~Executor();
+
+    /**
+     * @brief Agrega una corrutina; comienza en la siguiente llamada a run().
+     */
+    esp_err_t spawn(AsyncTask task);
+
+    /**
+     * @brief Reanuda las corrutinas listas y las que vencieron su
+     * temporizador. Si no hay ninguna lista, espera hasta ticks_to_wait.
+     * @return Cantidad de corrutinas reanudadas.
+     */
+    size_t run(TickType_t ticks_to_wait = 0);
+
+    /**
+     * @brief Despierta el punto de espera después de los ticks indicados si
+     * nada lo ha despertado antes. Solo desde la tarea del ejecutor.
+     */
+    bool add_timer(Waiter &waiter, TickType_t ticks);
+    void cancel_timer(Waiter &waiter);
+
+    size_t get_task_count() const { return m_task_count; }
+
+    /**
+     * @brief Ejecutor que está corriendo en la tarea actual (o nullptr).
+     */
+    static Executor *current();
+
+    /**
+     * @brief Suspende la corrutina actual durante los ticks indicados.
+     */
+    static auto sleep(TickType_t ticks)
+    {
+        struct awaiter
+        {
+            TickType_t ticks;
+            Waiter waiter;
+
+            bool await_ready() const { return ticks == 0 || current() == nullptr; }
+            void await_resume() { }
+
+            bool await_suspend(std::coroutine_handle<> handle)
+            {
+                Executor *executor = current();
+                waiter.arm(handle, *executor);
+                return executor->add_timer(waiter, ticks);
+            }
+        };
+
+        return awaiter{ticks, {}};
+    }
+
+    Executor &operator=(const Executor &) = delete;
+    Executor &operator=(Executor &&) = delete;
+
+private:
+    struct timer_entry_t
+    {
+        Waiter *waiter;
+        TickType_t deadline;
+    };
+
+    friend class Waiter;
+    friend struct AsyncTask::promise_type;
+
+    QueueHandle_t m_queue;
+    std::array<timer_entry_t, MAX_EXECUTOR_TIMERS> m_timers;
+    size_t m_timer_count;
+    std::atomic<size_t> m_task_count;
+
+    bool post(Waiter &waiter);
+    size_t run_timers(TickType_t now);
+    TickType_t get_next_timeout(TickType_t now, TickType_t ticks_to_wait) const;
+    void resume(Waiter &waiter);
+};
+
+} // namespace axomotor::threading
@@ -0,0 +1,269 @@
+#include "executor.hpp"
+
+#include <mutex>
+#include <new>
+#include <esp_log.h>
+
+namespace axomotor::threading {
+
+constexpr static const char *TAG = "executor";
+
+// ejecutor que está reanudando corrutinas en la tarea actual
+static thread_local Executor *s_current_executor = nullptr;
+
+static_assert(SMALL_FRAME_COUNT <= 32 && LARGE_FRAME_COUNT <= 32);
+
+// bloques de la reserva de marcos y los que están libres (un bit por bloque)
+alignas(std::max_align_t) static uint8_t s_small_frames[SMALL_FRAME_COUNT][SMALL_FRAME_SIZE];
+alignas(std::max_align_t) static uint8_t s_large_frames[LARGE_FRAME_COUNT][LARGE_FRAME_SIZE];
+static uint32_t s_small_free_mask = (uint32_t)((1ULL << SMALL_FRAME_COUNT) - 1);
+static uint32_t s_large_free_mask = (uint32_t)((1ULL << LARGE_FRAME_COUNT) - 1);
+static size_t s_heap_frame_count = 0;
+static std::mutex s_frame_mutex;
+
+/* FramePool */
+
+void *FramePool::allocate(size_t size) noexcept
+{
+    {
+        std::lock_guard lock(s_frame_mutex);
+
+        // toma el primer bloque libre del tamaño más pequeño en el que cabe
+        if (size <= SMALL_FRAME_SIZE && s_small_free_mask != 0) {
+            size_t index = __builtin_ctz(s_small_free_mask);
+            s_small_free_mask &= ~(1UL << index);
+            return s_small_frames[index];
+        }
+
+        if (size <= LARGE_FRAME_SIZE && s_large_free_mask != 0) {
+            size_t index = __builtin_ctz(s_large_free_mask);
+            s_large_free_mask &= ~(1UL << index);
+            return s_large_frames[index];
+        }
+
+        s_heap_frame_count++;
+    }
+
+    ESP_LOGW(TAG, "Coroutine frame of %u bytes taken from heap", (unsigned)size);
+    return ::operator new(size, std::nothrow);
+}
+
+void FramePool::deallocate(void *frame) noexcept
+{
+    auto block = static_cast<uint8_t *>(frame);
+    auto small_frames = &s_small_frames[0][0];
+    auto large_frames = &s_large_frames[0][0];
+
+    if (block >= small_frames && block < small_frames + sizeof(s_small_frames)) {
+        std::lock_guard lock(s_frame_mutex);
+        s_small_free_mask |= 1UL << ((block - small_frames) / SMALL_FRAME_SIZE);
+    } else if (block >= large_frames && block < large_frames + sizeof(s_large_frames)) {
+        std::lock_guard lock(s_frame_mutex);
+        s_large_free_mask |= 1UL << ((block - large_frames) / LARGE_FRAME_SIZE);
+    } else {
+        ::operator delete(frame);
+    }
+}
+
+size_t FramePool::get_heap_frame_count()
+{
+    std::lock_guard lock(s_frame_mutex);
+    return s_heap_frame_count;
+}
+
+/* Waiter */
+
+Waiter::Waiter() :
+    m_handle{nullptr},
+    m_executor{nullptr},
+    m_woken{false}
+{ }
+
+void Waiter::arm(std::coroutine_handle<> handle, Executor &executor)
+{
+    m_handle = handle;
+    m_executor = &executor;
+    m_woken.store(false);
+}
+
+bool Waiter::wake()
+{
+    if (m_executor == nullptr) return false;
+
+    // solo la primera fuente encola la corrutina
+    bool expected = false;
+    if (!m_woken.compare_exchange_strong(expected, true)) return false;
+
+    if (!m_executor->post(*this)) {
+        // permite que el temporizador la despierte más tarde
+        m_woken.store(false);
+        return false;
+    }
+
+    return true;
+}
+
+/* AsyncTask */
+
+AsyncTask AsyncTask::promise_type::get_return_object()
+{
+    return AsyncTask{std::coroutine_handle<promise_type>::from_promise(*this)};
+}
+
+AsyncTask::promise_type::~promise_type()
+{
+    if (executor != nullptr) executor->m_task_count--;
+}
+
+AsyncTask::~AsyncTask()
+{
+    // la corrutina nunca se inició
+    if (m_handle) m_handle.destroy();
+}
+
+/* Executor */
+
+Executor::Executor(size_t queue_size) :
+    m_timers{},
+    m_timer_count{0},
+    m_task_count{0}
+{
+    m_queue = xQueueCreate(queue_size, sizeof(Waiter *));
+    assert(m_queue);
+}
+
+Executor::~Executor()
+{
+    vQueueDelete(m_queue);
+}
+
+esp_err_t Executor::spawn(AsyncTask task)
+{
+    // no hubo memoria para el marco de la corrutina
+    if (!task.m_handle) return ESP_ERR_NO_MEM;
+
+    auto &promise = task.m_handle.promise();
+    promise.waiter.arm(task.m_handle, *this);
+    promise.executor = this;
+    m_task_count++;
+
+    if (!promise.waiter.wake()) {
+        ESP_LOGW(TAG, "Ready queue is full");
+        promise.executor = nullptr;
+        m_task_count--;
+        return ESP_ERR_NO_MEM;
+    }
+
+    // a partir de aquí la corrutina se libera sola al terminar
+    task.m_handle = nullptr;
+
+    return ESP_OK;
+}
+
+size_t Executor::run(TickType_t ticks_to_wait)
+{
+    Executor *previous = s_current_executor;
+    Waiter *waiter;
+    size_t resumed;
+
+    s_current_executor = this;
+    resumed = run_timers(xTaskGetTickCount());
+
+    // espera la primera corrutina lista solo si no se reanudó ninguna, sin
+    // pasar del siguiente temporizador
+    TickType_t timeout = resumed ? 0 : get_next_timeout(xTaskGetTickCount(), ticks_to_wait);
+
+    while (xQueueReceive(m_queue, &waiter, timeout) == pdTRUE) {
+        resume(*waiter);
+        resumed++;
+        timeout = 0;
+    }
+
+    resumed += run_timers(xTaskGetTickCount());
+    s_current_executor = previous;
+
+    return resumed;
+}
+
+bool Executor::add_timer(Waiter &waiter, TickType_t ticks)
+{
+    if (m_timer_count == m_timers.size()) {
+        ESP_LOGW(TAG, "Too many timers");
+        return false;
+    }
+
+    m_timers[m_timer_count++] = { &waiter, xTaskGetTickCount() + ticks };
+    return true;
+}
+
+void Executor::cancel_timer(Waiter &waiter)
+{
+    for (size_t i = 0; i < m_timer_count; i++) {
+        if (m_timers[i].waiter == &waiter) {
+            m_timers[i] = m_timers[--m_timer_count];
+            return;
+        }
+    }
+}
+
+Executor *Executor::current()
+{
+    return s_current_executor;
+}
+
+bool Executor::post(Waiter &waiter)
+{
+    Waiter *item = &waiter;
+    return xQueueSend(m_queue, &item, 0) == pdTRUE;
+}
+
+size_t Executor::run_timers(TickType_t now)
+{
+    size_t resumed = 0;
+    size_t i = 0;
+
+    while (i < m_timer_count) {
+        timer_entry_t timer = m_timers[i];
+
+        if ((TickType_t)(now - timer.deadline) >= portMAX_DELAY / 2) {
+            i++;
+            continue;
+        }
+
+        // quita el temporizador antes de reanudar, ya que la corrutina puede
+        // agregar otro
+        m_timers[i] = m_timers[--m_timer_count];
+
+        // si otra tarea ya la despertó, se reanudará desde la cola
+        bool expected = false;
+        if (timer.waiter->m_woken.compare_exchange_strong(expected, true)) {
+            timer.waiter->m_handle.resume();
+            resumed++;
+        }
+    }
+
+    return resumed;
+}
+
+TickType_t Executor::get_next_timeout(TickType_t now, TickType_t ticks_to_wait) const
+{
+    TickType_t timeout = ticks_to_wait;
+
+    for (size_t i = 0; i < m_timer_count; i++) {
+        TickType_t remaining = m_timers[i].deadline - now;
+        // el temporizador ya venció
+        if (remaining >= portMAX_DELAY / 2) return 0;
+        if (remaining < timeout) timeout = remaining;
+    }
+
+    return timeout;
+}
+
+void Executor::resume(Waiter &waiter)
+{
+    // el temporizador ya no debe despertar este punto de espera
+    cancel_timer(waiter);
+    waiter.m_handle.resume();
+}
+
+} // namespace axomotor::threading
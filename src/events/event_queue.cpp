@@ -1,6 +1,8 @@
 #include "events/event_queue.hpp"
 #include "constants/general.hpp"
 
+#include <algorithm>
+
 namespace axomotor::events {
 
 using namespace axomotor::constants::general;
@@ -12,15 +14,21 @@ time_t get_timestamp()
     return epoch;
 }
 
+#if EVENT_QUEUE_USE_RING
+DeviceEventQueue::DeviceEventQueue(size_t length, const EventNotifier *notifier) :
+    EventRing<device_event_t>(length, notifier)
+{ }
+#else
 DeviceEventQueue::DeviceEventQueue(size_t length) : EventQueue<device_event_t>(length)
 { }
+#endif
 
 bool DeviceEventQueue::send_to_back(const event_code_t code, TickType_t ticks_to_wait) const
 {
     device_event_t event{};
     event.code = code;
     event.timestamp = get_timestamp();
-    return EventQueue<device_event_t>::send_to_back(event, ticks_to_wait);
+    return EventQueueBackend<device_event_t>::send_to_back(event, ticks_to_wait);
 }
 
 bool DeviceEventQueue::send_to_front(const event_code_t code, TickType_t ticks_to_wait) const
@@ -29,10 +37,105 @@ bool DeviceEventQueue::send_to_front(const event_code_t code, TickType_t ticks_t
     event.code = code;
     event.timestamp = get_timestamp();
     
-    return EventQueue<device_event_t>::send_to_front(event, ticks_to_wait);
+    return EventQueueBackend<device_event_t>::send_to_front(event, ticks_to_wait);
 }
 
+#if EVENT_QUEUE_USE_RING
+
 EventQueueSet::EventQueueSet() :
+    m_notifier{},
+    device{DEVICE_EVENTS_QUEUE_LENGTH, &m_notifier},
+    position{POSITION_EVENTS_QUEUE_LENGTH, &m_notifier},
+    ping{PING_EVENTS_QUEUE_LENGTH, &m_notifier}
+{ }
+
+event_type_t EventQueueSet::wait_for_event(TickType_t ticks_to_wait) const
+{
+    const TickType_t started_at = xTaskGetTickCount();
+    event_type_t type;
+
+    while (true) {
+        type = get_ready_event();
+        if (type != event_type_t::NONE) return type;
+
+        TickType_t elapsed = xTaskGetTickCount() - started_at;
+        if (elapsed >= ticks_to_wait) return event_type_t::NONE;
+
+        // verifica de nuevo después de anunciar la espera para no perder
+        // un evento publicado entre ambas verificaciones
+        m_notifier.prepare_wait();
+        type = get_ready_event();
+        if (type != event_type_t::NONE) {
+            m_notifier.cancel_wait();
+            return type;
+        }
+
+        if (!m_notifier.wait(ticks_to_wait - elapsed)) {
+            return get_ready_event();
+        }
+    }
+}
+
+size_t EventQueueSet::drain(queued_event_t *events, size_t max_items, TickType_t ticks_to_wait) const
+{
+    size_t count = 0;
+
+    if (max_items == 0 || wait_for_event(ticks_to_wait) == event_type_t::NONE) {
+        return 0;
+    }
+
+    // cada cola se vacía antes de pasar a la de menor prioridad
+    while (count < max_items && device.receive(events[count].device, 0)) {
+        events[count++].type = event_type_t::DEVICE;
+    }
+    while (count < max_items && ping.receive(events[count].ping, 0)) {
+        events[count++].type = event_type_t::SERVER_PING;
+    }
+    while (count < max_items && position.receive(events[count].position, 0)) {
+        events[count++].type = event_type_t::POSITION;
+    }
+
+    return count;
+}
+
+uint32_t EventQueueSet::get_wakeup_count() const
+{
+    return m_notifier.get_wakeup_count();
+}
+
+event_type_t EventQueueSet::get_ready_event() const
+{
+    if (device.has_items()) {
+        return event_type_t::DEVICE;
+    } else if (ping.has_items()) {
+        return event_type_t::SERVER_PING;
+    } else if (position.has_items()) {
+        return event_type_t::POSITION;
+    } else {
+        return event_type_t::NONE;
+    }
+}
+
+#else
+
+// orden en el que drain() entrega los eventos
+static int get_priority(event_type_t type)
+{
+    switch (type)
+    {
+        case event_type_t::DEVICE:
+            return 0;
+        case event_type_t::SERVER_PING:
+            return 1;
+        case event_type_t::POSITION:
+            return 2;
+        default:
+            return 3;
+    }
+}
+
+EventQueueSet::EventQueueSet() :
+    m_wakeup_count{0},
     device{DEVICE_EVENTS_QUEUE_LENGTH},
     position{POSITION_EVENTS_QUEUE_LENGTH},
     ping{PING_EVENTS_QUEUE_LENGTH}
@@ -51,6 +154,9 @@ EventQueueSet::EventQueueSet() :
 event_type_t EventQueueSet::wait_for_event(TickType_t ticks_to_wait) const
 {
     auto activated_member = xQueueSelectFromSet(m_handle, ticks_to_wait);
+    if (activated_member != nullptr) {
+        m_wakeup_count++;
+    }
 
     if (activated_member == device.m_handle) {
         return event_type_t::DEVICE;
@@ -63,4 +169,47 @@ event_type_t EventQueueSet::wait_for_event(TickType_t ticks_to_wait) const
     }
 }
 
+size_t EventQueueSet::drain(queued_event_t *events, size_t max_items, TickType_t ticks_to_wait) const
+{
+    QueueSetMemberHandle_t member;
+    size_t count = 0;
+
+    // el conjunto tiene un aviso por cada elemento de las colas, por lo que
+    // deben seleccionarse uno por uno antes de leerlos
+    while (count < max_items &&
+           (member = xQueueSelectFromSet(m_handle, count == 0 ? ticks_to_wait : 0)) != nullptr) {
+        queued_event_t &event = events[count];
+
+        if (count == 0) {
+            m_wakeup_count++;
+        }
+
+        if (member == device.m_handle && device.receive(event.device, 0)) {
+            event.type = event_type_t::DEVICE;
+        } else if (member == position.m_handle && position.receive(event.position, 0)) {
+            event.type = event_type_t::POSITION;
+        } else if (member == ping.m_handle && ping.receive(event.ping, 0)) {
+            event.type = event_type_t::SERVER_PING;
+        } else {
+            continue;
+        }
+
+        count++;
+    }
+
+    // ordena por prioridad conservando el orden de llegada de cada cola
+    std::stable_sort(events, events + count, [](const queued_event_t &a, const queued_event_t &b) {
+        return get_priority(a.type) < get_priority(b.type);
+    });
+
+    return count;
+}
+
+uint32_t EventQueueSet::get_wakeup_count() const
+{
+    return m_wakeup_count;
+}
+
+#endif
+
 }
@@ -0,0 +1,50 @@
+#include "events/event_ring.hpp"
+
+namespace axomotor::events {
+
+EventNotifier::EventNotifier() :
+    m_task{nullptr},
+    m_is_waiting{false},
+    m_wakeup_count{0}
+{ }
+
+void EventNotifier::notify() const
+{
+    // solo el primer productor despierta al consumidor
+    if (m_is_waiting.exchange(false)) {
+        xTaskNotifyGiveIndexed(m_task.load(), EVENT_NOTIFY_INDEX);
+    }
+}
+
+bool EventNotifier::wait(TickType_t ticks_to_wait) const
+{
+    bool is_notified = ulTaskNotifyTakeIndexed(EVENT_NOTIFY_INDEX, pdTRUE, ticks_to_wait) != 0;
+
+    // un productor tomó la espera justo cuando se agotó el tiempo; se
+    // consume su notificación para que no despierte la siguiente espera
+    if (!is_notified && !m_is_waiting.exchange(false)) {
+        is_notified = ulTaskNotifyTakeIndexed(EVENT_NOTIFY_INDEX, pdTRUE, 0) != 0;
+    }
+
+    if (is_notified) {
+        m_wakeup_count++;
+    }
+
+    return is_notified;
+}
+
+void EventNotifier::prepare_wait() const
+{
+    m_task = xTaskGetCurrentTaskHandle();
+    m_is_waiting = true;
+}
+
+void EventNotifier::cancel_wait() const
+{
+    // si un productor ya tomó la espera, su notificación se descarta
+    if (!m_is_waiting.exchange(false)) {
+        ulTaskNotifyTakeIndexed(EVENT_NOTIFY_INDEX, pdTRUE, 0);
+    }
+}
+
+} // namespace axomotor::events
@@ -0,0 +1,187 @@
+#include "events/outbound_scheduler.hpp"
+#include "constants/general.hpp"
+
+#include <algorithm>
+#include <esp_log.h>
+
+namespace axomotor::events {
+
+using namespace axomotor::constants::general;
+
+constexpr static const char *TAG = "outbound_scheduler";
+
+// un envío equivale a un minuto de recarga a razón de un envío por minuto
+constexpr static const uint32_t TOKEN_COST = 60 * configTICK_RATE_HZ;
+
+// en el orden de traffic_class_t
+static const traffic_class_config_t CLASS_CONFIG[] = {
+    // weight, rate_per_minute, burst, capacity, drop_oldest
+    { 0, 0, 0, DEVICE_EVENTS_QUEUE_LENGTH, true },
+    { 4, 20, 5, DEVICE_EVENTS_QUEUE_LENGTH, false },
+    { 2, 12, 2, PING_EVENTS_QUEUE_LENGTH, true },
+    { 1, 60, POSITION_BATCH_SIZE, POSITION_EVENTS_QUEUE_LENGTH, true },
+    { 1, 2, 1, 0, false },
+};
+
+static_assert(sizeof(CLASS_CONFIG) / sizeof(CLASS_CONFIG[0]) == (size_t)traffic_class_t::MAX);
+
+OutboundScheduler::OutboundScheduler()
+{
+    const TickType_t now = xTaskGetTickCount();
+
+    for (size_t i = 0; i < m_classes.size(); i++) {
+        class_state_t &state = m_classes[i];
+        state.config = CLASS_CONFIG[i];
+        if (state.config.capacity > 0) {
+            state.items = std::make_unique<queued_event_t[]>(state.config.capacity);
+        }
+        state.head = 0;
+        state.count = 0;
+        // cada clase comienza con su ráfaga completa
+        state.tokens = state.config.burst * TOKEN_COST;
+        state.refilled_at = now;
+        state.current_weight = 0;
+        state.stats = {};
+    }
+}
+
+bool OutboundScheduler::enqueue(const queued_event_t &event)
+{
+    traffic_class_t tclass = classify(event);
+    class_state_t &state = m_classes[(size_t)tclass];
+    size_t capacity = state.config.capacity;
+
+    if (state.count == capacity) {
+        state.stats.dropped++;
+
+        if (!state.config.drop_oldest || capacity == 0) {
+            ESP_LOGW(TAG, "Class %d is full, event dropped", (int)tclass);
+            return false;
+        }
+
+        // los datos más recientes valen más que los que no alcanzaron a salir
+        state.head = (state.head + 1) % capacity;
+        state.count--;
+    }
+
+    state.items[(state.head + state.count) % capacity] = event;
+    state.count++;
+    return true;
+}
+
+bool OutboundScheduler::dequeue(queued_event_t &event)
+{
+    const TickType_t now = xTaskGetTickCount();
+
+    // los eventos de seguridad no compiten con las demás clases
+    class_state_t &safety = m_classes[(size_t)traffic_class_t::SAFETY];
+    if (is_ready(safety, now)) {
+        pop(safety, event);
+        return true;
+    }
+
+    // round robin ponderado suave: cada clase lista acumula su peso y sale
+    // la que tenga más; ésta devuelve la suma de los pesos, lo que intercala
+    // las clases en lugar de enviar cada una en bloque
+    class_state_t *selected = nullptr;
+    int32_t total_weight = 0;
+
+    for (size_t i = (size_t)traffic_class_t::DEVICE; i < m_classes.size(); i++) {
+        class_state_t &state = m_classes[i];
+        if (!is_ready(state, now)) continue;
+
+        state.current_weight += state.config.weight;
+        total_weight += state.config.weight;
+
+        if (selected == nullptr || state.current_weight > selected->current_weight) {
+            selected = &state;
+        }
+    }
+
+    if (selected == nullptr) return false;
+
+    selected->current_weight -= total_weight;
+    pop(*selected, event);
+    return true;
+}
+
+TickType_t OutboundScheduler::get_ticks_to_ready()
+{
+    const TickType_t now = xTaskGetTickCount();
+    TickType_t ticks_to_ready = portMAX_DELAY;
+
+    for (class_state_t &state : m_classes) {
+        if (state.count == 0) continue;
+        if (is_ready(state, now)) return 0;
+
+        uint32_t missing = TOKEN_COST - state.tokens;
+        uint32_t rate = state.config.rate_per_minute;
+        ticks_to_ready = std::min<TickType_t>(ticks_to_ready, (missing + rate - 1) / rate);
+    }
+
+    return ticks_to_ready;
+}
+
+size_t OutboundScheduler::count_pending() const
+{
+    size_t count = 0;
+    for (const class_state_t &state : m_classes) {
+        count += state.count;
+    }
+    return count;
+}
+
+traffic_class_stats_t OutboundScheduler::get_stats(traffic_class_t tclass) const
+{
+    return m_classes[(size_t)tclass].stats;
+}
+
+traffic_class_t OutboundScheduler::classify(const queued_event_t &event)
+{
+    switch (event.type)
+    {
+        case event_type_t::DEVICE:
+            return is_safety_event(event.device.code) ?
+                traffic_class_t::SAFETY : traffic_class_t::DEVICE;
+        case event_type_t::SERVER_PING:
+            return traffic_class_t::PING;
+        case event_type_t::POSITION:
+            return traffic_class_t::POSITION;
+        default:
+            return traffic_class_t::BULK;
+    }
+}
+
+bool OutboundScheduler::is_safety_event(event_code_t code)
+{
+    return code == event_code_t::PANIC_BUTTON_PRESSED ||
+           code == event_code_t::IMPACT_DETECTED;
+}
+
+bool OutboundScheduler::is_ready(class_state_t &state, TickType_t now)
+{
+    if (state.count == 0) return false;
+    if (state.config.rate_per_minute == 0) return true;
+
+    // recarga lo correspondiente al tiempo transcurrido sin pasar de la ráfaga
+    const uint32_t max_tokens = state.config.burst * TOKEN_COST;
+    uint64_t tokens = state.tokens + (uint64_t)(now - state.refilled_at) * state.config.rate_per_minute;
+
+    state.tokens = std::min<uint64_t>(tokens, max_tokens);
+    state.refilled_at = now;
+
+    return state.tokens >= TOKEN_COST;
+}
+
+void OutboundScheduler::pop(class_state_t &state, queued_event_t &event)
+{
+    event = state.items[state.head];
+    state.head = (state.head + 1) % state.config.capacity;
+    state.count--;
+    if (state.config.rate_per_minute > 0) {
+        state.tokens -= TOKEN_COST;
+    }
+    state.stats.sent++;
+}
+
+} // namespace axomotor::events
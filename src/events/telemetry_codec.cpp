@@ -0,0 +1,191 @@
+#include "events/telemetry_codec.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace axomotor::events::telemetry {
+
+constexpr static const float COORDINATE_SCALE = 1e6f;
+constexpr static const float SPEED_SCALE = 100.0f;
+constexpr static const float COURSE_SCALE = 100.0f;
+
+/* Escritura y lectura en little endian */
+
+static uint8_t *put_u8(uint8_t *p, uint8_t value)
+{
+    *p++ = value;
+    return p;
+}
+
+static uint8_t *put_u16(uint8_t *p, uint16_t value)
+{
+    *p++ = value;
+    *p++ = value >> 8;
+    return p;
+}
+
+static uint8_t *put_u32(uint8_t *p, uint32_t value)
+{
+    for (int i = 0; i < 4; i++) {
+        *p++ = value >> (8 * i);
+    }
+    return p;
+}
+
+static const uint8_t *get_u16(const uint8_t *p, uint16_t &value)
+{
+    value = p[0] | (p[1] << 8);
+    return p + 2;
+}
+
+static const uint8_t *get_u32(const uint8_t *p, uint32_t &value)
+{
+    value = 0;
+    for (int i = 0; i < 4; i++) {
+        value |= (uint32_t)p[i] << (8 * i);
+    }
+    return p + 4;
+}
+
+static uint8_t make_header(message_type_t type)
+{
+    return (TELEMETRY_FORMAT_VERSION << 4) | (uint8_t)type;
+}
+
+// convierte a entero sin signo con la escala indicada sin desbordarse
+static uint16_t to_fixed_u16(float value, float scale)
+{
+    if (!(value > 0.0f)) return 0;
+    return (uint16_t)std::min(std::lround(value * scale), (long)UINT16_MAX);
+}
+
+/* Codificación */
+
+esp_err_t encode_positions(
+    std::span<const position_event_t> positions,
+    std::span<uint8_t> buffer,
+    size_t &length)
+{
+    if (positions.size() > MAX_POSITIONS_PER_MESSAGE) return ESP_ERR_INVALID_ARG;
+
+    size_t size = get_positions_message_size(positions.size());
+    if (buffer.size() < size) return ESP_ERR_INVALID_SIZE;
+
+    uint8_t *p = buffer.data();
+    p = put_u8(p, make_header(message_type_t::POSITIONS));
+    p = put_u8(p, positions.size());
+
+    for (const position_event_t &event : positions) {
+        // el rumbo se normaliza a [0, 360)
+        float course = std::fmod(event.course_over_ground, 360.0f);
+        if (course < 0.0f) course += 360.0f;
+
+        p = put_u32(p, (uint32_t)event.timestamp);
+        p = put_u32(p, (uint32_t)(int32_t)std::lround(event.latitude * COORDINATE_SCALE));
+        p = put_u32(p, (uint32_t)(int32_t)std::lround(event.longitude * COORDINATE_SCALE));
+        p = put_u16(p, to_fixed_u16(event.speed_over_ground, SPEED_SCALE));
+        p = put_u16(p, to_fixed_u16(course, COURSE_SCALE));
+    }
+
+    length = size;
+    return ESP_OK;
+}
+
+esp_err_t encode_device_event(const device_event_t &event, std::span<uint8_t> buffer, size_t &length)
+{
+    if (buffer.size() < DEVICE_EVENT_MESSAGE_SIZE) return ESP_ERR_INVALID_SIZE;
+
+    uint8_t *p = buffer.data();
+    p = put_u8(p, make_header(message_type_t::DEVICE_EVENT));
+    p = put_u8(p, (uint8_t)event.code);
+    p = put_u32(p, (uint32_t)event.timestamp);
+
+    length = DEVICE_EVENT_MESSAGE_SIZE;
+    return ESP_OK;
+}
+
+esp_err_t encode_pong(const ping_event_t &event, std::span<uint8_t> buffer, size_t &length)
+{
+    if (buffer.size() < PONG_MESSAGE_SIZE) return ESP_ERR_INVALID_SIZE;
+
+    uint8_t *p = buffer.data();
+    p = put_u8(p, make_header(message_type_t::PONG));
+    p = put_u32(p, (uint32_t)event.timestamp);
+
+    length = PONG_MESSAGE_SIZE;
+    return ESP_OK;
+}
+
+/* Decodificación */
+
+message_type_t get_message_type(std::span<const uint8_t> message)
+{
+    if (message.size() < HEADER_SIZE) return message_type_t::NONE;
+    if ((message[0] >> 4) != TELEMETRY_FORMAT_VERSION) return message_type_t::NONE;
+
+    return (message_type_t)(message[0] & 0x0F);
+}
+
+esp_err_t decode_positions(
+    std::span<const uint8_t> message,
+    std::span<position_event_t> positions,
+    size_t &count)
+{
+    if (get_message_type(message) != message_type_t::POSITIONS) return ESP_ERR_INVALID_ARG;
+    if (message.size() < HEADER_SIZE + 1) return ESP_ERR_INVALID_SIZE;
+
+    size_t item_count = message[HEADER_SIZE];
+    if (message.size() != get_positions_message_size(item_count)) return ESP_ERR_INVALID_SIZE;
+    if (positions.size() < item_count) return ESP_ERR_INVALID_SIZE;
+
+    const uint8_t *p = message.data() + HEADER_SIZE + 1;
+
+    for (size_t i = 0; i < item_count; i++) {
+        position_event_t &event = positions[i];
+        uint32_t timestamp, latitude, longitude;
+        uint16_t speed, course;
+
+        p = get_u32(p, timestamp);
+        p = get_u32(p, latitude);
+        p = get_u32(p, longitude);
+        p = get_u16(p, speed);
+        p = get_u16(p, course);
+
+        event.timestamp = timestamp;
+        event.latitude = (int32_t)latitude / COORDINATE_SCALE;
+        event.longitude = (int32_t)longitude / COORDINATE_SCALE;
+        event.speed_over_ground = speed / SPEED_SCALE;
+        event.course_over_ground = course / COURSE_SCALE;
+    }
+
+    count = item_count;
+    return ESP_OK;
+}
+
+esp_err_t decode_device_event(std::span<const uint8_t> message, device_event_t &event)
+{
+    if (get_message_type(message) != message_type_t::DEVICE_EVENT) return ESP_ERR_INVALID_ARG;
+    if (message.size() != DEVICE_EVENT_MESSAGE_SIZE) return ESP_ERR_INVALID_SIZE;
+
+    uint32_t timestamp;
+    get_u32(message.data() + HEADER_SIZE + 1, timestamp);
+
+    event.code = (event_code_t)message[HEADER_SIZE];
+    event.timestamp = timestamp;
+    return ESP_OK;
+}
+
+esp_err_t decode_pong(std::span<const uint8_t> message, ping_event_t &event)
+{
+    if (get_message_type(message) != message_type_t::PONG) return ESP_ERR_INVALID_ARG;
+    if (message.size() != PONG_MESSAGE_SIZE) return ESP_ERR_INVALID_SIZE;
+
+    uint32_t timestamp;
+    get_u32(message.data() + HEADER_SIZE, timestamp);
+
+    event.ping_timestamp = 0;
+    event.timestamp = timestamp;
+    return ESP_OK;
+}
+
+} // namespace axomotor::events::telemetry
@@ -3,8 +3,11 @@
 #include "constants/hw.hpp"
 #include "constants/secrets.hpp"
 #include "constants/general.hpp"
+#include "events/telemetry_codec.hpp"
 #include "sim7000_helpers.hpp"
 
+#include <algorithm>
+#include <cstring>
 #include <esp_log.h>
 
 namespace axomotor::services {
@@ -18,10 +21,17 @@ constexpr static const char *TAG = "mobile_service";
 
 MobileService::MobileService() : 
     ServiceBase{TAG, 8 * 1024, 10},
+    m_next_housekeeping{0},
+    m_position_batch{},
+    m_position_batch_started_at{0},
     m_gps_enabled{false},
-    m_gps_signal_lost{false}
+    m_gps_signal_lost{false},
+    m_status_refresh_pending{false},
+    m_mqtt_resubscribe{false},
+    m_modem_recovered{false}
 {
     m_modem = std::make_shared<SIM7000_Modem>(UART_PORT, PIN_U1_RX, PIN_U1_TX, PIN_PWR);
+    m_modem->set_rx_mode(uart_rx_mode_t::LINE_EVENTS);
     m_gnss = std::make_shared<SIM7000_GNSS>(m_modem);
     m_mqtt = std::make_shared<SIM7000_MQTT>(m_modem);
     
@@ -44,6 +54,9 @@ esp_err_t MobileService::setup()
     // inicia el modulo y habilita la comunicación
     err = m_modem->init();
     if (err == ESP_OK) {
+        // sube la velocidad de la UART antes de que otros servicios envíen
+        // comandos; si falla se continúa con la velocidad actual
+        m_modem->negotiate_baud_rate(UART_MAX_BAUD_RATE);
         err = m_modem->enable_comm();
     }
 
@@ -61,17 +74,15 @@ esp_err_t MobileService::setup()
     m_modem->enable_events();
     esp_event_handler_register(MODEM_EVENTS, ESP_EVENT_ANY_ID, on_event, this);
 
+    // a partir de aquí, si el modem deja de responder se recupera sin
+    // reiniciar el microcontrolador
+    m_modem->enable_supervisor();
+
     // habilita el modulo gps
     m_gnss->turn_on();
     
     // establece la configuración de MQTT
-    mqtt_config_t config;
-    config.client_id = MQTT_CLIENT_ID;
-    config.username = MQTT_USERNAME;
-    config.password = MQTT_PASSWORD;
-    config.broker = SERVER_HOSTNAME;
-    
-    err = m_mqtt->set_config(config);
+    err = configure_mqtt();
     if (err == ESP_OK) {
         int retry_num = 5;
 
@@ -99,109 +110,346 @@ void MobileService::loop()
     // verifica si hay un viaje activo y el gps no está activado
     if (trip_active && !m_gps_enabled) {
         // habilita el reporte de posiciones
-        m_gnss->enable_nav_urc(POSITION_REPORT_INTERVAL);
+        m_executor.spawn(set_nav_urc(POSITION_REPORT_INTERVAL));
         m_gps_enabled = true;
     } 
     // de lo contrario verifica si no hay un viaje activo y el gps está activado
     else if (!trip_active && m_gps_enabled) {
-        m_gnss->disable_nav_urc();
+        // publica las últimas posiciones del viaje antes de ocupar otro
+        // lugar del ejecutor
+        flush_positions();
+        m_executor.spawn(set_nav_urc(0));
         m_gps_enabled = false;
     }
 
-    int8_t signal_quality;
-    std::string op_name;
-    network_reg_status_t reg_status;
-    bool is_mqtt_active;
-    esp_err_t err;
+    // si el ejecutor estaba lleno al terminar el viaje, las últimas
+    // posiciones se publican en cuanto haya lugar
+    if (!trip_active && m_position_batch.count > 0) {
+        flush_positions();
+    }
 
-    err = m_mqtt->get_state(is_mqtt_active);
-    if (err != ESP_OK || !is_mqtt_active) {
-        err = m_mqtt->connect();
-        m_mqtt->subscribe("device/1/ping");
+    // el mantenimiento se hace cada cierto tiempo y no con cada evento
+    // los comandos bloqueantes solo se envían si no hay corrutinas
+    // pendientes, ya que éstas ocupan lugares de la cola del modem que solo
+    // se liberan al reanudarlas en esta misma tarea
+    // mientras el supervisor recupera al modem los comandos no tendrían
+    // respuesta
+    TickType_t now = xTaskGetTickCount();
+    if ((int32_t)(now - m_next_housekeeping) >= 0 &&
+        m_executor.get_task_count() == 0 &&
+        !m_modem->is_recovering()) {
+        run_housekeeping();
+        now = xTaskGetTickCount();
+        m_next_housekeeping = now + pdMS_TO_TICKS(MOBILE_HOUSEKEEPING_INTERVAL_MS);
+    }
+
+    // mientras haya corrutinas pendientes solo espera un momento para
+    // reanudarlas pronto; si no, hasta el siguiente mantenimiento o hasta que
+    // una clase del planificador pueda enviar de nuevo
+    TickType_t ticks_to_wait = pdMS_TO_TICKS(MOBILE_EXECUTOR_POLL_MS);
+    if (m_executor.get_task_count() == 0) {
+        int32_t remaining = (int32_t)(m_next_housekeeping - now);
+        ticks_to_wait = std::min<TickType_t>(
+            remaining > 0 ? remaining : 0,
+            m_scheduler.get_ticks_to_ready()
+        );
+
+        // también despierta cuando el lote de posiciones cumple su edad
+        if (m_position_batch.count > 0) {
+            TickType_t age = now - m_position_batch_started_at;
+            TickType_t max_age = pdMS_TO_TICKS(POSITION_BATCH_MAX_AGE_MS);
+            ticks_to_wait = std::min(ticks_to_wait, age < max_age ? max_age - age : 0);
+        }
+    }
+
+    size_t count = AxoMotor::queue_set.drain(m_event_batch.data(), m_event_batch.size(), ticks_to_wait);
+
+    if (count > 1) {
+        ESP_LOGD(TAG, "Handling %u events", (unsigned)count);
+    }
+
+    // el orden de envío lo decide el planificador y no el de llegada
+    for (size_t i = 0; i < count; i++) {
+        m_scheduler.enqueue(m_event_batch[i]);
+    }
+
+    // solo se publica lo que cabe en el ejecutor; lo demás espera su turno
+    queued_event_t event;
+    while (m_executor.get_task_count() < threading::DEFAULT_EXECUTOR_QUEUE_SIZE &&
+           m_scheduler.dequeue(event)) {
+        dispatch_event(event);
+    }
+
+    // publica el lote aunque no esté lleno si la posición más antigua ya
+    // esperó demasiado
+    if (m_position_batch.count > 0 &&
+        xTaskGetTickCount() - m_position_batch_started_at >= pdMS_TO_TICKS(POSITION_BATCH_MAX_AGE_MS)) {
+        flush_positions();
+    }
+
+    // avanza las publicaciones y consultas pendientes
+    m_executor.run(0);
+}
+
+void MobileService::run_housekeeping()
+{
+    // se limpia antes de restablecer para no perder una recuperación que
+    // termine mientras tanto
+    if (m_modem_recovered.exchange(false)) {
+        restore_after_recovery();
     }
 
-    event_type_t type = AxoMotor::queue_set.wait_for_event(pdMS_TO_TICKS(5000));
+    check_mqtt_connection();
 
-    switch (type) 
+    // solo consulta al modem cuando vence el estado guardado
+    network_status_t net_status;
+    if (!m_status_refresh_pending && !m_modem->get_status_cache().get(net_status)) {
+        m_status_refresh_pending = m_executor.spawn(refresh_network_status()) == ESP_OK;
+    }
+}
+
+void MobileService::dispatch_event(const queued_event_t &event)
+{
+    switch (event.type) 
     {
         case event_type_t::POSITION: 
-        {
-            position_event_t event{};
-            AxoMotor::queue_set.position.receive(event, 0);
-            err = publish_position(event);
+            add_position(event.position);
             break;
-        } 
         case event_type_t::DEVICE: 
-        {
-            device_event_t event{};
-            AxoMotor::queue_set.device.receive(event, 0);
-            err = publish_event(event);
+            m_executor.spawn(publish_event(event.device));
             break;
-        }
         case event_type_t::SERVER_PING:
-        {
-            ping_event_t event{};
-            AxoMotor::queue_set.ping.receive(event, 0);
-            err = publish_pong(event);
+            m_executor.spawn(publish_pong(event.ping));
             break;
-        }
         default:
             break;
     }
+}
+
+esp_err_t MobileService::configure_mqtt()
+{
+    mqtt_config_t config;
+    config.client_id = MQTT_CLIENT_ID;
+    config.username = MQTT_USERNAME;
+    config.password = MQTT_PASSWORD;
+    config.broker = SERVER_HOSTNAME;
     
-    m_modem->get_signal_strength(signal_quality);
-    m_modem->get_current_operator(op_name);
-    m_modem->get_network_reg_status(reg_status);
+    return m_mqtt->set_config(config);
+}
+
+void MobileService::check_mqtt_connection()
+{
+    bool is_mqtt_active;
+    esp_err_t err;
+
+    err = m_mqtt->get_state(is_mqtt_active);
+    if (err == ESP_OK && is_mqtt_active) {
+        if (m_mqtt_resubscribe) {
+            m_mqtt_resubscribe = m_mqtt->subscribe("device/1/ping") != ESP_OK;
+        }
+        return;
+    }
+
+    // la conexión con el broker puede tardar minutos, por lo que se espera
+    // en una corrutina para seguir atendiendo los eventos (las publicaciones
+    // urgentes la interrumpen)
+    err = m_modem->activate_network();
+    if (err == ESP_OK) {
+        m_executor.spawn(connect_mqtt());
+    }
 }
 
-esp_err_t MobileService::publish_position(position_event_t &event)
+void MobileService::restore_after_recovery()
+{
+    ESP_LOGI(TAG, "Restoring services after modem recovery...");
+
+    // el reinicio del modem apaga el GNSS y borra la configuración de MQTT;
+    // la conexión y la suscripción se restablecen en check_mqtt_connection()
+    m_gnss->turn_on();
+    // el reporte de posiciones se vuelve a habilitar en el siguiente ciclo
+    m_gps_enabled = false;
+
+    if (configure_mqtt() == ESP_OK) {
+        m_mqtt_resubscribe = true;
+    } else {
+        // se reintenta en el siguiente ciclo
+        m_modem_recovered = true;
+    }
+}
+
+void MobileService::add_position(const position_event_t &event)
 {
     // verifica si no hay un viaje activo
-    if (!AxoMotor::event_group.is_trip_active()) return ESP_ERR_INVALID_STATE;
-
-    char topic[42];
-    char payload[180];
-    int length;
-    const char format[] = "{\"source\":\"vehicleDevice\",\"latitude\":%.6f,\"longitude\":%.6f,\"speed\":%.2f,\"timestamp\":%lld}";
-
-    // establece el tópico
-    snprintf(topic, sizeof(topic), "trip/%s/position", AxoMotor::get_current_trip_id());
-    // escribe el mensaje en formato JSON
-    length = snprintf(payload, sizeof(payload), format,
-        event.latitude, event.longitude, event.speed_over_ground, event.timestamp
+    if (!AxoMotor::event_group.is_trip_active()) return;
+
+    position_batch_t &batch = m_position_batch;
+    const char *trip_id = AxoMotor::get_current_trip_id();
+
+    // las posiciones de otro viaje no se publican con el identificador
+    // anterior
+    if (batch.count > 0 && strcmp(batch.trip_id, trip_id) != 0) {
+        flush_positions();
+        if (batch.count > 0) {
+            ESP_LOGW(TAG, "Dropping %u positions of trip %s", (unsigned)batch.count, batch.trip_id);
+            batch.count = 0;
+        }
+    }
+
+    if (batch.count == 0) {
+        m_position_batch_started_at = xTaskGetTickCount();
+        // el lote pertenece al viaje en el que se tomó la primera posición,
+        // aunque se publique después de que éste termine
+        strlcpy(batch.trip_id, trip_id, sizeof(batch.trip_id));
+    }
+
+    if (batch.count == batch.items.size()) {
+        // el ejecutor estaba lleno al intentar publicar el lote; se descarta
+        // la posición más antigua
+        std::copy(batch.items.begin() + 1, batch.items.end(), batch.items.begin());
+        batch.count--;
+    }
+
+    batch.items[batch.count++] = event;
+
+    if (batch.count == batch.items.size()) {
+        flush_positions();
+    }
+}
+
+void MobileService::flush_positions()
+{
+    if (m_position_batch.count == 0) return;
+
+    // si no hay lugar en el ejecutor se reintenta en el siguiente ciclo
+    if (m_executor.spawn(publish_positions(m_position_batch)) == ESP_OK) {
+        m_position_batch.count = 0;
+    }
+}
+
+threading::AsyncTask MobileService::connect_mqtt()
+{
+    // la suscripción se hace desde el loop, que sí puede bloquearse
+    if (co_await m_mqtt->connect_async() == ESP_OK) {
+        m_mqtt_resubscribe = true;
+    }
+}
+
+threading::AsyncTask MobileService::set_nav_urc(uint8_t interval)
+{
+    co_await m_gnss->set_nav_urc_async(interval);
+}
+
+threading::AsyncTask MobileService::refresh_network_status()
+{
+    network_status_t status;
+    co_await m_modem->get_network_status_async(status, true);
+    m_status_refresh_pending = false;
+}
+
+threading::AsyncTask MobileService::publish_positions(position_batch_t batch)
+{
+    char topic[48];
+    char payload[POSITION_BATCH_MAX_PAYLOAD];
+    size_t length;
+    const char format[] = "%s{\"latitude\":%.6f,\"longitude\":%.6f,\"speed\":%.2f,\"timestamp\":%lld}";
+
+    // el formato del lote se identifica con la versión del tópico
+    snprintf(
+        topic, 
+        sizeof(topic), 
+        "trip/%s/positions/v%d", 
+        batch.trip_id, 
+        TELEMETRY_TOPIC_VERSION
     );
+
+    if (TELEMETRY_BINARY_ENCODING) {
+        esp_err_t err = telemetry::encode_positions(
+            std::span(batch.items).first(batch.count),
+            std::span((uint8_t *)payload, sizeof(payload)),
+            length
+        );
+        if (err != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to encode positions (%s)", esp_err_to_name(err));
+            co_return;
+        }
+
+        ESP_LOGI(TAG, "Publishing %u positions...", (unsigned)batch.count);
+
+        std::span<char> span(payload);
+        co_await m_mqtt->publish_async(topic, span.subspan(0, length), 1, 1);
+        co_return;
+    }
+
+    // escribe las posiciones como un arreglo JSON
+    length = snprintf(payload, sizeof(payload), "{\"source\":\"vehicleDevice\",\"positions\":[");
+    for (size_t i = 0; i < batch.count; i++) {
+        const position_event_t &event = batch.items[i];
+        int written = snprintf(
+            payload + length, 
+            sizeof(payload) - length, 
+            format,
+            i > 0 ? "," : "",
+            event.latitude, 
+            event.longitude, 
+            event.speed_over_ground, 
+            (long long)event.timestamp
+        );
+
+        // deja lugar para cerrar el arreglo
+        if (written < 0 || length + written + 2 >= sizeof(payload)) {
+            ESP_LOGW(TAG, "Position batch truncated to %u items", (unsigned)i);
+            break;
+        }
+        length += written;
+    }
+    length += snprintf(payload + length, sizeof(payload) - length, "]}");
     
-    ESP_LOGI(TAG, "Publishing current position...");
+    ESP_LOGI(TAG, "Publishing %u positions...", (unsigned)batch.count);
 
     // publica el mensaje
     std::span<char> span(payload);
-    return m_mqtt->publish(topic, span.subspan(0, length), 1, 1);
+    co_await m_mqtt->publish_async(topic, span.subspan(0, length), 1, 1);
 }
 
-esp_err_t MobileService::publish_pong(events::ping_event_t &event)
+threading::AsyncTask MobileService::publish_pong(events::ping_event_t event)
 {
-    char topic[24];
+    char topic[32];
     char payload[32];
-    int length;
+    size_t length = 0;
     const char format[] = "{\"timestamp\":%lld}";
 
-    // establece el tópico
-    snprintf(topic, sizeof(topic), "device/%d/ping/pong", DEVICE_ID);
-    // escribe el mensaje en formato JSON
-    length = snprintf(payload, sizeof(payload), format, event.timestamp);
+    if (TELEMETRY_BINARY_ENCODING) {
+        // el formato binario va en un tópico aparte para que el servidor
+        // distinga ambos formatos
+        snprintf(topic, sizeof(topic), "device/%d/ping/pong/v%d", DEVICE_ID, TELEMETRY_TOPIC_VERSION);
+        esp_err_t err = telemetry::encode_pong(
+            event,
+            std::span((uint8_t *)payload, sizeof(payload)),
+            length
+        );
+        if (err != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to encode pong (%s)", esp_err_to_name(err));
+            co_return;
+        }
+    } else {
+        // establece el tópico
+        snprintf(topic, sizeof(topic), "device/%d/ping/pong", DEVICE_ID);
+        // escribe el mensaje en formato JSON
+        length = snprintf(payload, sizeof(payload), format, (long long)event.timestamp);
+    }
     
     ESP_LOGI(TAG, "Publishing pong...");
 
     // publica el mensaje
     std::span<char> span(payload);
-    return m_mqtt->publish(topic, span.subspan(0, length));
+    co_await m_mqtt->publish_async(topic, span.subspan(0, length));
 }
 
-esp_err_t MobileService::publish_event(events::device_event_t &event)
+threading::AsyncTask MobileService::publish_event(events::device_event_t event)
 {
-    char topic[24];
+    char topic[32];
     char payload[62];
-    int length;
+    size_t length = 0;
     const char format[] = "{\"code\":\"%s\",\"timestamp\":%lld}";
     const char *event_code;
 
@@ -259,26 +507,43 @@ esp_err_t MobileService::publish_event(events::device_event_t &event)
             event_code = "sensorFailure";
             break;
         default:
-            return ESP_ERR_INVALID_ARG;
+            co_return;
     }
 
-    // escribe el topico
-    snprintf(topic, sizeof(topic), "device/%d/event", DEVICE_ID);
-
-    // escribe el mensaje en formato JSON
-    length = snprintf(
-        payload, 
-        sizeof(payload), 
-        format, 
-        event_code, 
-        event.timestamp
-    );
+    if (TELEMETRY_BINARY_ENCODING) {
+        snprintf(topic, sizeof(topic), "device/%d/event/v%d", DEVICE_ID, TELEMETRY_TOPIC_VERSION);
+        esp_err_t err = telemetry::encode_device_event(
+            event,
+            std::span((uint8_t *)payload, sizeof(payload)),
+            length
+        );
+        if (err != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to encode event (%s)", esp_err_to_name(err));
+            co_return;
+        }
+    } else {
+        // escribe el topico
+        snprintf(topic, sizeof(topic), "device/%d/event", DEVICE_ID);
+
+        // escribe el mensaje en formato JSON
+        length = snprintf(
+            payload, 
+            sizeof(payload), 
+            format, 
+            event_code, 
+            (long long)event.timestamp
+        );
+    }
     
     ESP_LOGI(TAG, "Publishing event '%s'...", event_code);
 
+    // los eventos de seguridad no esperan a los comandos lentos en curso
+    cmd_priority_t priority = OutboundScheduler::is_safety_event(event.code) ?
+        cmd_priority_t::URGENT : cmd_priority_t::NORMAL;
+
     // publica el mensaje
     std::span<char> span(payload);
-    return m_mqtt->publish(topic, span.subspan(0, length), 2);
+    co_await m_mqtt->publish_async(topic, span.subspan(0, length), 2, false, priority);
 }
 
 void MobileService::on_event(void *args, esp_event_base_t base, int32_t id, void *data)
@@ -299,6 +564,18 @@ void MobileService::on_event(void *args, esp_event_base_t base, int32_t id, void
         event.ping_timestamp = 0;
         event.timestamp = xTaskGetTickCount();
         AxoMotor::queue_set.ping.overwrite(event);
+    } else if (id == MODEM_EVENT_RECOVERED) {
+        auto stats = reinterpret_cast<recovery_stats_t *>(data);
+
+        ESP_LOGW(
+            TAG,
+            "Modem recovered in %lu ms (MTTR: %lu ms, power cycles: %lu)",
+            (unsigned long)stats->last_recovery_ms,
+            (unsigned long)stats->mean_recovery_ms,
+            (unsigned long)stats->power_cycle_count
+        );
+
+        instance->m_modem_recovered = true;
     } else if (id == MODEM_EVENT_GNSS_NAVIGATION_REPORT) {
         auto info = reinterpret_cast<gnss_nav_info_t *>(data);
         
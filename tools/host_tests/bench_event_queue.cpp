@@ -0,0 +1,228 @@
+/*
+ * Compara las dos implementaciones de EventQueueSet: EventRing (sin
+ * bloqueos, un despertar por ráfaga) y las colas de FreeRTOS con un
+ * QueueSet. Se compila dos veces, con EVENT_QUEUE_USE_RING = 1 y 0.
+ *
+ * En host, las colas de FreeRTOS son la emulación de host_rtos.cpp (un mutex
+ * y una variable de condición), por lo que los tiempos solo sirven para
+ * comparar; la cantidad de despertares sí corresponde al dispositivo.
+ */
+
+#include "host_test.hpp"
+
+#include "events/event_queue.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace axomotor::events;
+using namespace std::chrono;
+
+#if EVENT_QUEUE_USE_RING
+static const char *const BACKEND = "EventRing";
+#else
+static const char *const BACKEND = "xQueue";
+#endif
+
+// cantidad de eventos que drain() puede entregar a la vez
+static const size_t DRAIN_SIZE = 32;
+
+static position_event_t make_position(int producer, int index)
+{
+    position_event_t event{};
+    event.timestamp = index;
+    event.latitude = producer;
+    return event;
+}
+
+/**
+ * @brief Envía y recibe en la misma tarea, sin esperas: costo de las
+ * operaciones de la cola.
+ */
+static void bench_uncontended()
+{
+    const size_t rounds = 20000;
+    const size_t batch = 10;
+    EventQueueSet set;
+    queued_event_t events[DRAIN_SIZE];
+    size_t received = 0;
+
+    auto start = steady_clock::now();
+
+    for (size_t round = 0; round < rounds; round++) {
+        for (size_t i = 0; i < batch; i++) {
+            set.position.send_to_back(make_position(0, i), 0);
+        }
+        received += set.drain(events, DRAIN_SIZE, 0);
+    }
+
+    double ns = duration<double, std::nano>(steady_clock::now() - start).count();
+    size_t total = rounds * batch;
+
+    CHECK(received == total);
+    printf("%-9s uncontended:   %6.1f ns/event (send + drain, batches of %zu)\n",
+        BACKEND, ns / total, batch);
+}
+
+// toma un evento del tipo indicado por wait_for_event()
+static bool receive_event(const EventQueueSet &set, event_type_t type, queued_event_t &event)
+{
+    event.type = type;
+
+    switch (type) {
+        case event_type_t::DEVICE:
+            return set.device.receive(event.device, 0);
+        case event_type_t::POSITION:
+            return set.position.receive(event.position, 0);
+        case event_type_t::SERVER_PING:
+            return set.ping.receive(event.ping, 0);
+        default:
+            return false;
+    }
+}
+
+/**
+ * @brief Un productor envía ráfagas de posiciones y eventos del dispositivo
+ * mientras el consumidor espera con drain(), como la tarea de MobileService,
+ * o evento por evento con wait_for_event().
+ */
+static void bench_bursts(bool use_drain)
+{
+    const int bursts = 200;
+    const int burst_size = 10;
+    EventQueueSet set;
+    std::atomic<int64_t> send_ns{0};
+    std::atomic<bool> is_done{false};
+
+    std::thread producer([&] {
+        for (int burst = 0; burst < bursts; burst++) {
+            auto start = steady_clock::now();
+
+            for (int i = 0; i < burst_size; i++) {
+                set.position.send_to_back(make_position(0, burst * burst_size + i));
+            }
+            set.device.send_to_back(event_code_t::HARSH_BRAKING);
+
+            send_ns += duration_cast<nanoseconds>(steady_clock::now() - start).count();
+            // deja que el consumidor termine antes de la siguiente ráfaga
+            std::this_thread::sleep_for(milliseconds(2));
+        }
+        is_done = true;
+    });
+
+    queued_event_t events[DRAIN_SIZE];
+    int positions = 0;
+    int devices = 0;
+    int last_index = -1;
+    bool is_ordered = true;
+    bool device_first = true;
+
+    while (positions < bursts * burst_size || devices < bursts) {
+        size_t count;
+
+        if (use_drain) {
+            count = set.drain(events, DRAIN_SIZE, pdMS_TO_TICKS(1000));
+        } else {
+            event_type_t type = set.wait_for_event(pdMS_TO_TICKS(1000));
+            count = receive_event(set, type, events[0]) ? 1 : 0;
+        }
+
+        if (count == 0) break;
+
+        for (size_t i = 0; i < count; i++) {
+            if (events[i].type == event_type_t::POSITION) {
+                if (events[i].position.timestamp != last_index + 1) is_ordered = false;
+                last_index = events[i].position.timestamp;
+                positions++;
+            } else if (events[i].type == event_type_t::DEVICE) {
+                // los eventos del dispositivo se entregan antes que las
+                // posiciones del mismo lote
+                if (i > 0 && events[i - 1].type != event_type_t::DEVICE) device_first = false;
+                devices++;
+            }
+        }
+    }
+
+    producer.join();
+
+    CHECK(positions == bursts * burst_size);
+    CHECK(devices == bursts);
+    CHECK(is_ordered);
+    CHECK(device_first);
+
+    int total = positions + devices;
+    uint32_t wakeups = set.get_wakeup_count();
+    printf("%-9s bursts (%s): %6.1f ns/event to send, %4u wakeups for %d bursts (%.2f per event)\n",
+        BACKEND,
+        use_drain ? "drain" : "wait ",
+        (double)send_ns / total,
+        (unsigned)wakeups,
+        bursts,
+        (double)wakeups / total);
+}
+
+/**
+ * @brief Varios productores envían sin pausa; la cola de posiciones se
+ * llena y los productores esperan espacio.
+ */
+static void bench_contended()
+{
+    const int producer_count = 4;
+    const int events_per_producer = 5000;
+    EventQueueSet set;
+    std::vector<std::thread> producers;
+
+    auto start = steady_clock::now();
+
+    for (int p = 0; p < producer_count; p++) {
+        producers.emplace_back([&set, p] {
+            for (int i = 0; i < events_per_producer; i++) {
+                set.position.send_to_back(make_position(p, i));
+            }
+        });
+    }
+
+    queued_event_t events[DRAIN_SIZE];
+    std::vector<int> last_index(producer_count, -1);
+    int received = 0;
+    bool is_ordered = true;
+
+    while (received < producer_count * events_per_producer) {
+        size_t count = set.drain(events, DRAIN_SIZE, pdMS_TO_TICKS(1000));
+        if (count == 0) break;
+
+        for (size_t i = 0; i < count; i++) {
+            const position_event_t &event = events[i].position;
+            int producer = (int)event.latitude;
+            if (event.timestamp != last_index[producer] + 1) is_ordered = false;
+            last_index[producer] = event.timestamp;
+        }
+        received += count;
+    }
+
+    for (std::thread &producer : producers) producer.join();
+    double ns = duration<double, std::nano>(steady_clock::now() - start).count();
+
+    // sin pérdidas y en orden por productor
+    CHECK(received == producer_count * events_per_producer);
+    CHECK(is_ordered);
+
+    printf("%-9s contended:     %6.1f ns/event, %u wakeups for %d events (%d producers)\n",
+        BACKEND,
+        ns / received,
+        (unsigned)set.get_wakeup_count(),
+        received,
+        producer_count);
+}
+
+int main()
+{
+    bench_uncontended();
+    bench_bursts(true);
+    bench_bursts(false);
+    bench_contended();
+
+    return host_test::summary(EVENT_QUEUE_USE_RING ? "event_queue (ring)" : "event_queue (xqueue)");
+}
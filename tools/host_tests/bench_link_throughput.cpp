@@ -0,0 +1,98 @@
+/*
+ * Mide la velocidad efectiva del enlace con el modem antes y después de
+ * negociar una velocidad mayor con AT+IPR, como
+ * SIM7000_Modem::measure_link_throughput(): se ejecuta varias veces AT+GSV y
+ * se divide el total de bytes enviados y recibidos (SIM7000_CmdStats) entre
+ * el tiempo transcurrido.
+ *
+ * El simulador limita su salida a la velocidad de la UART (--baud) y la
+ * cambia al responder AT+IPR, de modo que la medición refleja el tiempo de
+ * transmisión de las respuestas y no solo la latencia del modem.
+ */
+
+#include "host_test.hpp"
+
+#include "sim_modem.hpp"
+
+#include <sim7000_modem.hpp>
+
+#include <chrono>
+#include <cstdio>
+
+using namespace host_test;
+using namespace axomotor::lte_modem;
+
+static esp_err_t measure_link_throughput(PtyModem &modem, uint32_t &bytes_per_second)
+{
+    SIM7000_CmdStats &stats = modem.get_cmd_stats();
+    cmd_stats_t before{}, after{};
+    esp_err_t err = ESP_OK;
+
+    stats.get(at_cmd_t::GSV, before);
+    auto start = std::chrono::steady_clock::now();
+
+    for (size_t i = 0; i < LINK_BENCHMARK_ITERATIONS && err == ESP_OK; i++) {
+        command_t version(at_cmd_t::GSV);
+        err = run(modem, version);
+    }
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    stats.get(at_cmd_t::GSV, after);
+
+    if (err != ESP_OK) return err;
+
+    uint64_t bytes = (after.bytes_sent - before.bytes_sent) +
+        (after.bytes_received - before.bytes_received);
+    bytes_per_second = elapsed > 0 ? (uint32_t)(bytes * 1000000 / elapsed) : 0;
+
+    return ESP_OK;
+}
+
+int main(int argc, char **argv)
+{
+    const int high_speed = HIGH_SPEED_BAUD_RATES[0];
+    uint32_t before = 0, after = 0;
+    char baud_rate[16];
+    char params[16];
+
+    snprintf(baud_rate, sizeof(baud_rate), "%d", DEFAULT_BAUD_RATE);
+    snprintf(params, sizeof(params), "=%d", high_speed);
+
+    simulator_t sim;
+    bool started = start_simulator(argv[0], {
+        "--latency", "1",
+        "--jitter", "0",
+        "--baud", baud_rate,
+        "--seed", "1",
+    }, sim);
+    if (!started) return 1;
+
+    {
+        PtyModem modem(sim.fd);
+        command_t echo(at_cmd_t::E, "0");
+        command_t ipr(at_cmd_t::IPR, params);
+
+        CHECK(run(modem, echo) == ESP_OK);
+        CHECK(measure_link_throughput(modem, before) == ESP_OK);
+        CHECK(run(modem, ipr) == ESP_OK);
+        CHECK(measure_link_throughput(modem, after) == ESP_OK);
+    }
+
+    stop_simulator(sim);
+
+    printf(
+        "AT+GSV x%u: %d baud %lu B/s, %d baud %lu B/s (x%.2f)\n",
+        (unsigned)LINK_BENCHMARK_ITERATIONS,
+        DEFAULT_BAUD_RATE,
+        (unsigned long)before,
+        high_speed,
+        (unsigned long)after,
+        before > 0 ? (double)after / before : 0.0);
+
+    // 8 veces la velocidad de la UART; la latencia del modem y del pty
+    // limitan la ganancia, pero debe ser notable
+    CHECK(after > before * 2);
+
+    return host_test::summary("link_throughput");
+}
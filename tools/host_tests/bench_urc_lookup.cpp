@@ -0,0 +1,116 @@
+/*
+ * Compara la clasificación de URC por grupos (get_urc_def) y el índice de
+ * comandos (get_command_def) con la búsqueda lineal que se usaba antes, y
+ * verifica que ambas den el mismo resultado.
+ *
+ * Se incluye el archivo fuente para acceder a las tablas, que son internas.
+ */
+
+#include "host_test.hpp"
+
+#include "../../lib/lte_modem/src/sim7000_types.cpp"
+
+#include <vector>
+
+using namespace axomotor::lte_modem::internal;
+
+static const urc_def_t *get_urc_def_linear(std::string_view line)
+{
+    for (const urc_def_t &def : URC_TABLE) {
+        if (match_urc(def, line)) return &def;
+    }
+
+    return nullptr;
+}
+
+static const at_cmd_def_t *get_command_def_linear(at_cmd_t command)
+{
+    for (const at_cmd_def_t &def : AT_COMMANDS_TABLE) {
+        if (def.command == command) return &def;
+    }
+
+    return nullptr;
+}
+
+// líneas que recibe el parser: URC frecuentes, respuestas y resultados
+static const std::string_view LINES[] = {
+    "+UGNSINF: 1,1,20240101120000.000,19.432608,-99.133209,2240.0,0.00,0.0,1",
+    "+SMSUB: \"axomotor/ping\",\"1700000000\"",
+    "+CGREG: 1",
+    "+SMSTATE: 1",
+    "OK",
+    "ERROR",
+    "+CSQ: 20,99",
+    "+CME ERROR: 10",
+    "CONNECT",
+    "0, CONNECT OK",
+    "1, CLOSED",
+    "SEND OK",
+    "RDY",
+    "NORMAL POWER DOWN",
+    "+APP PDP: ACTIVE",
+    "SIMCOM_SIM7000G",
+    "> ",
+};
+
+static void test_equivalence()
+{
+    // cada entrada de la tabla se encuentra a sí misma
+    for (const urc_def_t &def : URC_TABLE) {
+        std::string line = def.identifier;
+        if (def.match == urc_match_t::AT_BEGINNING) line += ": 1";
+        if (def.match == urc_match_t::AT_END) line = "0, " + line;
+
+        CHECK(get_urc_def(line) == get_urc_def_linear(line));
+        CHECK(get_urc_def(line) != nullptr);
+    }
+
+    for (std::string_view line : LINES) {
+        CHECK(get_urc_def(line) == get_urc_def_linear(line));
+    }
+
+    // todas las posiciones del índice, incluidas las que no son comandos
+    for (int value = 0; value < (int)(CMD_GROUP_COUNT * 100); value++) {
+        at_cmd_t command = (at_cmd_t)value;
+        CHECK(get_command_def(command) == get_command_def_linear(command));
+    }
+    CHECK(get_command_def((at_cmd_t)-1) == nullptr);
+}
+
+static void benchmark()
+{
+    const size_t iterations = 2000000;
+    const size_t line_count = std::size(LINES);
+    const size_t cmd_count = std::size(AT_COMMANDS_TABLE);
+
+    double urc_index_ns = host_test::measure_ns(iterations, [](size_t i) {
+        host_test::keep(get_urc_def(LINES[i % line_count]));
+    });
+    double urc_linear_ns = host_test::measure_ns(iterations, [](size_t i) {
+        host_test::keep(get_urc_def_linear(LINES[i % line_count]));
+    });
+
+    // los comandos de la tabla en su orden, para que la búsqueda lineal
+    // recorra en promedio la mitad
+    double cmd_index_ns = host_test::measure_ns(iterations, [](size_t i) {
+        host_test::keep(get_command_def(AT_COMMANDS_TABLE[i % cmd_count].command));
+    });
+    double cmd_linear_ns = host_test::measure_ns(iterations, [](size_t i) {
+        host_test::keep(get_command_def_linear(AT_COMMANDS_TABLE[i % cmd_count].command));
+    });
+
+    printf(
+        "get_urc_def:     index %5.1f ns, linear %5.1f ns (%zu entries, %zu sample lines)\n",
+        urc_index_ns, urc_linear_ns, URC_TABLE_SIZE, line_count);
+    printf(
+        "get_command_def: index %5.1f ns, linear %5.1f ns (%zu commands)\n",
+        cmd_index_ns, cmd_linear_ns, cmd_count);
+}
+
+int main()
+{
+    test_equivalence();
+    benchmark();
+
+    return host_test::summary("urc_lookup");
+}
@@ -0,0 +1,197 @@
+#pragma once
+
+/*
+ * SIM7000_Modem de prueba para compilar SIM7000_Supervisor en host: en
+ * lugar de la UART y el pin PWRKEY usa un PtyModem conectado a
+ * tools/sim7000_sim. Se incluye en lugar del encabezado real anteponiendo
+ * fakes/ a las rutas de búsqueda.
+ *
+ * El simulador inicia con la probabilidad de no responder indicada (1 simula
+ * un modem bloqueado); el ciclo de encendido lo reinicia con otra, de modo
+ * que la prueba elige en qué paso se recupera el modem. Cada paso de la
+ * recuperación queda registrado con los instantes en que inició y terminó.
+ */
+
+#include "sim_modem.hpp"
+
+#include <sim7000_supervisor.hpp>
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace axomotor::lte_modem
+{
+    enum {
+        MODEM_EVENT_HANG_DETECTED,
+        MODEM_EVENT_RECOVERED,
+    };
+
+    // tiempo de espera de los comandos de la recuperación; el modem real
+    // espera hasta 10 s la respuesta de AT+CFUN=1,1
+    static const TickType_t FAKE_STEP_TIMEOUT_TICKS = pdMS_TO_TICKS(300);
+
+    class SIM7000_Modem
+    {
+    public:
+        struct step_t
+        {
+            recovery_level_t level;
+            std::chrono::steady_clock::time_point started_at;
+            std::chrono::steady_clock::time_point finished_at;
+        };
+
+        SIM7000_Modem(const char *argv0, const char *drop_rate) :
+            m_argv0{argv0},
+            m_power_on_drop_rate{"0"},
+            m_restore_result{ESP_OK}
+        {
+            start(drop_rate);
+        }
+
+        ~SIM7000_Modem()
+        {
+            stop();
+        }
+
+        /**
+         * @brief Probabilidad de no responder después del siguiente ciclo de
+         * encendido.
+         */
+        void set_power_on_drop_rate(const char *drop_rate) { m_power_on_drop_rate = drop_rate; }
+        void set_restore_result(esp_err_t result) { m_restore_result = result; }
+
+        /**
+         * @brief Envía un comando con el tiempo de espera de la recuperación,
+         * como lo haría otro servicio con el modem bloqueado.
+         */
+        esp_err_t execute(internal::at_cmd_t command, const char *params = "")
+        {
+            host_test::command_t cmd(command, params);
+            return host_test::run(*m_modem, cmd, FAKE_STEP_TIMEOUT_TICKS);
+        }
+
+        uint32_t get_consecutive_timeouts() const
+        {
+            return m_modem != nullptr ? m_modem->get_consecutive_timeouts() : 0;
+        }
+
+        void reset_consecutive_timeouts()
+        {
+            if (m_modem != nullptr) m_modem->reset_consecutive_timeouts();
+        }
+
+        std::vector<step_t> get_steps()
+        {
+            std::lock_guard lock(m_mutex);
+            return m_steps;
+        }
+
+        std::vector<int32_t> get_events()
+        {
+            std::lock_guard lock(m_mutex);
+            return m_events;
+        }
+
+        recovery_stats_t get_posted_stats()
+        {
+            std::lock_guard lock(m_mutex);
+            return m_posted_stats;
+        }
+
+        /* Recuperación (desde el supervisor) */
+
+        esp_err_t probe_link()
+        {
+            return run_step(recovery_level_t::PROBE, [this] {
+                return execute(internal::at_cmd_t::AT);
+            });
+        }
+
+        esp_err_t reset_modem()
+        {
+            return run_step(recovery_level_t::SOFT_RESET, [this] {
+                return execute(internal::at_cmd_t::CFUN, "=1,1");
+            });
+        }
+
+        esp_err_t power_cycle()
+        {
+            return run_step(recovery_level_t::POWER_CYCLE, [this] {
+                stop();
+                if (!start(m_power_on_drop_rate.c_str())) return ESP_FAIL;
+                return execute(internal::at_cmd_t::AT);
+            });
+        }
+
+        esp_err_t restore_state() { return m_restore_result; }
+
+        void post_event(int32_t id, TickType_t ticks_to_wait = portMAX_DELAY)
+        {
+            std::lock_guard lock(m_mutex);
+            m_events.push_back(id);
+        }
+
+        void post_event(
+            int32_t id,
+            void *data,
+            size_t size,
+            TickType_t ticks_to_wait = portMAX_DELAY)
+        {
+            std::lock_guard lock(m_mutex);
+            m_events.push_back(id);
+            if (id == MODEM_EVENT_RECOVERED && size == sizeof(m_posted_stats)) {
+                m_posted_stats = *(const recovery_stats_t *)data;
+            }
+        }
+
+    private:
+        std::string m_argv0;
+        std::string m_power_on_drop_rate;
+        esp_err_t m_restore_result;
+        host_test::simulator_t m_sim;
+        std::unique_ptr<host_test::PtyModem> m_modem;
+        std::mutex m_mutex;
+        std::vector<step_t> m_steps;
+        std::vector<int32_t> m_events;
+        recovery_stats_t m_posted_stats{};
+
+        bool start(const char *drop_rate)
+        {
+            bool started = host_test::start_simulator(m_argv0.c_str(), {
+                "--latency", "5",
+                "--jitter", "0",
+                "--drop-rate", drop_rate,
+                "--seed", "1",
+            }, m_sim);
+
+            if (!started) return false;
+
+            m_modem = std::make_unique<host_test::PtyModem>(m_sim.fd);
+            return true;
+        }
+
+        void stop()
+        {
+            if (m_modem == nullptr) return;
+
+            m_modem.reset();
+            host_test::stop_simulator(m_sim);
+        }
+
+        template <typename Fn>
+        esp_err_t run_step(recovery_level_t level, Fn &&fn)
+        {
+            step_t step{ level, std::chrono::steady_clock::now(), {} };
+            esp_err_t err = fn();
+            step.finished_at = std::chrono::steady_clock::now();
+
+            std::lock_guard lock(m_mutex);
+            m_steps.push_back(step);
+            return err;
+        }
+    };
+
+} // namespace axomotor::lte_modem
@@ -0,0 +1,455 @@
+/*
+ * Emulación de FreeRTOS y ESP-IDF sobre hilos de Linux para las pruebas en
+ * host. Cada hilo es una tarea y un tick equivale a un milisegundo.
+ *
+ * Todos los objetos comparten un mutex y una variable de condición: es lento
+ * comparado con el kernel, pero suficiente para verificar la lógica y para
+ * comparar implementaciones entre sí en el mismo host.
+ */
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/event_groups.h>
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+#include <esp_err.h>
+#include <esp_pthread.h>
+#include <esp_timer.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+using clock_type = std::chrono::steady_clock;
+
+static std::mutex g_mutex;
+static std::condition_variable g_cond;
+static const clock_type::time_point g_started_at = clock_type::now();
+static std::atomic<TickType_t> g_tick_offset{0};
+
+struct task_t
+{
+    uint32_t notify_value[configTASK_NOTIFICATION_ARRAY_ENTRIES];
+};
+
+struct semaphore_t
+{
+    UBaseType_t count;
+    UBaseType_t max_count;
+};
+
+struct event_group_t
+{
+    EventBits_t bits;
+};
+
+// búfer circular reservado al crearse, como en FreeRTOS, para que enviar y
+// recibir no reserven memoria (test_cmd_pool_heap cuenta las reservas)
+struct queue_t
+{
+    std::unique_ptr<char[]> storage;
+    size_t length;
+    size_t item_size;
+    size_t head;
+    size_t count;
+    // conjunto al que pertenece la cola (xQueueAddToSet)
+    queue_t *set;
+
+    char *at(size_t index) { return &storage[((head + index) % length) * item_size]; }
+
+    void push(const void *item, bool to_front)
+    {
+        if (to_front) {
+            head = (head + length - 1) % length;
+            memcpy(at(0), item, item_size);
+        } else {
+            memcpy(at(count), item, item_size);
+        }
+        count++;
+    }
+};
+
+static thread_local task_t t_task = {};
+
+// espera con el mutex tomado hasta que se cumple la condición o el tiempo
+template <typename Predicate>
+static bool wait_for(std::unique_lock<std::mutex> &lock, TickType_t ticks_to_wait, Predicate predicate)
+{
+    if (ticks_to_wait == portMAX_DELAY) {
+        g_cond.wait(lock, predicate);
+        return true;
+    }
+
+    // sin tiempo de espera no se bloquea, como en FreeRTOS
+    if (ticks_to_wait == 0) return predicate();
+
+    return g_cond.wait_for(lock, std::chrono::milliseconds(ticks_to_wait), predicate);
+}
+
+/* Tiempo y tareas */
+
+TickType_t xTaskGetTickCount()
+{
+    auto elapsed = clock_type::now() - g_started_at;
+    return std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count() + g_tick_offset;
+}
+
+void host_advance_ticks(TickType_t ticks)
+{
+    g_tick_offset += ticks;
+}
+
+int64_t esp_timer_get_time()
+{
+    auto elapsed = clock_type::now() - g_started_at;
+    return std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    std::this_thread::sleep_for(std::chrono::milliseconds(ticks));
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle()
+{
+    return &t_task;
+}
+
+const char *pcTaskGetName(TaskHandle_t)
+{
+    return "host";
+}
+
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t)
+{
+    return 0;
+}
+
+// los hilos del host ignoran la pila, la prioridad y el núcleo
+esp_pthread_cfg_t esp_pthread_get_default_config()
+{
+    return { CONFIG_PTHREAD_TASK_STACK_SIZE_DEFAULT, CONFIG_PTHREAD_TASK_PRIO_DEFAULT, false, nullptr, tskNO_AFFINITY };
+}
+
+esp_err_t esp_pthread_set_cfg(const esp_pthread_cfg_t *)
+{
+    return ESP_OK;
+}
+
+BaseType_t xTaskNotifyGiveIndexed(TaskHandle_t handle, UBaseType_t index)
+{
+    {
+        std::lock_guard lock(g_mutex);
+        static_cast<task_t *>(handle)->notify_value[index]++;
+    }
+    g_cond.notify_all();
+    return pdPASS;
+}
+
+uint32_t ulTaskNotifyTakeIndexed(UBaseType_t index, BaseType_t clear_on_exit, TickType_t ticks_to_wait)
+{
+    std::unique_lock lock(g_mutex);
+    uint32_t &value = t_task.notify_value[index];
+
+    wait_for(lock, ticks_to_wait, [&] { return value > 0; });
+
+    uint32_t previous = value;
+    if (previous > 0) {
+        value = clear_on_exit ? 0 : previous - 1;
+    }
+    return previous;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t handle)
+{
+    return xTaskNotifyGiveIndexed(handle, 0);
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t ticks_to_wait)
+{
+    return ulTaskNotifyTakeIndexed(0, clear_on_exit, ticks_to_wait);
+}
+
+/* Semáforos */
+
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t max_count, UBaseType_t initial_count)
+{
+    return new semaphore_t{initial_count, max_count};
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex()
+{
+    return new semaphore_t{1, 1};
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary()
+{
+    return new semaphore_t{0, 1};
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t handle)
+{
+    delete static_cast<semaphore_t *>(handle);
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t handle, TickType_t ticks_to_wait)
+{
+    semaphore_t *semaphore = static_cast<semaphore_t *>(handle);
+    std::unique_lock lock(g_mutex);
+
+    if (!wait_for(lock, ticks_to_wait, [&] { return semaphore->count > 0; })) {
+        return pdFALSE;
+    }
+
+    semaphore->count--;
+    return pdTRUE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t handle)
+{
+    semaphore_t *semaphore = static_cast<semaphore_t *>(handle);
+
+    {
+        std::lock_guard lock(g_mutex);
+        if (semaphore->count >= semaphore->max_count) return pdFALSE;
+        semaphore->count++;
+    }
+
+    g_cond.notify_all();
+    return pdTRUE;
+}
+
+/* Grupos de eventos */
+
+EventGroupHandle_t xEventGroupCreate()
+{
+    return new event_group_t{0};
+}
+
+void vEventGroupDelete(EventGroupHandle_t handle)
+{
+    delete static_cast<event_group_t *>(handle);
+}
+
+EventBits_t xEventGroupGetBits(EventGroupHandle_t handle)
+{
+    std::lock_guard lock(g_mutex);
+    return static_cast<event_group_t *>(handle)->bits;
+}
+
+EventBits_t xEventGroupSetBits(EventGroupHandle_t handle, EventBits_t bits)
+{
+    EventBits_t result;
+
+    {
+        std::lock_guard lock(g_mutex);
+        result = static_cast<event_group_t *>(handle)->bits |= bits;
+    }
+
+    g_cond.notify_all();
+    return result;
+}
+
+EventBits_t xEventGroupClearBits(EventGroupHandle_t handle, EventBits_t bits)
+{
+    std::lock_guard lock(g_mutex);
+    event_group_t *group = static_cast<event_group_t *>(handle);
+    EventBits_t previous = group->bits;
+
+    group->bits &= ~bits;
+    return previous;
+}
+
+EventBits_t xEventGroupWaitBits(
+    EventGroupHandle_t handle,
+    EventBits_t bits,
+    BaseType_t clear_on_exit,
+    BaseType_t wait_for_all,
+    TickType_t ticks_to_wait)
+{
+    event_group_t *group = static_cast<event_group_t *>(handle);
+    std::unique_lock lock(g_mutex);
+
+    auto is_set = [&] {
+        return wait_for_all ? (group->bits & bits) == bits : (group->bits & bits) != 0;
+    };
+
+    bool is_completed = wait_for(lock, ticks_to_wait, is_set);
+    EventBits_t result = group->bits;
+
+    if (is_completed && clear_on_exit) {
+        group->bits &= ~bits;
+    }
+
+    return result;
+}
+
+EventBits_t xEventGroupSync(EventGroupHandle_t handle, EventBits_t set, EventBits_t wait, TickType_t ticks_to_wait)
+{
+    xEventGroupSetBits(handle, set);
+    return xEventGroupWaitBits(handle, wait, pdTRUE, pdTRUE, ticks_to_wait);
+}
+
+/* Colas y conjuntos de colas */
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size)
+{
+    return new queue_t{std::make_unique<char[]>(length * item_size), length, item_size, 0, 0, nullptr};
+}
+
+void vQueueDelete(QueueHandle_t handle)
+{
+    delete static_cast<queue_t *>(handle);
+}
+
+static BaseType_t queue_send(QueueHandle_t handle, const void *item, TickType_t ticks_to_wait, bool to_front)
+{
+    queue_t *queue = static_cast<queue_t *>(handle);
+
+    {
+        std::unique_lock lock(g_mutex);
+
+        if (!wait_for(lock, ticks_to_wait, [&] { return queue->count < queue->length; })) {
+            return pdFALSE;
+        }
+
+        queue->push(item, to_front);
+
+        // el conjunto recibe la cola que tiene un elemento nuevo
+        if (queue->set != nullptr && queue->set->count < queue->set->length) {
+            queue->set->push(&queue, false);
+        }
+    }
+
+    g_cond.notify_all();
+    return pdTRUE;
+}
+
+BaseType_t xQueueSendToBack(QueueHandle_t queue, const void *item, TickType_t ticks_to_wait)
+{
+    return queue_send(queue, item, ticks_to_wait, false);
+}
+
+BaseType_t xQueueSendToFront(QueueHandle_t queue, const void *item, TickType_t ticks_to_wait)
+{
+    return queue_send(queue, item, ticks_to_wait, true);
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t ticks_to_wait)
+{
+    return queue_send(queue, item, ticks_to_wait, false);
+}
+
+BaseType_t xQueueOverwrite(QueueHandle_t handle, const void *item)
+{
+    queue_t *queue = static_cast<queue_t *>(handle);
+
+    {
+        std::lock_guard lock(g_mutex);
+        queue->count = 0;
+    }
+
+    return queue_send(handle, item, 0, false);
+}
+
+static BaseType_t queue_read(QueueHandle_t handle, void *item, TickType_t ticks_to_wait, bool remove)
+{
+    queue_t *queue = static_cast<queue_t *>(handle);
+    bool was_full;
+
+    {
+        std::unique_lock lock(g_mutex);
+
+        if (!wait_for(lock, ticks_to_wait, [&] { return queue->count > 0; })) {
+            return pdFALSE;
+        }
+
+        memcpy(item, queue->at(0), queue->item_size);
+        was_full = queue->count == queue->length;
+        if (remove) {
+            queue->head = (queue->head + 1) % queue->length;
+            queue->count--;
+        }
+    }
+
+    if (remove && was_full) g_cond.notify_all();
+    return pdTRUE;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void *item, TickType_t ticks_to_wait)
+{
+    return queue_read(queue, item, ticks_to_wait, true);
+}
+
+BaseType_t xQueuePeek(QueueHandle_t queue, void *item, TickType_t ticks_to_wait)
+{
+    return queue_read(queue, item, ticks_to_wait, false);
+}
+
+BaseType_t xQueueReset(QueueHandle_t handle)
+{
+    {
+        std::lock_guard lock(g_mutex);
+        static_cast<queue_t *>(handle)->count = 0;
+    }
+
+    g_cond.notify_all();
+    return pdPASS;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t handle)
+{
+    std::lock_guard lock(g_mutex);
+    return static_cast<queue_t *>(handle)->count;
+}
+
+UBaseType_t uxQueueSpacesAvailable(QueueHandle_t handle)
+{
+    std::lock_guard lock(g_mutex);
+    queue_t *queue = static_cast<queue_t *>(handle);
+    return queue->length - queue->count;
+}
+
+QueueSetHandle_t xQueueCreateSet(UBaseType_t length)
+{
+    return xQueueCreate(length, sizeof(queue_t *));
+}
+
+BaseType_t xQueueAddToSet(QueueSetMemberHandle_t member, QueueSetHandle_t set)
+{
+    std::lock_guard lock(g_mutex);
+    static_cast<queue_t *>(member)->set = static_cast<queue_t *>(set);
+    return pdPASS;
+}
+
+QueueSetMemberHandle_t xQueueSelectFromSet(QueueSetHandle_t set, TickType_t ticks_to_wait)
+{
+    queue_t *member = nullptr;
+    xQueueReceive(set, &member, ticks_to_wait);
+    return member;
+}
+
+/* ESP-IDF */
+
+const char *esp_err_to_name(esp_err_t code)
+{
+    switch (code) {
+        case ESP_OK: return "ESP_OK";
+        case ESP_FAIL: return "ESP_FAIL";
+        case ESP_ERR_NO_MEM: return "ESP_ERR_NO_MEM";
+        case ESP_ERR_INVALID_ARG: return "ESP_ERR_INVALID_ARG";
+        case ESP_ERR_INVALID_STATE: return "ESP_ERR_INVALID_STATE";
+        case ESP_ERR_INVALID_SIZE: return "ESP_ERR_INVALID_SIZE";
+        case ESP_ERR_NOT_FOUND: return "ESP_ERR_NOT_FOUND";
+        case ESP_ERR_NOT_SUPPORTED: return "ESP_ERR_NOT_SUPPORTED";
+        case ESP_ERR_TIMEOUT: return "ESP_ERR_TIMEOUT";
+        case ESP_ERR_INVALID_RESPONSE: return "ESP_ERR_INVALID_RESPONSE";
+        case ESP_ERR_NOT_FINISHED: return "ESP_ERR_NOT_FINISHED";
+        case ESP_ERR_NOT_ALLOWED: return "ESP_ERR_NOT_ALLOWED";
+        default: return "UNKNOWN_ERROR";
+    }
+}
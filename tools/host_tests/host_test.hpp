@@ -0,0 +1,83 @@
+#pragma once
+
+/*
+ * Utilidades mínimas para las pruebas en host: verificaciones que cuentan los
+ * fallos sin detener la prueba y un cronómetro para las mediciones.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <string_view>
+
+namespace host_test {
+
+inline int failures = 0;
+inline int checks = 0;
+
+inline void check(bool condition, const char *expression, const char *file, int line)
+{
+    checks++;
+    if (condition) return;
+
+    failures++;
+    printf("FAIL %s:%d: %s\n", file, line, expression);
+}
+
+inline void check_equal(
+    std::string_view actual,
+    std::string_view expected,
+    const char *expression,
+    const char *file,
+    int line)
+{
+    checks++;
+    if (actual == expected) return;
+
+    failures++;
+    printf(
+        "FAIL %s:%d: %s\n  actual:   \"%.*s\"\n  expected: \"%.*s\"\n",
+        file, line, expression,
+        (int)actual.length(), actual.data(),
+        (int)expected.length(), expected.data());
+}
+
+/**
+ * @brief Imprime el resumen y devuelve el código de salida del programa.
+ */
+inline int summary(const char *name)
+{
+    printf("%s: %d checks, %d failures\n", name, checks, failures);
+    return failures == 0 ? 0 : 1;
+}
+
+/**
+ * @brief Ejecuta fn el número de veces indicado y devuelve los nanosegundos
+ * por iteración.
+ */
+template <typename Fn>
+double measure_ns(size_t iterations, Fn &&fn)
+{
+    auto started_at = std::chrono::steady_clock::now();
+
+    for (size_t i = 0; i < iterations; i++) {
+        fn(i);
+    }
+
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - started_at;
+    return elapsed.count() / iterations;
+}
+
+// evita que el compilador descarte un resultado de una medición
+template <typename T>
+inline void keep(const T &value)
+{
+    asm volatile("" : : "g"(&value) : "memory");
+}
+
+} // namespace host_test
+
+#define CHECK(expression) \
+    host_test::check((expression), #expression, __FILE__, __LINE__)
+
+#define CHECK_EQ_STR(actual, expected) \
+    host_test::check_equal((actual), (expected), #actual " == " #expected, __FILE__, __LINE__)
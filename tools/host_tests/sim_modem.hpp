@@ -0,0 +1,197 @@
+/*
+ * SIM7000_BasicModem conectado a tools/sim7000_sim a través de un
+ * pseudo-terminal, compartido por las pruebas y mediciones que usan el
+ * simulador.
+ *
+ * El simulador se compila junto con las pruebas y se busca en el mismo
+ * directorio que el ejecutable.
+ */
+
+#pragma once
+
+#include <sim7000_basic_modem.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <csignal>
+#include <cstring>
+#include <fcntl.h>
+#include <initializer_list>
+#include <mutex>
+#include <poll.h>
+#include <string>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace host_test
+{
+    using namespace axomotor::lte_modem;
+    using namespace axomotor::lte_modem::internal;
+
+    /**
+     * @brief SIM7000_BasicModem conectado al pty del simulador. Un hilo lee el
+     * pty y entrega los datos al parser, como la tarea de la UART.
+     */
+    class PtyModem : public SIM7000_BasicModem
+    {
+    public:
+        explicit PtyModem(int fd) :
+            SIM7000_BasicModem(1024),
+            m_fd{fd},
+            m_stop{false}
+        {
+            m_is_running = true;
+            m_reader = std::thread([this] { read_loop(); });
+        }
+
+        ~PtyModem()
+        {
+            m_stop = true;
+            m_reader.join();
+        }
+
+        /**
+         * @brief Cuenta las veces que se escribió la secuencia al modem.
+         */
+        size_t count_written(std::string_view sequence)
+        {
+            std::lock_guard lock(m_mutex);
+            size_t count = 0;
+
+            for (size_t pos = m_written.find(sequence);
+                 pos != std::string::npos;
+                 pos = m_written.find(sequence, pos + sequence.length())) {
+                count++;
+            }
+
+            return count;
+        }
+
+        using SIM7000_BasicModem::reset_consecutive_timeouts;
+
+    protected:
+        void on_urc_message(std::string_view, const urc_def_t &) override { }
+
+        int on_cmd_write(const char *data, size_t length) override
+        {
+            std::lock_guard lock(m_mutex);
+            m_written.append(data, length);
+            return write(m_fd, data, length);
+        }
+
+    private:
+        int m_fd;
+        std::atomic<bool> m_stop;
+        std::thread m_reader;
+        std::mutex m_mutex;
+        std::string m_written;
+
+        void read_loop()
+        {
+            char buffer[256];
+
+            while (!m_stop) {
+                struct pollfd pfd = { m_fd, POLLIN, 0 };
+                if (poll(&pfd, 1, 10) <= 0) continue;
+
+                ssize_t length = read(m_fd, buffer, sizeof(buffer));
+                if (length > 0) feed_buffer(buffer, length);
+            }
+        }
+    };
+
+    struct command_t
+    {
+        sim7000_cmd_context_t context;
+        sim7000_cmd_result_info_t info;
+
+        explicit command_t(at_cmd_t command, const char *params = "")
+        {
+            context.command = command;
+            context.params = std::span<const char>(params, strlen(params));
+            context.result_info = &info;
+        }
+    };
+
+    struct simulator_t
+    {
+        pid_t pid = -1;
+        int output = -1;
+        int fd = -1;
+    };
+
+    /**
+     * @brief Inicia el simulador que se encuentra junto al ejecutable y abre
+     * su pty.
+     */
+    static inline bool start_simulator(
+        const char *argv0,
+        std::initializer_list<const char *> args,
+        simulator_t &sim)
+    {
+        std::string path(argv0);
+        path = path.substr(0, path.rfind('/') + 1) + "sim7000_sim";
+
+        int pipe_fds[2];
+        if (pipe(pipe_fds) != 0) return false;
+
+        std::vector<const char *> argv{ path.c_str() };
+        argv.insert(argv.end(), args.begin(), args.end());
+        argv.push_back(nullptr);
+
+        sim.pid = fork();
+        if (sim.pid == 0) {
+            dup2(pipe_fds[1], STDOUT_FILENO);
+            close(pipe_fds[0]);
+            execv(path.c_str(), (char *const *)argv.data());
+            _exit(127);
+        }
+
+        close(pipe_fds[1]);
+        sim.output = pipe_fds[0];
+        if (sim.pid < 0) return false;
+
+        // "SIM7000 simulator listening on /dev/pts/N"
+        std::string line;
+        char c;
+        while (read(sim.output, &c, 1) == 1 && c != '\n') line.push_back(c);
+
+        size_t pos = line.find("/dev/");
+        if (pos == std::string::npos) {
+            printf("failed to start %s\n", path.c_str());
+            return false;
+        }
+
+        sim.fd = open(line.c_str() + pos, O_RDWR | O_NOCTTY);
+        return sim.fd >= 0;
+    }
+
+    /**
+     * @brief Detiene el simulador y devuelve sus estadísticas.
+     */
+    static inline std::string stop_simulator(simulator_t &sim)
+    {
+        std::string output;
+        char buffer[256];
+        ssize_t length;
+
+        kill(sim.pid, SIGTERM);
+        while ((length = read(sim.output, buffer, sizeof(buffer))) > 0) {
+            output.append(buffer, length);
+        }
+
+        waitpid(sim.pid, nullptr, 0);
+        close(sim.output);
+        close(sim.fd);
+
+        return output;
+    }
+
+    static inline esp_err_t run(PtyModem &modem, command_t &cmd, TickType_t ticks_to_wait = 0)
+    {
+        esp_err_t err = modem.submit_cmd(cmd.context, ticks_to_wait);
+        return err == ESP_OK ? modem.wait_for_cmd(cmd.context) : err;
+    }
+}
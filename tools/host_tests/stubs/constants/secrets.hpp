@@ -0,0 +1,11 @@
+#pragma once
+
+// valores de ejemplo; el firmware usa include/constants/secrets.hpp
+#define SERVER_HOSTNAME     "localhost"
+#define MQTT_USERNAME       "host"
+#define MQTT_CLIENT_ID      "host"
+#define MQTT_PASSWORD       "host"
+#define DEVICE_ID           1
+
+#define WIFI_SSID           "host"
+#define WIFI_PASSWORD       "host"
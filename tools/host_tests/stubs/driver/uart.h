@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include "../esp_err.h"
+#include "../freertos/FreeRTOS.h"
+#include "../hal/uart_types.h"
+
+#define UART_PIN_NO_CHANGE -1
+
+typedef enum
+{
+    UART_DATA,
+    UART_BREAK,
+    UART_BUFFER_FULL,
+    UART_FIFO_OVF,
+    UART_FRAME_ERR,
+    UART_PARITY_ERR,
+    UART_DATA_BREAK,
+    UART_PATTERN_DET,
+    UART_EVENT_MAX
+} uart_event_type_t;
+
+typedef struct
+{
+    uart_event_type_t type;
+    size_t size;
+    bool timeout_flag;
+} uart_event_t;
+
+esp_err_t uart_driver_install(uart_port_t, int, int, int, QueueHandle_t *, int);
+esp_err_t uart_param_config(uart_port_t, const uart_config_t *);
+esp_err_t uart_set_pin(uart_port_t, int, int, int, int);
+int uart_read_bytes(uart_port_t, void *, uint32_t, TickType_t);
+int uart_write_bytes(uart_port_t, const void *, size_t);
+esp_err_t uart_flush(uart_port_t);
+esp_err_t uart_flush_input(uart_port_t);
+esp_err_t uart_set_baudrate(uart_port_t, uint32_t);
+esp_err_t uart_get_baudrate(uart_port_t, uint32_t *);
+esp_err_t uart_wait_tx_done(uart_port_t, TickType_t);
+esp_err_t uart_get_buffered_data_len(uart_port_t, size_t *);
+esp_err_t uart_enable_pattern_det_baud_intr(uart_port_t, char, uint8_t, int, int, int);
+esp_err_t uart_disable_pattern_det_intr(uart_port_t);
+esp_err_t uart_pattern_queue_reset(uart_port_t, int);
+int uart_pattern_pop_pos(uart_port_t);
+int uart_pattern_get_pos(uart_port_t);
+esp_err_t uart_set_rx_timeout(uart_port_t, uint8_t);
+esp_err_t uart_set_rx_full_threshold(uart_port_t, int);
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+
+typedef const char *esp_event_base_t;
+typedef void *esp_event_loop_handle_t;
+typedef void (*esp_event_handler_t)(void *, esp_event_base_t, int32_t, void *);
+
+#define ESP_EVENT_DECLARE_BASE(id) extern esp_event_base_t const id
+#define ESP_EVENT_DEFINE_BASE(id) esp_event_base_t const id = #id
+#define ESP_EVENT_ANY_ID -1
+
+typedef struct
+{
+    int32_t queue_size;
+    const char *task_name;
+    UBaseType_t task_priority;
+    uint32_t task_stack_size;
+    BaseType_t task_core_id;
+} esp_event_loop_args_t;
+
+esp_err_t esp_event_loop_create(const esp_event_loop_args_t *, esp_event_loop_handle_t *);
+esp_err_t esp_event_loop_create_default();
+esp_err_t esp_event_loop_delete(esp_event_loop_handle_t);
+esp_err_t esp_event_post_to(esp_event_loop_handle_t, esp_event_base_t, int32_t, const void *, size_t, TickType_t);
+esp_err_t esp_event_post(esp_event_base_t, int32_t, const void *, size_t, TickType_t);
+esp_err_t esp_event_handler_register(esp_event_base_t, int32_t, esp_event_handler_t, void *);
+esp_err_t esp_event_handler_unregister(esp_event_base_t, int32_t, esp_event_handler_t);
@@ -0,0 +1,5 @@
+#pragma once
+
+// solo los tipos que aparecen en los encabezados de los servicios
+typedef void *httpd_handle_t;
+typedef struct httpd_req httpd_req_t;
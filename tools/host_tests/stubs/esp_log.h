@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstdarg>
+#include <cstdio>
+
+typedef int (*vprintf_like_t)(const char *, va_list);
+
+// solo se imprimen errores y advertencias, para no alterar las mediciones; los
+// demás niveles conservan sus argumentos, como ESP-IDF con el nivel de
+// registro reducido
+#define ESP_LOGE(tag, format, ...) printf("E %s: " format "\n", tag, ##__VA_ARGS__)
+#define ESP_LOGW(tag, format, ...) printf("W %s: " format "\n", tag, ##__VA_ARGS__)
+#define ESP_LOGI(tag, format, ...) do { if (0) printf("%s: " format "\n", tag, ##__VA_ARGS__); } while (0)
+#define ESP_LOGD(tag, format, ...) do { if (0) printf("%s: " format "\n", tag, ##__VA_ARGS__); } while (0)
+#define ESP_LOGV(tag, format, ...) do { if (0) printf("%s: " format "\n", tag, ##__VA_ARGS__); } while (0)
+#define ESP_LOG_BUFFER_HEX(tag, buffer, length) do { (void)(buffer); (void)(length); } while (0)
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "esp_err.h"
+#include "esp_event.h"
+
+typedef struct esp_netif_obj esp_netif_t;
+typedef void *esp_netif_iodriver_handle;
+
+typedef struct esp_netif_driver_base_s
+{
+    esp_err_t (*post_attach)(esp_netif_t *netif, esp_netif_iodriver_handle handle);
+    esp_netif_t *netif;
+} esp_netif_driver_base_t;
+
+typedef struct
+{
+    esp_netif_iodriver_handle handle;
+    esp_err_t (*transmit)(void *handle, void *buffer, size_t length);
+    esp_err_t (*transmit_wrap)(void *handle, void *buffer, size_t length, void *netstack_buffer);
+    void (*driver_free_rx_buffer)(void *handle, void *buffer);
+} esp_netif_driver_ifconfig_t;
+
+typedef struct { int unused; } esp_netif_config_t;
+typedef struct { uint32_t addr; } esp_ip4_addr_t;
+typedef struct { esp_ip4_addr_t ip, netmask, gw; } esp_netif_ip_info_t;
+
+typedef struct
+{
+    esp_netif_t *esp_netif;
+    esp_netif_ip_info_t ip_info;
+    bool ip_changed;
+} ip_event_got_ip_t;
+
+extern esp_event_base_t const IP_EVENT;
+
+enum
+{
+    IP_EVENT_STA_GOT_IP,
+    IP_EVENT_STA_LOST_IP,
+    IP_EVENT_AP_STAIPASSIGNED,
+    IP_EVENT_GOT_IP6,
+    IP_EVENT_ETH_GOT_IP,
+    IP_EVENT_ETH_LOST_IP,
+    IP_EVENT_PPP_GOT_IP,
+    IP_EVENT_PPP_LOST_IP
+};
+
+#define ESP_NETIF_DEFAULT_PPP() { 0 }
+#define IPSTR "%d.%d.%d.%d"
+#define IP2STR(addr) 0, 0, 0, 0
+
+esp_netif_t *esp_netif_new(const esp_netif_config_t *);
+void esp_netif_destroy(esp_netif_t *);
+esp_err_t esp_netif_attach(esp_netif_t *, esp_netif_iodriver_handle);
+esp_err_t esp_netif_set_driver_config(esp_netif_t *, const esp_netif_driver_ifconfig_t *);
+esp_err_t esp_netif_receive(esp_netif_t *, void *, size_t, void *);
+void esp_netif_action_start(void *, esp_event_base_t, int32_t, void *);
+void esp_netif_action_stop(void *, esp_event_base_t, int32_t, void *);
+esp_err_t esp_netif_init();
+esp_err_t esp_netif_get_ip_info(esp_netif_t *, esp_netif_ip_info_t *);
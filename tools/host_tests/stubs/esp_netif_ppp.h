@@ -0,0 +1,40 @@
+#pragma once
+
+#include "esp_netif.h"
+
+extern esp_event_base_t const NETIF_PPP_STATUS;
+
+typedef enum
+{
+    NETIF_PPP_ERRORNONE = 0,
+    NETIF_PPP_ERRORPARAM,
+    NETIF_PPP_ERROROPEN,
+    NETIF_PPP_ERRORDEVICE,
+    NETIF_PPP_ERRORALLOC,
+    NETIF_PPP_ERRORUSER,
+    NETIF_PPP_ERRORCONNECT,
+    NETIF_PPP_ERRORAUTHFAIL,
+    NETIF_PPP_ERRORPROTOCOL,
+    NETIF_PPP_ERRORPEERDEAD,
+    NETIF_PPP_ERRORIDLETIMEOUT,
+    NETIF_PPP_ERRORCONNECTTIME,
+    NETIF_PPP_ERRORLOOPBACK,
+    NETIF_PPP_PHASE_DEAD = 0x100,
+    NETIF_PPP_PHASE_RUNNING = 0x10b,
+    NETIF_PPP_CONNECT_FAILED = 0x200
+} esp_netif_ppp_status_event_t;
+
+typedef enum
+{
+    NETIF_PPP_AUTHTYPE_NONE = 0,
+    NETIF_PPP_AUTHTYPE_PAP = 1
+} esp_netif_auth_type_t;
+
+typedef struct
+{
+    bool ppp_phase_event_enabled;
+    bool ppp_error_event_enabled;
+} esp_netif_ppp_config_t;
+
+esp_err_t esp_netif_ppp_set_auth(esp_netif_t *, esp_netif_auth_type_t, const char *, const char *);
+esp_err_t esp_netif_ppp_set_params(esp_netif_t *, const esp_netif_ppp_config_t *);
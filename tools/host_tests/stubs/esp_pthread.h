@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstddef>
+#include "esp_err.h"
+
+typedef struct
+{
+    size_t stack_size;
+    size_t prio;
+    bool inherit_cfg;
+    const char *thread_name;
+    int pin_to_core;
+} esp_pthread_cfg_t;
+
+esp_pthread_cfg_t esp_pthread_get_default_config();
+esp_err_t esp_pthread_set_cfg(const esp_pthread_cfg_t *);
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned UBaseType_t;
+
+// un tick por milisegundo, como en el firmware
+#define configTICK_RATE_HZ                      1000
+#define configTASK_NOTIFICATION_ARRAY_ENTRIES   2
+#define CONFIG_PTHREAD_TASK_STACK_SIZE_DEFAULT  4096
+#define CONFIG_PTHREAD_TASK_PRIO_DEFAULT        5
+
+#define portMAX_DELAY           ((TickType_t)0xffffffffUL)
+#define portTICK_PERIOD_MS      1
+#define pdMS_TO_TICKS(ms)       ((TickType_t)(ms))
+#define pdTICKS_TO_MS(ticks)    ((uint32_t)(ticks))
+#define pdTRUE                  1
+#define pdFALSE                 0
+#define pdPASS                  1
+#define tskNO_AFFINITY          0x7fffffff
+
+#define BIT0    (1u << 0)
+#define BIT1    (1u << 1)
+#define BIT2    (1u << 2)
+#define BIT3    (1u << 3)
+#define BIT4    (1u << 4)
+#define BIT5    (1u << 5)
+#define BIT6    (1u << 6)
+#define BIT7    (1u << 7)
+#define BIT8    (1u << 8)
+#define BIT9    (1u << 9)
+#define BIT10   (1u << 10)
+
+typedef struct { int unused; } portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED {}
+#define portENTER_CRITICAL(mux)
+#define portEXIT_CRITICAL(mux)
+
+typedef void *TaskHandle_t;
+typedef void *QueueHandle_t;
+typedef void *QueueSetHandle_t;
+typedef void *QueueSetMemberHandle_t;
+typedef void *EventGroupHandle_t;
+typedef void *SemaphoreHandle_t;
+typedef void *TimerHandle_t;
+
+#include "task.h"
+#include "queue.h"
+#include "event_groups.h"
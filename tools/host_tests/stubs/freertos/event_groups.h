@@ -0,0 +1,18 @@
+#pragma once
+
+#include "FreeRTOS.h"
+
+typedef uint32_t EventBits_t;
+
+EventGroupHandle_t xEventGroupCreate();
+void vEventGroupDelete(EventGroupHandle_t group);
+EventBits_t xEventGroupGetBits(EventGroupHandle_t group);
+EventBits_t xEventGroupSetBits(EventGroupHandle_t group, EventBits_t bits);
+EventBits_t xEventGroupClearBits(EventGroupHandle_t group, EventBits_t bits);
+EventBits_t xEventGroupWaitBits(
+    EventGroupHandle_t group,
+    EventBits_t bits,
+    BaseType_t clear_on_exit,
+    BaseType_t wait_for_all,
+    TickType_t ticks_to_wait);
+EventBits_t xEventGroupSync(EventGroupHandle_t group, EventBits_t set, EventBits_t wait, TickType_t ticks_to_wait);
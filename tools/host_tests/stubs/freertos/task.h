@@ -0,0 +1,23 @@
+#pragma once
+
+#include "FreeRTOS.h"
+
+typedef enum { eNoAction, eSetBits, eIncrement } eNotifyAction;
+
+// cada hilo del host es una tarea
+TaskHandle_t xTaskGetCurrentTaskHandle();
+TickType_t xTaskGetTickCount();
+void vTaskDelay(TickType_t ticks);
+const char *pcTaskGetName(TaskHandle_t task);
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task);
+
+// solo en host: adelanta xTaskGetTickCount sin esperar, para probar lógica
+// que depende del tiempo transcurrido
+void host_advance_ticks(TickType_t ticks);
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task);
+uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t ticks_to_wait);
+BaseType_t xTaskNotify(TaskHandle_t task, uint32_t value, eNotifyAction action);
+BaseType_t xTaskNotifyWait(uint32_t clear_on_entry, uint32_t clear_on_exit, uint32_t *value, TickType_t ticks_to_wait);
+BaseType_t xTaskNotifyGiveIndexed(TaskHandle_t task, UBaseType_t index);
+uint32_t ulTaskNotifyTakeIndexed(UBaseType_t index, BaseType_t clear_on_exit, TickType_t ticks_to_wait);
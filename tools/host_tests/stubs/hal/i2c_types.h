@@ -0,0 +1,3 @@
+#pragma once
+
+typedef enum { I2C_NUM_0, I2C_NUM_1 } i2c_port_t;
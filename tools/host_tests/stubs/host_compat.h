@@ -0,0 +1,9 @@
+#pragma once
+
+// funciones de newlib (ESP-IDF) que glibc no tiene antes de la versión 2.38
+#include <cstddef>
+#include <features.h>
+
+#if !__GLIBC_PREREQ(2, 38)
+extern "C" size_t strlcpy(char *dst, const char *src, size_t size);
+#endif
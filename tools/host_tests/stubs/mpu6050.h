@@ -0,0 +1,3 @@
+#pragma once
+
+typedef void *mpu6050_handle_t;
@@ -0,0 +1,223 @@
+/*
+ * Verifica que publicar con un espacio de la reserva de comandos no reserva
+ * memoria dinámica. En host se cuentan las llamadas a operator new en lugar
+ * de heap_caps_get_free_size().
+ *
+ * Se repite el camino de SIM7000_MQTT::publish() (acquire_cmd_slot,
+ * format_params y AT+SMPUB con carga útil) sobre TestModem, y el de
+ * publish_async(), cuyos marcos de corrutina se toman de FramePool.
+ */
+
+#include "host_test.hpp"
+#include "test_modem.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <vector>
+
+using namespace axomotor::lte_modem;
+using namespace axomotor::lte_modem::internal;
+using namespace axomotor::threading;
+
+static std::atomic<size_t> s_allocations{0};
+
+// sin inline, para que el compilador no empareje malloc() con delete
+__attribute__((noinline)) void *operator new(size_t size)
+{
+    s_allocations++;
+    void *ptr = malloc(size);
+    if (ptr == nullptr) abort();
+    return ptr;
+}
+
+void *operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+__attribute__((noinline)) void operator delete(void *ptr) noexcept
+{
+    free(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept
+{
+    operator delete(ptr);
+}
+
+void operator delete[](void *ptr) noexcept
+{
+    operator delete(ptr);
+}
+
+void operator delete[](void *ptr, size_t) noexcept
+{
+    operator delete(ptr);
+}
+
+static const char TOPIC[] = "axomotor/device/positions";
+static const char PAYLOAD[] = "{\"lat\":19.432608,\"lon\":-99.133209,\"speed\":42.5,\"course\":271.3}";
+
+// responde como el modem a AT+SMPUB: el indicador y después OK
+static void answer_publish(TestModem &modem)
+{
+    modem.feed("\r\n> ");
+    modem.feed("\r\nOK\r\n");
+    // lo escrito solo interesa a otras pruebas
+    modem.clear_written();
+}
+
+static esp_err_t publish(TestModem &modem)
+{
+    SIM7000_CmdSlot slot = modem.acquire_cmd_slot();
+    esp_err_t err = slot.format_params(
+        "=\"%s\",%u,%u,%u",
+        TOPIC,
+        (unsigned)strlen(PAYLOAD),
+        1U,
+        0U);
+
+    if (err == ESP_OK) {
+        sim7000_cmd_context_t context;
+        context.command = at_cmd_t::SMPUB;
+        context.params = slot.get_params();
+        context.payload = std::span<const char>(PAYLOAD, strlen(PAYLOAD));
+        context.send_payload = true;
+        context.result_info = &slot.get_result_info();
+
+        err = modem.submit_cmd(context);
+        if (err == ESP_OK) {
+            answer_publish(modem);
+            err = modem.wait_for_cmd(context);
+        }
+    }
+
+    return err;
+}
+
+static AsyncTask publish_async(TestModem &modem, esp_err_t &result)
+{
+    SIM7000_CmdSlot slot = co_await modem.acquire_cmd_slot_async();
+    esp_err_t err = slot.format_params(
+        "=\"%s\",%u,%u,%u",
+        TOPIC,
+        (unsigned)strlen(PAYLOAD),
+        1U,
+        0U);
+
+    if (err == ESP_OK) {
+        sim7000_cmd_context_t context;
+        context.command = at_cmd_t::SMPUB;
+        context.params = slot.get_params();
+        context.payload = std::span<const char>(PAYLOAD, strlen(PAYLOAD));
+        context.send_payload = true;
+        context.result_info = &slot.get_result_info();
+
+        err = co_await modem.exec(context);
+    }
+
+    result = err;
+}
+
+static void test_publish()
+{
+    const size_t publish_count = 100;
+    TestModem modem;
+
+    // la primera publicación crea la entrada de estadísticas del comando y
+    // el buffer de stdout
+    CHECK(publish(modem) == ESP_OK);
+
+    size_t allocations = s_allocations;
+    size_t failures = 0;
+
+    for (size_t i = 0; i < publish_count; i++) {
+        if (publish(modem) != ESP_OK) failures++;
+    }
+
+    size_t count = s_allocations - allocations;
+    printf("publish: %zu allocations in %zu publishes\n", count, publish_count);
+
+    CHECK(failures == 0);
+    CHECK(count == 0);
+}
+
+static void test_publish_async()
+{
+    const size_t publish_count = 100;
+    TestModem modem;
+    Executor executor;
+    esp_err_t result = ESP_FAIL;
+
+    auto run_once = [&] {
+        result = ESP_FAIL;
+        executor.spawn(publish_async(modem, result));
+
+        // la corrutina envía el comando y se suspende hasta la respuesta
+        executor.run(0);
+        answer_publish(modem);
+        executor.run(0);
+    };
+
+    run_once();
+    CHECK(result == ESP_OK);
+
+    size_t allocations = s_allocations;
+    size_t heap_frames = FramePool::get_heap_frame_count();
+    size_t failures = 0;
+
+    for (size_t i = 0; i < publish_count; i++) {
+        run_once();
+        if (result != ESP_OK) failures++;
+    }
+
+    size_t count = s_allocations - allocations;
+    printf("publish_async: %zu allocations in %zu publishes\n", count, publish_count);
+
+    CHECK(failures == 0);
+    CHECK(executor.get_task_count() == 0);
+    // los marcos de publish_async, acquire_cmd_slot_async y exec caben en la
+    // reserva
+    CHECK(FramePool::get_heap_frame_count() == heap_frames);
+    CHECK(count == 0);
+}
+
+static AsyncTask idle_task()
+{
+    co_return;
+}
+
+static void test_frame_pool_overflow()
+{
+    const size_t extra_frames = 4;
+    std::vector<AsyncTask> tasks;
+    tasks.reserve(SMALL_FRAME_COUNT + LARGE_FRAME_COUNT + extra_frames);
+
+    size_t heap_frames = FramePool::get_heap_frame_count();
+
+    // las corrutinas que no se inician conservan su marco hasta destruirse
+    for (size_t i = 0; i < SMALL_FRAME_COUNT + LARGE_FRAME_COUNT + extra_frames; i++) {
+        tasks.push_back(idle_task());
+    }
+
+    // al agotarse los bloques los marcos se toman del heap
+    CHECK(FramePool::get_heap_frame_count() == heap_frames + extra_frames);
+
+    tasks.clear();
+    heap_frames = FramePool::get_heap_frame_count();
+
+    // los bloques liberados se vuelven a usar
+    tasks.push_back(idle_task());
+    CHECK(FramePool::get_heap_frame_count() == heap_frames);
+}
+
+int main()
+{
+    test_publish();
+    test_publish_async();
+    test_frame_pool_overflow();
+
+    return host_test::summary("cmd_pool_heap");
+}
@@ -0,0 +1,257 @@
+/*
+ * Pruebas de los histogramas log2 de SIM7000_CmdStats y del tiempo de espera
+ * adaptativo que se calcula a partir de ellos: límites de los intervalos,
+ * extracción de percentiles, reducción de la ventana y recorte al límite
+ * del comando. Al final imprime los histogramas de una distribución de
+ * latencias simulada.
+ */
+
+#include "host_test.hpp"
+
+#include <sim7000_cmd_stats.hpp>
+
+#include <cstring>
+#include <random>
+
+using namespace axomotor::lte_modem;
+using namespace axomotor::lte_modem::internal;
+
+// registra una ejecución del comando que tardó time_ms en terminar
+static void record(
+    SIM7000_CmdStats &stats,
+    at_cmd_t command,
+    uint32_t time_ms,
+    at_cmd_result_t result = at_cmd_result_t::OK,
+    int error_code = -1)
+{
+    sim7000_cmd_result_info_t info;
+    info.result = result;
+    info.error_code = error_code;
+
+    sim7000_cmd_context_t context;
+    context.command = command;
+    context.result_info = &info;
+    context.sent_time = 1000000;
+    context.first_byte_time = context.sent_time + (time_ms / 2) * 1000;
+    context.bytes_sent = 10;
+    context.bytes_received = 20;
+
+    stats.record(context, context.sent_time + time_ms * 1000);
+}
+
+static void test_buckets()
+{
+    CHECK(cmd_histogram_t::get_bucket(0) == 0);
+    CHECK(cmd_histogram_t::get_bucket(1) == 1);
+    CHECK(cmd_histogram_t::get_bucket(2) == 2);
+    CHECK(cmd_histogram_t::get_bucket(3) == 2);
+    CHECK(cmd_histogram_t::get_bucket(4) == 3);
+    CHECK(cmd_histogram_t::get_bucket(1023) == 10);
+    CHECK(cmd_histogram_t::get_bucket(1024) == 11);
+    CHECK(cmd_histogram_t::get_bucket(16383) == 14);
+    // el último intervalo acumula todo lo que exceda ~16 s
+    CHECK(cmd_histogram_t::get_bucket(16384) == CMD_HISTOGRAM_BUCKETS - 1);
+    CHECK(cmd_histogram_t::get_bucket(UINT32_MAX) == CMD_HISTOGRAM_BUCKETS - 1);
+
+    // cada tiempo queda por debajo del límite de su intervalo y, salvo en el
+    // intervalo 0, por encima del límite del anterior
+    for (uint32_t ms = 0; ms < 20000; ms++) {
+        size_t bucket = cmd_histogram_t::get_bucket(ms);
+        if (bucket < CMD_HISTOGRAM_BUCKETS - 1) {
+            CHECK(ms < cmd_histogram_t::get_bucket_limit(bucket));
+        }
+        if (bucket > 0) {
+            CHECK(ms >= cmd_histogram_t::get_bucket_limit(bucket - 1));
+        }
+    }
+}
+
+static void test_percentile()
+{
+    cmd_histogram_t histogram{};
+    CHECK(histogram.percentile(50) == 0);
+
+    // 90 muestras de 10 ms ([8, 16)) y 10 de 300 ms ([256, 512))
+    for (int i = 0; i < 90; i++) histogram.add(10);
+    for (int i = 0; i < 10; i++) histogram.add(300);
+
+    CHECK(histogram.total() == 100);
+    CHECK(histogram.percentile(0) == 16);
+    CHECK(histogram.percentile(50) == 16);
+    CHECK(histogram.percentile(90) == 16);
+    CHECK(histogram.percentile(91) == 512);
+    CHECK(histogram.percentile(99) == 512);
+    CHECK(histogram.percentile(100) == 512);
+
+    // una sola muestra
+    cmd_histogram_t single{};
+    single.add(0);
+    CHECK(single.percentile(99) == 1);
+}
+
+static void test_window()
+{
+    cmd_histogram_t histogram{};
+
+    for (uint32_t i = 0; i < CMD_HISTOGRAM_WINDOW - 1; i++) histogram.add(10);
+    CHECK(histogram.total() == CMD_HISTOGRAM_WINDOW - 1);
+
+    // al completar la ventana los contadores se reducen a la mitad
+    histogram.add(10);
+    CHECK(histogram.total() == CMD_HISTOGRAM_WINDOW / 2);
+
+    // las muestras recientes desplazan a las anteriores: 1000 muestras
+    // completan la ventana tres veces más
+    for (int i = 0; i < 1000; i++) histogram.add(1000);
+    CHECK(histogram.percentile(50) == 1024);
+    CHECK(histogram.buckets[cmd_histogram_t::get_bucket(10)] == CMD_HISTOGRAM_WINDOW / 16);
+    CHECK(histogram.total() < CMD_HISTOGRAM_WINDOW);
+}
+
+static void test_adaptive_timeout()
+{
+    SIM7000_CmdStats stats;
+    const uint32_t limit_ms = 10000;
+
+    // sin muestras se utiliza el límite
+    CHECK(stats.get_adaptive_timeout(at_cmd_t::SMPUB, limit_ms) == limit_ms);
+
+    for (uint32_t i = 0; i < ADAPTIVE_TIMEOUT_MIN_SAMPLES - 1; i++) {
+        record(stats, at_cmd_t::SMPUB, 1000);
+    }
+    CHECK(stats.get_adaptive_timeout(at_cmd_t::SMPUB, limit_ms) == limit_ms);
+
+    // p99 de 1000 ms es 1024 ms, por el margen
+    record(stats, at_cmd_t::SMPUB, 1000);
+    CHECK(stats.get_adaptive_timeout(at_cmd_t::SMPUB, limit_ms) == 1024 * ADAPTIVE_TIMEOUT_MARGIN);
+    // nunca excede el límite del comando
+    CHECK(stats.get_adaptive_timeout(at_cmd_t::SMPUB, 1500) == 1500);
+
+    // después de agotarse el tiempo de espera vuelve al límite hasta la
+    // siguiente respuesta
+    record(stats, at_cmd_t::SMPUB, limit_ms, at_cmd_result_t::NO_ANSWER);
+    CHECK(stats.get_adaptive_timeout(at_cmd_t::SMPUB, limit_ms) == limit_ms);
+    record(stats, at_cmd_t::SMPUB, 1000);
+    CHECK(stats.get_adaptive_timeout(at_cmd_t::SMPUB, limit_ms) == 1024 * ADAPTIVE_TIMEOUT_MARGIN);
+
+    // comandos rápidos: no baja del mínimo, salvo que el límite sea menor
+    for (uint32_t i = 0; i < ADAPTIVE_TIMEOUT_MIN_SAMPLES; i++) {
+        record(stats, at_cmd_t::CSQ, 20);
+    }
+    CHECK(stats.get_adaptive_timeout(at_cmd_t::CSQ, limit_ms) == ADAPTIVE_TIMEOUT_MIN_MS);
+    CHECK(stats.get_adaptive_timeout(at_cmd_t::CSQ, 300) == 300);
+}
+
+static void test_record()
+{
+    SIM7000_CmdStats stats;
+    cmd_stats_t entry;
+
+    CHECK(!stats.get(at_cmd_t::CSQ, entry));
+
+    record(stats, at_cmd_t::CSQ, 40);
+    record(stats, at_cmd_t::CSQ, 40, at_cmd_result_t::CME_ERROR, 10);
+    record(stats, at_cmd_t::CSQ, 40, at_cmd_result_t::CANCELLED);
+    record(stats, at_cmd_t::CSQ, 9000, at_cmd_result_t::NO_ANSWER);
+
+    CHECK(stats.get(at_cmd_t::CSQ, entry));
+    CHECK(entry.count == 4);
+    CHECK(entry.errors == 1);
+    CHECK(entry.last_error_code == 10);
+    CHECK(entry.cancellations == 1);
+    CHECK(entry.timeouts == 1);
+    CHECK(entry.consecutive_timeouts == 1);
+    CHECK(entry.bytes_sent == 40);
+    CHECK(entry.bytes_received == 80);
+    // los cancelados y los que agotaron el tiempo no cuentan para la latencia
+    CHECK(entry.final_result.total() == 2);
+    CHECK(entry.first_byte.total() == 4);
+
+    // la memoria es fija: los comandos que no caben no se registran
+    for (size_t i = 0; i < MAX_CMD_STATS_ENTRIES + 4; i++) {
+        record(stats, (at_cmd_t)(10000 + i), 10);
+    }
+    CHECK(stats.size() == MAX_CMD_STATS_ENTRIES);
+    CHECK(stats.get_entry(0, entry) && entry.command == at_cmd_t::CSQ);
+    CHECK(!stats.get_entry(MAX_CMD_STATS_ENTRIES, entry));
+
+    stats.reset();
+    CHECK(stats.size() == 0);
+}
+
+static void test_serialize()
+{
+    SIM7000_CmdStats stats;
+    char buffer[512];
+
+    CHECK(stats.serialize(buffer) > 0);
+    CHECK_EQ_STR(buffer, "{\"cmds\":[]}");
+
+    record(stats, at_cmd_t::CSQ, 3);
+    size_t length = stats.serialize(buffer);
+    CHECK(length == strlen(buffer));
+    CHECK_EQ_STR(
+        buffer,
+        "{\"cmds\":[{\"cmd\":\"CSQ\",\"n\":1,\"to\":0,\"err\":0,\"cx\":0,\"ec\":-1,"
+        "\"tx\":10,\"rx\":20,"
+        "\"ttfb\":[0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0],"
+        "\"ttf\":[0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0]}]}");
+
+    // si no cabe no se escribe nada
+    CHECK(stats.serialize(std::span<char>(buffer, 64)) == 0);
+}
+
+static void print_histogram(const char *name, const cmd_histogram_t &histogram)
+{
+    printf("  %s (%u samples)\n", name, (unsigned)histogram.total());
+
+    uint32_t lower = 0;
+    for (size_t i = 0; i < CMD_HISTOGRAM_BUCKETS; i++) {
+        uint32_t upper = cmd_histogram_t::get_bucket_limit(i);
+        if (histogram.buckets[i] > 0) {
+            printf("    [%5u, %5u) ms %4u\n", lower, upper, (unsigned)histogram.buckets[i]);
+        }
+        lower = upper;
+    }
+
+    printf(
+        "    p50 <= %u ms, p90 <= %u ms, p99 <= %u ms\n",
+        histogram.percentile(50),
+        histogram.percentile(90),
+        histogram.percentile(99));
+}
+
+static void dump()
+{
+    SIM7000_CmdStats stats;
+    std::mt19937 random(7);
+    // AT+SMPUB: la mayoría en ~250 ms, con una cola larga por la red
+    std::lognormal_distribution<double> latency(5.5, 0.5);
+
+    for (int i = 0; i < 400; i++) {
+        record(stats, at_cmd_t::SMPUB, (uint32_t)latency(random));
+    }
+
+    cmd_stats_t entry;
+    CHECK(stats.get(at_cmd_t::SMPUB, entry));
+
+    printf("SMPUB, lognormal latency (median ~245 ms):\n");
+    print_histogram("first byte", entry.first_byte);
+    print_histogram("final result", entry.final_result);
+    printf(
+        "  adaptive timeout: %u ms (limit 30000 ms)\n",
+        stats.get_adaptive_timeout(at_cmd_t::SMPUB, 30000));
+}
+
+int main()
+{
+    test_buckets();
+    test_percentile();
+    test_window();
+    test_adaptive_timeout();
+    test_record();
+    test_serialize();
+    dump();
+
+    return host_test::summary("cmd_stats");
+}
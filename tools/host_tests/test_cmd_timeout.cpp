@@ -0,0 +1,115 @@
+/*
+ * Verifica que la respuesta tardía de un comando que agotó su tiempo de
+ * espera se descarte y no se atribuya al siguiente comando de la cola.
+ *
+ * AT+CSQ no define un tiempo máximo de respuesta, por lo que su tiempo de
+ * espera es de 100 ms.
+ */
+
+#include "host_test.hpp"
+#include "test_modem.hpp"
+
+#include <thread>
+
+using namespace axomotor::lte_modem;
+using namespace axomotor::lte_modem::internal;
+
+struct command_t
+{
+    sim7000_cmd_context_t context;
+    sim7000_cmd_result_info_t info;
+
+    explicit command_t(at_cmd_t command)
+    {
+        context.command = command;
+        context.result_info = &info;
+    }
+};
+
+static void test_late_result()
+{
+    TestModem modem;
+    command_t first(at_cmd_t::CSQ);
+    command_t second(at_cmd_t::CSQ);
+
+    CHECK(modem.submit_cmd(first.context) == ESP_OK);
+    CHECK(modem.take_written() == "AT+CSQ\r");
+    CHECK(modem.wait_for_cmd(first.context) == ESP_ERR_TIMEOUT);
+    CHECK(first.info.result == at_cmd_result_t::NO_ANSWER);
+    CHECK(modem.timeouts == 1);
+
+    // no se envía hasta descartar la respuesta del anterior
+    CHECK(modem.submit_cmd(second.context) == ESP_OK);
+    CHECK(modem.take_written().empty());
+
+    modem.feed("\r\n+CSQ: 20,99\r\n\r\nOK\r\n");
+    CHECK(modem.poll_cmd(second.context) == ESP_ERR_NOT_FINISHED);
+    CHECK(modem.take_written() == "AT+CSQ\r");
+
+    // el segundo recibe solo su propia respuesta
+    modem.feed("\r\n+CSQ: 15,99\r\n\r\nOK\r\n");
+    CHECK(modem.wait_for_cmd(second.context) == ESP_OK);
+    CHECK(second.info.response == "+CSQ: 15,99");
+}
+
+static void test_late_error()
+{
+    TestModem modem;
+    command_t first(at_cmd_t::CSQ);
+    command_t second(at_cmd_t::CSQ);
+
+    CHECK(modem.submit_cmd(first.context) == ESP_OK);
+    CHECK(modem.wait_for_cmd(first.context) == ESP_ERR_TIMEOUT);
+    CHECK(modem.submit_cmd(second.context) == ESP_OK);
+    modem.take_written();
+
+    // un ERROR tardío tampoco hace fallar al siguiente
+    modem.feed("\r\nERROR\r\n");
+    CHECK(modem.take_written() == "AT+CSQ\r");
+    modem.feed("\r\nOK\r\n");
+    CHECK(modem.wait_for_cmd(second.context) == ESP_OK);
+    CHECK(second.info.result == at_cmd_result_t::OK);
+}
+
+static void test_result_after_drain_timeout()
+{
+    static const char PARAMS[] = "=\"axomotor/ping\",4,1,0";
+    static const char PAYLOAD[] = "ping";
+    TestModem modem;
+    command_t first(at_cmd_t::CSQ);
+    command_t second(at_cmd_t::SMPUB);
+
+    second.context.params = std::span<const char>(PARAMS, sizeof(PARAMS) - 1);
+    second.context.payload = std::span<const char>(PAYLOAD, sizeof(PAYLOAD) - 1);
+    second.context.send_payload = true;
+
+    CHECK(modem.submit_cmd(first.context) == ESP_OK);
+    CHECK(modem.wait_for_cmd(first.context) == ESP_ERR_TIMEOUT);
+    CHECK(modem.submit_cmd(second.context) == ESP_OK);
+    modem.take_written();
+
+    // si la respuesta no llega a tiempo, el siguiente comando se envía de
+    // todos modos al vencer el tiempo de descarte
+    std::this_thread::sleep_for(std::chrono::milliseconds(CMD_DRAIN_TIMEOUT_MS + 50));
+    CHECK(modem.poll_cmd(second.context) == ESP_ERR_NOT_FINISHED);
+    CHECK(modem.take_written() == std::string("AT+SMPUB") + PARAMS + "\r");
+
+    // un OK antes del indicador no puede ser del comando con carga útil, por
+    // lo que se reconoce como el resultado tardío del anterior
+    modem.feed("\r\nOK\r\n");
+    CHECK(modem.poll_cmd(second.context) == ESP_ERR_NOT_FINISHED);
+
+    modem.feed("\r\n> ");
+    CHECK(modem.take_written() == std::string(PAYLOAD) + "\r");
+    modem.feed("\r\nOK\r\n");
+    CHECK(modem.wait_for_cmd(second.context) == ESP_OK);
+}
+
+int main()
+{
+    test_late_result();
+    test_late_error();
+    test_result_after_drain_timeout();
+
+    return host_test::summary("cmd_timeout");
+}
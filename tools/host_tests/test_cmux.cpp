@@ -0,0 +1,307 @@
+/*
+ * Pruebas del codificador y decodificador de tramas de SIM7000_CMux: FCS de
+ * las tramas UIH y UI, longitud extendida, resincronización con los
+ * delimitadores y respuesta a los comandos del canal de control.
+ *
+ * Las tramas esperadas se arman aquí con un CRC calculado bit a bit, sin la
+ * tabla del multiplexor.
+ */
+
+#include "host_test.hpp"
+
+#include <sim7000_cmux.hpp>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace axomotor::lte_modem;
+
+static const uint8_t FLAG = 0xF9;
+static const uint8_t SABM = 0x2F;
+static const uint8_t UA = 0x63;
+static const uint8_t DISC = 0x43;
+static const uint8_t UIH = 0xEF;
+static const uint8_t UI = 0x03;
+static const uint8_t PF = 0x10;
+
+static uint8_t crc8(const std::vector<uint8_t> &data)
+{
+    uint8_t crc = 0xFF;
+
+    for (uint8_t byte : data) {
+        crc ^= byte;
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 1) ? (crc >> 1) ^ 0xE0 : crc >> 1;
+        }
+    }
+
+    return crc;
+}
+
+/**
+ * @brief Arma una trama como la enviaría el modem (respuesta, C/R = 0).
+ */
+static std::string make_frame(
+    uint8_t dlci,
+    uint8_t control,
+    std::string_view info,
+    bool fcs_over_info,
+    bool is_command = false)
+{
+    std::vector<uint8_t> header;
+    header.push_back((dlci << 2) | (is_command ? 0x02 : 0) | 0x01);
+    header.push_back(control);
+
+    if (info.length() < 128) {
+        header.push_back((info.length() << 1) | 0x01);
+    } else {
+        header.push_back((info.length() & 0x7F) << 1);
+        header.push_back(info.length() >> 7);
+    }
+
+    std::vector<uint8_t> covered = header;
+    if (fcs_over_info) covered.insert(covered.end(), info.begin(), info.end());
+
+    std::string frame(1, (char)FLAG);
+    frame.append(header.begin(), header.end());
+    frame.append(info);
+    frame.push_back((char)(0xFF - crc8(covered)));
+    frame.push_back((char)FLAG);
+    return frame;
+}
+
+struct cmux_fixture_t
+{
+    SIM7000_CMux cmux;
+    std::vector<std::string> written;
+    std::string received[CMUX_MAX_CHANNELS];
+    // responde UA a cada SABM y DISC, y confirma CLD, como el modem
+    bool auto_answer;
+
+    cmux_fixture_t() : cmux{write, this}, auto_answer{true}
+    {
+        for (uint8_t dlci = 0; dlci < CMUX_MAX_CHANNELS; dlci++) {
+            cmux.set_receiver(dlci, receive, &received[dlci]);
+        }
+    }
+
+    void feed(const std::string &data)
+    {
+        cmux.feed(data.data(), data.length());
+    }
+
+    static int write(void *ctx, const char *data, size_t length)
+    {
+        auto fixture = static_cast<cmux_fixture_t *>(ctx);
+        std::string frame(data, length);
+        fixture->written.push_back(frame);
+
+        uint8_t dlci = (uint8_t)frame[1] >> 2;
+        uint8_t control = frame[2] & ~PF;
+        if (!fixture->auto_answer) return length;
+
+        if (control == SABM || control == DISC) {
+            fixture->feed(make_frame(dlci, UA | PF, "", true));
+        } else if (dlci == CMUX_CONTROL_CHANNEL && (uint8_t)frame[4] == 0xC3) {
+            const char cld_response[] = { (char)0xC1, 0x01 };
+            fixture->feed(make_frame(dlci, UIH, std::string_view(cld_response, 2), false));
+        }
+
+        return length;
+    }
+
+    static void receive(void *ctx, const char *data, size_t length)
+    {
+        static_cast<std::string *>(ctx)->append(data, length);
+    }
+};
+
+static void open_channels(cmux_fixture_t &fixture)
+{
+    CHECK(fixture.cmux.open(CMUX_CONTROL_CHANNEL) == ESP_OK);
+    CHECK(fixture.cmux.open(CMUX_AT_CHANNEL) == ESP_OK);
+    fixture.written.clear();
+}
+
+static void test_open()
+{
+    cmux_fixture_t fixture;
+
+    // los canales de datos requieren el de control
+    CHECK(fixture.cmux.open(CMUX_AT_CHANNEL) == ESP_ERR_INVALID_STATE);
+    CHECK(fixture.cmux.open(CMUX_CONTROL_CHANNEL) == ESP_OK);
+    CHECK(fixture.cmux.is_open(CMUX_CONTROL_CHANNEL));
+
+    // SABM con P/F en el canal de control, FCS sobre el encabezado
+    CHECK(fixture.written.size() == 1);
+    CHECK(fixture.written[0] == make_frame(0, SABM | PF, "", true, true));
+
+    // sin respuesta del modem se agota el tiempo
+    fixture.auto_answer = false;
+    CHECK(fixture.cmux.open(CMUX_PPP_CHANNEL, 1) == ESP_ERR_TIMEOUT);
+    CHECK(!fixture.cmux.is_open(CMUX_PPP_CHANNEL));
+}
+
+static void test_uih_fcs()
+{
+    cmux_fixture_t fixture;
+    open_channels(fixture);
+
+    // el FCS de UIH solo cubre el encabezado
+    fixture.feed(make_frame(CMUX_AT_CHANNEL, UIH, "\r\nOK\r\n", false));
+    CHECK(fixture.received[CMUX_AT_CHANNEL] == "\r\nOK\r\n");
+    CHECK(fixture.cmux.get_dropped_frames() == 0);
+
+    // un FCS calculado también sobre la información no es válido en UIH
+    fixture.received[CMUX_AT_CHANNEL].clear();
+    fixture.feed(make_frame(CMUX_AT_CHANNEL, UIH, "AT", true));
+    CHECK(fixture.received[CMUX_AT_CHANNEL].empty());
+    CHECK(fixture.cmux.get_dropped_frames() == 1);
+
+    // escribir divide los datos en tramas UIH de CMUX_MAX_FRAME_SIZE
+    std::string data(CMUX_MAX_FRAME_SIZE + 10, 'x');
+    CHECK(fixture.cmux.write(CMUX_AT_CHANNEL, data.data(), data.length()) == (int)data.length());
+    CHECK(fixture.written.size() == 2);
+    CHECK(fixture.written[0] == make_frame(CMUX_AT_CHANNEL, UIH, data.substr(0, CMUX_MAX_FRAME_SIZE), false, true));
+    CHECK(fixture.written[1] == make_frame(CMUX_AT_CHANNEL, UIH, data.substr(CMUX_MAX_FRAME_SIZE), false, true));
+
+    // un canal cerrado no acepta escrituras
+    CHECK(fixture.cmux.write(CMUX_NMEA_CHANNEL, "x", 1) == -1);
+}
+
+static void test_ui_fcs()
+{
+    cmux_fixture_t fixture;
+    open_channels(fixture);
+
+    // el FCS de UI cubre también la información
+    fixture.feed(make_frame(CMUX_AT_CHANNEL, UI, "RDY", true));
+    CHECK(fixture.received[CMUX_AT_CHANNEL] == "RDY");
+    CHECK(fixture.cmux.get_dropped_frames() == 0);
+
+    // si solo cubre el encabezado, la información no está protegida
+    fixture.received[CMUX_AT_CHANNEL].clear();
+    fixture.feed(make_frame(CMUX_AT_CHANNEL, UI, "RDY", false));
+    CHECK(fixture.received[CMUX_AT_CHANNEL].empty());
+    CHECK(fixture.cmux.get_dropped_frames() == 1);
+
+    // un byte alterado en la información se detecta
+    std::string frame = make_frame(CMUX_AT_CHANNEL, UI, "RDY", true);
+    frame[5] ^= 0x01;
+    fixture.feed(frame);
+    CHECK(fixture.received[CMUX_AT_CHANNEL].empty());
+    CHECK(fixture.cmux.get_dropped_frames() == 2);
+}
+
+static void test_length_extension()
+{
+    cmux_fixture_t fixture;
+    open_channels(fixture);
+
+    // más de 127 bytes requieren el segundo byte de longitud
+    std::string info(200, '\0');
+    for (size_t i = 0; i < info.length(); i++) info[i] = (char)i;
+
+    fixture.feed(make_frame(CMUX_PPP_CHANNEL, UIH, info, false));
+    // el canal PPP no está abierto, pero la recepción no depende de ello
+    CHECK(fixture.received[CMUX_PPP_CHANNEL] == info);
+    CHECK(fixture.cmux.get_dropped_frames() == 0);
+
+    // las que exceden CMUX_MAX_RX_FRAME_SIZE se descartan
+    std::string too_long(CMUX_MAX_RX_FRAME_SIZE + 1, 'x');
+    fixture.feed(make_frame(CMUX_AT_CHANNEL, UIH, too_long, false));
+    CHECK(fixture.received[CMUX_AT_CHANNEL].empty());
+    CHECK(fixture.cmux.get_dropped_frames() == 1);
+
+    // y la siguiente trama se recibe de nuevo
+    fixture.feed(make_frame(CMUX_AT_CHANNEL, UIH, "OK", false));
+    CHECK(fixture.received[CMUX_AT_CHANNEL] == "OK");
+}
+
+static void test_flag_resync()
+{
+    cmux_fixture_t fixture;
+    open_channels(fixture);
+
+    // basura después de una trama y delimitadores repetidos: la basura se
+    // descarta como una trama inválida
+    fixture.feed("garbage\xF9\xF9\xF9");
+    fixture.feed(make_frame(CMUX_AT_CHANNEL, UIH, "A", false).substr(1));
+    CHECK(fixture.received[CMUX_AT_CHANNEL] == "A");
+    CHECK(fixture.cmux.get_dropped_frames() == 1);
+
+    // el delimitador final de una trama es el inicial de la siguiente
+    std::string first = make_frame(CMUX_AT_CHANNEL, UIH, "B", false);
+    std::string second = make_frame(CMUX_AT_CHANNEL, UIH, "C", false);
+    fixture.feed(first + second.substr(1));
+    CHECK(fixture.received[CMUX_AT_CHANNEL] == "ABC");
+
+    // una trama sin delimitador final se descarta y la recepción se
+    // resincroniza con el siguiente delimitador
+    std::string broken = make_frame(CMUX_AT_CHANNEL, UIH, "X", false);
+    broken.back() = 'Z';
+    fixture.feed(broken);
+    CHECK(fixture.cmux.get_dropped_frames() == 2);
+    fixture.feed(make_frame(CMUX_AT_CHANNEL, UIH, "D", false));
+    CHECK(fixture.received[CMUX_AT_CHANNEL] == "ABCD");
+
+    // una trama entregada byte por byte
+    std::string frame = make_frame(CMUX_AT_CHANNEL, UIH, "E", false);
+    for (char byte : frame) fixture.cmux.feed(&byte, 1);
+    CHECK(fixture.received[CMUX_AT_CHANNEL] == "ABCDE");
+}
+
+static void test_control_channel()
+{
+    cmux_fixture_t fixture;
+    open_channels(fixture);
+
+    // MSC del modem (comando, C/R = 1): se devuelve como respuesta
+    const char msc_command[] = { (char)0xE3, 0x05, 0x07, 0x0D };
+    const char msc_response[] = { (char)0xE1, 0x05, 0x07, 0x0D };
+    fixture.feed(make_frame(CMUX_CONTROL_CHANNEL, UIH, std::string_view(msc_command, 4), false));
+    CHECK(fixture.written.size() == 1);
+    CHECK(fixture.written[0] == make_frame(CMUX_CONTROL_CHANNEL, UIH, std::string_view(msc_response, 4), false, true));
+
+    // las respuestas del modem no se contestan
+    fixture.written.clear();
+    fixture.feed(make_frame(CMUX_CONTROL_CHANNEL, UIH, std::string_view(msc_response, 4), false));
+    CHECK(fixture.written.empty());
+
+    // el modem cierra un canal con DISC y se confirma con UA
+    fixture.feed(make_frame(CMUX_AT_CHANNEL, DISC | PF, "", true, true));
+    CHECK(!fixture.cmux.is_open(CMUX_AT_CHANNEL));
+    CHECK(fixture.written.size() == 1);
+    CHECK(fixture.written[0] == make_frame(CMUX_AT_CHANNEL, UA | PF, "", true));
+}
+
+static void test_close()
+{
+    cmux_fixture_t fixture;
+    open_channels(fixture);
+
+    // el modem confirma CLD con el mismo mensaje como respuesta
+    CHECK(fixture.cmux.close(1) == ESP_OK);
+
+    // DISC del canal AT y CLD en el de control
+    const char cld_command[] = { (char)0xC3, 0x01 };
+    CHECK(fixture.written.size() == 2);
+    CHECK(fixture.written[0] == make_frame(CMUX_AT_CHANNEL, DISC | PF, "", true, true));
+    CHECK(fixture.written[1] == make_frame(CMUX_CONTROL_CHANNEL, UIH, std::string_view(cld_command, 2), false, true));
+    CHECK(!fixture.cmux.is_open(CMUX_CONTROL_CHANNEL));
+    CHECK(!fixture.cmux.is_open(CMUX_AT_CHANNEL));
+}
+
+int main()
+{
+    test_open();
+    test_uih_fcs();
+    test_ui_fcs();
+    test_length_extension();
+    test_flag_resync();
+    test_control_channel();
+    test_close();
+
+    return host_test::summary("cmux");
+}
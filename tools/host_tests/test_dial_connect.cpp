@@ -0,0 +1,101 @@
+/*
+ * Verifica que el CONNECT que responde a ATD*99# termine el comando de
+ * marcado y cambie a modo de datos, aunque CONNECT también esté en la tabla
+ * de URC, y que los bytes que le siguen se entreguen como datos.
+ */
+
+#include "host_test.hpp"
+#include "test_modem.hpp"
+
+#include <cstring>
+
+using namespace axomotor::lte_modem;
+using namespace axomotor::lte_modem::internal;
+
+static const char DIAL_PARAMS[] = "*99#";
+// inicio de una trama LCP de PPP
+static const char PPP_FRAME[] = "\x7e\xff\x7d\x23\xc0\x21\x7d\x21";
+
+struct command_t
+{
+    sim7000_cmd_context_t context;
+    sim7000_cmd_result_info_t info;
+
+    explicit command_t(at_cmd_t command, const char *params = "")
+    {
+        context.command = command;
+        context.params = std::span<const char>(params, strlen(params));
+        context.result_info = &info;
+    }
+};
+
+static void test_connect_with_data()
+{
+    TestModem modem;
+    command_t dial(at_cmd_t::D, DIAL_PARAMS);
+
+    CHECK(modem.submit_cmd(dial.context) == ESP_OK);
+    CHECK(modem.take_written() == "ATD*99#\r");
+
+    // la respuesta y los primeros datos llegan juntos
+    modem.feed(std::string("\r\nCONNECT 150000000\r\n") + PPP_FRAME);
+
+    CHECK(modem.wait_for_cmd(dial.context) == ESP_OK);
+    CHECK(dial.info.result == at_cmd_result_t::OK);
+    CHECK(modem.urcs.empty());
+    CHECK(modem.data_received == PPP_FRAME);
+
+    // en modo de datos no se aceptan comandos y todo se entrega como datos
+    command_t query(at_cmd_t::CSQ);
+    CHECK(modem.submit_cmd(query.context) == ESP_ERR_INVALID_STATE);
+    modem.feed("\r\nOK\r\n");
+    CHECK(modem.data_received == std::string(PPP_FRAME) + "\r\nOK\r\n");
+
+    // al volver a modo de comandos, CONNECT fuera de una llamada es un URC
+    modem.leave_data_mode();
+    modem.feed("\r\nCONNECT\r\n");
+    CHECK(modem.urcs.size() == 1 && modem.urcs[0] == "CONNECT");
+}
+
+static void test_connect_split()
+{
+    TestModem modem;
+    command_t dial(at_cmd_t::D, DIAL_PARAMS);
+
+    CHECK(modem.submit_cmd(dial.context) == ESP_OK);
+
+    modem.feed("\r\nCONN");
+    CHECK(modem.poll_cmd(dial.context) == ESP_ERR_NOT_FINISHED);
+    modem.feed("ECT\r\n");
+    CHECK(modem.wait_for_cmd(dial.context) == ESP_OK);
+    CHECK(modem.urcs.empty());
+
+    modem.feed(PPP_FRAME);
+    CHECK(modem.data_received == PPP_FRAME);
+}
+
+static void test_no_carrier()
+{
+    TestModem modem;
+    command_t dial(at_cmd_t::D, DIAL_PARAMS);
+
+    CHECK(modem.submit_cmd(dial.context) == ESP_OK);
+    modem.feed("\r\nNO CARRIER\r\n");
+    CHECK(modem.wait_for_cmd(dial.context) == ESP_FAIL);
+
+    // sigue en modo de comandos
+    command_t query(at_cmd_t::CSQ);
+    CHECK(modem.submit_cmd(query.context) == ESP_OK);
+    modem.feed("\r\n+CSQ: 20,99\r\n\r\nOK\r\n");
+    CHECK(modem.wait_for_cmd(query.context) == ESP_OK);
+    CHECK(modem.data_received.empty());
+}
+
+int main()
+{
+    test_connect_with_data();
+    test_connect_split();
+    test_no_carrier();
+
+    return host_test::summary("dial_connect");
+}
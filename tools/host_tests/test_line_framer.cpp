@@ -0,0 +1,286 @@
+/*
+ * Pruebas de SIM7000_LineFramer y del indicador "> " del parser, y medición
+ * del costo por línea frente al buffer std::string que se usaba antes.
+ */
+
+#include "host_test.hpp"
+#include "test_modem.hpp"
+
+#include <sim7000_line_framer.hpp>
+
+#include <cstring>
+#include <string>
+
+using namespace axomotor::lte_modem;
+using namespace axomotor::lte_modem::internal;
+
+static void write_all(SIM7000_LineFramer &framer, std::string_view data)
+{
+    CHECK(framer.write(data.data(), data.length()) == data.length());
+}
+
+static std::string next(SIM7000_LineFramer &framer)
+{
+    std::string_view line;
+    if (!framer.next_line(line)) return "<none>";
+    return std::string(line);
+}
+
+static void test_capacity()
+{
+    SIM7000_LineFramer small(5);
+    SIM7000_LineFramer odd(100);
+
+    // mínimo de 16 bytes y potencias de 2
+    CHECK(small.capacity() == 16);
+    CHECK(odd.capacity() == 128);
+}
+
+static void test_partial_lines()
+{
+    SIM7000_LineFramer framer(64);
+
+    write_all(framer, "+CSQ: 2");
+    CHECK_EQ_STR(next(framer), "<none>");
+    write_all(framer, "0,99\r\nOK\r");
+    CHECK_EQ_STR(next(framer), "+CSQ: 20,99");
+    // el CR sin LF no termina la línea
+    CHECK_EQ_STR(next(framer), "<none>");
+    write_all(framer, "\n");
+    CHECK_EQ_STR(next(framer), "OK");
+    CHECK(framer.is_empty());
+}
+
+static void test_empty_lines()
+{
+    SIM7000_LineFramer framer(64);
+
+    write_all(framer, "\r\n\r\nOK\r\n");
+    CHECK_EQ_STR(next(framer), "");
+    CHECK_EQ_STR(next(framer), "");
+    CHECK_EQ_STR(next(framer), "OK");
+    CHECK_EQ_STR(next(framer), "<none>");
+}
+
+static void test_bare_cr_lf()
+{
+    SIM7000_LineFramer framer(64);
+
+    // solo la secuencia CRLF separa líneas
+    write_all(framer, "A\rB\nC\n\r\r\n");
+    CHECK_EQ_STR(next(framer), "A\rB\nC\n\r");
+    CHECK(framer.is_empty());
+
+    // LF seguido de CR tampoco es un fin de línea
+    write_all(framer, "X\n\rY\r\n");
+    CHECK_EQ_STR(next(framer), "X\n\rY");
+}
+
+static void test_wrapped_lines()
+{
+    SIM7000_LineFramer framer(16);
+    std::string_view line;
+
+    // deja el inicio de los datos cerca del final físico del buffer
+    write_all(framer, "0123456789");
+    framer.discard(10);
+    write_all(framer, "ab");
+    framer.discard(0);
+
+    // la línea cruza el final del buffer y se entrega contigua
+    write_all(framer, "cdefghijkl\r\n");
+    CHECK(framer.next_line(line));
+    CHECK_EQ_STR(line, "abcdefghijkl");
+    CHECK(framer.is_empty());
+
+    // CR en la última posición física y LF en la primera
+    SIM7000_LineFramer split(16);
+    write_all(split, "0123456789abcd");
+    split.discard(14);
+    write_all(split, "Z\r\nW\r\n");
+    CHECK_EQ_STR(next(split), "Z");
+    CHECK_EQ_STR(next(split), "W");
+
+    // la ventana de escritura termina en el final físico del buffer
+    SIM7000_LineFramer window(16);
+    write_all(window, "0123456789");
+    window.discard(8);
+    CHECK(window.get_write_window().size() == 6);
+    window.commit(6);
+    CHECK(window.get_write_window().size() == 8);
+}
+
+static void test_line_longer_than_buffer()
+{
+    SIM7000_LineFramer framer(16);
+    std::string long_line(40, 'x');
+
+    // solo cabe lo que permite la capacidad
+    CHECK(framer.write(long_line.data(), long_line.length()) == 16);
+    CHECK(framer.is_full());
+
+    // sin fin de línea, el contenido se entrega completo para no bloquearse
+    CHECK_EQ_STR(next(framer), std::string(16, 'x'));
+    CHECK(framer.is_empty());
+
+    write_all(framer, "xxxx\r\n");
+    CHECK_EQ_STR(next(framer), "xxxx");
+
+    // el parser recibe la línea en fragmentos del tamaño del buffer, pero
+    // no pierde datos ni el código de resultado
+    const std::string_view response = "+CGNSINF: 1,1,20240101000000.000,19.432608,-99.133209";
+    TestModem modem(16);
+    sim7000_cmd_result_info_t result;
+    sim7000_cmd_context_t context;
+    context.command = at_cmd_t::CGNSINF;
+    context.result_info = &result;
+
+    CHECK(modem.submit_cmd(context, 1000) == ESP_OK);
+    modem.feed("\r\n");
+    modem.feed(response);
+    modem.feed("\r\n\r\nOK\r\n");
+    CHECK(modem.wait_for_cmd(context) == ESP_OK);
+
+    std::string joined;
+    for (char c : result.response) {
+        if (c != '\r' && c != '\n') joined += c;
+    }
+    CHECK_EQ_STR(joined, response);
+}
+
+static void test_prompt()
+{
+    SIM7000_LineFramer framer(32);
+
+    // el indicador no termina en CRLF
+    write_all(framer, "> ");
+    CHECK(framer.starts_with("> "));
+    CHECK_EQ_STR(next(framer), "<none>");
+
+    TestModem modem;
+    const char payload[] = "{\"ok\":1}";
+    const char params[] = "=\"t\",8,1,0";
+    sim7000_cmd_result_info_t result;
+    sim7000_cmd_context_t context;
+    context.command = at_cmd_t::SMPUB;
+    context.params = std::span<const char>(params, strlen(params));
+    context.payload = std::span<const char>(payload, strlen(payload));
+    context.send_payload = true;
+    context.result_info = &result;
+
+    CHECK(modem.submit_cmd(context, 1000) == ESP_OK);
+    CHECK_EQ_STR(modem.take_written(), "AT+SMPUB=\"t\",8,1,0\r");
+
+    // el indicador llega en dos partes
+    modem.feed("\r\n>");
+    CHECK_EQ_STR(modem.take_written(), "");
+    modem.feed(" ");
+    CHECK_EQ_STR(modem.take_written(), "{\"ok\":1}\r");
+    CHECK(context.payload_sent);
+
+    modem.feed("\r\nOK\r\n");
+    CHECK(modem.wait_for_cmd(context) == ESP_OK);
+
+    // sin carga útil pendiente, "> " forma parte de la respuesta
+    sim7000_cmd_context_t plain;
+    plain.command = at_cmd_t::CGMM;
+    plain.result_info = &result;
+
+    CHECK(modem.submit_cmd(plain, 1000) == ESP_OK);
+    modem.feed("\r\n> SIMCOM_SIM7000G\r\n\r\nOK\r\n");
+    CHECK(modem.wait_for_cmd(plain) == ESP_OK);
+    CHECK_EQ_STR(result.response, "> SIMCOM_SIM7000G");
+    CHECK_EQ_STR(modem.take_written(), "AT+CGMM\r");
+}
+
+/* Medición */
+
+// respuesta típica: un URC de GNSS y una consulta de señal
+static const char STREAM[] =
+    "\r\n+UGNSINF: 1,1,20240101120000.000,19.432608,-99.133209,2240.0,0.00,0.0,1,,1.1,1.4,0.9,,12,9,,,38,,\r\n"
+    "\r\n+CSQ: 20,99\r\n\r\nOK\r\n";
+
+// parser anterior: std::string con find() y erase() desde el inicio
+static size_t parse_with_string(std::string &buffer, const char *data, size_t length)
+{
+    size_t lines = 0;
+    size_t position;
+
+    buffer.append(data, length);
+    while ((position = buffer.find("\r\n")) != std::string::npos) {
+        std::string line = buffer.substr(0, position);
+        buffer.erase(0, position + 2);
+        if (!line.empty()) lines++;
+        host_test::keep(line);
+    }
+
+    return lines;
+}
+
+static size_t parse_with_framer(SIM7000_LineFramer &framer, const char *data, size_t length)
+{
+    std::string_view line;
+    size_t lines = 0;
+
+    while (length > 0) {
+        size_t written = framer.write(data, length);
+        data += written;
+        length -= written;
+
+        while (framer.next_line(line)) {
+            if (!line.empty()) lines++;
+            host_test::keep(line);
+        }
+    }
+
+    return lines;
+}
+
+static void benchmark()
+{
+    const size_t iterations = 200000;
+    const size_t length = sizeof(STREAM) - 1;
+
+    // la UART entrega los datos en fragmentos de tamaño variable
+    for (size_t chunk : {8UL, 32UL, length}) {
+        SIM7000_LineFramer framer(1024);
+        std::string buffer;
+        size_t framer_lines = 0;
+        size_t string_lines = 0;
+
+        double framer_ns = host_test::measure_ns(iterations, [&](size_t) {
+            for (size_t offset = 0; offset < length; offset += chunk) {
+                framer_lines += parse_with_framer(framer, STREAM + offset, std::min(chunk, length - offset));
+            }
+        });
+
+        double string_ns = host_test::measure_ns(iterations, [&](size_t) {
+            for (size_t offset = 0; offset < length; offset += chunk) {
+                string_lines += parse_with_string(buffer, STREAM + offset, std::min(chunk, length - offset));
+            }
+        });
+
+        CHECK(framer_lines == iterations * 3);
+        CHECK(string_lines == framer_lines);
+
+        printf(
+            "chunk %3zu B: framer %6.1f ns/line, std::string %6.1f ns/line\n",
+            chunk,
+            framer_ns / 3,
+            string_ns / 3);
+    }
+}
+
+int main()
+{
+    test_capacity();
+    test_partial_lines();
+    test_empty_lines();
+    test_bare_cr_lf();
+    test_wrapped_lines();
+    test_line_longer_than_buffer();
+    test_prompt();
+    benchmark();
+
+    return host_test::summary("line_framer");
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+/*
+ * SIM7000_BasicModem sin UART: guarda lo que el modem escribe y permite
+ * inyectar las respuestas desde la prueba con feed(). Los comandos se envían
+ * con submit_cmd() y se esperan con wait_for_cmd() para controlar el orden
+ * de los bytes sin depender de otros hilos.
+ */
+
+#include <sim7000_basic_modem.hpp>
+
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class TestModem : public axomotor::lte_modem::SIM7000_BasicModem
+{
+public:
+    explicit TestModem(size_t buffer_size = 1024) : SIM7000_BasicModem(buffer_size)
+    {
+        m_is_running = true;
+    }
+
+    void feed(std::string_view data)
+    {
+        feed_buffer(data.data(), data.length());
+    }
+
+    /**
+     * @brief Devuelve lo escrito al modem desde la última llamada.
+     */
+    std::string take_written()
+    {
+        std::lock_guard lock(m_mutex);
+        std::string written = std::move(m_written);
+        m_written.clear();
+        return written;
+    }
+
+    /**
+     * @brief Descarta lo escrito al modem conservando la memoria del buffer.
+     */
+    void clear_written()
+    {
+        std::lock_guard lock(m_mutex);
+        m_written.clear();
+    }
+
+    std::vector<std::string> urcs;
+    std::string data_received;
+    uint32_t timeouts = 0;
+
+    using SIM7000_BasicModem::leave_data_mode;
+
+protected:
+    void on_urc_message(std::string_view line, const axomotor::lte_modem::internal::urc_def_t &) override
+    {
+        urcs.emplace_back(line);
+    }
+
+    int on_cmd_write(const char *data, size_t length) override
+    {
+        std::lock_guard lock(m_mutex);
+        m_written.append(data, length);
+        return length;
+    }
+
+    void on_data_received(const char *data, size_t length) override
+    {
+        data_received.append(data, length);
+    }
+
+    void on_cmd_timeout(uint32_t consecutive_timeouts) override
+    {
+        timeouts = consecutive_timeouts;
+    }
+
+private:
+    std::mutex m_mutex;
+    std::string m_written;
+};
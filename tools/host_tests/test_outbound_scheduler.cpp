@@ -0,0 +1,280 @@
+/*
+ * Pruebas de OutboundScheduler: prioridad estricta de los eventos de
+ * seguridad (sin límite de envíos y sin rechazos), intercalado del round
+ * robin ponderado, recarga de los token buckets con get_ticks_to_ready() y
+ * descarte del más antiguo frente al rechazo del nuevo al llenarse una clase.
+ *
+ * El tiempo se adelanta con host_advance_ticks() en lugar de esperar.
+ */
+
+#include "host_test.hpp"
+
+#include <constants/general.hpp>
+#include <events/outbound_scheduler.hpp>
+#include <freertos/task.h>
+
+#include <string>
+
+using namespace axomotor::constants::general;
+using namespace axomotor::events;
+
+// un minuto recarga todas las clases hasta su ráfaga
+static const TickType_t FULL_REFILL_TICKS = 60 * configTICK_RATE_HZ;
+
+static queued_event_t make_device(event_code_t code, time_t timestamp = 0)
+{
+    queued_event_t event{};
+    event.type = event_type_t::DEVICE;
+    event.device = { timestamp, code };
+    return event;
+}
+
+static queued_event_t make_position(time_t timestamp)
+{
+    queued_event_t event{};
+    event.type = event_type_t::POSITION;
+    event.position = { timestamp, 19.43f, -99.13f, 0.0f, 0.0f };
+    return event;
+}
+
+static queued_event_t make_ping(uint64_t ping_timestamp)
+{
+    queued_event_t event{};
+    event.type = event_type_t::SERVER_PING;
+    event.ping = { ping_timestamp, 0 };
+    return event;
+}
+
+static queued_event_t make_panic(time_t timestamp = 0)
+{
+    return make_device(event_code_t::PANIC_BUTTON_PRESSED, timestamp);
+}
+
+static char get_class_letter(const queued_event_t &event)
+{
+    switch (OutboundScheduler::classify(event))
+    {
+        case traffic_class_t::SAFETY: return 'S';
+        case traffic_class_t::DEVICE: return 'D';
+        case traffic_class_t::PING: return 'P';
+        case traffic_class_t::POSITION: return 'L';
+        default: return 'B';
+    }
+}
+
+static void test_classify()
+{
+    CHECK(OutboundScheduler::classify(make_panic()) == traffic_class_t::SAFETY);
+    CHECK(OutboundScheduler::classify(make_device(event_code_t::IMPACT_DETECTED)) ==
+        traffic_class_t::SAFETY);
+    CHECK(OutboundScheduler::classify(make_device(event_code_t::HARSH_BRAKING)) ==
+        traffic_class_t::DEVICE);
+    CHECK(OutboundScheduler::classify(make_ping(1)) == traffic_class_t::PING);
+    CHECK(OutboundScheduler::classify(make_position(1)) == traffic_class_t::POSITION);
+}
+
+static void test_safety_precedence()
+{
+    OutboundScheduler scheduler;
+    queued_event_t event;
+
+    CHECK(scheduler.enqueue(make_position(1)));
+    CHECK(scheduler.enqueue(make_device(event_code_t::HARSH_BRAKING)));
+    CHECK(scheduler.enqueue(make_ping(1)));
+    CHECK(scheduler.enqueue(make_panic(1)));
+    CHECK(scheduler.enqueue(make_device(event_code_t::IMPACT_DETECTED, 2)));
+
+    // salen antes que las demás clases aunque llegaron después
+    CHECK(scheduler.dequeue(event));
+    CHECK(event.device.code == event_code_t::PANIC_BUTTON_PRESSED);
+    CHECK(scheduler.dequeue(event));
+    CHECK(event.device.code == event_code_t::IMPACT_DETECTED);
+
+    CHECK(scheduler.dequeue(event));
+    CHECK(get_class_letter(event) != 'S');
+    CHECK(scheduler.count_pending() == 2);
+
+    // un evento de seguridad que llega después también pasa primero
+    CHECK(scheduler.enqueue(make_panic(3)));
+    CHECK(scheduler.dequeue(event));
+    CHECK(event.device.code == event_code_t::PANIC_BUTTON_PRESSED);
+    CHECK(event.device.timestamp == 3);
+}
+
+static void test_safety_is_not_limited()
+{
+    OutboundScheduler scheduler;
+    queued_event_t event;
+    int sent = 0;
+
+    // tres veces la capacidad de la clase sin que pase el tiempo
+    for (int round = 0; round < 3; round++) {
+        for (size_t i = 0; i < DEVICE_EVENTS_QUEUE_LENGTH; i++) {
+            CHECK(scheduler.enqueue(make_panic()));
+        }
+
+        CHECK(scheduler.get_ticks_to_ready() == 0);
+        while (scheduler.dequeue(event)) sent++;
+    }
+
+    CHECK(sent == 3 * (int)DEVICE_EVENTS_QUEUE_LENGTH);
+    CHECK(scheduler.get_stats(traffic_class_t::SAFETY).sent == (uint32_t)sent);
+
+    // llena, descarta el más antiguo y acepta el nuevo
+    for (size_t i = 0; i < DEVICE_EVENTS_QUEUE_LENGTH + 2; i++) {
+        CHECK(scheduler.enqueue(make_panic(i)));
+    }
+
+    CHECK(scheduler.get_stats(traffic_class_t::SAFETY).dropped == 2);
+    CHECK(scheduler.dequeue(event));
+    CHECK(event.device.timestamp == 2);
+}
+
+static void test_weighted_interleave()
+{
+    OutboundScheduler scheduler;
+    queued_event_t event;
+    std::string order;
+
+    // la clase BULK está reservada y no acepta eventos
+    queued_event_t bulk{};
+    bulk.type = event_type_t::NETWORK;
+    CHECK(!scheduler.enqueue(bulk));
+
+    CHECK(scheduler.enqueue(make_device(event_code_t::HARSH_BRAKING)));
+    CHECK(scheduler.enqueue(make_ping(1)));
+    CHECK(scheduler.enqueue(make_position(1)));
+
+    // mantiene las tres clases con eventos y sus buckets llenos para que
+    // solo influyan los pesos (4, 2 y 1)
+    for (int i = 0; i < 14; i++) {
+        CHECK(scheduler.dequeue(event));
+        order.push_back(get_class_letter(event));
+
+        switch (get_class_letter(event))
+        {
+            case 'D': scheduler.enqueue(make_device(event_code_t::HARSH_BRAKING)); break;
+            case 'P': scheduler.enqueue(make_ping(1)); break;
+            case 'L': scheduler.enqueue(make_position(1)); break;
+        }
+
+        host_advance_ticks(FULL_REFILL_TICKS);
+    }
+
+    // intercalado, no en bloque
+    CHECK_EQ_STR(order, "DPDLDPDDPDLDPD");
+}
+
+static void test_token_refill()
+{
+    OutboundScheduler scheduler;
+    queued_event_t event;
+
+    CHECK(scheduler.get_ticks_to_ready() == portMAX_DELAY);
+
+    // DEVICE: ráfaga de 5 y 20 envíos por minuto
+    for (int i = 0; i < 6; i++) {
+        CHECK(scheduler.enqueue(make_device(event_code_t::HARSH_BRAKING, i)));
+    }
+
+    for (int i = 0; i < 5; i++) {
+        CHECK(scheduler.dequeue(event));
+        CHECK(event.device.timestamp == i);
+    }
+
+    CHECK(!scheduler.dequeue(event));
+
+    // un envío cada 3 s; el tiempo real transcurrido recarga unos ticks
+    TickType_t ticks = scheduler.get_ticks_to_ready();
+    CHECK(ticks <= 3000 && ticks > 2900);
+
+    host_advance_ticks(ticks - 1);
+    CHECK(!scheduler.dequeue(event));
+    CHECK(scheduler.get_ticks_to_ready() <= 1);
+
+    host_advance_ticks(1);
+    CHECK(scheduler.get_ticks_to_ready() == 0);
+    CHECK(scheduler.dequeue(event));
+    CHECK(event.device.timestamp == 5);
+
+    // la recarga no pasa de la ráfaga
+    host_advance_ticks(10 * FULL_REFILL_TICKS);
+    for (int i = 0; i < 6; i++) {
+        CHECK(scheduler.enqueue(make_device(event_code_t::HARSH_BRAKING)));
+    }
+
+    int sent = 0;
+    while (scheduler.dequeue(event)) sent++;
+    CHECK(sent == 5);
+
+    // con DEVICE esperando 3 s, la espera la determina POSITION, que
+    // recarga un envío por segundo
+    for (size_t i = 0; i <= POSITION_BATCH_SIZE; i++) {
+        CHECK(scheduler.enqueue(make_position(i)));
+    }
+
+    for (size_t i = 0; i < POSITION_BATCH_SIZE; i++) {
+        CHECK(scheduler.dequeue(event));
+        CHECK(get_class_letter(event) == 'L');
+    }
+
+    CHECK(!scheduler.dequeue(event));
+    ticks = scheduler.get_ticks_to_ready();
+    CHECK(ticks <= 1000 && ticks > 900);
+}
+
+static void test_drop_policy()
+{
+    OutboundScheduler scheduler;
+    queued_event_t event;
+
+    // DEVICE rechaza el evento nuevo
+    for (size_t i = 0; i < DEVICE_EVENTS_QUEUE_LENGTH; i++) {
+        CHECK(scheduler.enqueue(make_device(event_code_t::HARSH_BRAKING, i)));
+    }
+    CHECK(!scheduler.enqueue(make_device(event_code_t::HARSH_BRAKING, 100)));
+    CHECK(scheduler.get_stats(traffic_class_t::DEVICE).dropped == 1);
+
+    // POSITION descarta la más antigua
+    for (size_t i = 0; i < POSITION_EVENTS_QUEUE_LENGTH + 3; i++) {
+        CHECK(scheduler.enqueue(make_position(i)));
+    }
+    CHECK(scheduler.get_stats(traffic_class_t::POSITION).dropped == 3);
+
+    // PING solo conserva la última respuesta
+    CHECK(scheduler.enqueue(make_ping(1)));
+    CHECK(scheduler.enqueue(make_ping(2)));
+    CHECK(scheduler.get_stats(traffic_class_t::PING).dropped == 1);
+
+    CHECK(scheduler.count_pending() ==
+        DEVICE_EVENTS_QUEUE_LENGTH + POSITION_EVENTS_QUEUE_LENGTH + 1);
+
+    time_t first_device = -1, first_position = -1;
+    uint64_t ping = 0;
+
+    while (scheduler.dequeue(event)) {
+        if (get_class_letter(event) == 'D' && first_device < 0) {
+            first_device = event.device.timestamp;
+        } else if (get_class_letter(event) == 'L' && first_position < 0) {
+            first_position = event.position.timestamp;
+        } else if (get_class_letter(event) == 'P') {
+            ping = event.ping.ping_timestamp;
+        }
+    }
+
+    CHECK(first_device == 0);
+    CHECK(first_position == 3);
+    CHECK(ping == 2);
+}
+
+int main()
+{
+    test_classify();
+    test_safety_precedence();
+    test_safety_is_not_limited();
+    test_weighted_interleave();
+    test_token_refill();
+    test_drop_policy();
+
+    return host_test::summary("outbound_scheduler");
+}
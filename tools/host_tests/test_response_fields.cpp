@@ -0,0 +1,247 @@
+/*
+ * Pruebas de SIM7000_ResponseFields: prefijo del comando, campos entre
+ * comillas con delimitadores, campos vacíos y campos faltantes. Incluye una
+ * medición contra el parseo anterior de CGNSINF, que copiaba la respuesta a
+ * un std::string y llamaba a extract_token() por cada campo.
+ */
+
+#include "host_test.hpp"
+
+#include <sim7000_helpers.hpp>
+#include <sim7000_response_fields.hpp>
+
+#include <cmath>
+#include <string>
+
+using namespace axomotor::lte_modem;
+using namespace axomotor::lte_modem::helpers;
+
+static const char CGNSINF[] =
+    "+CGNSINF: 1,1,20240101120000.000,19.432608,-99.133209,2240.000,42.50,271.3,1,,1.2,1.5,0.9,,12,9,,,35,,";
+
+static void test_prefix()
+{
+    SIM7000_ResponseFields fields("+CSQ: 20,99");
+    CHECK(fields.size() == 2);
+    CHECK(fields.get_int(0) == 20);
+    CHECK(fields.get_int(1) == 99);
+
+    // sin prefijo se separa toda la línea
+    fields.split("20,99");
+    CHECK(fields.size() == 2);
+    CHECK_EQ_STR(fields[0], "20");
+
+    // un '+' sin ": " no es un prefijo
+    fields.split("+12,34");
+    CHECK(fields.size() == 2);
+    CHECK_EQ_STR(fields[0], "+12");
+
+    // prefijo sin campos
+    fields.split("+CSQ: ");
+    CHECK(fields.size() == 0);
+    fields.split("");
+    CHECK(fields.size() == 0);
+}
+
+static void test_quoted()
+{
+    SIM7000_ResponseFields fields("+SMSUB: \"axomotor/a,b\",\"payload, with, commas\"");
+    CHECK(fields.size() == 2);
+    CHECK_EQ_STR(fields[0], "axomotor/a,b");
+    CHECK_EQ_STR(fields[1], "payload, with, commas");
+
+    // campo entre comillas en medio y vacío
+    fields.split("+CGDCONT: 1,\"IP\",\"\",\"0.0.0.0\",0");
+    CHECK(fields.size() == 5);
+    CHECK_EQ_STR(fields[1], "IP");
+    CHECK(fields.is_empty(2));
+    CHECK_EQ_STR(fields[3], "0.0.0.0");
+    CHECK(fields.get_int(4, -1) == 0);
+
+    // lo que sigue a la comilla de cierre se descarta hasta el delimitador
+    fields.split("\"a\"x,b");
+    CHECK(fields.size() == 2);
+    CHECK_EQ_STR(fields[0], "a");
+    CHECK_EQ_STR(fields[1], "b");
+
+    // comilla sin cerrar: el campo llega hasta el final
+    fields.split("1,\"abc,def");
+    CHECK(fields.size() == 2);
+    CHECK_EQ_STR(fields[1], "abc,def");
+}
+
+static void test_empty_fields()
+{
+    SIM7000_ResponseFields fields("1,,3,,");
+    CHECK(fields.size() == 5);
+    CHECK_EQ_STR(fields[0], "1");
+    CHECK(fields.is_empty(1));
+    CHECK_EQ_STR(fields[2], "3");
+    CHECK(fields.is_empty(3));
+    CHECK(fields.is_empty(4));
+
+    // los campos vacíos devuelven el valor por defecto
+    CHECK(fields.get_int(1, -1) == -1);
+    CHECK(fields.get_float(3, 2.5f) == 2.5f);
+    CHECK(fields.get_fixed(4, 6, -7) == -7);
+
+    fields.split(",");
+    CHECK(fields.size() == 2);
+    CHECK(fields.is_empty(0));
+    CHECK(fields.is_empty(1));
+
+    // otro delimitador
+    fields.split("24/01/01,12:00:00", '/');
+    CHECK(fields.size() == 3);
+    CHECK_EQ_STR(fields[2], "01,12:00:00");
+}
+
+static void test_missing_fields()
+{
+    // CGNSINF sin fix: solo el estado de ejecución
+    SIM7000_ResponseFields fields("+CGNSINF: 0");
+    CHECK(fields.size() == 1);
+    CHECK(fields.get_int(0, -1) == 0);
+    CHECK(fields.is_empty(1));
+    CHECK(fields.get_int<uint8_t>(15, 99) == 99);
+    CHECK(fields.get_float(3, -1.0f) == -1.0f);
+    CHECK(fields.get_string(20).empty());
+
+    std::string value = "sin cambio";
+    CHECK(!fields.get_string(5, value));
+    CHECK(value == "sin cambio");
+    CHECK(fields.get_string(0, value));
+    CHECK(value == "0");
+
+    gnss_nav_info_t info;
+    parse_gnss_info("+CGNSINF: 1,0,,,,,,,,", info);
+    CHECK(info.run_status == 1);
+    CHECK(info.fix_status == 0);
+    CHECK(info.date_time == 0);
+    CHECK(info.gps_satellites == 0);
+}
+
+static void test_limit()
+{
+    std::string line;
+    for (int i = 0; i < 30; i++) {
+        if (i > 0) line += ',';
+        line += std::to_string(i);
+    }
+
+    // los campos que exceden MAX_RESPONSE_FIELDS se descartan
+    SIM7000_ResponseFields fields(line);
+    CHECK(fields.size() == MAX_RESPONSE_FIELDS);
+    CHECK(fields.get_int(MAX_RESPONSE_FIELDS - 1) == (int)MAX_RESPONSE_FIELDS - 1);
+    CHECK(fields.get_int(MAX_RESPONSE_FIELDS, -1) == -1);
+}
+
+static void test_values()
+{
+    SIM7000_ResponseFields fields(CGNSINF);
+    CHECK(fields.size() == 21);
+    CHECK(fields.get_int<uint64_t>(2) == 20240101120000ULL);
+    CHECK(std::fabs(fields.get_float(3) - 19.432608f) < 1e-5f);
+    CHECK(fields.get_fixed(3, 6) == 19432608);
+    CHECK(fields.get_fixed(4, 6) == -99133209);
+    // menos decimales que la escala: se completa
+    CHECK(fields.get_fixed(6, 3) == 42500);
+    // más decimales que la escala: se truncan
+    CHECK(fields.get_fixed(3, 2) == 1943);
+    CHECK(fields.get_fixed(5, 0) == 2240);
+    CHECK(fields.get_int<uint8_t>(14) == 12);
+    CHECK(fields.get_int<uint8_t>(15) == 9);
+
+    fields.split("+X: abc,+1.5,-0.05");
+    CHECK(fields.get_fixed(0, 2, -1) == -1);
+    CHECK(fields.get_fixed(1, 2) == 150);
+    CHECK(fields.get_fixed(2, 2) == -5);
+
+    gnss_nav_info_t info;
+    parse_gnss_info(CGNSINF, info);
+    CHECK(info.run_status == 1);
+    CHECK(info.fix_status == 1);
+    CHECK(info.date_time == 20240101120000ULL);
+    CHECK(std::fabs(info.longitude + 99.133209f) < 1e-4f);
+    CHECK(std::fabs(info.course_over_ground - 271.3f) < 1e-3f);
+    CHECK(info.fix_mode == 1);
+    CHECK(info.gnss_satellites == 12);
+    CHECK(info.gps_satellites == 9);
+}
+
+// parseo anterior de CGNSINF: una copia y un recorrido por campo
+static void parse_gnss_info_tokens(std::string_view response, gnss_nav_info_t &info)
+{
+    std::string payload(response);
+    std::string aux;
+
+    remove_before(payload, ": ");
+    extract_token(payload, 0, ",", aux, true);
+    info.run_status = to_number<uint8_t>(aux);
+    extract_token(payload, 1, ",", aux, true);
+    info.fix_status = to_number<uint8_t>(aux);
+    extract_token(payload, 2, ",", aux, true);
+    info.date_time = to_number<uint64_t>(aux);
+    extract_token(payload, 3, ",", aux, true);
+    info.latitude = to_number<float>(aux);
+    extract_token(payload, 4, ",", aux, true);
+    info.longitude = to_number<float>(aux);
+    extract_token(payload, 5, ",", aux, true);
+    info.msl_altitude = to_number<float>(aux);
+    extract_token(payload, 6, ",", aux, true);
+    info.speed_over_ground = to_number<float>(aux);
+    extract_token(payload, 7, ",", aux, true);
+    info.course_over_ground = to_number<float>(aux);
+    extract_token(payload, 8, ",", aux, true);
+    info.fix_mode = to_number<uint8_t>(aux);
+    extract_token(payload, 14, ",", aux, true);
+    info.gnss_satellites = to_number<uint8_t>(aux);
+    extract_token(payload, 15, ",", aux, true);
+    info.gps_satellites = to_number<uint8_t>(aux);
+}
+
+static void benchmark()
+{
+    const size_t iterations = 500000;
+    gnss_nav_info_t fields_info;
+    gnss_nav_info_t tokens_info;
+
+    // ambos dan el mismo resultado
+    parse_gnss_info(CGNSINF, fields_info);
+    parse_gnss_info_tokens(CGNSINF, tokens_info);
+    CHECK(fields_info.date_time == tokens_info.date_time);
+    CHECK(fields_info.latitude == tokens_info.latitude);
+    CHECK(fields_info.course_over_ground == tokens_info.course_over_ground);
+    CHECK(fields_info.gps_satellites == tokens_info.gps_satellites);
+
+    double split_ns = host_test::measure_ns(iterations, [](size_t) {
+        SIM7000_ResponseFields fields(CGNSINF);
+        host_test::keep(fields.size());
+    });
+    double fields_ns = host_test::measure_ns(iterations, [&](size_t) {
+        parse_gnss_info(CGNSINF, fields_info);
+        host_test::keep(fields_info);
+    });
+    double tokens_ns = host_test::measure_ns(iterations, [&](size_t) {
+        parse_gnss_info_tokens(CGNSINF, tokens_info);
+        host_test::keep(tokens_info);
+    });
+
+    printf("split CGNSINF (21 fields): %6.1f ns\n", split_ns);
+    printf(
+        "parse_gnss_info: ResponseFields %6.1f ns, extract_token %6.1f ns\n",
+        fields_ns, tokens_ns);
+}
+
+int main()
+{
+    test_prefix();
+    test_quoted();
+    test_empty_fields();
+    test_missing_fields();
+    test_limit();
+    test_values();
+    benchmark();
+
+    return host_test::summary("response_fields");
+}
@@ -0,0 +1,197 @@
+/*
+ * Pruebas de cancelación de comandos contra tools/sim7000_sim a través de un
+ * pseudo-terminal: cancelación de un comando en la cola, de uno en curso
+ * cuya respuesta llega después (se descarta), de una publicación que espera
+ * el indicador "> " (se cancela con ESC) y de un comando abortable. También
+ * mide la latencia de una publicación del botón de pánico que llega mientras
+ * AT+SMCONN está en curso, con prioridad normal y urgente.
+ */
+
+#include "host_test.hpp"
+
+#include "sim_modem.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+using namespace host_test;
+
+// el simulador responde con latencia fija para que los comandos sin tiempo
+// máximo de respuesta (100 ms) no agoten su tiempo de espera
+static const int SMCONN_DELAY_MS = 300;
+
+static void setup(PtyModem &modem)
+{
+    command_t echo(at_cmd_t::E, "0");
+    command_t network(at_cmd_t::CNACT, "=1,\"internet\"");
+    command_t connect(at_cmd_t::SMCONN);
+
+    CHECK(run(modem, echo) == ESP_OK);
+    CHECK(run(modem, network) == ESP_OK);
+    CHECK(run(modem, connect) == ESP_OK);
+}
+
+static void test_cancel_queued(PtyModem &modem)
+{
+    command_t running(at_cmd_t::CGSN);
+    command_t queued(at_cmd_t::CSQ);
+
+    CHECK(modem.submit_cmd(running.context) == ESP_OK);
+    CHECK(modem.submit_cmd(queued.context) == ESP_OK);
+
+    // se quita de la cola sin enviarse
+    CHECK(modem.cancel_cmd(queued.context) == ESP_OK);
+    CHECK(modem.wait_for_cmd(queued.context) == ESP_ERR_TIMEOUT);
+    CHECK(queued.info.result == at_cmd_result_t::CANCELLED);
+
+    CHECK(modem.wait_for_cmd(running.context) == ESP_OK);
+    CHECK(running.info.response.find("869951030000000") != std::string::npos);
+    CHECK(modem.count_written("AT+CSQ") == 0);
+
+    // un comando que ya terminó no se puede cancelar
+    CHECK(modem.cancel_cmd(running.context) == ESP_ERR_INVALID_STATE);
+}
+
+static void test_drain_stale_result(PtyModem &modem)
+{
+    command_t cancelled(at_cmd_t::CGSN);
+    command_t next(at_cmd_t::CSQ);
+
+    CHECK(modem.submit_cmd(cancelled.context) == ESP_OK);
+    CHECK(modem.cancel_cmd(cancelled.context) == ESP_OK);
+    CHECK(modem.wait_for_cmd(cancelled.context) == ESP_ERR_TIMEOUT);
+
+    // no se envía hasta recibir el resultado del comando cancelado
+    CHECK(modem.submit_cmd(next.context) == ESP_OK);
+    CHECK(modem.count_written("AT+CSQ") == 0);
+
+    CHECK(modem.wait_for_cmd(next.context) == ESP_OK);
+    CHECK(next.info.response.starts_with("+CSQ: "));
+    CHECK(next.info.response.find("869951030000000") == std::string::npos);
+}
+
+static void test_cancel_during_prompt(PtyModem &modem)
+{
+    static const char PAYLOAD[] = "ping";
+    command_t publish(at_cmd_t::SMPUB, "=\"axomotor/ping\",4,1,0");
+    command_t next(at_cmd_t::CSQ);
+
+    publish.context.payload = std::span<const char>(PAYLOAD, strlen(PAYLOAD));
+    publish.context.send_payload = true;
+
+    // se cancela antes de recibir "> "; al llegar el indicador, el modem
+    // cancela la publicación con ESC en lugar de escribir la carga útil
+    CHECK(modem.submit_cmd(publish.context) == ESP_OK);
+    CHECK(modem.cancel_cmd(publish.context) == ESP_OK);
+    CHECK(modem.wait_for_cmd(publish.context) == ESP_ERR_TIMEOUT);
+    CHECK(publish.info.result == at_cmd_result_t::CANCELLED);
+
+    CHECK(modem.submit_cmd(next.context) == ESP_OK);
+    CHECK(modem.wait_for_cmd(next.context) == ESP_OK);
+    CHECK(next.info.response.starts_with("+CSQ: "));
+
+    CHECK(modem.count_written("\x1b") == 1);
+    CHECK(modem.count_written(std::string(PAYLOAD) + "\r") == 0);
+}
+
+static void test_cancel_abortable(PtyModem &modem)
+{
+    command_t disconnect(at_cmd_t::SMDISC);
+    command_t connect(at_cmd_t::SMCONN);
+    command_t state(at_cmd_t::SMSTATE, "?");
+
+    CHECK(run(modem, disconnect) == ESP_OK);
+
+    // AT+SMCONN se aborta con el CR que se escribe al cancelar
+    CHECK(modem.submit_cmd(connect.context) == ESP_OK);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    CHECK(modem.cancel_cmd(connect.context) == ESP_OK);
+    CHECK(modem.wait_for_cmd(connect.context) == ESP_ERR_TIMEOUT);
+
+    // el ERROR del comando abortado no se atribuye a la consulta
+    CHECK(run(modem, state) == ESP_OK);
+    CHECK(state.info.response.find("+SMSTATE: 0") != std::string::npos);
+}
+
+static void test_urgent_publish_latency(PtyModem &modem)
+{
+    static const char PAYLOAD[] = "panic";
+    // momentos, desde el envío de AT+SMCONN, en los que llega la publicación
+    const int offsets_ms[] = { 0, 100, 200 };
+    long long worst_ms[2] = { 0, 0 };
+
+    command_t connect(at_cmd_t::SMCONN);
+    CHECK(run(modem, connect) == ESP_OK);
+
+    for (cmd_priority_t priority : { cmd_priority_t::NORMAL, cmd_priority_t::URGENT }) {
+        for (int offset_ms : offsets_ms) {
+            command_t reconnect(at_cmd_t::SMCONN);
+            command_t publish(at_cmd_t::SMPUB, "=\"device/1/event\",5,2,0");
+
+            publish.context.payload = std::span<const char>(PAYLOAD, strlen(PAYLOAD));
+            publish.context.send_payload = true;
+            publish.context.priority = priority;
+
+            CHECK(modem.submit_cmd(reconnect.context) == ESP_OK);
+            std::this_thread::sleep_for(std::chrono::milliseconds(offset_ms));
+
+            auto started_at = std::chrono::steady_clock::now();
+            CHECK(modem.submit_cmd(publish.context) == ESP_OK);
+            CHECK(modem.wait_for_cmd(publish.context) == ESP_OK);
+            auto elapsed = std::chrono::steady_clock::now() - started_at;
+
+            long long &worst = worst_ms[priority == cmd_priority_t::URGENT];
+            worst = std::max<long long>(
+                worst,
+                std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count());
+
+            // la urgente interrumpe la conexión; la normal espera a que termine
+            esp_err_t err = modem.wait_for_cmd(reconnect.context);
+            CHECK(priority == cmd_priority_t::URGENT ? err != ESP_OK : err == ESP_OK);
+        }
+    }
+
+    printf(
+        "panic-to-publish during AT+SMCONN (%d ms): NORMAL worst %lld ms, URGENT worst %lld ms\n",
+        SMCONN_DELAY_MS,
+        worst_ms[0],
+        worst_ms[1]);
+
+    // la urgente solo espera el ERROR del comando abortado y su propio
+    // intercambio, no el resto de la conexión
+    CHECK(worst_ms[1] < worst_ms[0]);
+    CHECK(worst_ms[1] < SMCONN_DELAY_MS);
+}
+
+int main(int argc, char **argv)
+{
+    simulator_t sim;
+    bool started = start_simulator(argv[0], {
+        "--latency", "50",
+        "--jitter", "0",
+        "--smconn-delay", "300",     // SMCONN_DELAY_MS
+        "--seed", "1",
+    }, sim);
+    if (!started) return 1;
+
+    {
+        PtyModem modem(sim.fd);
+
+        setup(modem);
+        test_cancel_queued(modem);
+        test_drain_stale_result(modem);
+        test_cancel_during_prompt(modem);
+        test_cancel_abortable(modem);
+        test_urgent_publish_latency(modem);
+    }
+
+    // la publicación cancelada no llegó al broker; solo las seis de la
+    // medición, y cada urgente abortó una conexión
+    std::string stats = stop_simulator(sim);
+    printf("simulator:%s", stats.c_str());
+    CHECK(stats.find("publishes=6 ") != std::string::npos);
+    CHECK(stats.find("aborted=5 ") != std::string::npos);
+
+    return host_test::summary("sim_cancel");
+}
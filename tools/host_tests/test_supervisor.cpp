@@ -0,0 +1,183 @@
+/*
+ * Pruebas de SIM7000_Supervisor con el modem de fakes/ conectado a
+ * tools/sim7000_sim: detección del bloqueo a partir de los comandos sin
+ * respuesta (--drop-rate 1), escalamiento de la prueba con AT a AT+CFUN=1,1
+ * y al ciclo de encendido con esperas que se duplican, interrupción de la
+ * recuperación y tiempo medio de recuperación (MTTR).
+ *
+ * Las esperas entre pasos son las del firmware (2 s y 4 s), por lo que la
+ * prueba tarda unos segundos.
+ */
+
+#include "host_test.hpp"
+
+#include "fakes/sim7000_modem.hpp"
+
+#include <chrono>
+#include <functional>
+#include <thread>
+
+using namespace axomotor::lte_modem;
+using namespace std::chrono_literals;
+
+using clock_type = std::chrono::steady_clock;
+
+static bool wait_until(const std::function<bool()> &predicate, std::chrono::milliseconds timeout)
+{
+    auto deadline = clock_type::now() + timeout;
+
+    while (!predicate()) {
+        if (clock_type::now() >= deadline) return false;
+        std::this_thread::sleep_for(10ms);
+    }
+
+    return true;
+}
+
+static long long to_ms(clock_type::duration duration)
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(duration).count();
+}
+
+// comandos sin respuesta hasta alcanzar el umbral, como los detectaría el
+// modem real en on_cmd_timeout()
+static void hang(SIM7000_Modem &modem, SIM7000_Supervisor &supervisor)
+{
+    for (uint32_t i = 0; i < SUPERVISOR_TIMEOUT_THRESHOLD; i++) {
+        CHECK(modem.execute(internal::at_cmd_t::CSQ) == ESP_ERR_TIMEOUT);
+        supervisor.notify_timeout(modem.get_consecutive_timeouts());
+    }
+}
+
+static void test_probe_recovery(const char *argv0)
+{
+    SIM7000_Modem modem(argv0, "0");
+    SIM7000_Supervisor supervisor(modem);
+
+    CHECK(supervisor.enable() == ESP_OK);
+
+    // bajo el umbral no hay recuperación
+    supervisor.notify_timeout(SUPERVISOR_TIMEOUT_THRESHOLD - 1);
+    std::this_thread::sleep_for(100ms);
+    CHECK(supervisor.get_stats().hang_count == 0);
+
+    // el modem volvió a responder: basta con la prueba con AT
+    supervisor.notify_timeout(SUPERVISOR_TIMEOUT_THRESHOLD);
+    CHECK(wait_until([&] { return supervisor.get_stats().recovery_count == 1; }, 2000ms));
+
+    recovery_stats_t stats = supervisor.get_stats();
+    CHECK(stats.hang_count == 1);
+    CHECK(stats.power_cycle_count == 0);
+    CHECK(stats.last_level == recovery_level_t::PROBE);
+    CHECK(stats.last_recovery_ms < 1000);
+    CHECK(stats.mean_recovery_ms == stats.last_recovery_ms);
+    CHECK(modem.get_steps().size() == 1);
+
+    std::vector<int32_t> events = modem.get_events();
+    CHECK(events.size() == 2);
+    CHECK(events.size() == 2 && events[0] == MODEM_EVENT_HANG_DETECTED);
+    CHECK(events.size() == 2 && events[1] == MODEM_EVENT_RECOVERED);
+    CHECK(modem.get_posted_stats().recovery_count == 1);
+
+    CHECK(supervisor.disable() == ESP_OK);
+}
+
+static void test_escalation(const char *argv0)
+{
+    // bloqueado hasta el ciclo de encendido
+    SIM7000_Modem modem(argv0, "1");
+    SIM7000_Supervisor supervisor(modem);
+
+    CHECK(supervisor.enable() == ESP_OK);
+    hang(modem, supervisor);
+
+    CHECK(wait_until([&] { return supervisor.is_recovering(); }, 1000ms));
+
+    // los comandos de la propia recuperación no inician otra
+    supervisor.notify_timeout(SUPERVISOR_TIMEOUT_THRESHOLD + 1);
+
+    CHECK(wait_until([&] { return supervisor.get_stats().recovery_count == 1; }, 10000ms));
+
+    recovery_stats_t first = supervisor.get_stats();
+    CHECK(first.hang_count == 1);
+    CHECK(first.power_cycle_count == 1);
+    CHECK(first.last_level == recovery_level_t::POWER_CYCLE);
+    CHECK(modem.get_consecutive_timeouts() == 0);
+
+    std::vector<SIM7000_Modem::step_t> steps = modem.get_steps();
+    CHECK(steps.size() == 3);
+    if (steps.size() != 3) return;
+
+    CHECK(steps[0].level == recovery_level_t::PROBE);
+    CHECK(steps[1].level == recovery_level_t::SOFT_RESET);
+    CHECK(steps[2].level == recovery_level_t::POWER_CYCLE);
+
+    // después de cada paso fallido se espera RECOVERY_BACKOFF_MS y luego el
+    // doble
+    long long first_gap = to_ms(steps[1].started_at - steps[0].finished_at);
+    long long second_gap = to_ms(steps[2].started_at - steps[1].finished_at);
+
+    printf(
+        "backoff: %lld ms, %lld ms (recovered in %lu ms)\n",
+        first_gap,
+        second_gap,
+        (unsigned long)first.last_recovery_ms);
+
+    CHECK(first_gap >= RECOVERY_BACKOFF_MS);
+    CHECK(first_gap < RECOVERY_BACKOFF_MS + 200);
+    CHECK(second_gap >= 2 * RECOVERY_BACKOFF_MS);
+    CHECK(second_gap < 2 * RECOVERY_BACKOFF_MS + 200);
+    CHECK(first.last_recovery_ms >= 3 * RECOVERY_BACKOFF_MS);
+
+    // después del ciclo de encendido el modem responde; el siguiente bloqueo
+    // se resuelve con la prueba y el MTTR promedia ambas recuperaciones
+    supervisor.notify_timeout(SUPERVISOR_TIMEOUT_THRESHOLD);
+    CHECK(wait_until([&] { return supervisor.get_stats().recovery_count == 2; }, 2000ms));
+
+    recovery_stats_t second = supervisor.get_stats();
+    uint32_t expected_mean = (first.last_recovery_ms + second.last_recovery_ms) / 2;
+
+    printf(
+        "MTTR: %lu ms over %lu recoveries\n",
+        (unsigned long)second.mean_recovery_ms,
+        (unsigned long)second.recovery_count);
+
+    CHECK(second.hang_count == 2);
+    CHECK(second.last_level == recovery_level_t::PROBE);
+    CHECK(second.mean_recovery_ms + 1 >= expected_mean && second.mean_recovery_ms <= expected_mean + 1);
+
+    CHECK(supervisor.disable() == ESP_OK);
+}
+
+static void test_interrupted(const char *argv0)
+{
+    SIM7000_Modem modem(argv0, "1");
+    SIM7000_Supervisor supervisor(modem);
+
+    CHECK(supervisor.enable() == ESP_OK);
+    supervisor.notify_timeout(SUPERVISOR_TIMEOUT_THRESHOLD);
+
+    // se detiene durante la espera después de la prueba con AT
+    CHECK(wait_until([&] { return modem.get_steps().size() == 1; }, 1000ms));
+    std::this_thread::sleep_for(500ms);
+
+    auto started_at = clock_type::now();
+    CHECK(supervisor.disable() == ESP_OK);
+    CHECK(to_ms(clock_type::now() - started_at) < 1000);
+
+    recovery_stats_t stats = supervisor.get_stats();
+    CHECK(stats.hang_count == 1);
+    CHECK(stats.recovery_count == 0);
+    CHECK(!supervisor.is_recovering());
+    CHECK(modem.get_steps().size() == 1);
+    CHECK(modem.get_events().size() == 1);
+}
+
+int main(int argc, char **argv)
+{
+    test_probe_recovery(argv[0]);
+    test_escalation(argv[0]);
+    test_interrupted(argv[0]);
+
+    return host_test::summary("supervisor");
+}
@@ -0,0 +1,342 @@
+/*
+ * Pruebas del formato binario de la telemetría (events/telemetry_codec):
+ * ida y vuelta de posiciones, eventos del dispositivo y pongs, coordenadas
+ * negativas, normalización del rumbo, saturación de la velocidad y errores
+ * de tamaño. Imprime el tamaño de cada mensaje frente al JSON que publica
+ * MobileService y el tiempo de codificar y decodificar un lote de posiciones
+ * en ambos formatos.
+ */
+
+#include "host_test.hpp"
+
+#include "events/telemetry_codec.hpp"
+#include "constants/general.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+using namespace axomotor::constants::general;
+using namespace axomotor::events;
+using namespace axomotor::events::telemetry;
+
+// resolución del formato más el error de float en coordenadas de ~100 grados
+static const float COORDINATE_TOLERANCE = 1e-5f;
+static const float SCALED_TOLERANCE = 0.006f;
+
+static bool is_near(float a, float b, float tolerance)
+{
+    return std::fabs(a - b) <= tolerance;
+}
+
+static void test_positions_round_trip()
+{
+    // ciudad de México, Santiago (latitud y longitud negativas), Sídney y
+    // Greenwich (longitud 0)
+    const position_event_t positions[] = {
+        { 1760000000, 19.432608f, -99.133209f, 57.3f, 271.5f },
+        { 1760000020, -33.448890f, -70.669265f, 0.0f, 0.0f },
+        { 1760000040, -33.868820f, 151.209290f, 110.25f, 359.99f },
+        { 1760000060, 51.477928f, 0.0f, 3.5f, 90.0f },
+        { 1760000080, -90.0f, -180.0f, 655.35f, 180.0f },
+    };
+    const size_t count = std::size(positions);
+    uint8_t buffer[256];
+    size_t length = 0;
+
+    CHECK(encode_positions(positions, buffer, length) == ESP_OK);
+    CHECK(length == get_positions_message_size(count));
+    CHECK(get_message_type(std::span<const uint8_t>(buffer, length)) == message_type_t::POSITIONS);
+
+    position_event_t decoded[count];
+    size_t decoded_count = 0;
+    CHECK(decode_positions(std::span<const uint8_t>(buffer, length), decoded, decoded_count) == ESP_OK);
+    CHECK(decoded_count == count);
+
+    for (size_t i = 0; i < count; i++) {
+        CHECK(decoded[i].timestamp == positions[i].timestamp);
+        CHECK(is_near(decoded[i].latitude, positions[i].latitude, COORDINATE_TOLERANCE));
+        CHECK(is_near(decoded[i].longitude, positions[i].longitude, COORDINATE_TOLERANCE));
+        CHECK(is_near(decoded[i].speed_over_ground, positions[i].speed_over_ground, SCALED_TOLERANCE));
+        CHECK(is_near(decoded[i].course_over_ground, positions[i].course_over_ground, SCALED_TOLERANCE));
+    }
+
+    // lote vacío
+    CHECK(encode_positions({}, buffer, length) == ESP_OK);
+    CHECK(length == HEADER_SIZE + 1);
+    CHECK(decode_positions(std::span<const uint8_t>(buffer, length), decoded, decoded_count) == ESP_OK);
+    CHECK(decoded_count == 0);
+}
+
+static void test_position_layout()
+{
+    const position_event_t position = { 0x01020304, -0.000001f, 0.000002f, 1.0f, 2.0f };
+    uint8_t buffer[32];
+    size_t length = 0;
+
+    CHECK(encode_positions(std::span(&position, 1), buffer, length) == ESP_OK);
+
+    const uint8_t expected[] = {
+        (TELEMETRY_FORMAT_VERSION << 4) | (uint8_t)message_type_t::POSITIONS,
+        1,
+        0x04, 0x03, 0x02, 0x01,     // timestamp
+        0xFF, 0xFF, 0xFF, 0xFF,     // -1e-6 grados
+        0x02, 0x00, 0x00, 0x00,     // 2e-6 grados
+        0x64, 0x00,                 // 1.00 km/h
+        0xC8, 0x00,                 // 2.00 grados
+    };
+
+    CHECK(length == sizeof(expected));
+    CHECK(length == sizeof(expected) && memcmp(buffer, expected, length) == 0);
+}
+
+static float round_trip_course(float course)
+{
+    position_event_t position = { 0, 0.0f, 0.0f, 0.0f, course };
+    position_event_t decoded{};
+    uint8_t buffer[32];
+    size_t length = 0;
+    size_t count = 0;
+
+    encode_positions(std::span(&position, 1), buffer, length);
+    decode_positions(std::span<const uint8_t>(buffer, length), std::span(&decoded, 1), count);
+    return decoded.course_over_ground;
+}
+
+static float round_trip_speed(float speed)
+{
+    position_event_t position = { 0, 0.0f, 0.0f, speed, 0.0f };
+    position_event_t decoded{};
+    uint8_t buffer[32];
+    size_t length = 0;
+    size_t count = 0;
+
+    encode_positions(std::span(&position, 1), buffer, length);
+    decode_positions(std::span<const uint8_t>(buffer, length), std::span(&decoded, 1), count);
+    return decoded.speed_over_ground;
+}
+
+static void test_course_and_speed()
+{
+    // el rumbo se normaliza a [0, 360)
+    CHECK(is_near(round_trip_course(360.0f), 0.0f, SCALED_TOLERANCE));
+    CHECK(is_near(round_trip_course(365.5f), 5.5f, SCALED_TOLERANCE));
+    CHECK(is_near(round_trip_course(725.25f), 5.25f, SCALED_TOLERANCE));
+    CHECK(is_near(round_trip_course(-90.0f), 270.0f, SCALED_TOLERANCE));
+
+    // la velocidad se satura en el máximo del formato y no admite negativos
+    const float max_speed = UINT16_MAX / 100.0f;
+    CHECK(is_near(round_trip_speed(max_speed), max_speed, SCALED_TOLERANCE));
+    CHECK(is_near(round_trip_speed(1000.0f), max_speed, SCALED_TOLERANCE));
+    CHECK(is_near(round_trip_speed(1e9f), max_speed, SCALED_TOLERANCE));
+    CHECK(round_trip_speed(-5.0f) == 0.0f);
+    CHECK(round_trip_speed(NAN) == 0.0f);
+}
+
+static void test_device_event_and_pong()
+{
+    uint8_t buffer[16];
+    size_t length = 0;
+
+    const device_event_t event = { 1760000000, event_code_t::PANIC_BUTTON_PRESSED };
+    device_event_t decoded_event{};
+
+    CHECK(encode_device_event(event, buffer, length) == ESP_OK);
+    CHECK(length == DEVICE_EVENT_MESSAGE_SIZE);
+    CHECK(get_message_type(std::span<const uint8_t>(buffer, length)) == message_type_t::DEVICE_EVENT);
+    CHECK(decode_device_event(std::span<const uint8_t>(buffer, length), decoded_event) == ESP_OK);
+    CHECK(decoded_event.code == event.code);
+    CHECK(decoded_event.timestamp == event.timestamp);
+
+    const ping_event_t ping = { 1760000000123ULL, 1760000000 };
+    ping_event_t decoded_ping{};
+
+    CHECK(encode_pong(ping, buffer, length) == ESP_OK);
+    CHECK(length == PONG_MESSAGE_SIZE);
+    CHECK(get_message_type(std::span<const uint8_t>(buffer, length)) == message_type_t::PONG);
+    CHECK(decode_pong(std::span<const uint8_t>(buffer, length), decoded_ping) == ESP_OK);
+    CHECK(decoded_ping.timestamp == ping.timestamp);
+    // el pong solo lleva la marca de tiempo del dispositivo
+    CHECK(decoded_ping.ping_timestamp == 0);
+}
+
+static void test_errors()
+{
+    position_event_t positions[MAX_POSITIONS_PER_MESSAGE + 1] = {};
+    position_event_t decoded[4];
+    uint8_t buffer[64];
+    size_t length = 0;
+    size_t count = 0;
+
+    // búfer insuficiente
+    std::span<uint8_t> short_buffer(buffer, get_positions_message_size(4) - 1);
+    CHECK(encode_positions(std::span(positions, 4), short_buffer, length) == ESP_ERR_INVALID_SIZE);
+    CHECK(encode_device_event(device_event_t{}, std::span(buffer, DEVICE_EVENT_MESSAGE_SIZE - 1), length) == ESP_ERR_INVALID_SIZE);
+    CHECK(encode_pong(ping_event_t{}, std::span(buffer, PONG_MESSAGE_SIZE - 1), length) == ESP_ERR_INVALID_SIZE);
+
+    // la cantidad se codifica en un byte
+    static uint8_t large_buffer[get_positions_message_size(MAX_POSITIONS_PER_MESSAGE + 1)];
+    CHECK(encode_positions(positions, large_buffer, length) == ESP_ERR_INVALID_ARG);
+    CHECK(encode_positions(std::span(positions, MAX_POSITIONS_PER_MESSAGE), large_buffer, length) == ESP_OK);
+
+    // mensajes truncados o de otro tipo
+    CHECK(encode_positions(std::span(positions, 2), buffer, length) == ESP_OK);
+    CHECK(decode_positions(std::span<const uint8_t>(buffer, length - 1), decoded, count) == ESP_ERR_INVALID_SIZE);
+    CHECK(decode_positions(std::span<const uint8_t>(buffer, length), std::span(decoded, 1), count) == ESP_ERR_INVALID_SIZE);
+
+    device_event_t event;
+    ping_event_t ping;
+    CHECK(decode_device_event(std::span<const uint8_t>(buffer, length), event) == ESP_ERR_INVALID_ARG);
+    CHECK(decode_pong(std::span<const uint8_t>(buffer, length), ping) == ESP_ERR_INVALID_ARG);
+
+    // versión desconocida o mensaje vacío
+    CHECK(get_message_type({}) == message_type_t::NONE);
+    buffer[0] = ((TELEMETRY_FORMAT_VERSION + 1) << 4) | (uint8_t)message_type_t::PONG;
+    CHECK(get_message_type(std::span<const uint8_t>(buffer, PONG_MESSAGE_SIZE)) == message_type_t::NONE);
+    CHECK(decode_pong(std::span<const uint8_t>(buffer, PONG_MESSAGE_SIZE), ping) == ESP_ERR_INVALID_ARG);
+}
+
+// tamaños frente a los mensajes JSON de MobileService
+static void make_positions(position_event_t *positions, size_t count)
+{
+    for (size_t i = 0; i < count; i++) {
+        positions[i] = {
+            (time_t)(1760000000 + 20 * i),
+            19.432608f + i * 1e-4f,
+            -99.133209f - i * 1e-4f,
+            57.3f + i,
+            271.5f,
+        };
+    }
+}
+
+// el lote como lo escribe MobileService::publish_positions()
+static int format_positions_json(std::span<const position_event_t> positions, char *json, size_t size)
+{
+    int length = snprintf(json, size, "{\"source\":\"vehicleDevice\",\"positions\":[");
+    for (size_t i = 0; i < positions.size(); i++) {
+        length += snprintf(
+            json + length,
+            size - length,
+            "%s{\"latitude\":%.6f,\"longitude\":%.6f,\"speed\":%.2f,\"timestamp\":%lld}",
+            i > 0 ? "," : "",
+            positions[i].latitude,
+            positions[i].longitude,
+            positions[i].speed_over_ground,
+            (long long)positions[i].timestamp);
+    }
+    length += snprintf(json + length, size - length, "]}");
+    return length;
+}
+
+// lectura mínima del JSON anterior (sin validar la estructura), como cota
+// inferior del costo de un analizador JSON
+static size_t parse_positions_json(const char *json, position_event_t *positions, size_t max_count)
+{
+    size_t count = 0;
+    const char *item = json;
+
+    while (count < max_count && (item = strstr(item, "{\"latitude\":")) != nullptr) {
+        position_event_t &position = positions[count++];
+        char *end;
+
+        position.latitude = strtof(item + 12, &end);
+        position.longitude = strtof(strchr(end, ':') + 1, &end);
+        position.speed_over_ground = strtof(strchr(end, ':') + 1, &end);
+        position.timestamp = strtoll(strchr(end, ':') + 1, &end, 10);
+        position.course_over_ground = 0;
+        item = end;
+    }
+
+    return count;
+}
+
+static void print_sizes()
+{
+    const size_t count = 10;
+    position_event_t positions[count];
+    char json[1024];
+    uint8_t buffer[1024];
+    size_t binary_length = 0;
+
+    make_positions(positions, count);
+    int json_length = format_positions_json(positions, json, sizeof(json));
+
+    CHECK(encode_positions(positions, buffer, binary_length) == ESP_OK);
+    printf("positions (x%zu): %4zu B binary, %4d B JSON\n", count, binary_length, json_length);
+
+    const device_event_t event = { 1760000000, event_code_t::PANIC_BUTTON_PRESSED };
+    json_length = snprintf(
+        json,
+        sizeof(json),
+        "{\"code\":\"%s\",\"timestamp\":%lld}",
+        "panicButtonPressed",
+        (long long)event.timestamp);
+
+    CHECK(encode_device_event(event, buffer, binary_length) == ESP_OK);
+    printf("device event:     %4zu B binary, %4d B JSON\n", binary_length, json_length);
+
+    const ping_event_t ping = { 0, 1760000000 };
+    json_length = snprintf(json, sizeof(json), "{\"timestamp\":%lld}", (long long)ping.timestamp);
+
+    CHECK(encode_pong(ping, buffer, binary_length) == ESP_OK);
+    printf("pong:             %4zu B binary, %4d B JSON\n", binary_length, json_length);
+}
+
+static void benchmark()
+{
+    const size_t iterations = 100000;
+    const size_t count = POSITION_BATCH_SIZE;
+    position_event_t positions[count];
+    position_event_t decoded[count];
+    char json[POSITION_BATCH_MAX_PAYLOAD];
+    uint8_t buffer[POSITION_BATCH_MAX_PAYLOAD];
+    size_t binary_length = 0;
+    size_t decoded_count = 0;
+    int json_length = 0;
+
+    make_positions(positions, count);
+
+    double binary_encode_ns = host_test::measure_ns(iterations, [&](size_t) {
+        encode_positions(positions, buffer, binary_length);
+        host_test::keep(buffer);
+    });
+    double json_encode_ns = host_test::measure_ns(iterations, [&](size_t) {
+        json_length = format_positions_json(positions, json, sizeof(json));
+        host_test::keep(json);
+    });
+
+    double binary_decode_ns = host_test::measure_ns(iterations, [&](size_t) {
+        decode_positions(std::span<const uint8_t>(buffer, binary_length), decoded, decoded_count);
+        host_test::keep(decoded);
+    });
+    CHECK(decoded_count == count);
+
+    double json_decode_ns = host_test::measure_ns(iterations, [&](size_t) {
+        decoded_count = parse_positions_json(json, decoded, count);
+        host_test::keep(decoded);
+    });
+    CHECK(decoded_count == count);
+    CHECK(is_near(decoded[count - 1].latitude, positions[count - 1].latitude, COORDINATE_TOLERANCE));
+
+    printf(
+        "encode %zu positions: binary %7.1f ns, snprintf JSON %7.1f ns (x%.1f)\n",
+        count, binary_encode_ns, json_encode_ns, json_encode_ns / binary_encode_ns);
+    printf(
+        "decode %zu positions: binary %7.1f ns, strtof JSON   %7.1f ns (x%.1f)\n",
+        count, binary_decode_ns, json_decode_ns, json_decode_ns / binary_decode_ns);
+}
+
+int main()
+{
+    test_positions_round_trip();
+    test_position_layout();
+    test_course_and_speed();
+    test_device_event_and_pong();
+    test_errors();
+    print_sizes();
+    benchmark();
+
+    return host_test::summary("telemetry_codec");
+}
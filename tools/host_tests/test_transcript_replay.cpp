@@ -0,0 +1,171 @@
+/*
+ * Pruebas de las grabaciones de la UART (SIM7000_TranscriptWriter/Reader) y
+ * reproducción de una grabación con SIM7000_ReplayModem: reporta la
+ * velocidad del analizador, la del enlace grabado y la latencia de las
+ * respuestas del modem.
+ *
+ * Sin argumentos reproduce data/sample.s7tr (una sesión de arranque, conexión
+ * MQTT y 30 s de navegación); se puede indicar otra grabación, p. ej. una
+ * copiada de la tarjeta SD:
+ *   build/test_transcript_replay <archivo>
+ */
+
+#include "host_test.hpp"
+
+#include <sim7000_transcript.hpp>
+
+#include <cstdio>
+#include <string>
+#include <unistd.h>
+
+using namespace axomotor::lte_modem;
+
+// contenido conocido de data/sample.s7tr
+static const uint32_t SAMPLE_RECORDS = 88;
+static const uint32_t SAMPLE_BYTES_RX = 3405;
+static const uint32_t SAMPLE_BYTES_TX = 623;
+// 30 +UGNSINF, +APP PDP y +SMSUB; sin comando en curso, las respuestas
+// +CPIN y +CGREG también se despachan como URC
+static const uint32_t SAMPLE_URC_COUNT = 34;
+static const uint32_t SAMPLE_RESPONSES = 28;
+// repeticiones para medir la velocidad del analizador
+static const int REPLAY_ROUNDS = 200;
+
+static void test_round_trip()
+{
+    char path[] = "/tmp/transcript_XXXXXX";
+    int fd = mkstemp(path);
+    CHECK(fd >= 0);
+    close(fd);
+
+    // un registro mayor al máximo se divide en dos
+    std::string large(TRANSCRIPT_MAX_RECORD_LENGTH + 10, 'x');
+    SIM7000_TranscriptWriter writer;
+
+    CHECK(writer.start(path) == ESP_OK);
+    CHECK(writer.start(path) == ESP_ERR_INVALID_STATE);
+    writer.record(transcript_dir_t::TX, "AT\r", 3);
+    writer.record(transcript_dir_t::RX, "\r\nOK\r\n", 6);
+    writer.record(transcript_dir_t::RX, large.data(), large.length());
+    CHECK(writer.stop() == ESP_OK);
+    CHECK(!writer.is_recording());
+
+    // sin grabación activa no se escribe nada
+    writer.record(transcript_dir_t::TX, "AT\r", 3);
+
+    FILE *file = fopen(path, "rb");
+    CHECK(file != nullptr);
+    if (file == nullptr) return;
+
+    SIM7000_TranscriptReader reader(file);
+    transcript_record_t record;
+    char buffer[16];
+
+    CHECK(reader.open() == ESP_OK);
+
+    CHECK(reader.next(record) == ESP_OK);
+    CHECK(record.direction == transcript_dir_t::TX);
+    CHECK(record.length == 3);
+    CHECK_EQ_STR(std::string_view(buffer, reader.read(buffer)), "AT\r");
+
+    // los datos que no se leen se omiten
+    CHECK(reader.next(record) == ESP_OK);
+    CHECK(record.direction == transcript_dir_t::RX);
+    CHECK(record.length == 6);
+
+    CHECK(reader.next(record) == ESP_OK);
+    CHECK(record.length == TRANSCRIPT_MAX_RECORD_LENGTH);
+    CHECK(reader.next(record) == ESP_OK);
+    CHECK(record.length == 10);
+    CHECK(record.delta_us == 0);
+
+    CHECK(reader.next(record) == ESP_ERR_NOT_FOUND);
+
+    fclose(file);
+    unlink(path);
+}
+
+static void test_invalid_file()
+{
+    FILE *file = tmpfile();
+    fputs("not a transcript", file);
+    rewind(file);
+
+    SIM7000_ReplayModem modem;
+    transcript_replay_stats_t stats;
+    CHECK(modem.replay(file, false, stats) == ESP_ERR_INVALID_RESPONSE);
+
+    fclose(file);
+}
+
+static bool replay(const char *path, bool is_sample)
+{
+    FILE *file = fopen(path, "rb");
+    if (file == nullptr) {
+        printf("failed to open %s\n", path);
+        return false;
+    }
+
+    SIM7000_ReplayModem modem;
+    transcript_replay_stats_t stats;
+    int64_t elapsed_us = 0;
+
+    for (int i = 0; i < REPLAY_ROUNDS; i++) {
+        rewind(file);
+        CHECK(modem.replay(file, false, stats) == ESP_OK);
+        elapsed_us += stats.elapsed_us;
+    }
+
+    fclose(file);
+
+    if (is_sample) {
+        CHECK(stats.records == SAMPLE_RECORDS);
+        CHECK(stats.bytes_rx == SAMPLE_BYTES_RX);
+        CHECK(stats.bytes_tx == SAMPLE_BYTES_TX);
+        CHECK(stats.urc_count == SAMPLE_URC_COUNT);
+        CHECK(stats.responses == SAMPLE_RESPONSES);
+    }
+
+    double recorded_s = stats.recorded_us / 1e6;
+    double parse_mbps = elapsed_us > 0 ?
+        (double)stats.bytes_rx * REPLAY_ROUNDS / elapsed_us : 0.0;
+
+    printf(
+        "%s: %lu records, %lu B rx, %lu B tx, %lu URC in %.1f s\n",
+        path,
+        (unsigned long)stats.records,
+        (unsigned long)stats.bytes_rx,
+        (unsigned long)stats.bytes_tx,
+        (unsigned long)stats.urc_count,
+        recorded_s);
+    printf(
+        "  link:     %.0f B/s rx, %.0f B/s tx\n",
+        recorded_s > 0 ? stats.bytes_rx / recorded_s : 0.0,
+        recorded_s > 0 ? stats.bytes_tx / recorded_s : 0.0);
+    printf(
+        "  latency:  %lu responses, avg %.1f ms, max %.1f ms\n",
+        (unsigned long)stats.responses,
+        stats.responses > 0 ? stats.total_latency_us / 1e3 / stats.responses : 0.0,
+        stats.max_latency_us / 1e3);
+    printf("  parser:   %.1f MB/s (%d replays)\n", parse_mbps, REPLAY_ROUNDS);
+
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    std::string path;
+
+    if (argc > 1) {
+        path = argv[1];
+    } else {
+        path = argv[0];
+        path = path.substr(0, path.rfind('/') + 1) + "../data/sample.s7tr";
+    }
+
+    test_round_trip();
+    test_invalid_file();
+    CHECK(replay(path.c_str(), argc <= 1));
+
+    return host_test::summary("transcript_replay");
+}
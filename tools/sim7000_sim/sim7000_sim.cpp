@@ -0,0 +1,594 @@
+/*
+ * Simulador de SIM7000 para Linux a través de un pseudo-terminal.
+ *
+ * Responde el subconjunto de comandos AT que utiliza lib/lte_modem (E, CGMM,
+ * CGSN, GSV, CCLK, CPIN, CSQ, CGREG, COPS, CNACT, IPR, SMCONF/SMCONN/SMPUB/
+ * SMSUB/SMSTATE, CGNSPWR/CGNSURC/CGNSINF) con latencia, errores y ráfagas de
+ * URC configurables.
+ *
+ * Compilación:
+ *   g++ -std=c++20 -O2 -o sim7000_sim tools/sim7000_sim/sim7000_sim.cpp
+ *
+ * El simulador imprime la ruta del pty esclavo. Para usarlo con el
+ * dispositivo, se puede enlazar el pty con un adaptador USB-serie conectado a
+ * la UART del modem:
+ *   socat /dev/ttyUSB0,raw,echo=0,b115200 <pty>,raw,echo=0
+ *
+ * Opciones:
+ *   --latency <ms>         latencia base de las respuestas (20)
+ *   --jitter <ms>          variación aleatoria de la latencia (10)
+ *   --error-rate <p>       probabilidad de responder ERROR (0)
+ *   --drop-rate <p>        probabilidad de no responder (0)
+ *   --urc-burst <n>        URC +UGNSINF adicionales por ráfaga (0)
+ *   --burst-interval <ms>  intervalo entre ráfagas (5000)
+ *   --loopback             reenvía los mensajes publicados como +SMSUB si el
+ *                          tópico está suscrito
+ *   --smconn-delay <ms>    tiempo de conexión con el broker (400)
+ *   --no-abort             AT+SMCONN no se aborta al recibir un carácter
+ *   --baud <n>             limita la salida a la velocidad de una UART (10
+ *                          bits por byte); AT+IPR=<n> la cambia después de
+ *                          responder OK. Sin la opción no hay límite
+ *   --seed <n>             semilla del generador aleatorio
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <map>
+#include <poll.h>
+#include <random>
+#include <set>
+#include <string>
+#include <string_view>
+#include <termios.h>
+#include <unistd.h>
+
+using clock_type = std::chrono::steady_clock;
+using namespace std::chrono_literals;
+
+#define CRLF "\r\n"
+
+struct sim_config_t
+{
+    int latency_ms = 20;
+    int jitter_ms = 10;
+    double error_rate = 0.0;
+    double drop_rate = 0.0;
+    int urc_burst = 0;
+    int burst_interval_ms = 5000;
+    bool loopback = false;
+    int smconn_delay_ms = 400;
+    bool smconn_abortable = true;
+    int baud_rate = 0;
+    unsigned seed = std::random_device{}();
+};
+
+struct sim_stats_t
+{
+    unsigned long commands = 0;
+    unsigned long errors = 0;
+    unsigned long dropped = 0;
+    unsigned long publishes = 0;
+    unsigned long aborted = 0;
+    unsigned long urcs = 0;
+    unsigned long bytes_rx = 0;
+    unsigned long bytes_tx = 0;
+};
+
+static volatile sig_atomic_t s_is_running = 1;
+
+class SIM7000_Simulator
+{
+public:
+    SIM7000_Simulator(int fd, const sim_config_t &config) :
+        m_fd{fd},
+        m_config{config},
+        m_random{config.seed},
+        m_last_output{clock_type::now()},
+        m_next_burst{clock_type::now() + std::chrono::milliseconds(config.burst_interval_ms)},
+        m_next_nav_urc{clock_type::now()},
+        m_tx_ready{clock_type::now()},
+        m_baud_rate{config.baud_rate}
+    { }
+
+    void run()
+    {
+        char buffer[512];
+
+        while (s_is_running) {
+            struct pollfd pfd = { m_fd, POLLIN, 0 };
+            struct timespec timeout = get_poll_timeout();
+            ppoll(&pfd, 1, &timeout, nullptr);
+
+            if (pfd.revents & POLLIN) {
+                ssize_t length = read(m_fd, buffer, sizeof(buffer));
+                if (length > 0) {
+                    m_stats.bytes_rx += length;
+                    receive(std::string_view(buffer, length));
+                }
+            }
+
+            finish_connection();
+            generate_urcs();
+            flush_output();
+        }
+    }
+
+    const sim_stats_t &get_stats() const { return m_stats; }
+
+private:
+    int m_fd;
+    sim_config_t m_config;
+    sim_stats_t m_stats;
+    std::mt19937 m_random;
+    std::string m_line;
+    // salidas programadas ordenadas por instante de envío
+    using output_map_t = std::multimap<clock_type::time_point, std::string>;
+    output_map_t m_output;
+    clock_type::time_point m_last_output;
+    clock_type::time_point m_next_burst;
+    clock_type::time_point m_next_nav_urc;
+    // instante en el que la UART termina de transmitir la última salida
+    clock_type::time_point m_tx_ready;
+
+    /* Estado del modem */
+
+    bool m_echo = true;
+    bool m_net_active = false;
+    bool m_mqtt_connected = false;
+    bool m_gnss_on = false;
+    int m_nav_urc_interval = 0;
+    std::set<std::string> m_topics;
+    // conexión con el broker en curso (AT+SMCONN)
+    bool m_conn_pending = false;
+    clock_type::time_point m_conn_deadline;
+    // velocidad actual y la solicitada con AT+IPR, que se aplica después de
+    // enviar el OK
+    int m_baud_rate;
+    int m_next_baud_rate = 0;
+    output_map_t::iterator m_baud_switch;
+
+    // publicación pendiente de recibir su contenido después de "> "
+    size_t m_payload_length = 0;
+    std::string m_payload_topic;
+    std::string m_payload;
+
+    void receive(std::string_view data)
+    {
+        for (char c : data) {
+            // mientras se conecta con el broker, cualquier carácter aborta el
+            // comando (V.25ter); si no es abortable, se ignora
+            if (m_conn_pending) {
+                if (m_config.smconn_abortable) {
+                    m_conn_pending = false;
+                    m_stats.aborted++;
+                    respond("ERROR");
+                }
+                continue;
+            }
+
+            // verifica si se está recibiendo el contenido de una publicación
+            if (m_payload_length > 0) {
+                // ESC cancela la publicación
+                if (c == '\x1b') {
+                    m_payload_length = 0;
+                    m_stats.aborted++;
+                    respond("ERROR");
+                    continue;
+                }
+
+                m_payload.push_back(c);
+                if (m_payload.length() == m_payload_length) {
+                    finish_publish();
+                }
+                continue;
+            }
+
+            if (c == '\r') {
+                if (!m_line.empty()) {
+                    handle_line(m_line);
+                    m_line.clear();
+                }
+            } else if (c != '\n') {
+                m_line.push_back(c);
+            }
+        }
+    }
+
+    void handle_line(const std::string &line)
+    {
+        if (m_echo) {
+            send_now(line + "\r");
+        }
+
+        // ignora lo que no sea un comando
+        if (line.length() < 2 || strncasecmp(line.c_str(), "AT", 2) != 0) return;
+        m_stats.commands++;
+
+        std::uniform_real_distribution<double> chance(0.0, 1.0);
+
+        // inyección de fallos
+        if (chance(m_random) < m_config.drop_rate) {
+            m_stats.dropped++;
+            return;
+        }
+
+        if (chance(m_random) < m_config.error_rate) {
+            m_stats.errors++;
+            respond("ERROR");
+            return;
+        }
+
+        std::string_view cmd(line);
+        cmd.remove_prefix(2);
+        handle_command(cmd);
+    }
+
+    void handle_command(std::string_view cmd)
+    {
+        if (cmd.empty()) {
+            respond("OK");
+        } else if (cmd == "E0" || cmd == "E1") {
+            m_echo = cmd == "E1";
+            respond("OK");
+        } else if (cmd == "+CGMM") {
+            respond("SIMCOM_SIM7000G" CRLF CRLF "OK");
+        } else if (cmd == "+CGMR") {
+            respond("Revision:1529B11SIM7000G" CRLF CRLF "OK");
+        } else if (cmd == "+CGSN") {
+            respond("869951030000000" CRLF CRLF "OK");
+        } else if (cmd == "+GSV") {
+            respond("SIMCOM_Ltd" CRLF "SIMCOM_SIM7000G" CRLF
+                "Revision:1529B11SIM7000G" CRLF CRLF "OK");
+        } else if (cmd.starts_with("+IPR=")) {
+            m_next_baud_rate = atoi(std::string(cmd.substr(5)).c_str());
+            m_baud_switch = respond("OK");
+        } else if (cmd == "+CCLK?") {
+            respond(std::string("+CCLK: \"") + get_clock() + "\"" CRLF CRLF "OK");
+        } else if (cmd == "+CPIN?") {
+            respond("+CPIN: READY" CRLF CRLF "OK");
+        } else if (cmd == "+CSQ") {
+            std::uniform_int_distribution<int> rssi(14, 28);
+            respond("+CSQ: " + std::to_string(rssi(m_random)) + ",99" CRLF CRLF "OK");
+        } else if (cmd == "+CGREG?") {
+            respond("+CGREG: 0,1" CRLF CRLF "OK");
+        } else if (cmd == "+COPS?") {
+            respond("+COPS: 0,0,\"SIMULATOR\",7" CRLF CRLF "OK");
+        } else if (cmd == "+CGNAPN") {
+            respond("+CGNAPN: 1,\"internet\"" CRLF CRLF "OK");
+        } else if (cmd == "+CGACT?") {
+            respond("+CGACT: 1,1" CRLF CRLF "OK");
+        } else if (cmd.starts_with("+CGPADDR")) {
+            respond("+CGPADDR: 1,10.0.0.2" CRLF CRLF "OK");
+        } else if (cmd == "+CGDCONT?") {
+            respond("+CGDCONT: 1,\"IP\",\"internet\",\"0.0.0.0\",0,0,0,0" CRLF CRLF "OK");
+        } else if (cmd == "+CNACT?") {
+            respond(m_net_active ?
+                "+CNACT: 1,\"10.0.0.2\"" CRLF CRLF "OK" :
+                "+CNACT: 0,\"0.0.0.0\"" CRLF CRLF "OK");
+        } else if (cmd.starts_with("+CNACT=")) {
+            m_net_active = cmd.substr(7, 1) != "0";
+            respond("OK");
+            respond(m_net_active ? "+APP PDP: ACTIVE" : "+APP PDP: DEACTIVE");
+        } else if (cmd.starts_with("+SMCONF=")) {
+            respond("OK");
+        } else if (cmd == "+SMCONN") {
+            if (!m_net_active) {
+                respond("ERROR");
+                return;
+            }
+            // la conexión con el broker tarda más que un comando normal
+            m_conn_pending = true;
+            m_conn_deadline = clock_type::now() +
+                std::chrono::milliseconds(get_latency() + m_config.smconn_delay_ms);
+        } else if (cmd == "+SMDISC") {
+            m_mqtt_connected = false;
+            respond("OK");
+        } else if (cmd == "+SMSTATE?") {
+            respond(std::string("+SMSTATE: ") + (m_mqtt_connected ? "1" : "0") +
+                CRLF CRLF "OK");
+        } else if (cmd.starts_with("+SMPUB=")) {
+            start_publish(cmd.substr(7));
+        } else if (cmd.starts_with("+SMSUB=")) {
+            m_topics.insert(get_first_string(cmd.substr(7)));
+            respond("OK");
+        } else if (cmd.starts_with("+SMUNSUB=")) {
+            m_topics.erase(get_first_string(cmd.substr(9)));
+            respond("OK");
+        } else if (cmd == "+CGNSPWR?") {
+            respond(std::string("+CGNSPWR: ") + (m_gnss_on ? "1" : "0") + CRLF CRLF "OK");
+        } else if (cmd.starts_with("+CGNSPWR=")) {
+            m_gnss_on = cmd.substr(9, 1) == "1";
+            respond("OK");
+        } else if (cmd == "+CGNSURC?") {
+            respond("+CGNSURC: " + std::to_string(m_nav_urc_interval) + CRLF CRLF "OK");
+        } else if (cmd.starts_with("+CGNSURC=")) {
+            m_nav_urc_interval = atoi(std::string(cmd.substr(9)).c_str());
+            m_next_nav_urc = clock_type::now();
+            respond("OK");
+        } else if (cmd == "+CGNSINF") {
+            respond("+CGNSINF: " + get_nav_info() + CRLF CRLF "OK");
+        } else if (cmd.starts_with("+CFUN") || cmd.starts_with("+IPR") ||
+                   cmd.starts_with("+CMEE")) {
+            respond("OK");
+        } else {
+            respond("ERROR");
+        }
+    }
+
+    void start_publish(std::string_view params)
+    {
+        // "topic",length,qos,retain
+        m_payload_topic = get_first_string(params);
+        size_t comma = params.find(',', m_payload_topic.length() + 2);
+        m_payload_length = comma == std::string_view::npos ?
+            0 : atoi(std::string(params.substr(comma + 1)).c_str());
+
+        if (!m_mqtt_connected) {
+            m_payload_length = 0;
+            respond("ERROR");
+            return;
+        }
+
+        if (m_payload_length == 0) {
+            finish_publish();
+            return;
+        }
+
+        // el indicador se envía sin salto de línea
+        m_payload.clear();
+        schedule("> ", get_latency());
+    }
+
+    void finish_publish()
+    {
+        m_stats.publishes++;
+        m_payload_length = 0;
+        respond("OK");
+
+        // reenvía el mensaje si el tópico está suscrito
+        if (m_config.loopback && m_topics.contains(m_payload_topic)) {
+            respond("+SMSUB: \"" + m_payload_topic + "\",\"" + m_payload + "\"");
+            m_stats.urcs++;
+        }
+    }
+
+    void finish_connection()
+    {
+        if (!m_conn_pending || clock_type::now() < m_conn_deadline) return;
+
+        m_conn_pending = false;
+        m_mqtt_connected = true;
+        respond("OK");
+    }
+
+    void generate_urcs()
+    {
+        auto now = clock_type::now();
+
+        // reporte de navegación periódico (una posición por segundo)
+        if (m_gnss_on && m_nav_urc_interval > 0 && now >= m_next_nav_urc) {
+            m_next_nav_urc = now + std::chrono::seconds(m_nav_urc_interval);
+            schedule(CRLF "+UGNSINF: " + get_nav_info() + CRLF, 0);
+            m_stats.urcs++;
+        }
+
+        // ráfaga de URC para probar el despacho bajo carga
+        if (m_config.urc_burst > 0 && now >= m_next_burst) {
+            m_next_burst = now + std::chrono::milliseconds(m_config.burst_interval_ms);
+            std::string burst;
+
+            for (int i = 0; i < m_config.urc_burst; i++) {
+                burst += CRLF "+UGNSINF: " + get_nav_info() + CRLF;
+            }
+
+            schedule(burst, 0);
+            m_stats.urcs += m_config.urc_burst;
+        }
+    }
+
+    output_map_t::iterator respond(const std::string &response, int extra_ms = 0)
+    {
+        return schedule(CRLF + response + CRLF, get_latency() + extra_ms);
+    }
+
+    int get_latency()
+    {
+        std::uniform_int_distribution<int> jitter(0, std::max(m_config.jitter_ms, 0));
+        return m_config.latency_ms + jitter(m_random);
+    }
+
+    output_map_t::iterator schedule(const std::string &data, int delay_ms)
+    {
+        // mantiene el orden de las respuestas aunque la latencia varíe
+        auto when = std::max(
+            clock_type::now() + std::chrono::milliseconds(delay_ms),
+            m_last_output
+        );
+        m_last_output = when;
+        return m_output.emplace(when, data);
+    }
+
+    void send_now(const std::string &data)
+    {
+        schedule(data, 0);
+    }
+
+    void flush_output()
+    {
+        auto now = clock_type::now();
+
+        while (!m_output.empty() && m_output.begin()->first <= now && m_tx_ready <= now) {
+            const std::string &data = m_output.begin()->second;
+            ssize_t written = write(m_fd, data.data(), data.length());
+            if (written > 0) m_stats.bytes_tx += written;
+
+            // la siguiente salida espera a que la UART transmita esta
+            if (m_baud_rate > 0 && written > 0) {
+                m_tx_ready = now + std::chrono::nanoseconds(
+                    written * 10 * 1000000000LL / m_baud_rate);
+            }
+
+            if (m_next_baud_rate > 0 && m_output.begin() == m_baud_switch) {
+                // sin límite de velocidad el cambio no tiene efecto
+                if (m_baud_rate > 0) m_baud_rate = m_next_baud_rate;
+                m_next_baud_rate = 0;
+            }
+
+            m_output.erase(m_output.begin());
+        }
+    }
+
+    struct timespec get_poll_timeout() const
+    {
+        // despierta a tiempo para la siguiente salida, con un máximo de 5 ms
+        // para generar las URC
+        auto timeout = std::chrono::nanoseconds(5ms);
+
+        if (!m_output.empty()) {
+            auto next = std::max(m_output.begin()->first, m_tx_ready);
+            timeout = std::clamp(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(next - clock_type::now()),
+                std::chrono::nanoseconds(0),
+                timeout);
+        }
+
+        return { 0, (long)timeout.count() };
+    }
+
+    std::string get_nav_info()
+    {
+        char buffer[160];
+        time_t now = time(nullptr);
+        struct tm utc;
+        gmtime_r(&now, &utc);
+
+        // posición con una pequeña variación alrededor de un punto fijo
+        std::uniform_real_distribution<double> offset(-0.0005, 0.0005);
+        snprintf(
+            buffer,
+            sizeof(buffer),
+            "1,1,%04d%02d%02d%02d%02d%02d.000,%.6f,%.6f,2240.0,%.2f,0.0,1,,1.2,1.5,0.9,,12,8,,,35,,",
+            utc.tm_year + 1900, utc.tm_mon + 1, utc.tm_mday,
+            utc.tm_hour, utc.tm_min, utc.tm_sec,
+            19.432608 + offset(m_random),
+            -99.133209 + offset(m_random),
+            std::abs(offset(m_random)) * 40000
+        );
+
+        return buffer;
+    }
+
+    static std::string get_clock()
+    {
+        char buffer[32];
+        time_t now = time(nullptr);
+        struct tm utc;
+        gmtime_r(&now, &utc);
+        strftime(buffer, sizeof(buffer), "%y/%m/%d,%H:%M:%S+00", &utc);
+        return buffer;
+    }
+
+    static std::string get_first_string(std::string_view params)
+    {
+        size_t start = params.find('"');
+        if (start == std::string_view::npos) return std::string();
+        size_t end = params.find('"', start + 1);
+        return std::string(params.substr(start + 1, end - start - 1));
+    }
+};
+
+static void on_signal(int)
+{
+    s_is_running = 0;
+}
+
+static bool parse_args(int argc, char **argv, sim_config_t &config)
+{
+    for (int i = 1; i < argc; i++) {
+        std::string_view arg(argv[i]);
+        const char *value = i + 1 < argc ? argv[i + 1] : nullptr;
+
+        if (arg == "--loopback") {
+            config.loopback = true;
+            continue;
+        }
+
+        if (arg == "--no-abort") {
+            config.smconn_abortable = false;
+            continue;
+        }
+
+        if (value == nullptr) return false;
+        i++;
+
+        if (arg == "--latency") config.latency_ms = atoi(value);
+        else if (arg == "--jitter") config.jitter_ms = atoi(value);
+        else if (arg == "--error-rate") config.error_rate = atof(value);
+        else if (arg == "--drop-rate") config.drop_rate = atof(value);
+        else if (arg == "--urc-burst") config.urc_burst = atoi(value);
+        else if (arg == "--burst-interval") config.burst_interval_ms = atoi(value);
+        else if (arg == "--smconn-delay") config.smconn_delay_ms = atoi(value);
+        else if (arg == "--seed") config.seed = strtoul(value, nullptr, 10);
+        else if (arg == "--baud") config.baud_rate = atoi(value);
+        else return false;
+    }
+
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    sim_config_t config;
+
+    if (!parse_args(argc, argv, config)) {
+        fprintf(stderr, "Invalid arguments (see the header of sim7000_sim.cpp)\n");
+        return 1;
+    }
+
+    int master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0) {
+        perror("Failed to create pseudo-terminal");
+        return 1;
+    }
+
+    const char *slave_path = ptsname(master);
+
+    // configura el lado esclavo en modo crudo y lo mantiene abierto para que
+    // el maestro no reciba un cierre cuando el cliente se desconecta
+    int slave = open(slave_path, O_RDWR | O_NOCTTY);
+    struct termios tio;
+    tcgetattr(slave, &tio);
+    cfmakeraw(&tio);
+    tcsetattr(slave, TCSANOW, &tio);
+
+    printf("SIM7000 simulator listening on %s\n", slave_path);
+    fflush(stdout);
+
+    signal(SIGINT, on_signal);
+    signal(SIGTERM, on_signal);
+
+    SIM7000_Simulator simulator(master, config);
+    simulator.run();
+
+    const sim_stats_t &stats = simulator.get_stats();
+    printf(
+        "\ncommands=%lu errors=%lu dropped=%lu publishes=%lu aborted=%lu urcs=%lu rx=%lu tx=%lu\n",
+        stats.commands,
+        stats.errors,
+        stats.dropped,
+        stats.publishes,
+        stats.aborted,
+        stats.urcs,
+        stats.bytes_rx,
+        stats.bytes_tx
+    );
+
+    close(slave);
+    close(master);
+    return 0;
+}